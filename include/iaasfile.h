@@ -1,12 +1,16 @@
 #pragma once
 
 #include <memory>
+#include <functional>
 #include "imodule.h"
 #include <list>
 
+#include "ivolumetest.h"
+
 #include "math/Plane3.h"
 #include "math/Vector3.h"
 #include "math/AABB.h"
+#include "math/Ray.h"
 
 namespace map
 {
@@ -76,6 +80,19 @@ public:
 
     virtual std::size_t     getNumAreas() const = 0;
     virtual const Area&     getArea(int areaNum) const = 0;
+
+    /**
+     * Invokes the functor with the number of each area whose bounds are 
+     * not entirely outside the given view volume. The areas are looked up
+     * in a spatial index, the order of invocation is unspecified.
+     */
+    virtual void forEachAreaInVolume(const VolumeTest& volume, const std::function<void(int)>& functor) const = 0;
+
+    /**
+     * Returns the number of the area whose bounds are intersected first by
+     * the given ray, or -1 if the ray doesn't hit any area.
+     */
+    virtual int findAreaAlongRay(const Ray& ray) const = 0;
 };
 typedef std::shared_ptr<IAasFile> IAasFilePtr;
 
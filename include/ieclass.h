@@ -31,6 +31,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "imodule.h"
 #include "math/Vector3.h"
+#include "string/interned.h"
 
 #include <vector>
 #include <list>
@@ -53,11 +54,11 @@ class EntityClassAttribute
 {
 private:
 
-    // Attribute type
-    std::string _type;
+    // Attribute type, interned like the name, there are only a few distinct ones
+    string::InternedString _type;
 
     // Attribute name
-    std::string _name;
+    string::InternedString _name;
 
     // Value
     std::string _value;
@@ -85,6 +86,12 @@ public:
         return _name;
     }
 
+    /// The interned attribute key name
+    const string::InternedString& getInternedName() const
+    {
+        return _name;
+    }
+
     /// Get attribute value
     const std::string& getValue() const
     {
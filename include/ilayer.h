@@ -2,6 +2,7 @@
 
 #include <set>
 #include <string>
+#include <cstdint>
 #include <functional>
 #include "imodule.h"
 #include <sigc++/signal.h>
@@ -15,6 +16,31 @@ typedef std::shared_ptr<INode> INodePtr;
 // A list of named layers
 typedef std::set<int> LayerList;
 
+// Compact form of a LayerList, bit N is set for the layer with the ID N.
+// Layer IDs beyond the capacity of the mask share the highest bit.
+typedef std::uint64_t LayerMask;
+
+const int LAYER_MASK_OVERFLOW_BIT = 63;
+
+// Returns the bit representing the given layer in a LayerMask
+inline LayerMask getLayerMaskBit(int layerId)
+{
+	return layerId >= 0 && layerId < LAYER_MASK_OVERFLOW_BIT ?
+		LayerMask(1) << layerId : LayerMask(1) << LAYER_MASK_OVERFLOW_BIT;
+}
+
+inline LayerMask createLayerMask(const LayerList& layers)
+{
+	LayerMask mask = 0;
+
+	for (int layerId : layers)
+	{
+		mask |= getLayerMaskBit(layerId);
+	}
+
+	return mask;
+}
+
 /**
  * greebo: Interface of a Layered object.
  */
@@ -45,6 +71,12 @@ public:
      */
     virtual const LayerList& getLayers() const = 0;
 
+	/**
+	 * Returns the layers of this object in the compact form of a bitmask,
+	 * as produced by createLayerMask(getLayers()).
+	 */
+	virtual LayerMask getLayerMask() const = 0;
+
 	/**
 	 * greebo: This assigns the given node to the given set of layers. Any previous
 	 * assignments of the node will be overwritten by this routine.
@@ -183,6 +215,17 @@ public:
 	 */
 	virtual void setSelected(int layerID, bool selected) = 0;
 
+	/**
+	 * Maintenance of the per-layer member index. Nodes register themselves with
+	 * the layer manager of their root when they are inserted into the scene, and
+	 * unregister when they are removed again. Nodes in the scene report any change
+	 * of their layer assignment, the layer manager will update their visibility the
+	 * next time a membership change is processed.
+	 */
+	virtual void registerNode(const INodePtr& node) = 0;
+	virtual void unregisterNode(const INodePtr& node) = 0;
+	virtual void onNodeLayersChanged(const INodePtr& node, const LayerList& previousLayers) = 0;
+
 	/**
 	 * A signal for client code to get notified about layer creation,
 	 * renamings and removal.
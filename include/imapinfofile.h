@@ -2,6 +2,7 @@
 
 #include <string>
 #include <map>
+#include <iosfwd>
 #include "imodule.h"
 #include "imap.h"
 #include <functional>
@@ -30,6 +31,10 @@ typedef std::map<NodeIndexPair, scene::INodePtr> NodeIndexMap;
  *
  * Later, when the info file is parsed after map load, the module will be asked 
  * to parse the blocks it's responsible for, and apply its information to the map.
+ *
+ * Modules dealing with per-node information can additionally store their state
+ * in a binary companion file, which is loaded instead of their text blocks
+ * as long as the text file has not been changed since.
  */
 class IMapInfoFileModule
 {
@@ -125,6 +130,29 @@ public:
 	 * Post-parsing cleanup routine, called after applyInfoToScene().
 	 */
 	virtual void onInfoFileLoadFinished() = 0;
+
+	// Binary Companion File (optional)
+
+	/**
+	 * Write the same information as writeBlocks() in binary form, this is called
+	 * right after writeBlocks(). Returns false if this module doesn't support
+	 * (or cannot write) binary data, its text blocks will be parsed on load.
+	 */
+	virtual bool writeBinaryBlock(std::ostream& stream)
+	{
+		return false;
+	}
+
+	/**
+	 * Load the data written by writeBinaryBlock(), this replaces the parseBlock()
+	 * calls for all the blocks this module has written. Returns false if the data
+	 * could not be read, the module's state is reset through onInfoFileLoadStart()
+	 * and its text blocks are parsed instead.
+	 */
+	virtual bool readBinaryBlock(std::istream& stream)
+	{
+		return false;
+	}
 };
 typedef std::shared_ptr<IMapInfoFileModule> IMapInfoFileModulePtr;
 
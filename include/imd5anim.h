@@ -54,8 +54,8 @@ public:
 		Quaternion orientation;
 	};
 	
-	// Each frame has a series of float values, applied to one or more animated components (x, y, z, yaw, pitch, roll)
-	typedef std::vector<float> FrameKeys;
+	typedef std::vector<Key> Keys;
+	typedef std::shared_ptr<const Keys> KeysPtr;
 
 	/**
 	 * Get the number of joints in this animation.
@@ -83,9 +83,12 @@ public:
 	virtual std::size_t getNumFrames() const = 0;
 
 	/**
-	 * Returns the float values of the given frame index.
+	 * Returns the decoded pose of the given frame, one key per joint. Each key
+	 * is the base frame key with the frame's animated components applied,
+	 * relative to the parent joint. The frames might be decoded on demand
+	 * and released again, hold on to the returned pointer while using it.
 	 */
-	virtual const FrameKeys& getFrameKeys(std::size_t index) const = 0;
+	virtual KeysPtr getFramePose(std::size_t index) const = 0;
 };
 typedef std::shared_ptr<IMD5Anim> IMD5AnimPtr;
 
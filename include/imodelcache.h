@@ -3,11 +3,29 @@
 #include "imodule.h"
 #include "imodel.h"
 #include "inode.h"
+#include <set>
 #include <sigc++/signal.h>
 
 namespace model 
 {
 
+// Cumulative counters describing the work done by the model cache
+struct ModelCacheStatistics
+{
+    // Number of models parsed by the cache, including the prefetched ones
+    std::size_t modelsLoaded = 0;
+
+    // Number of models handed to the worker threads by prefetchModels()
+    std::size_t modelsPrefetched = 0;
+
+    // Number of models read from the binary on-disk cache instead of being imported
+    std::size_t modelsReadFromBinaryCache = 0;
+
+    // Time the calling thread has spent in getModel() waiting
+    // for prefetched models or loading models on its own
+    std::size_t loadMilliseconds = 0;
+};
+
 /** Modelcache interface.
  */
 class IModelCache :
@@ -29,10 +47,27 @@ public:
 	 * so calling this with the same path twice will return the same
 	 * IModelPtr to save memory.
 	 *
+	 * Imported static models are additionally stored in a binary cache on disk,
+	 * which is used in later sessions as long as the source file is unchanged.
+	 *
 	 * This method is primarily used by the ModelLoaders to acquire their model data.
 	 */
 	virtual IModelPtr getModel(const std::string& modelPath) = 0;
 
+    /**
+     * Starts loading the models referenced by the given paths in worker threads.
+     * Subsequent calls to getModel() or getModelNode() for one of these paths
+     * pick up the parsed model, waiting for the worker if it's not done yet.
+     *
+     * The paths are resolved like in getModelNode(), modelDef names are
+     * replaced by their mesh. Particles, paths without a suitable importer and
+     * models which are already in the cache are ignored.
+     */
+    virtual void prefetchModels(const std::set<std::string>& modelPaths) = 0;
+
+    // Returns the counters accumulated since the module has been initialised
+    virtual ModelCacheStatistics getStatistics() const = 0;
+
     // Loads a model from the static resources in DarkRadiant's runtime data/resources folder
     virtual scene::INodePtr getModelNodeForStaticResource(const std::string& resourcePath) = 0;
 
@@ -230,6 +230,20 @@ public:
      * reload.
 	 */
 	virtual void reloadParticleDefs() = 0;
+
+	/// Number of particle emitters rendered since the last reset. Active emitters
+	/// have been simulated, skipped ones were culled, updated at a reduced rate
+	/// or re-used the simulation of an identical emitter.
+	struct EmitterStatistics
+	{
+		std::size_t active = 0;
+		std::size_t skipped = 0;
+	};
+
+	virtual EmitterStatistics getEmitterStatistics() const = 0;
+
+	/// Resets the emitter statistics, usually called at the start of a frame
+	virtual void resetEmitterStatistics() = 0;
 };
 
 } // namespace
@@ -2,11 +2,13 @@
 
 #include "imodule.h"
 #include <functional>
+#include <vector>
 
 #include "math/Vector3.h"
 #include "math/AABB.h"
 
 #include "ishaderlayer.h"
+#include "render/ArbitraryMeshVertex.h"
 #include <sigc++/signal.h>
 
 /**
@@ -367,6 +369,33 @@ public:
     virtual void render(const RenderInfo& info) const = 0;
 };
 
+/**
+ * An OpenGLRenderable made of indexed triangles, which are drawn the same way
+ * regardless of the transform the renderable is submitted with, like the
+ * surfaces of static models.
+ *
+ * When the same renderable is submitted many times without a light, the
+ * backend may draw all these instances with a single draw call of its own,
+ * instead of invoking render() once per instance.
+ */
+class InstanceableRenderable :
+    public OpenGLRenderable
+{
+public:
+    /// The vertices of the triangles drawn by render()
+    virtual const std::vector<ArbitraryMeshVertex>& getVertexArray() const = 0;
+
+    /// The triangle indices into the vertex array, three per triangle
+    virtual const std::vector<unsigned int>& getIndexArray() const = 0;
+
+    /**
+     * Identifies the current vertex and index data. It changes every time the
+     * geometry is modified and is never shared by two renderable objects, which
+     * allows the backend to re-use data derived from the geometry.
+     */
+    virtual std::size_t getGeometryId() const = 0;
+};
+
 class Matrix4;
 class Texture;
 
@@ -565,6 +594,19 @@ public:
 
 	// Subscription to get notified as soon as the openGL extensions have been initialised
 	virtual sigc::signal<void> signal_extensionsInitialised() = 0;
+
+    /// Counters collected by the backend during the last call to render()
+    struct Statistics
+    {
+        /// Number of draw calls, i.e. render() calls on the submitted renderables
+        /// plus one for each batch of merged instances
+        std::size_t drawCalls = 0;
+
+        /// Number of renderables drawn as part of a merged instance batch
+        std::size_t batchedInstances = 0;
+    };
+
+    virtual const Statistics& getStatistics() const = 0;
 };
 typedef std::shared_ptr<RenderSystem> RenderSystemPtr;
 typedef std::weak_ptr<RenderSystem> RenderSystemWeakPtr;
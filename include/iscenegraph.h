@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <vector>
 #include "imodule.h"
 #include "inode.h"
 #include "ipath.h"
@@ -35,6 +36,14 @@ typedef std::shared_ptr<ISpacePartitionSystem> ISpacePartitionSystemPtr;
 class Graph
 {
 public:
+	enum class ChangeType
+	{
+		Insert,
+		Erase,
+	};
+
+	// The node insertions and removals collected during a transaction, in the order they happened
+	using ChangeSet = std::vector<std::pair<ChangeType, INodePtr>>;
 
 	/* greebo: Derive from this class to get notified on scene changes
 	 */
@@ -52,6 +61,24 @@ public:
 
 		// Gets called when <node> is removed from the scenegraph
 		virtual void onSceneNodeErase(const INodePtr& node) {}
+
+		// Gets called once when a transaction is committed, with all the nodes
+		// inserted or removed in the meantime. The default implementation
+		// dispatches the changes to onSceneNodeInsert/onSceneNodeErase one by one.
+		virtual void onSceneNodesChanged(const ChangeSet& changes)
+		{
+			for (const auto& [type, node] : changes)
+			{
+				if (type == ChangeType::Insert)
+				{
+					onSceneNodeInsert(node);
+				}
+				else
+				{
+					onSceneNodeErase(node);
+				}
+			}
+		}
 	};
 
 	// Returns the root-node of the graph.
@@ -84,6 +111,20 @@ public:
 	// A specific node has changed its bounds
 	virtual void nodeBoundsChanged(const scene::INodePtr& node) = 0;
 
+	/**
+	 * Starts a transaction, which can be nested. Until the outermost transaction
+	 * is committed, the nodes inserted or changing their bounds are not (re-)linked
+	 * into the space partition, and the scene observers are not notified about
+	 * insertions and removals. Multiple bounds changes of the same node result
+	 * in a single relink. Use the scene::GraphTransaction class to ensure
+	 * that every transaction is committed.
+	 */
+	virtual void beginTransaction() = 0;
+
+	// Commits the current transaction. If this is the outermost one, the pending nodes
+	// are linked into the space partition and the observers receive the collected changes.
+	virtual void commitTransaction() = 0;
+
 	// A walker class to be used in "foreachNodeInVolume"
 	class Walker
 	{
@@ -118,6 +159,31 @@ public:
 typedef std::shared_ptr<Graph> GraphPtr;
 typedef std::weak_ptr<Graph> GraphWeakPtr;
 
+/**
+ * Scoped transaction on a scene graph, which is committed on destruction.
+ * Use this to batch a lot of insertions, removals or transformations.
+ */
+class GraphTransaction
+{
+private:
+	Graph& _graph;
+
+public:
+	GraphTransaction(Graph& graph) :
+		_graph(graph)
+	{
+		_graph.beginTransaction();
+	}
+
+	GraphTransaction(const GraphTransaction& other) = delete;
+	GraphTransaction& operator=(const GraphTransaction& other) = delete;
+
+	~GraphTransaction()
+	{
+		_graph.commitTransaction();
+	}
+};
+
 class Cloneable
 {
 public:
@@ -84,6 +84,10 @@ public:
 	// Links this node into the SP tree. Returns the node it ends up being associated with
 	virtual void link(const scene::INodePtr& sceneNode) = 0;
 
+	// Links all the given nodes into the SP tree, which is faster than linking them
+	// one after the other. None of the nodes must be linked already.
+	virtual void link(const std::vector<scene::INodePtr>& sceneNodes) = 0;
+
 	// Unlink this node from the SP tree, returns true if this was successful
 	// (node had been linked before)
 	virtual bool unlink(const scene::INodePtr& sceneNode) = 0;
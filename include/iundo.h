@@ -6,6 +6,7 @@
 #include "imodule.h"
 #include "imap.h"
 #include <cstddef>
+#include <functional>
 #include <memory>
 #include <sigc++/signal.h>
 
@@ -18,6 +19,10 @@ class IUndoMemento
 {
 public:
     virtual ~IUndoMemento() {}
+
+    // Returns the approximate number of bytes occupied by this memento,
+    // including the heap memory it is holding on to
+    virtual std::size_t getApproximateSize() const = 0;
 };
 typedef std::shared_ptr<IUndoMemento> IUndoMementoPtr;
 
@@ -86,6 +91,18 @@ public:
 	// it immediately from the stack, therefore it never existed.
 	virtual void cancel() = 0;
 
+    // Returns the approximate number of bytes occupied by all recorded undo and redo operations
+    virtual std::size_t getMemoryUsage() const = 0;
+
+    // The size of an operation is calculated when it is recorded. Data shared with
+    // other operations is split among its owners at that time, this re-calculates
+    // all sizes to account for the owners added or discarded since then.
+    virtual void updateMemoryUsage() = 0;
+
+    // Invokes the given functor for each operation in the undo history (oldest first),
+    // passing the operation name and its approximate size in bytes
+    virtual void foreachOperation(const std::function<void(const std::string&, std::size_t)>& functor) const = 0;
+
     enum class EventType
     {
         OperationRecorded,
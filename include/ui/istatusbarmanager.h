@@ -23,6 +23,7 @@ struct StandardPosition
         GridSize = 30,
         OrthoViewPosition = 40,
         ShaderClipboard = 50,
+        UndoMemory = 55,
         MapEditStopwatch = 60,
         Back = 9000,
     };
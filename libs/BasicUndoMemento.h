@@ -2,20 +2,88 @@
 
 #include "iundo.h"
 
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace undo
 {
 
+// Approximate number of heap bytes owned by the given object, used to estimate
+// the memory footprint of undo mementos. The default assumes no heap allocation.
+template<typename T> std::size_t getHeapSize(const T& object);
+inline std::size_t getHeapSize(const std::string& str);
+template<typename First, typename Second> std::size_t getHeapSize(const std::pair<First, Second>& pair);
+template<typename T> std::size_t getHeapSize(const std::vector<T>& vector);
+template<typename T> std::size_t getHeapSize(const std::list<T>& list);
+
+template<typename T>
+std::size_t getHeapSize(const T& object)
+{
+    return 0;
+}
+
+inline std::size_t getHeapSize(const std::string& str)
+{
+    // Short strings are stored in-place
+    return str.capacity() >= sizeof(std::string) ? str.capacity() + 1 : 0;
+}
+
+template<typename First, typename Second>
+std::size_t getHeapSize(const std::pair<First, Second>& pair)
+{
+    return getHeapSize(pair.first) + getHeapSize(pair.second);
+}
+
+template<typename T>
+std::size_t getHeapSize(const std::vector<T>& vector)
+{
+    auto size = vector.capacity() * sizeof(T);
+
+    for (const auto& element : vector)
+    {
+        size += getHeapSize(element);
+    }
+
+    return size;
+}
+
+template<typename T>
+std::size_t getHeapSize(const std::list<T>& list)
+{
+    // Each list node carries two pointers next to the element
+    auto size = list.size() * (sizeof(T) + 2 * sizeof(void*));
+
+    for (const auto& element : list)
+    {
+        size += getHeapSize(element);
+    }
+
+    return size;
+}
+
+// Returns the share of the given object size that can be attributed to
+// one of the owners of the given shared pointer. The share depends on the
+// current number of owners, see IUndoSystem::updateMemoryUsage().
+template<typename T>
+std::size_t getSharedSize(const std::shared_ptr<T>& ptr, std::size_t size)
+{
+    return ptr ? size / static_cast<std::size_t>(ptr.use_count()) : 0;
+}
+
 /**
  * An UndoMemento implementation capable of holding a single
  * copyable object, which is stored by value.
  */
 template<typename Copyable>
-class BasicUndoMemento : 
+class BasicUndoMemento :
 	public IUndoMemento
 {
 	Copyable _data;
 public:
-	BasicUndoMemento(const Copyable& data) : 
+	BasicUndoMemento(const Copyable& data) :
 		_data(data)
 	{}
 
@@ -23,6 +91,11 @@ public:
 	{
 		return _data;
 	}
+
+    std::size_t getApproximateSize() const override
+    {
+        return sizeof(*this) + getHeapSize(_data);
+    }
 };
 
 } // namespace
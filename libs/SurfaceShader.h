@@ -6,6 +6,7 @@
 #include "util/Noncopyable.h"
 #include "irender.h"
 #include "shaderlib.h"
+#include "string/interned.h"
 
 /**
  * Encapsulates a GL ShaderPtr and keeps track whether this
@@ -18,8 +19,8 @@ class SurfaceShader :
 	public Shader::Observer
 {
 private:
-    // greebo: The name of the material
-    std::string _materialName;
+    // greebo: The name of the material, interned since it's shared by many surfaces
+    string::InternedString _materialName;
 
     RenderSystemPtr _renderSystem;
 
@@ -37,7 +38,7 @@ private:
 public:
     // Constructor. The renderSystem reference will be kept internally as reference
     // The SurfaceShader will try to de-reference it when capturing shaders.
-    SurfaceShader(const std::string& materialName, const RenderSystemPtr& renderSystem = RenderSystemPtr()) :
+    SurfaceShader(const string::InternedString& materialName, const RenderSystemPtr& renderSystem = RenderSystemPtr()) :
         _materialName(materialName),
         _renderSystem(renderSystem),
         _inUse(false),
@@ -82,14 +83,19 @@ public:
         return _materialName;
     }
 
+    const string::InternedString& getInternedMaterialName() const
+    {
+        return _materialName;
+    }
+
     /**
     * \brief
     * Set the material name.
     */
-    void setMaterialName(const std::string& name)
+    void setMaterialName(const string::InternedString& name)
     {
         // return, if the shader is the same as the currently used
-        if (shader_equal(_materialName, name)) return;
+        if (_materialName.iequals(name)) return;
 
         releaseShader();
 
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdlib>
-#include <memory>
+#include <cstring>
+#include <string>
 #include "Vector3.h"
 #include "SHA256.h"
 
@@ -40,22 +42,40 @@ inline std::size_t hashVector3(const Vector3& v, std::size_t significantDigits)
     return xHash;
 }
 
-// Convenience wrapper around the C-style functions in the SHA256.h header
+namespace detail
+{
+    constexpr char HexChars[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
+
+    inline std::string toHexString(const uint8_t* bytes, std::size_t numBytes)
+    {
+        std::string hexString(numBytes * 2, '\0');
+
+        for (std::size_t i = 0; i < numBytes; ++i)
+        {
+            hexString[i*2] = HexChars[(bytes[i] & 0xF0) >> 4];
+            hexString[i*2 + 1] = HexChars[bytes[i] & 0x0F];
+        }
+
+        return hexString;
+    }
+}
+
+// Convenience wrapper around the C-style functions in the SHA256.h header.
+// Use this one for checksums which are stored or compared across sessions.
 class Hash
 {
 private:
-    std::unique_ptr<SHA256_CTX> _context;
+    mutable SHA256_CTX _context;
 
 public:
-    Hash() :
-        _context(new SHA256_CTX)
+    Hash()
     {
-        sha256_init(_context.get());
+        sha256_init(&_context);
     }
 
     void addSizet(std::size_t value)
     {
-        sha256_update(_context.get(), reinterpret_cast<const uint8_t*>(&value), sizeof(value));
+        sha256_update(&_context, reinterpret_cast<const uint8_t*>(&value), sizeof(value));
     }
 
     void addDouble(double value, std::size_t significantDigits)
@@ -73,32 +93,231 @@ public:
             static_cast<std::size_t>(v.z() * detail::RoundingFactor(significantDigits)),
         };
         
-        sha256_update(_context.get(), reinterpret_cast<const uint8_t*>(&components), sizeof(components));
+        sha256_update(&_context, reinterpret_cast<const uint8_t*>(&components), sizeof(components));
     }
 
     void addString(const std::string& str)
     {
         if (str.length() == 0) return;
 
-        sha256_update(_context.get(), reinterpret_cast<const uint8_t*>(str.data()), str.length());
+        sha256_update(&_context, reinterpret_cast<const uint8_t*>(str.data()), str.length());
     }
 
     operator std::string() const
     {
         uint8_t digest[SHA256_BLOCK_SIZE];
-        sha256_final(_context.get(), digest);
+        sha256_final(&_context, digest);
 
-        constexpr char hexChars[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
+        return detail::toHexString(digest, sizeof(digest));
+    }
+};
 
-        std::string hexString(sizeof(digest) * 2, '\0');
+/**
+ * Non-cryptographic 128 bit hash with the same interface as math::Hash,
+ * for the fingerprints of scene nodes that are only compared within the
+ * running session. The data is processed using the MurmurHash3 (x64, 128 bit)
+ * algorithm, the result is the same as hashing all the added data at once.
+ * Digests of strings and raw data are the same on every platform, so these
+ * can be used as keys of files cached on disk.
+ */
+class FastHash
+{
+private:
+    uint64_t _h1;
+    uint64_t _h2;
+
+    // Data not yet processed, waiting for a complete block
+    uint8_t _block[16];
+    std::size_t _blockSize;
+
+    uint64_t _length;
+
+    static constexpr uint64_t C1 = 0x87c37b91114253d5ULL;
+    static constexpr uint64_t C2 = 0x4cf5ad432745937fULL;
+
+public:
+    FastHash() :
+        _h1(0),
+        _h2(0),
+        _blockSize(0),
+        _length(0)
+    {}
+
+    void addSizet(std::size_t value)
+    {
+        addData(&value, sizeof(value));
+    }
 
-        for (auto i = 0; i < sizeof(digest); ++i)
+    void addDouble(double value, std::size_t significantDigits)
+    {
+        auto intValue = static_cast<std::size_t>(value * detail::RoundingFactor(significantDigits));
+        addSizet(intValue);
+    }
+
+    void addVector3(const Vector3& v, std::size_t significantDigits)
+    {
+        std::size_t components[3] =
+        {
+            static_cast<std::size_t>(v.x() * detail::RoundingFactor(significantDigits)),
+            static_cast<std::size_t>(v.y() * detail::RoundingFactor(significantDigits)),
+            static_cast<std::size_t>(v.z() * detail::RoundingFactor(significantDigits)),
+        };
+
+        addData(components, sizeof(components));
+    }
+
+    void addString(const std::string& str)
+    {
+        if (str.length() == 0) return;
+
+        addData(str.data(), str.length());
+    }
+
+    void addData(const void* data, std::size_t size)
+    {
+        auto bytes = static_cast<const uint8_t*>(data);
+        _length += size;
+
+        // Complete a pending block first
+        if (_blockSize > 0)
         {
-            hexString[i*2] = hexChars[(digest[i] & 0xF0) >> 4];
-            hexString[i*2 + 1] = hexChars[digest[i] & 0x0F];
+            auto numBytes = std::min(size, sizeof(_block) - _blockSize);
+            std::memcpy(_block + _blockSize, bytes, numBytes);
+
+            _blockSize += numBytes;
+            bytes += numBytes;
+            size -= numBytes;
+
+            if (_blockSize < sizeof(_block))
+            {
+                return;
+            }
+
+            processBlock(_block);
+            _blockSize = 0;
         }
 
-        return hexString;
+        for (; size >= sizeof(_block); bytes += sizeof(_block), size -= sizeof(_block))
+        {
+            processBlock(bytes);
+        }
+
+        if (size > 0)
+        {
+            std::memcpy(_block, bytes, size);
+            _blockSize = size;
+        }
+    }
+
+    // Returns the digest as 32 hexadecimal characters
+    operator std::string() const
+    {
+        uint64_t h1, h2;
+        getDigest(h1, h2);
+
+        uint8_t digest[16];
+
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            digest[i] = static_cast<uint8_t>(h1 >> (56 - i * 8));
+            digest[i + 8] = static_cast<uint8_t>(h2 >> (56 - i * 8));
+        }
+
+        return detail::toHexString(digest, sizeof(digest));
+    }
+
+    // Returns the first 64 bits of the digest
+    uint64_t getDigest64() const
+    {
+        uint64_t h1, h2;
+        getDigest(h1, h2);
+
+        return h1;
+    }
+
+private:
+    void getDigest(uint64_t& h1, uint64_t& h2) const
+    {
+        h1 = _h1;
+        h2 = _h2;
+
+        // Process the remaining bytes
+        uint64_t k1 = 0;
+        uint64_t k2 = 0;
+
+        for (std::size_t i = _blockSize; i > 8; --i)
+        {
+            k2 ^= static_cast<uint64_t>(_block[i - 1]) << ((i - 9) * 8);
+        }
+
+        for (std::size_t i = std::min<std::size_t>(_blockSize, 8); i > 0; --i)
+        {
+            k1 ^= static_cast<uint64_t>(_block[i - 1]) << ((i - 1) * 8);
+        }
+
+        if (_blockSize > 8)
+        {
+            k2 *= C2; k2 = rotateLeft(k2, 33); k2 *= C1; h2 ^= k2;
+        }
+
+        if (_blockSize > 0)
+        {
+            k1 *= C1; k1 = rotateLeft(k1, 31); k1 *= C2; h1 ^= k1;
+        }
+
+        h1 ^= _length;
+        h2 ^= _length;
+
+        h1 += h2;
+        h2 += h1;
+
+        h1 = finalMix(h1);
+        h2 = finalMix(h2);
+
+        h1 += h2;
+        h2 += h1;
+    }
+
+    static uint64_t rotateLeft(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    static uint64_t finalMix(uint64_t k)
+    {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ULL;
+        k ^= k >> 33;
+
+        return k;
+    }
+
+    static uint64_t readLittleEndian(const uint8_t* bytes)
+    {
+        uint64_t value = 0;
+
+        for (std::size_t i = 8; i > 0; --i)
+        {
+            value = (value << 8) | bytes[i - 1];
+        }
+
+        return value;
+    }
+
+    void processBlock(const uint8_t* bytes)
+    {
+        uint64_t k1 = readLittleEndian(bytes);
+        uint64_t k2 = readLittleEndian(bytes + 8);
+
+        k1 *= C1; k1 = rotateLeft(k1, 31); k1 *= C2; _h1 ^= k1;
+
+        _h1 = rotateLeft(_h1, 27); _h1 += _h2; _h1 = _h1 * 5 + 0x52dce729;
+
+        k2 *= C2; k2 = rotateLeft(k2, 33); k2 *= C1; _h2 ^= k2;
+
+        _h2 = rotateLeft(_h2, 31); _h2 += _h1; _h2 = _h2 * 5 + 0x38495ab5;
     }
 };
 
@@ -0,0 +1,355 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <vector>
+#include "irender.h"
+#include "math/Matrix4.h"
+
+namespace render
+{
+
+/**
+ * The instances of an InstanceableRenderable submitted to a shader pass,
+ * combined into one vertex and index array to be drawn in one go.
+ *
+ * The passes eligible for merging are using the fixed-function pipeline,
+ * which can't pick the model matrix from a per-instance buffer. Instead,
+ * every instance is transformed into a slot of the combined arrays. The
+ * slots are kept by transform across updates: when the camera moves and
+ * the set of visible instances changes, only the instances which haven't
+ * been seen before need to be transformed. The draw ranges cover the slots
+ * of the current instances, adjacent slots are merged into one range.
+ */
+class InstanceBatch
+{
+public:
+    // Compact world-space vertex, carrying what the fixed-function passes need
+    struct Vertex
+    {
+        float vertex[3];
+        float normal[3];
+        float texcoord[2];
+    };
+
+    // A range of the index array to draw
+    struct Range
+    {
+        std::size_t firstIndex;
+        std::size_t numIndices;
+    };
+
+private:
+    // Orders transforms by their elements, to look up the slot of an instance
+    struct TransformLess
+    {
+        bool operator()(const Matrix4& a, const Matrix4& b) const
+        {
+            const double* first = a;
+            const double* second = b;
+
+            return std::lexicographical_compare(first, first + 16, second, second + 16);
+        }
+    };
+
+    std::size_t _geometryId;
+
+    // Number of vertices and indices of a single instance
+    std::size_t _numVertices;
+    std::size_t _numIndices;
+
+    std::vector<Vertex> _vertices;
+    std::vector<unsigned int> _indices;
+
+    // The slot of every transformed instance, and the slots available for re-use
+    std::map<Matrix4, std::size_t, TransformLess> _slots;
+    std::vector<std::size_t> _freeSlots;
+
+    // The instances and ranges drawn by the last update
+    std::size_t _numInstances;
+    std::vector<Range> _ranges;
+
+public:
+    InstanceBatch() :
+        _geometryId(0),
+        _numVertices(0),
+        _numIndices(0),
+        _numInstances(0)
+    {}
+
+    // Sets the instances to draw, returns the number of them which had to be transformed
+    std::size_t update(const InstanceableRenderable& renderable, const std::vector<Matrix4>& transforms)
+    {
+        if (_geometryId != renderable.getGeometryId())
+        {
+            // All slots are outdated, start over
+            _geometryId = renderable.getGeometryId();
+            _numVertices = renderable.getVertexArray().size();
+            _numIndices = renderable.getIndexArray().size();
+
+            _vertices.clear();
+            _indices.clear();
+            _slots.clear();
+            _freeSlots.clear();
+        }
+
+        _numInstances = transforms.size();
+        _ranges.clear();
+
+        if (_numVertices == 0 || _numIndices == 0)
+        {
+            return 0; // nothing to draw
+        }
+
+        std::vector<std::size_t> drawnSlots;
+        drawnSlots.reserve(transforms.size());
+
+        std::size_t numTransformed = 0;
+
+        for (const auto& transform : transforms)
+        {
+            auto slot = _slots.find(transform);
+
+            if (slot == _slots.end())
+            {
+                slot = _slots.emplace(transform, allocateSlot()).first;
+                transformInstance(renderable, transform, slot->second);
+                ++numTransformed;
+            }
+
+            drawnSlots.push_back(slot->second);
+        }
+
+        // Instances out of sight are kept for a while, until they outnumber the visible ones
+        if (_slots.size() > 2 * drawnSlots.size())
+        {
+            releaseUnusedSlots(drawnSlots);
+        }
+
+        updateRanges(drawnSlots);
+
+        return numTransformed;
+    }
+
+    std::size_t getNumInstances() const
+    {
+        return _numInstances;
+    }
+
+    // Number of instances currently held in the arrays, including the ones not drawn
+    std::size_t getNumSlots() const
+    {
+        return _slots.size();
+    }
+
+    const std::vector<Vertex>& getVertices() const
+    {
+        return _vertices;
+    }
+
+    const std::vector<unsigned int>& getIndices() const
+    {
+        return _indices;
+    }
+
+    const std::vector<Range>& getRanges() const
+    {
+        return _ranges;
+    }
+
+private:
+    std::size_t allocateSlot()
+    {
+        if (!_freeSlots.empty())
+        {
+            auto slot = _freeSlots.back();
+            _freeSlots.pop_back();
+            return slot;
+        }
+
+        auto slot = _vertices.size() / _numVertices;
+
+        _vertices.resize(_vertices.size() + _numVertices);
+        _indices.resize(_indices.size() + _numIndices);
+
+        return slot;
+    }
+
+    void releaseUnusedSlots(const std::vector<std::size_t>& drawnSlots)
+    {
+        std::vector<bool> isDrawn(_vertices.size() / _numVertices, false);
+
+        for (auto slot : drawnSlots)
+        {
+            isDrawn[slot] = true;
+        }
+
+        for (auto i = _slots.begin(); i != _slots.end();)
+        {
+            if (isDrawn[i->second])
+            {
+                ++i;
+                continue;
+            }
+
+            _freeSlots.push_back(i->second);
+            _slots.erase(i++);
+        }
+    }
+
+    void transformInstance(const InstanceableRenderable& renderable, const Matrix4& transform, std::size_t slot)
+    {
+        // Normals are transformed like the fixed-function pipeline does,
+        // using the inverse transpose without normalising them
+        auto normalTransform = transform.getInverse().getTransposed();
+        auto firstVertex = slot * _numVertices;
+
+        const auto& vertices = renderable.getVertexArray();
+
+        for (std::size_t i = 0; i < vertices.size(); ++i)
+        {
+            auto vertex = transform.transformPoint(Vector3(vertices[i].vertex));
+            auto normal = normalTransform.transformDirection(Vector3(vertices[i].normal));
+
+            _vertices[firstVertex + i] = Vertex
+            {
+                { static_cast<float>(vertex.x()), static_cast<float>(vertex.y()), static_cast<float>(vertex.z()) },
+                { static_cast<float>(normal.x()), static_cast<float>(normal.y()), static_cast<float>(normal.z()) },
+                { static_cast<float>(vertices[i].texcoord.x()), static_cast<float>(vertices[i].texcoord.y()) }
+            };
+        }
+
+        const auto& indices = renderable.getIndexArray();
+        auto firstIndex = slot * _numIndices;
+
+        for (std::size_t i = 0; i < indices.size(); ++i)
+        {
+            _indices[firstIndex + i] = static_cast<unsigned int>(firstVertex) + indices[i];
+        }
+    }
+
+    void updateRanges(const std::vector<std::size_t>& drawnSlots)
+    {
+        for (auto slot : drawnSlots)
+        {
+            auto firstIndex = slot * _numIndices;
+
+            if (!_ranges.empty() && _ranges.back().firstIndex + _ranges.back().numIndices == firstIndex)
+            {
+                _ranges.back().numIndices += _numIndices;
+            }
+            else
+            {
+                _ranges.push_back(Range{ firstIndex, _numIndices });
+            }
+        }
+    }
+};
+
+/**
+ * Groups the unlit instances submitted to a shader pass by renderable and
+ * by the handedness of their transform. A batch is kept for every group of
+ * at least MinInstancesPerBatch instances, across frames, and dropped once
+ * the group doesn't show up often enough anymore.
+ */
+class InstanceBatchSet
+{
+public:
+    static constexpr std::size_t MinInstancesPerBatch = 4;
+
+    // The renderable and whether the transforms are right-handed
+    using Key = std::pair<const OpenGLRenderable*, bool>;
+
+private:
+    struct Group
+    {
+        const InstanceableRenderable* renderable;
+        std::vector<Matrix4> transforms;
+    };
+
+    // The instances collected since the last update
+    std::map<Key, Group> _groups;
+
+    std::map<Key, InstanceBatch> _batches;
+
+public:
+    // Collects an instance for the next update, returns false if the renderable can't be batched
+    bool addInstance(const OpenGLRenderable& renderable, const Matrix4& transform)
+    {
+        auto instanceable = dynamic_cast<const InstanceableRenderable*>(&renderable);
+
+        if (!instanceable)
+        {
+            return false;
+        }
+
+        auto& group = _groups[Key(&renderable, isRightHanded(transform))];
+        group.renderable = instanceable;
+        group.transforms.push_back(transform);
+
+        return true;
+    }
+
+    // Updates the batches from the instances collected so far, then starts a new collection
+    void update()
+    {
+        for (auto i = _batches.begin(); i != _batches.end();)
+        {
+            auto group = _groups.find(i->first);
+
+            if (group == _groups.end() || group->second.transforms.size() < MinInstancesPerBatch)
+            {
+                _batches.erase(i++);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        for (const auto& [key, group] : _groups)
+        {
+            if (group.transforms.size() >= MinInstancesPerBatch)
+            {
+                _batches[key].update(*group.renderable, group.transforms);
+            }
+        }
+
+        _groups.clear();
+    }
+
+    // Returns true if the given instance is drawn by one of the batches of the last update
+    bool isBatched(const OpenGLRenderable& renderable, const Matrix4& transform) const
+    {
+        return !_batches.empty() && _batches.count(Key(&renderable, isRightHanded(transform))) > 0;
+    }
+
+    bool empty() const
+    {
+        return _batches.empty();
+    }
+
+    void clear()
+    {
+        _groups.clear();
+        _batches.clear();
+    }
+
+    // Visits every batch, passing the handedness of its transforms
+    void foreachBatch(const std::function<void(bool, const InstanceBatch&)>& functor) const
+    {
+        for (const auto& [key, batch] : _batches)
+        {
+            functor(key.second, batch);
+        }
+    }
+
+private:
+    static bool isRightHanded(const Matrix4& transform)
+    {
+        return transform.getHandedness() == Matrix4::RIGHTHANDED;
+    }
+};
+
+}
@@ -2,6 +2,7 @@
 
 #include "itransformnode.h"
 #include "iscenegraph.h"
+#include "imap.h"
 #include "debugging/debugging.h"
 #include "InstanceWalkers.h"
 #include "AABBAccumulateWalker.h"
@@ -23,10 +24,13 @@ Node::Node() :
 	_local2world(Matrix4::getIdentity()),
 	_instantiated(false),
 	_forceVisible(false),
+	_layerMask(0),
+	_layerManager(nullptr),
     _renderEntity(nullptr)
 {
 	// Each node is part of layer 0 by default
 	_layers.insert(0);
+	_layerMask = createLayerMask(_layers);
 }
 
 Node::Node(const Node& other) :
@@ -43,6 +47,8 @@ Node::Node(const Node& other) :
 	_instantiated(false),
 	_forceVisible(false),
 	_layers(other._layers),
+	_layerMask(other._layerMask),
+	_layerManager(nullptr),
     _renderEntity(other._renderEntity)
 {}
 
@@ -108,28 +114,33 @@ bool Node::excluded() const
 
 void Node::addToLayer(int layerId)
 {
-	_layers.insert(layerId);
+	if (_layers.count(layerId) > 0) return;
+
+	LayerList newLayers(_layers);
+	newLayers.insert(layerId);
+
+	setLayers(std::move(newLayers));
 }
 
 void Node::moveToLayer(int layerId)
 {
-	_layers.clear();
-	_layers.insert(layerId);
+	setLayers(LayerList{ layerId });
 }
 
 void Node::removeFromLayer(int layerId)
 {
 	// Look up the layer ID and remove it from the list
-	LayerList::iterator found = _layers.find(layerId);
+	if (_layers.count(layerId) == 0) return;
 
-	if (found != _layers.end()) {
-		_layers.erase(found);
+	LayerList newLayers(_layers);
+	newLayers.erase(layerId);
 
-		// greebo: Make sure that every node is at least member of layer 0
-		if (_layers.empty()) {
-			_layers.insert(0);
-		}
+	// greebo: Make sure that every node is at least member of layer 0
+	if (newLayers.empty()) {
+		newLayers.insert(0);
 	}
+
+	setLayers(std::move(newLayers));
 }
 
 const LayerList& Node::getLayers() const
@@ -137,14 +148,35 @@ const LayerList& Node::getLayers() const
 	return _layers;
 }
 
+LayerMask Node::getLayerMask() const
+{
+	return _layerMask;
+}
+
 void Node::assignToLayers(const LayerList& newLayers)
 {
 	if (!newLayers.empty())
     {
-        _layers = newLayers;
+        setLayers(LayerList(newLayers));
     }
 }
 
+void Node::setLayers(LayerList&& newLayers)
+{
+	if (newLayers == _layers) return;
+
+	LayerList previousLayers;
+	previousLayers.swap(_layers);
+
+	_layers = std::move(newLayers);
+	_layerMask = createLayerMask(_layers);
+
+	if (_layerManager != nullptr)
+	{
+		_layerManager->onNodeLayersChanged(getSelf(), previousLayers);
+	}
+}
+
 void Node::addChildNode(const INodePtr& node)
 {
 	// Add the node to the TraversableNodeSet, this triggers an
@@ -277,10 +309,19 @@ void Node::onInsertIntoScene(IMapRootNode& root)
 {
 	_instantiated = true;
     connectUndoSystem(root.getUndoSystem());
+
+	_layerManager = &root.getLayerManager();
+	_layerManager->registerNode(getSelf());
 }
 
 void Node::onRemoveFromScene(IMapRootNode& root)
 {
+	if (_layerManager != nullptr)
+	{
+		_layerManager->unregisterNode(getSelf());
+		_layerManager = nullptr;
+	}
+
     disconnectUndoSystem(root.getUndoSystem());
 	_instantiated = false;
 }
@@ -63,6 +63,13 @@ private:
 	// The list of layers this object is associated to
 	LayerList _layers;
 
+	// The same list in the form of a bitmask
+	LayerMask _layerMask;
+
+	// The layer manager of the scene this node is part of, is notified
+	// about layer assignment changes
+	ILayerManager* _layerManager;
+
 protected:
 	// If this node is attached to a parent entity, this is the reference to it
     IRenderEntity* _renderEntity;
@@ -104,6 +111,7 @@ public:
     virtual void removeFromLayer(int layerId) override;
 	virtual void moveToLayer(int layerId) override;
     virtual const LayerList& getLayers() const override;
+	virtual LayerMask getLayerMask() const override;
 	virtual void assignToLayers(const LayerList& newLayers) override;
 
 	virtual void addChildNode(const INodePtr& node) override;
@@ -217,6 +225,9 @@ private:
     void connectUndoSystem(IUndoSystem& undoSystem);
     void disconnectUndoSystem(IUndoSystem& undoSystem);
 
+	// Replaces the layer assignment, updating the mask and notifying the layer manager
+	void setLayers(LayerList&& newLayers);
+
 	void evaluateBounds() const;
 	void evaluateChildBounds() const;
 	void evaluateTransform() const;
@@ -10,6 +10,7 @@
 #include "scenelib.h"
 #include "string/string.h"
 #include "command/ExecutionNotPossible.h"
+#include "util/Parallel.h"
 #include "NodeUtils.h"
 
 namespace scene
@@ -18,10 +19,17 @@ namespace scene
 namespace merge
 {
 
+namespace
+{
+    // Below this number of entities the differences are analysed on the calling thread
+    constexpr std::size_t MinEntitiesForParallelComparison = 4;
+}
+
 ComparisonResult::Ptr GraphComparer::Compare(const IMapRootNodePtr& source, const IMapRootNodePtr& base)
 {
     auto result = std::make_shared<ComparisonResult>(source, base);
 
+    // Each collection distributes its nodes to several threads
     auto sourceEntities = NodeUtils::CollectEntityFingerprints(source);
     auto baseEntities = NodeUtils::CollectEntityFingerprints(base);
 
@@ -93,10 +101,13 @@ void GraphComparer::processDifferingEntities(ComparisonResult& result, const Ent
     std::set_difference(baseMismatches.begin(), baseMismatches.end(), sourceMismatches.begin(), sourceMismatches.end(),
         std::back_inserter(missingInSource), compareEntityNames);
 
+    // The entries of the entities present in both graphs, to be analysed in parallel
+    std::vector<ComparisonResult::EntityDifference*> modifiedEntities;
+
     for (const auto& match : matchingByName)
     {
-        auto sourceMismatch = sourceMismatches.find(match.second.entityName)->second;
-        auto baseMismatch = baseMismatches.find(match.second.entityName)->second;
+        const auto& sourceMismatch = sourceMismatches.find(match.second.entityName)->second;
+        const auto& baseMismatch = baseMismatches.find(match.second.entityName)->second;
 
         auto& entityDiff = result.differingEntities.emplace_back(ComparisonResult::EntityDifference
         {
@@ -108,12 +119,20 @@ void GraphComparer::processDifferingEntities(ComparisonResult& result, const Ent
             ComparisonResult::EntityDifference::Type::EntityPresentButDifferent
         });
 
+        modifiedEntities.push_back(&entityDiff);
+    }
+
+    // Each task fills in its own entries, the order of the result is not affected
+    util::forEachIndexInParallel(modifiedEntities.size(), MinEntitiesForParallelComparison, [&](std::size_t index)
+    {
+        auto& entityDiff = *modifiedEntities[index];
+
         // Analyse the key values
-        entityDiff.differingKeyValues = compareKeyValues(sourceMismatch.node, baseMismatch.node);
+        entityDiff.differingKeyValues = compareKeyValues(entityDiff.sourceNode, entityDiff.baseNode);
 
         // Analyse the child nodes
-        entityDiff.differingChildren = compareChildNodes(sourceMismatch.node, baseMismatch.node);
-    }
+        entityDiff.differingChildren = compareChildNodes(entityDiff.sourceNode, entityDiff.baseNode);
+    });
 
     for (const auto& mismatch : missingInSource)
     {
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <map>
+#include <vector>
+#include <functional>
 #include "inode.h"
 #include "icomparablenode.h"
 #include "ientity.h"
 #include "itextstream.h"
+#include "util/Parallel.h"
 
 namespace scene
 {
@@ -14,6 +17,9 @@ namespace merge
 
 using Fingerprints = std::map<std::string, INodePtr>;
 
+// Below this number of nodes the fingerprints are calculated on the calling thread
+constexpr std::size_t MinNodesForParallelFingerprinting = 64;
+
 class NodeUtils
 {
 public:
@@ -51,11 +57,25 @@ public:
         });
     }
 
+    // Returns the fingerprints of the given nodes (in the same order), the
+    // fingerprints of larger node sets are calculated in parallel
+    static std::vector<std::string> CalculateFingerprints(const std::vector<std::shared_ptr<IComparableNode>>& nodes)
+    {
+        std::vector<std::string> fingerprints(nodes.size());
+
+        util::forEachIndexInParallel(nodes.size(), MinNodesForParallelFingerprinting, [&](std::size_t index)
+        {
+            fingerprints[index] = nodes[index]->getFingerprint();
+        });
+
+        return fingerprints;
+    }
+
 private:
     static Fingerprints CollectNodeFingerprints(const INodePtr& parent,
         const std::function<bool(const INodePtr& node)>& nodePredicate)
     {
-        Fingerprints result;
+        std::vector<std::shared_ptr<IComparableNode>> nodes;
 
         parent->foreachNode([&](const INodePtr& node)
         {
@@ -66,16 +86,24 @@ private:
 
             if (!comparable) return true; // skip
 
+            nodes.emplace_back(std::move(comparable));
+            return true;
+        });
+
+        auto fingerprints = CalculateFingerprints(nodes);
+
+        Fingerprints result;
+
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+        {
             // Store the fingerprint and check for collisions
-            auto insertResult = result.try_emplace(comparable->getFingerprint(), node);
+            auto insertResult = result.try_emplace(std::move(fingerprints[i]), nodes[i]);
 
             if (!insertResult.second)
             {
                 rWarning() << "More than one node with the same fingerprint found in the parent node with name " << parent->name() << std::endl;
             }
-
-            return true;
-        });
+        }
 
         return result;
     }
@@ -50,7 +50,7 @@ protected:
             memberFingerprints.emplace(NodeUtils::GetGroupMemberFingerprint(member));
         });
 
-        math::Hash hash;
+        math::FastHash hash;
 
         for (const auto& fingerprint : memberFingerprints)
         {
@@ -25,6 +25,9 @@ struct ThreeWayMergeOperation::ComparisonData
 
     ComparisonData(const IMapRootNodePtr& baseRoot, const IMapRootNodePtr& sourceRoot, const IMapRootNodePtr& targetRoot)
     {
+        // The comparisons run one after the other, each of them is distributing
+        // its work to several threads, running them side by side would only
+        // oversubscribe the processor
         baseToSource = GraphComparer::Compare(sourceRoot, baseRoot);
         baseToTarget = GraphComparer::Compare(targetRoot, baseRoot);
 
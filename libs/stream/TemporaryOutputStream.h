@@ -1,8 +1,12 @@
 #pragma once
 
 #include "i18n.h"
+#include <atomic>
+#include <functional>
 #include <string>
 #include <fstream>
+#include <thread>
+#include <vector>
 #include "os/fs.h"
 #include "fmt/format.h"
 
@@ -11,6 +15,8 @@ namespace stream
 
 // An output stream wrapper which opens a temporary file next to the actual target,
 // moving the temporary file over the target file on demand.
+// Every instance is using its own temporary file, such that several threads can
+// write the same target without interfering, the last one replacing the target wins.
 // If something goes wrong, a std::runtime_error is thrown.
 class TemporaryOutputStream
 {
@@ -21,10 +27,10 @@ private:
     std::ofstream _stream;
 
 public:
-    TemporaryOutputStream(const fs::path& targetFile) :
+    TemporaryOutputStream(const fs::path& targetFile, std::ios::openmode mode = std::ios::out) :
         _targetFile(targetFile),
         _temporaryPath(getTemporaryPath(_targetFile)),
-        _stream(_temporaryPath)
+        _stream(_temporaryPath, mode | std::ios::out)
     {
         if (!_stream.is_open())
         {
@@ -95,13 +101,36 @@ public:
         }
     }
 
+    // Writes the given data to the target file, by means of a temporary file, such that
+    // no half-written target can be picked up by anyone, even if several threads are
+    // writing it. Missing parent folders are created. Throws std::runtime_error on failure.
+    static void WriteFile(const fs::path& targetFile, const std::vector<char>& data)
+    {
+        if (targetFile.has_parent_path())
+        {
+            fs::create_directories(targetFile.parent_path());
+        }
+
+        TemporaryOutputStream tempStream(targetFile, std::ios::binary);
+
+        if (!tempStream.getStream().write(data.data(), data.size()))
+        {
+            throw std::runtime_error(fmt::format(_("Failed to write file {0}"), targetFile.string()));
+        }
+
+        tempStream.closeAndReplaceTargetFile();
+    }
+
 private:
     static fs::path getTemporaryPath(const fs::path& targetFile)
     {
+        static std::atomic<std::size_t> counter(0);
+
         fs::path tempFile = targetFile;
 
         tempFile.remove_filename();
-        tempFile /= "_" + targetFile.filename().string();
+        tempFile /= fmt::format("_{0}.{1:x}.{2}", targetFile.filename().string(),
+            std::hash<std::thread::id>()(std::this_thread::get_id()), counter++);
 
         return tempFile;
     }
@@ -4,8 +4,12 @@
 #include <cstdint>
 
 #include "idatastream.h"
+#include <istream>
+#include <limits>
 #include <ostream>
 #include <algorithm>
+#include <string>
+#include <vector>
 
 namespace stream
 {
@@ -72,4 +76,121 @@ inline InputStream::byte_type readByte(InputStream& stream)
 	return value;
 }
 
+namespace detail
+{
+
+// Returns false if the (seekable) stream holds less than the given number of
+// bytes, to not trust sizes read from a corrupt file before allocating memory
+inline bool hasRemainingData(std::istream& stream, std::size_t size)
+{
+	auto position = stream.tellg();
+
+	if (position == std::istream::pos_type(-1))
+	{
+		return true; // not seekable, the read will fail
+	}
+
+	stream.seekg(0, std::ios_base::end);
+	auto end = stream.tellg();
+	stream.seekg(position);
+
+	if (static_cast<std::size_t>(end - position) < size)
+	{
+		stream.setstate(std::ios_base::failbit);
+		return false;
+	}
+
+	return true;
+}
+
+}
+
+/**
+ * Read an integer type stored in little endian format from the given
+ * std::istream. Returns false if the stream ran out of data.
+ */
+template<typename ValueType>
+inline bool readLittleEndian(std::istream& stream, ValueType& value)
+{
+	stream.read(reinterpret_cast<char*>(&value), sizeof(ValueType));
+
+#ifdef __BIG_ENDIAN__
+	std::reverse(reinterpret_cast<char*>(&value), reinterpret_cast<char*>(&value) + sizeof(ValueType));
+#endif
+
+	return !stream.fail();
+}
+
+/**
+ * Writes the given array of numbers in Little Endian byte order with a single
+ * write operation (on little endian platforms). The size is not written.
+ */
+template<typename ValueType>
+void writeLittleEndianArray(std::ostream& stream, const std::vector<ValueType>& values)
+{
+#ifdef __BIG_ENDIAN__
+	for (auto value : values)
+	{
+		writeLittleEndian(stream, value);
+	}
+#else
+	stream.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(ValueType));
+#endif
+}
+
+/**
+ * Reads the given number of values written by writeLittleEndianArray()
+ * into the given vector. Returns false if the stream ran out of data.
+ */
+template<typename ValueType>
+inline bool readLittleEndianArray(std::istream& stream, std::vector<ValueType>& values, std::size_t count)
+{
+	if (count > std::numeric_limits<std::size_t>::max() / sizeof(ValueType) ||
+		!detail::hasRemainingData(stream, count * sizeof(ValueType)))
+	{
+		return false;
+	}
+
+	values.resize(count);
+	stream.read(reinterpret_cast<char*>(values.data()), count * sizeof(ValueType));
+
+#ifdef __BIG_ENDIAN__
+	for (auto& value : values)
+	{
+		std::reverse(reinterpret_cast<char*>(&value), reinterpret_cast<char*>(&value) + sizeof(ValueType));
+	}
+#endif
+
+	return !stream.fail();
+}
+
+/**
+ * Writes the given string to the stream, preceded by its length
+ * as 32 bit Little Endian number.
+ */
+inline void writeLengthPrefixedString(std::ostream& stream, const std::string& str)
+{
+	writeLittleEndian<std::uint32_t>(stream, static_cast<std::uint32_t>(str.size()));
+	stream.write(str.data(), str.size());
+}
+
+/**
+ * Reads a string written by writeLengthPrefixedString().
+ * Returns false if the stream ran out of data.
+ */
+inline bool readLengthPrefixedString(std::istream& stream, std::string& str)
+{
+	std::uint32_t length = 0;
+
+	if (!readLittleEndian(stream, length) || !detail::hasRemainingData(stream, length))
+	{
+		return false;
+	}
+
+	str.resize(length);
+	stream.read(&str[0], length);
+
+	return !stream.fail();
+}
+
 }
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <cctype>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+namespace string
+{
+
+/**
+ * Handle to a string stored in a global pool. Each distinct string is
+ * stored exactly once, copying a handle is copying a pointer, and two handles
+ * are compared by comparing their pointers. This is meant for the names being
+ * repeated many thousand times in a map, like material names and spawnarg keys.
+ *
+ * Interning is thread-safe, the strings are never released again. Each binary
+ * module has its own pool, handles of different modules are compared by value.
+ *
+ * Every string knows its lower case variant (which is interned as well), so
+ * case-insensitive comparisons are pointer comparisons too.
+ */
+class InternedString
+{
+private:
+    struct Pool;
+
+    struct Entry
+    {
+        std::string value;
+
+        // The interned lower case variant of this string, points to itself if
+        // the string is lower case already
+        const Entry* lowerCase;
+
+        // The pool this entry belongs to
+        const Pool* pool;
+    };
+
+    struct Pool
+    {
+        std::mutex lock;
+        std::unordered_map<std::string, std::unique_ptr<Entry>> entries;
+
+        const Entry* empty;
+
+        Pool()
+        {
+            empty = intern(std::string());
+        }
+
+        // Requires the lock to be held
+        const Entry* intern(const std::string& str)
+        {
+            auto existing = entries.find(str);
+
+            if (existing != entries.end())
+            {
+                return existing->second.get();
+            }
+
+            std::string lowerCaseString(str);
+
+            for (auto& c : lowerCaseString)
+            {
+                c = static_cast<char>(::tolower(static_cast<unsigned char>(c)));
+            }
+
+            const Entry* lowerCase = lowerCaseString != str ? intern(lowerCaseString) : nullptr;
+
+            auto& entry = entries[str];
+            entry.reset(new Entry{ str, lowerCase, this });
+
+            if (!lowerCase)
+            {
+                entry->lowerCase = entry.get();
+            }
+
+            return entry.get();
+        }
+    };
+
+    const Entry* _entry;
+
+    static Pool& GetPool()
+    {
+        // Never destroyed, handles held by other static objects stay valid
+        static Pool* _pool = new Pool;
+        return *_pool;
+    }
+
+    explicit InternedString(const Entry* entry) :
+        _entry(entry)
+    {}
+
+public:
+    // Constructs the empty string
+    InternedString() :
+        _entry(GetPool().empty)
+    {}
+
+    InternedString(const std::string& str) :
+        _entry(Intern(str))
+    {}
+
+    InternedString(const char* str) :
+        _entry(Intern(str))
+    {}
+
+    const std::string& str() const
+    {
+        return _entry->value;
+    }
+
+    operator const std::string&() const
+    {
+        return _entry->value;
+    }
+
+    const char* c_str() const
+    {
+        return _entry->value.c_str();
+    }
+
+    bool empty() const
+    {
+        return _entry->value.empty();
+    }
+
+    std::size_t size() const
+    {
+        return _entry->value.size();
+    }
+
+    // The interned lower case variant of this string
+    InternedString toLowerCase() const
+    {
+        return InternedString(_entry->lowerCase);
+    }
+
+    // Case-insensitive comparison
+    bool iequals(const InternedString& other) const
+    {
+        return _entry->lowerCase == other._entry->lowerCase ||
+            (_entry->pool != other._entry->pool && _entry->lowerCase->value == other._entry->lowerCase->value);
+    }
+
+    bool operator==(const InternedString& other) const
+    {
+        // Strings created by another binary module are living in a different pool
+        return _entry == other._entry ||
+            (_entry->pool != other._entry->pool && _entry->value == other._entry->value);
+    }
+
+    bool operator!=(const InternedString& other) const
+    {
+        return !operator==(other);
+    }
+
+    bool operator==(const std::string& other) const
+    {
+        return _entry->value == other;
+    }
+
+    bool operator!=(const std::string& other) const
+    {
+        return _entry->value != other;
+    }
+
+    bool operator==(const char* other) const
+    {
+        return _entry->value == other;
+    }
+
+    bool operator!=(const char* other) const
+    {
+        return _entry->value != other;
+    }
+
+    bool operator<(const InternedString& other) const
+    {
+        return _entry != other._entry && _entry->value < other._entry->value;
+    }
+
+    // The hash of the string value, this is the same for all pools
+    std::size_t hash() const
+    {
+        return std::hash<std::string>()(_entry->value);
+    }
+
+    // Returns the number of distinct strings interned in this binary module
+    static std::size_t GetPoolSize()
+    {
+        auto& pool = GetPool();
+        std::lock_guard<std::mutex> lock(pool.lock);
+
+        return pool.entries.size();
+    }
+
+private:
+    static const Entry* Intern(const std::string& str)
+    {
+        auto& pool = GetPool();
+        std::lock_guard<std::mutex> lock(pool.lock);
+
+        return pool.intern(str);
+    }
+};
+
+inline bool operator==(const std::string& str, const InternedString& interned)
+{
+    return interned == str;
+}
+
+inline bool operator!=(const std::string& str, const InternedString& interned)
+{
+    return interned != str;
+}
+
+inline std::ostream& operator<<(std::ostream& stream, const InternedString& str)
+{
+    return stream << str.str();
+}
+
+}
+
+namespace std
+{
+
+template<>
+struct hash<::string::InternedString>
+{
+    std::size_t operator()(const ::string::InternedString& str) const
+    {
+        return str.hash();
+    }
+};
+
+}
@@ -3,7 +3,10 @@
 /// \file
 /// C-style null-terminated-character-array string library.
 
+#include <cctype>
+#include <cstdint>
 #include <cstring>
+#include <string>
 
 namespace string
 {
@@ -30,6 +33,33 @@ struct ILess
     }
 };
 
+/// Case-insensitive equality functor for use with unordered containers
+struct IEquals
+{
+    bool operator() (const std::string& lhs, const std::string& rhs) const
+    {
+        return lhs.size() == rhs.size() && icmp(lhs.c_str(), rhs.c_str()) == 0;
+    }
+};
+
+/// Case-insensitive hash functor for use with unordered containers,
+/// strings differing in case only produce the same hash (FNV-1a)
+struct IHash
+{
+    std::size_t operator() (const std::string& str) const
+    {
+        std::uint64_t hash = 14695981039346656037ULL;
+
+        for (auto c : str)
+        {
+            hash ^= static_cast<std::uint64_t>(::tolower(static_cast<unsigned char>(c)));
+            hash *= 1099511628211ULL;
+        }
+
+        return static_cast<std::size_t>(hash);
+    }
+};
+
 }
 
 /// \brief Returns true if [\p string, \p string + \p n) is lexicographically equal to [\p other, \p other + \p n).
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <thread>
+#include <vector>
+#include "ScopedBoolLock.h"
+
+namespace util
+{
+
+namespace detail
+{
+
+// True on the threads running the chunks of a parallel section
+inline bool& isParallelWorker()
+{
+    static thread_local bool isParallelWorker = false;
+    return isParallelWorker;
+}
+
+}
+
+/**
+ * Splits the range [0..count) into one chunk per hardware thread and invokes
+ * the function for each chunk [start..end), distributing the calls to several
+ * threads. Ranges smaller than minCountForParallel are passed in one piece
+ * on the calling thread, as are the calls made from one of the worker threads:
+ * nested parallel sections don't multiply the thread count.
+ * Any exception thrown by the function is propagated to the caller.
+ */
+inline void forEachChunkInParallel(std::size_t count, std::size_t minCountForParallel,
+    const std::function<void(std::size_t start, std::size_t end)>& func)
+{
+    if (count == 0) return;
+
+    if (count < minCountForParallel || detail::isParallelWorker())
+    {
+        func(0, count);
+        return;
+    }
+
+    auto numTasks = std::max(std::thread::hardware_concurrency(), 1u);
+    auto chunkSize = (count + numTasks - 1) / numTasks;
+
+    std::vector<std::future<void>> tasks;
+
+    for (std::size_t start = 0; start < count; start += chunkSize)
+    {
+        auto end = std::min(start + chunkSize, count);
+
+        tasks.emplace_back(std::async(std::launch::async, [&func, start, end]()
+        {
+            // The thread might be a pooled one, the lock restores its flag when done
+            ScopedBoolLock workerLock(detail::isParallelWorker());
+
+            func(start, end);
+        }));
+    }
+
+    // Wait for all chunks, this will propagate any exceptions
+    for (auto& task : tasks)
+    {
+        task.get();
+    }
+}
+
+/**
+ * Invokes the function for each index in [0..count), distributing the calls
+ * to several threads. See forEachChunkInParallel for the details.
+ */
+inline void forEachIndexInParallel(std::size_t count, std::size_t minCountForParallel,
+    const std::function<void(std::size_t)>& func)
+{
+    forEachChunkInParallel(count, minCountForParallel, [&func](std::size_t start, std::size_t end)
+    {
+        for (auto i = start; i < end; ++i)
+        {
+            func(i);
+        }
+    });
+}
+
+}
@@ -8,6 +8,7 @@
 #include "itextstream.h"
 #include "iorthoview.h"
 #include "icameraview.h"
+#include "iparticles.h"
 
 #include <time.h>
 #include <fmt/format.h>
@@ -684,6 +685,7 @@ void CamWnd::Cam_Draw()
 
     // Reset statistics for this frame
     _renderStats.resetStats();
+    GlobalParticlesManager().resetEmitterStatistics();
 
     _view.resetCullStats();
 
@@ -791,6 +793,10 @@ void CamWnd::Cam_Draw()
         // Accumulate render statistics
         _renderStats.setLightCount(renderer.getVisibleLights(),
                                    renderer.getTotalLights());
+
+        auto particleStats = GlobalParticlesManager().getEmitterStatistics();
+        _renderStats.setParticleEmitters(particleStats.active, particleStats.skipped);
+
         _renderStats.frontEndComplete();
 
         // Render any active mousetools
@@ -805,6 +811,9 @@ void CamWnd::Cam_Draw()
         );
         GlobalRenderSystem().render(allowedRenderFlags, _camera->getModelView(),
                                     _camera->getProjection(), _view.getViewer());
+
+        const auto& backendStats = GlobalRenderSystem().getStatistics();
+        _renderStats.setDrawCalls(backendStats.drawCalls, backendStats.batchedInstances);
     }
 
     // greebo: Draw the clipper's points (skipping the depth-test)
@@ -1,6 +1,7 @@
 #include "CameraWndManager.h"
 
 #include "imousetoolmanager.h"
+#include "iparticles.h"
 #include "iselection.h"
 #include "itextstream.h"
 #include "xmlutil/Node.h"
@@ -452,6 +453,7 @@ const StringSet& CameraWndManager::getDependencies() const
         MODULE_RENDERSYSTEM,
         MODULE_COMMANDSYSTEM,
         MODULE_MOUSETOOLMANAGER,
+        MODULE_PARTICLESMANAGER,
     };
 
 	return _dependencies;
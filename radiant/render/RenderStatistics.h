@@ -19,6 +19,14 @@ class RenderStatistics
     int _visibleLights = 0;
     int _totalLights = 0;
 
+    // Draw calls issued by the render backend
+    std::size_t _drawCalls = 0;
+    std::size_t _batchedInstances = 0;
+
+    // Particle emitters simulated in this frame, and those culled or sharing a simulation
+    std::size_t _activeEmitters = 0;
+    std::size_t _skippedEmitters = 0;
+
 public:
 
     /// Return the constructed string for display
@@ -30,6 +38,10 @@ public:
 
         return "lights: " + std::to_string(_visibleLights)
              + " / " + std::to_string(_totalLights)
+             + " | draws: " + std::to_string(_drawCalls)
+             + " (" + std::to_string(_batchedInstances) + " batched)"
+             + " | particles: " + std::to_string(_activeEmitters)
+             + " (" + std::to_string(_skippedEmitters) + " skipped)"
              + " | f/e: " + std::to_string(_feTime) + " ms"
              + " | b/e: " + std::to_string(beTime) + " ms"
              + " | tot: " + std::to_string(totTime) + " ms"
@@ -49,10 +61,26 @@ public:
         _totalLights += total;
     }
 
+    /// Set the draw call count, along with the number of objects drawn in batches
+    void setDrawCalls(std::size_t drawCalls, std::size_t batchedInstances)
+    {
+        _drawCalls = drawCalls;
+        _batchedInstances = batchedInstances;
+    }
+
+    /// Set the number of simulated and skipped particle emitters
+    void setParticleEmitters(std::size_t active, std::size_t skipped)
+    {
+        _activeEmitters = active;
+        _skippedEmitters = skipped;
+    }
+
     /// Reset statistics at the beginning of a frame render
     void resetStats()
     {
         _visibleLights = _totalLights = 0;
+        _drawCalls = _batchedInstances = 0;
+        _activeEmitters = _skippedEmitters = 0;
 
         _feTime = 0;
         _timer.Start();
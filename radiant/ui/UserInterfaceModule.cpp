@@ -215,6 +215,7 @@ void UserInterfaceModule::initialiseModule(const IApplicationContext& ctx)
 	_editStopwatchStatus.reset(new statusbar::EditingStopwatchStatus);
     _commandStatus.reset(new statusbar::CommandStatus);
     _mapStatisticsStatus.reset(new statusbar::MapStatistics);
+    _undoMemoryStatus.reset(new statusbar::UndoMemoryStatus);
 	_manipulatorToggle.reset(new ManipulatorToggle);
     _textureToolModeToggles.reset(new TexToolModeToggles);
 	_selectionModeToggle.reset(new SelectionModeToggle);
@@ -260,6 +261,7 @@ void UserInterfaceModule::shutdownModule()
 	_autoSaveRequestHandler.reset();
 	_shaderClipboardStatus.reset();
     _mapStatisticsStatus.reset();
+    _undoMemoryStatus.reset();
 	_editStopwatchStatus.reset();
 	_commandStatus.reset();
 	_manipulatorToggle.reset();
@@ -19,6 +19,7 @@
 #include "statusbar/EditingStopwatchStatus.h"
 #include "statusbar/CommandStatus.h"
 #include "statusbar/MapStatistics.h"
+#include "statusbar/UndoMemoryStatus.h"
 #include "messages/CommandExecutionFailed.h"
 #include "messages/TextureChanged.h"
 #include "messages/NotificationMessage.h"
@@ -52,6 +53,7 @@ private:
 	std::unique_ptr<statusbar::EditingStopwatchStatus> _editStopwatchStatus;
 	std::unique_ptr<statusbar::CommandStatus> _commandStatus;
 	std::unique_ptr<statusbar::MapStatistics> _mapStatisticsStatus;
+	std::unique_ptr<statusbar::UndoMemoryStatus> _undoMemoryStatus;
 	std::unique_ptr<ManipulatorToggle> _manipulatorToggle;
 	std::unique_ptr<SelectionModeToggle> _selectionModeToggle;
 	std::unique_ptr<TexToolModeToggles> _textureToolModeToggles;
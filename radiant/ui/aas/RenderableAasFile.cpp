@@ -44,15 +44,21 @@ void RenderableAasFile::renderSolid(RenderableCollector& collector, const Volume
 	Matrix4 invModelView = volume.GetModelview().getFullInverse();
 	Vector3 viewPos = invModelView.tCol().getProjected();
 
-	for (const RenderableSolidAABB& aabb : _renderableAabbs)
+	_visibleAreas.clear();
+
+	// Only the areas in the view volume are submitted
+	_aasFile->forEachAreaInVolume(volume, [&](int areaNum)
 	{
+		const RenderableSolidAABB& aabb = _renderableAabbs[areaNum];
+
 		if (_hideDistantAreas && (aabb.getAABB().getOrigin() - viewPos).getLengthSquared() > _hideDistanceSquared)
 		{
-			continue;
+			return;
 		}
 
+		_visibleAreas.push_back(areaNum);
 		collector.addRenderable(*_normalShader, aabb, Matrix4::getIdentity());
-	}
+	});
 
 	if (_renderNumbers)
 	{
@@ -80,15 +86,10 @@ void RenderableAasFile::setAasFile(const IAasFilePtr& aasFile)
 void RenderableAasFile::render(const RenderInfo& info) const
 {
 	// draw label
-	// Render the area numbers
-	for (std::size_t areaNum = 0; areaNum < _aasFile->getNumAreas(); ++areaNum)
+	// Render the area numbers of the areas submitted by renderSolid()
+	for (int areaNum : _visibleAreas)
 	{
-		const IAasFile::Area& area = _aasFile->getArea(static_cast<int>(areaNum));
-
-		if (_hideDistantAreas && (area.center - info.getViewerLocation()).getLengthSquared() > _hideDistanceSquared)
-		{
-			continue;
-		}
+		const IAasFile::Area& area = _aasFile->getArea(areaNum);
 
 		glRasterPos3dv(area.center);
 		GlobalOpenGL().drawString(string::to_string(areaNum));
@@ -107,6 +108,7 @@ void RenderableAasFile::prepare()
 void RenderableAasFile::constructRenderables()
 {
 	_renderableAabbs.clear();
+	_renderableAabbs.reserve(_aasFile->getNumAreas());
 
 	for (std::size_t areaNum = 0; areaNum < _aasFile->getNumAreas(); ++areaNum)
 	{
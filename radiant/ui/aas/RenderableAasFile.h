@@ -1,6 +1,6 @@
 #pragma once
 
-#include <list>
+#include <vector>
 #include <sigc++/trackable.h>
 
 #include "irenderable.h"
@@ -30,7 +30,11 @@ private:
 
 	ShaderPtr _normalShader;
 
-    std::list<RenderableSolidAABB> _renderableAabbs;
+    // One renderable per area, indexed by area number
+    std::vector<RenderableSolidAABB> _renderableAabbs;
+
+    // The areas submitted in the last renderSolid() call, their numbers are drawn in render()
+    mutable std::vector<int> _visibleAreas;
 
 	bool _renderNumbers;
 	bool _hideDistantAreas;
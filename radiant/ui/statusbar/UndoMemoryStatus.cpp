@@ -0,0 +1,77 @@
+#include "UndoMemoryStatus.h"
+
+#include "i18n.h"
+#include "iundo.h"
+#include "iradiant.h"
+#include "ui/istatusbarmanager.h"
+#include "os/filesize.h"
+
+namespace ui
+{
+
+namespace statusbar
+{
+
+namespace
+{
+    const char* const STATUS_BAR_ELEMENT = "UndoMemory";
+}
+
+UndoMemoryStatus::UndoMemoryStatus()
+{
+    // Operation messages are sent for every recorded, undone and redone operation
+    _mapOperationListener = GlobalRadiantCore().getMessageBus().addListener(
+        radiant::IMessage::MapOperationFinished,
+        radiant::TypeListener<map::OperationMessage>(
+            sigc::mem_fun(this, &UndoMemoryStatus::onMapOperationFinished)));
+
+    _mapEventConn = GlobalMapModule().signal_mapEvent().connect(
+        sigc::mem_fun(this, &UndoMemoryStatus::onMapEvent)
+    );
+
+    GlobalStatusBarManager().addTextElement(STATUS_BAR_ELEMENT, "",
+        StandardPosition::UndoMemory, _("Approximate memory used by the undo history"));
+
+    requestIdleCallback();
+}
+
+UndoMemoryStatus::~UndoMemoryStatus()
+{
+    _mapEventConn.disconnect();
+    GlobalRadiantCore().getMessageBus().removeListener(_mapOperationListener);
+}
+
+void UndoMemoryStatus::onIdle()
+{
+    updateStatusBar();
+}
+
+void UndoMemoryStatus::onMapOperationFinished(map::OperationMessage& message)
+{
+    requestIdleCallback();
+}
+
+void UndoMemoryStatus::onMapEvent(IMap::MapEvent ev)
+{
+    if (ev == IMap::MapLoaded || ev == IMap::MapUnloaded)
+    {
+        requestIdleCallback();
+    }
+}
+
+void UndoMemoryStatus::updateStatusBar()
+{
+    std::size_t memoryUsage = 0;
+
+    if (GlobalMapModule().getRoot())
+    {
+        memoryUsage = GlobalMapModule().getUndoSystem().getMemoryUsage();
+    }
+
+    GlobalStatusBarManager().setText(STATUS_BAR_ELEMENT,
+        fmt::format(_("Undo: {0}"), os::getFormattedFileSize(memoryUsage)));
+}
+
+}
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <sigc++/connection.h>
+#include "imap.h"
+#include "wxutil/event/SingleIdleCallback.h"
+#include "messages/MapOperationMessage.h"
+
+namespace ui
+{
+
+namespace statusbar
+{
+
+// Class displaying the approximate memory occupied by the map's undo history
+class UndoMemoryStatus final :
+    private wxutil::SingleIdleCallback
+{
+private:
+    std::size_t _mapOperationListener;
+    sigc::connection _mapEventConn;
+
+public:
+    UndoMemoryStatus();
+
+    ~UndoMemoryStatus();
+
+protected:
+    void onIdle() override;
+
+private:
+    void onMapOperationFinished(map::OperationMessage& message);
+    void onMapEvent(IMap::MapEvent ev);
+    void updateStatusBar();
+};
+
+}
+
+}
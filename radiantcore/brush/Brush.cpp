@@ -4,6 +4,7 @@
 #include "irenderable.h"
 #include "itextstream.h"
 #include "shaderlib.h"
+#include "string/predicate.h"
 
 #include "BrushModule.h"
 #include "BrushNode.h"
@@ -171,11 +172,24 @@ void Brush::setShader(const std::string& newShader) {
 }
 
 bool Brush::hasShader(const std::string& name) {
+    // Don't intern the name, this would lock the pool and keep any
+    // searched name around. Faces sharing a material share the same
+    // interned string, so each distinct material is compared only once.
+    const std::string* lastMismatch = nullptr;
+
     // Traverse the faces
     for (Faces::const_iterator i = m_faces.begin(); i != m_faces.end(); ++i) {
-        if (shader_equal((*i)->getShader(), name)) {
+        const auto& materialName = (*i)->getFaceShader().getMaterialName();
+
+        if (&materialName == lastMismatch) {
+            continue;
+        }
+
+        if (string::iequals(materialName, name)) {
             return true;
         }
+
+        lastMismatch = &materialName;
     }
 
     // not found
@@ -341,7 +355,11 @@ void Brush::undoSave()
 
 IUndoMementoPtr Brush::exportState() const
 {
-    return IUndoMementoPtr(new BrushUndoMemento(m_faces, _detailFlag));
+    auto memento = std::make_shared<BrushUndoMemento>(m_faces, _detailFlag,
+        std::static_pointer_cast<BrushUndoMemento>(_lastSavedState.lock()));
+    _lastSavedState = memento;
+
+    return memento;
 }
 
 void Brush::importState(const IUndoMementoPtr& state)
@@ -351,7 +369,7 @@ void Brush::importState(const IUndoMementoPtr& state)
 	BrushUndoMemento& memento = *std::static_pointer_cast<BrushUndoMemento>(state);
 
 	_detailFlag = memento._detailFlag;
-    appendFaces(memento._faces);
+    appendFaces(*memento._faces);
 
     onFacePlaneChanged();
 
@@ -6,6 +6,7 @@
 #include "SelectableComponents.h"
 #include "RenderableWireFrame.h"
 #include "Translatable.h"
+#include "BasicUndoMemento.h"
 
 #include <sigc++/signal.h>
 #include "util/Noncopyable.h"
@@ -125,20 +126,29 @@ private:
 
 	DetailFlag _detailFlag;
 
+	// The most recently exported undo memento, used as reference for the next one
+	mutable std::weak_ptr<IUndoMemento> _lastSavedState;
+
 public:
 	/// \brief The undo memento for a brush stores only the list of face references - the faces are not copied.
+	/// The list itself is shared with the previously exported memento if the set of faces didn't change.
 	class BrushUndoMemento :
 		public IUndoMemento
 	{
 	public:
-		BrushUndoMemento(const Faces& faces, DetailFlag detailFlag) :
-			_faces(faces),
+		BrushUndoMemento(const Faces& faces, DetailFlag detailFlag, const std::shared_ptr<BrushUndoMemento>& previous) :
+			_faces(previous && *previous->_faces == faces ? previous->_faces : std::make_shared<const Faces>(faces)),
 			_detailFlag(detailFlag)
 		{}
 
 		virtual ~BrushUndoMemento() {}
 
-		Faces _faces;
+		std::size_t getApproximateSize() const override
+		{
+			return sizeof(*this) + undo::getSharedSize(_faces, sizeof(Faces) + undo::getHeapSize(*_faces));
+		}
+
+		std::shared_ptr<const Faces> _faces;
 		DetailFlag _detailFlag;
 	};
 
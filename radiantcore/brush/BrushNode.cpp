@@ -73,7 +73,7 @@ std::string BrushNode::getFingerprint()
         return std::string(); // empty brushes produce an empty fingerprint
     }
 
-    math::Hash hash;
+    math::FastHash hash;
 
     hash.addSizet(static_cast<std::size_t>(m_brush.getDetailFlag() + 1));
 
@@ -8,6 +8,7 @@
 #include "math/Matrix3.h"
 #include "shaderlib.h"
 #include "texturelib.h"
+#include "BasicUndoMemento.h"
 #include "Winding.h"
 #include "selection/algorithm/Texturing.h"
 
@@ -15,20 +16,36 @@
 #include "BrushNode.h"
 #include "BrushModule.h"
 
-// The structure that is saved in the undostack
+// The structure that is saved in the undostack.
+// The texture projection is shared with the previously exported state
+// of the same face if it didn't change in between, which is the case for
+// most transform operations. The material name is interned anyway.
 class Face::SavedState final :
     public IUndoMemento
 {
 public:
     FacePlane::SavedState _planeState;
-    TextureProjection _texdefState;
-    std::string _materialName;
+    std::shared_ptr<const TextureProjection> _texdefState;
+    string::InternedString _materialName;
 
-    SavedState(const Face& face) :
+    SavedState(const Face& face, const std::shared_ptr<SavedState>& previous) :
         _planeState(face.getPlane()),
-        _texdefState(face.getProjection()),
-        _materialName(face.getShader())
-    {}
+        _materialName(face.getFaceShader().getInternedMaterialName())
+    {
+        if (previous && *previous->_texdefState == face.getProjection())
+        {
+            _texdefState = previous->_texdefState;
+        }
+        else
+        {
+            _texdefState = std::make_shared<TextureProjection>(face.getProjection());
+        }
+    }
+
+    std::size_t getApproximateSize() const override
+    {
+        return sizeof(*this) + undo::getSharedSize(_texdefState, sizeof(TextureProjection));
+    }
 };
 
 Face::Face(Brush& owner) :
@@ -98,7 +115,7 @@ Face::Face(Brush& owner, const Face& other) :
     IUndoable(other),
     _owner(owner),
     m_plane(other.m_plane),
-    _shader(other._shader.getMaterialName(), _owner.getBrushNode().getRenderSystem()),
+    _shader(other._shader.getInternedMaterialName(), _owner.getBrushNode().getRenderSystem()),
     _texdef(other.getProjection()),
     _undoStateSaver(nullptr),
     _faceIsVisible(other._faceIsVisible)
@@ -182,7 +199,10 @@ void Face::undoSave()
 // undoable
 IUndoMementoPtr Face::exportState() const
 {
-    return std::make_shared<SavedState>(*this);
+    auto state = std::make_shared<SavedState>(*this, _lastSavedState.lock());
+    _lastSavedState = state;
+
+    return state;
 }
 
 void Face::importState(const IUndoMementoPtr& data)
@@ -193,7 +213,7 @@ void Face::importState(const IUndoMementoPtr& data)
 
     state->_planeState.exportState(getPlane());
     setShader(state->_materialName);
-    _texdef = state->_texdefState;
+    _texdef = *state->_texdefState;
 
     planeChanged();
     _owner.onFaceConnectivityChanged();
@@ -57,6 +57,9 @@ private:
 
 	IUndoStateSaver* _undoStateSaver;
 
+	// The most recently exported undo state, used as reference for the next one
+	mutable std::weak_ptr<SavedState> _lastSavedState;
+
 	// Cached visibility flag, queried during front end rendering
 	bool _faceIsVisible;
 
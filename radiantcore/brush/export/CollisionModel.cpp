@@ -1,5 +1,8 @@
 #include "CollisionModel.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "itextstream.h"
 #include "iselection.h"
 #include "ientity.h"
@@ -7,6 +10,7 @@
 #include "gamelib.h"
 #include "brush/Brush.h"
 #include "brush/Winding.h"
+#include "util/Parallel.h"
 
 namespace cmutil {
 
@@ -33,7 +37,7 @@ void writeVector(std::ostream& st, const Vector3& vector)
 }
 
 // Writes a single polygon to the given stream <st>
-std::ostream& operator<< (std::ostream& st, const Polygon poly) {
+std::ostream& operator<< (std::ostream& st, const Polygon& poly) {
 	st << poly.numEdges;
 
 	// Edge List
@@ -53,7 +57,7 @@ std::ostream& operator<< (std::ostream& st, const Polygon poly) {
 	return st;
 }
 
-std::ostream& operator<< (std::ostream& st, const BrushStruc b) {
+std::ostream& operator<< (std::ostream& st, const BrushStruc& b) {
 	st << b.numFaces << " {\n";
 
 	// Write all the planes
@@ -76,60 +80,104 @@ std::ostream& operator<< (std::ostream& st, const BrushStruc b) {
 	return st;
 }
 
-CollisionModel::CollisionModel() {
+CollisionModel::CollisionModel() :
+	_numRemovedPolygons(0),
+	_shader(game::current::getValue<std::string>(GKEY_COLLISION_SHADER))
+{
 	// Create the "NULL" edge (numVertices = 0)
-	_edges[0] = Edge(0);
+	_edges.push_back(Edge(0));
 }
 
-int CollisionModel::findVertex(const Vector3& vertex) const {
-	for (VertexMap::const_iterator i = _vertices.begin();
-		i != _vertices.end();
-		++i)
+std::size_t CollisionModel::VertexHash::operator()(const Vector3& vertex) const
+{
+	// The vertices are snapped already, hash their position on the snap grid
+	std::size_t hash = 0;
+
+	for (std::size_t i = 0; i < 3; ++i)
 	{
-		if (i->second == vertex) {
-			return static_cast<int>(i->first);
-		}
+		auto quantised = static_cast<std::uint64_t>(std::llround(vertex[i] / MAX_PRECISION));
+		hash ^= std::hash<std::uint64_t>()(quantised) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
 	}
-	return -1;
+
+	return hash;
 }
 
-std::size_t CollisionModel::addVertex(const Vector3& vertex)
+std::size_t CollisionModel::EdgeListHash::operator()(const EdgeList& edges) const
 {
-	Vector3 snapped = vertex.getSnapped(MAX_PRECISION);
+	std::size_t hash = edges.size();
 
-	// Try to lookup the index of the given vertex
-	int foundIndex = findVertex(snapped);
+	for (int edge : edges)
+	{
+		hash ^= std::hash<int>()(edge) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	}
 
-	if (foundIndex == -1) {
-		// Insert the vertex at the end of the VertexMap
-		// The size of the map is the highest index + 1
-		std::size_t lastIndex = _vertices.size();
-		_vertices[lastIndex] = snapped;
+	return hash;
+}
 
-		return lastIndex;
+namespace
+{
+	inline std::uint64_t getEdgeKey(std::size_t from, std::size_t to)
+	{
+		return from < to ?
+			(static_cast<std::uint64_t>(from) << 32) | to :
+			(static_cast<std::uint64_t>(to) << 32) | from;
 	}
-	else {
-		// Return the found index
-		return static_cast<std::size_t>(foundIndex);
+
+	// The absolute edge numbers in ascending order, the key of the polygon lookup
+	inline EdgeList getSortedEdges(const EdgeList& edges)
+	{
+		EdgeList sorted;
+		sorted.reserve(edges.size());
+
+		for (int edge : edges)
+		{
+			sorted.push_back(abs(edge));
+		}
+
+		std::sort(sorted.begin(), sorted.end());
+
+		return sorted;
+	}
+
+	inline bool hasRepeatedEdges(const EdgeList& sortedEdges)
+	{
+		return std::adjacent_find(sortedEdges.begin(), sortedEdges.end()) != sortedEdges.end();
 	}
+
+	// Below this number of brushes, the geometry is not collected in parallel
+	const std::size_t MIN_BRUSHES_FOR_PARALLEL_COLLECTION = 64;
 }
 
-int CollisionModel::findEdge(const Edge& edge) const {
-	for (EdgeMap::const_iterator i = _edges.begin();
-		 i != _edges.end();
-		 i++)
+std::size_t CollisionModel::addVertex(const Vector3& snappedVertex)
+{
+	// Try to insert the vertex at the end, returns the existing index if it is known
+	auto result = _vertexIndex.emplace(snappedVertex, _vertices.size());
+
+	if (result.second)
 	{
-		// Direction match?
-		if (i->second.from == edge.from && i->second.to == edge.to) {
-			return static_cast<int>(i->first);
-		}
+		_vertices.push_back(snappedVertex);
+	}
 
-		// Opposite direction match?
-		if (i->second.from == edge.to && i->second.to == edge.from) {
-			return -static_cast<int>(i->first);
-		}
+	return result.first->second;
+}
+
+int CollisionModel::findEdge(const Edge& edge) const {
+	// The NULL edge matches the (0,0) pair, which is reported as "not found"
+	if (edge.from == 0 && edge.to == 0) {
+		return 0;
 	}
-	return 0;
+
+	auto found = _edgeIndex.find(getEdgeKey(edge.from, edge.to));
+
+	if (found == _edgeIndex.end()) {
+		return 0;
+	}
+
+	const Edge& existing = _edges[found->second];
+
+	// Direction match? Otherwise it's the opposite direction
+	return existing.from == edge.from && existing.to == edge.to ?
+		static_cast<int>(found->second) : -static_cast<int>(found->second);
 }
 
 std::size_t CollisionModel::addEdge(const Edge& edge) {
@@ -139,7 +187,12 @@ std::size_t CollisionModel::addEdge(const Edge& edge) {
 	if (foundIndex == 0) {
 		// NULL edge found, insert the edge with a new index
 		std::size_t edgeIndex = _edges.size();
-		_edges[edgeIndex] = edge;
+		_edges.push_back(edge);
+
+		if (edge.from != 0 || edge.to != 0) {
+			_edgeIndex.emplace(getEdgeKey(edge.from, edge.to), edgeIndex);
+		}
+
 		return edgeIndex;
 	}
 	else {
@@ -147,37 +200,85 @@ std::size_t CollisionModel::addEdge(const Edge& edge) {
 	}
 }
 
-int CollisionModel::findPolygon(const EdgeList& otherEdges) {
-	for (std::size_t p = 0; p < _polygons.size(); p++) {
-		// Check if the edge count matches
-		if (otherEdges.size() == _polygons[p].numEdges) {
-			// The match count
-			std::size_t matches = 0;
-
-			// See through the current polygon and count the matches
-			for (std::size_t i = 0; i < _polygons[p].edges.size(); i++) {
-				for (std::size_t j = 0; j < otherEdges.size(); j++) {
-					if (abs(_polygons[p].edges[i]) == abs(otherEdges[j])) {
-						matches++;
-					}
-				}
+bool CollisionModel::polygonMatches(std::size_t index, const EdgeList& otherEdges) const {
+	const Polygon& polygon = _polygons[index];
+
+	// Check if the edge count matches
+	if (otherEdges.size() != polygon.numEdges) {
+		return false;
+	}
+
+	// The match count
+	std::size_t matches = 0;
+
+	// See through the polygon and count the matches
+	for (std::size_t i = 0; i < polygon.edges.size(); i++) {
+		for (std::size_t j = 0; j < otherEdges.size(); j++) {
+			if (abs(polygon.edges[i]) == abs(otherEdges[j])) {
+				matches++;
 			}
+		}
+	}
+
+	// If the polygons are the same, all the edge indices matched
+	return matches == otherEdges.size();
+}
+
+int CollisionModel::findPolygon(const EdgeList& otherEdges) {
+	EdgeList sortedEdges = getSortedEdges(otherEdges);
+
+	std::size_t found = _polygons.size();
 
-			// If the polygons are the same, all the edge indices matched
-			if (matches == otherEdges.size()) {
-				// Remove the duplicate polygon
-				PolygonList::iterator i = _polygons.begin() + p;
-				_polygons.erase(i);
-				rMessage() << "CollisionModel: Removed duplicate polygon.\n";
-				return static_cast<int>(p);
+	if (!hasRepeatedEdges(sortedEdges)) {
+		// Among polygons using each edge once, only the one with the same edges can match
+		auto existing = _polygonIndex.find(sortedEdges);
+
+		if (existing != _polygonIndex.end()) {
+			found = existing->second;
+		}
+
+		for (std::size_t index : _polygonsWithRepeatedEdges) {
+			if (index < found && polygonMatches(index, otherEdges)) {
+				found = index;
+				break;
+			}
+		}
+	}
+	else {
+		// The match count can't be derived from the edge sets, compare to every polygon
+		for (std::size_t p = 0; p < _polygons.size(); p++) {
+			if (!_removedPolygons[p] && polygonMatches(p, otherEdges)) {
+				found = p;
+				break;
 			}
 		}
 	}
-	return -1;
+
+	if (found == _polygons.size()) {
+		return -1;
+	}
+
+	// Remove the duplicate polygon
+	removePolygon(found, getSortedEdges(_polygons[found].edges));
+	++_numRemovedPolygons;
+
+	return static_cast<int>(found);
+}
+
+void CollisionModel::removePolygon(std::size_t index, const EdgeList& sortedEdges) {
+	_removedPolygons[index] = true;
+
+	if (hasRepeatedEdges(sortedEdges)) {
+		_polygonsWithRepeatedEdges.erase(std::find(
+			_polygonsWithRepeatedEdges.begin(), _polygonsWithRepeatedEdges.end(), index));
+	}
+	else {
+		_polygonIndex.erase(sortedEdges);
+	}
 }
 
 void CollisionModel::addPolygon(
-	const Face& face,
+	const FaceGeometry& face,
 	const VertexList& vertexList)
 {
 	Polygon poly;
@@ -194,52 +295,61 @@ void CollisionModel::addPolygon(
 	}
 
 	if (findPolygon(poly.edges) == -1) {
-		AABB faceAABB = face.getWinding().aabb();
-
 		poly.numEdges = poly.edges.size();
-		poly.plane = face.plane3();
-		poly.min = faceAABB.origin - faceAABB.extents;
-		poly.max = faceAABB.origin + faceAABB.extents;
+		poly.plane = face.plane;
+		poly.min = face.min;
+		poly.max = face.max;
 		//poly.shader = face.GetShader();
-		poly.shader = game::current::getValue<std::string>(GKEY_COLLISION_SHADER);
+		poly.shader = _shader;
+
+		std::size_t index = _polygons.size();
+		EdgeList sortedEdges = getSortedEdges(poly.edges);
+
+		if (hasRepeatedEdges(sortedEdges)) {
+			_polygonsWithRepeatedEdges.push_back(index);
+		}
+		else {
+			_polygonIndex.emplace(std::move(sortedEdges), index);
+		}
 
 		_polygons.push_back(poly);
+		_removedPolygons.push_back(false);
 	}
 }
 
-VertexList CollisionModel::addWinding(
-	const Winding& winding)
+VertexList CollisionModel::addWinding(const std::vector<Vector3>& snappedVertices)
 {
 	VertexList vertexList;
 
-	for (Winding::const_iterator i = winding.begin(); i != winding.end(); ++i) {
+	if (snappedVertices.empty()) {
+		rError() << "Warning: degenerate winding found.\n";
+		return vertexList;
+	}
+
+	for (const Vector3& vertex : snappedVertices) {
 		// Create a vertexId and add it to the stack
-		vertexList.push_back(addVertex(i->vertex));
+		vertexList.push_back(addVertex(vertex));
 	}
 	// Now add the first vertex a second time to the end of the list
-	vertexList.push_back(addVertex(winding.begin()->vertex));
+	vertexList.push_back(addVertex(snappedVertices.front()));
 
-	if (vertexList.size() > 1) {
-		Edge edge;
+	Edge edge;
 
-		// Now work through the stack, adding the edges (note the -1 in the for condition)
-		for (std::size_t i = 0; i < vertexList.size()-1; i++) {
-			edge.from = vertexList[i];
-			edge.to = vertexList[i+1];
+	// Now work through the stack, adding the edges (note the -1 in the for condition)
+	for (std::size_t i = 0; i < vertexList.size()-1; i++) {
+		edge.from = vertexList[i];
+		edge.to = vertexList[i+1];
 
-			addEdge(edge);
-		}
-	}
-	else {
-		rError() << "Warning: degenerate winding found.\n";
+		addEdge(edge);
 	}
 
 	// Now that all edges are added, return the VertexList defining the winding
 	return vertexList;
 }
 
-void CollisionModel::addBrush(Brush& brush) {
-	BrushStruc b;
+void CollisionModel::collectBrushGeometry(Brush& brush, BrushGeometry& geometry)
+{
+	BrushStruc& b = geometry.brush;
 
 	// The number of faces
 	b.numFaces = brush.getNumFaces();
@@ -250,20 +360,76 @@ void CollisionModel::addBrush(Brush& brush) {
 	b.min = brushAABB.origin - brushAABB.extents;
 	b.max = brushAABB.origin + brushAABB.extents;
 
+	geometry.faces.reserve(b.numFaces);
+
 	// Populate the FaceList
 	for (Brush::const_iterator i = brush.begin(); i != brush.end(); i++) {
 		// Store the plane into the brush
 		b.planes.push_back((*i)->plane3());
 
+		const Winding& winding = (*i)->getWinding();
+		AABB faceAABB = winding.aabb();
+
+		FaceGeometry face;
+		face.plane = (*i)->plane3();
+		face.min = faceAABB.origin - faceAABB.extents;
+		face.max = faceAABB.origin + faceAABB.extents;
+
+		face.vertices.reserve(winding.size());
+
+		for (Winding::const_iterator v = winding.begin(); v != winding.end(); ++v) {
+			face.vertices.push_back(v->vertex.getSnapped(MAX_PRECISION));
+		}
+
+		geometry.faces.emplace_back(std::move(face));
+	}
+}
+
+void CollisionModel::addBrushGeometry(const BrushGeometry& geometry)
+{
+	for (const FaceGeometry& face : geometry.faces) {
 		// Parse the winding of this Face for vertices/edges
-		VertexList vertexList = addWinding((*i)->getWinding());
+		VertexList vertexList = addWinding(face.vertices);
+
+		if (vertexList.empty()) continue;
 
-		// Pass the Face& and the VertexList to create the polygon
-		addPolygon(*(*i), vertexList);
+		// Pass the face geometry and the VertexList to create the polygon
+		addPolygon(face, vertexList);
 	}
 
 	// Store the BrushStruc into the list
-	_brushes.push_back(b);
+	_brushes.push_back(geometry.brush);
+}
+
+void CollisionModel::addBrush(Brush& brush) {
+	BrushGeometry geometry;
+	collectBrushGeometry(brush, geometry);
+
+	addBrushGeometry(geometry);
+}
+
+void CollisionModel::addBrushes(const std::vector<Brush*>& brushes)
+{
+	std::vector<BrushGeometry> geometry(brushes.size());
+
+	// Building the windings modifies the brushes, do it here
+	// such that the worker threads only ever read from them
+	for (Brush* brush : brushes) {
+		brush->evaluateBRep();
+	}
+
+	util::forEachIndexInParallel(brushes.size(), MIN_BRUSHES_FOR_PARALLEL_COLLECTION, [&](std::size_t i) {
+		collectBrushGeometry(*brushes[i], geometry[i]);
+	});
+
+	// The indices depend on the order, so these are assigned sequentially
+	for (const BrushGeometry& brushGeometry : geometry) {
+		addBrushGeometry(brushGeometry);
+	}
+
+	if (_numRemovedPolygons > 0) {
+		rMessage() << "CollisionModel: Removed " << _numRemovedPolygons << " duplicate polygons." << std::endl;
+	}
 }
 
 void CollisionModel::setModel(const std::string& model) {
@@ -288,25 +454,21 @@ std::ostream& operator<<(std::ostream& st, const CollisionModel& cm) {
 
 	// Export the vertices
 	st << "\tvertices { /* numVertices = */ " << cm._vertices.size() << "\n";
-	for (VertexMap::const_iterator i = cm._vertices.begin();
-		 i != cm._vertices.end();
-		 i++)
+	for (std::size_t i = 0; i < cm._vertices.size(); i++)
 	{
-		st << "\t/* " << i->first << " */ ";
-		writeVector(st, i->second);
+		st << "\t/* " << i << " */ ";
+		writeVector(st, cm._vertices[i]);
 		st << "\n";
 	}
 	st << "\t}\n";
 
 	// Export the edges
 	st << "\tedges { /* numEdges = */ " << cm._edges.size() << "\n";
-	for (EdgeMap::const_iterator i = cm._edges.begin();
-		 i != cm._edges.end();
-		 ++i)
+	for (std::size_t i = 0; i < cm._edges.size(); i++)
 	{
-		st << "\t/* " << i->first << " */ ";
-		st << "( " << i->second.from << " " << i->second.to << " ) ";
-		st << "0 " << i->second.numVertices << "\n";
+		st << "\t/* " << i << " */ ";
+		st << "( " << cm._edges[i].from << " " << cm._edges[i].to << " ) ";
+		st << "0 " << cm._edges[i].numVertices << "\n";
 	}
 	st << "\t}\n";
 
@@ -318,6 +480,8 @@ std::ostream& operator<<(std::ostream& st, const CollisionModel& cm) {
 	// Export the polygons
 	st << "\tpolygons {\n";
 	for (std::size_t i = 0; i < cm._polygons.size(); i++) {
+		if (cm._removedPolygons[i]) continue;
+
 		st << "\t" << cm._polygons[i] << "\n";
 	}
 	st << "\t}\n";
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "Geometry.h"
+#include <cstdint>
 #include <memory>
+#include <unordered_map>
 
 class Winding;
 class Brush;
@@ -12,18 +14,50 @@ namespace cmutil {
 class CollisionModel
 {
 	// The container instances with all the vertices/edges/faces
-	VertexMap _vertices;
-	EdgeMap _edges;
+	VertexArray _vertices;
+	EdgeArray _edges;
 	PolygonList _polygons;
 	BrushList _brushes;
 
+	// Duplicate polygons are removed again, their slots are flagged here
+	std::vector<bool> _removedPolygons;
+	std::size_t _numRemovedPolygons;
+
+	// Hashes of the snapped vertex positions, mapping to the vertex index
+	struct VertexHash
+	{
+		std::size_t operator()(const Vector3& vertex) const;
+	};
+	std::unordered_map<Vector3, std::size_t, VertexHash> _vertexIndex;
+
+	// Maps the vertex pair (smaller index first) to the edge index
+	std::unordered_map<std::uint64_t, std::size_t> _edgeIndex;
+
+	// Maps the sorted absolute edge numbers of each polygon to its index.
+	// Polygons using an edge more than once are kept in a separate list,
+	// since they can match polygons with different edges.
+	struct EdgeListHash
+	{
+		std::size_t operator()(const EdgeList& edges) const;
+	};
+	std::unordered_map<EdgeList, std::size_t, EdgeListHash> _polygonIndex;
+	std::vector<std::size_t> _polygonsWithRepeatedEdges;
+
 	std::string _model;
+	std::string _shader;
 
 public:
 	CollisionModel();
 
 	void addBrush(Brush& brush);
 
+	/** greebo: Adds all the given brushes, in this order. The windings
+	 * 			and planes are collected in parallel, the resulting
+	 * 			model is the same as the one of calling addBrush()
+	 * 			for each brush.
+	 */
+	void addBrushes(const std::vector<Brush*>& brushes);
+
 	/** greebo: Stream insertion operator, use this to write
 	 * the collision model into a file. Qualified as "friend" to allow the access
 	 * of private members and the first function argument to be std::ostream.
@@ -40,27 +74,42 @@ public:
 	static std::size_t getBrushMemory(const BrushList& brushes);
 
 private:
-	/** greebo: Adds the given vertex to the internal vertex list
+	// The geometry of a single brush face, with snapped winding vertices
+	struct FaceGeometry
+	{
+		std::vector<Vector3> vertices;
+		Plane3 plane;
+		Vector3 min;
+		Vector3 max;
+	};
+
+	// The geometry of a brush, which can be gathered independently of the others
+	struct BrushGeometry
+	{
+		BrushStruc brush;
+		std::vector<FaceGeometry> faces;
+	};
+
+	static void collectBrushGeometry(Brush& brush, BrushGeometry& geometry);
+
+	// Adds the collected geometry of a brush to the vertices, edges and polygons
+	void addBrushGeometry(const BrushGeometry& geometry);
+
+	/** greebo: Adds the given (snapped) vertex to the internal vertex list
 	 * and returns its index. If the vertex already exists,
 	 * the index to the existing vertex is returned.
 	 *
 	 * @returns: the index of the (existing/inserted) vertex.
 	 */
-	std::size_t addVertex(const Vector3& vertex);
-
-	/** greebo: Tries to lookup the index of the given vertex.
-	 *
-	 * @returns: the index of the vertex or -1 if not found
-	 */
-	int findVertex(const Vector3& vertex) const;
+	std::size_t addVertex(const Vector3& snappedVertex);
 
-	/** greebo: "Parses" the given Winding and adds its
-	 * 			geometry info (vertices, edges, polys) into the maps.
+	/** greebo: "Parses" the given winding vertices and adds the
+	 * 			geometry info (vertices, edges) into the maps.
 	 *
 	 * @returns: the VertexList defining the Winding points in a
 	 * 			 closed loop (last vertexId = first vertexId)
 	 */
-	VertexList addWinding(const Winding& winding);
+	VertexList addWinding(const std::vector<Vector3>& snappedVertices);
 
 	/** greebo: Adds the given edge to the internal edge map
 	 * and returns its index. If the edge already exists,
@@ -80,18 +129,23 @@ private:
 
 	/** greebo: Tries to lookup the index of the matching polygon.
 	 * 			All the Edge indices are compared regardless of
-	 * 			their order.
+	 * 			their order. A matching polygon is removed.
 	 *
 	 * @returns: the index of the polygon or -1 if not found
 	 */
 	int findPolygon(const EdgeList& otherEdges);
 
+	// The edge comparison of findPolygon(), counting the pairs of equal edge numbers
+	bool polygonMatches(std::size_t index, const EdgeList& otherEdges) const;
+
+	void removePolygon(std::size_t index, const EdgeList& sortedEdges);
+
 	/** greebo: Adds a polygon basing on the given face & vertexlist.
 	 * 			Be sure to add the first vertex a second time
 	 * 			to the end of the pass a "closed" winding.
 	 * 			Duplicate polygons are not added.
 	 */
-	void addPolygon(const Face& face, const VertexList& vertexList);
+	void addPolygon(const FaceGeometry& face, const VertexList& vertexList);
 };
 
 typedef std::shared_ptr<CollisionModel> CollisionModelPtr;
@@ -1,7 +1,7 @@
 #ifndef CM_GEOMETRY_H_
 #define CM_GEOMETRY_H_
 
-#include <map>
+#include <string>
 #include <vector>
 #include "math/Vector3.h"
 #include "math/Plane3.h"
@@ -14,8 +14,8 @@ namespace cmutil {
 // A list of indexed ("named") vertices
 typedef std::vector<std::size_t> VertexList;
 
-// The indexed vertices of the collisionmodel
-typedef std::map<std::size_t, Vector3> VertexMap;
+// The vertices of the collisionmodel, indexed by their position in the array
+typedef std::vector<Vector3> VertexArray;
 
 struct Edge {
 	std::size_t from;	// The starting vertex index
@@ -29,8 +29,8 @@ struct Edge {
 	{}
 };
 
-// The indexed Edges (each consisting of a start/end vertex)
-typedef std::map<std::size_t, Edge> EdgeMap;
+// The Edges (each consisting of a start/end vertex), indexed by their position in the array
+typedef std::vector<Edge> EdgeArray;
 // A vector of Edges defining a polygon (the sign indicates the direction)
 typedef std::vector<int> EdgeList;
 
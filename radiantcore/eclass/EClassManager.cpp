@@ -26,7 +26,8 @@ EClassManager::EClassManager() :
     _realised(false),
     _defLoader(std::bind(&EClassManager::loadDefAndResolveInheritance, this),
                std::bind(&EClassManager::onDefLoadingCompleted, this)),
-	_curParseStamp(0)
+	_curParseStamp(0),
+    _flatteningPass(0)
 {}
 
 sigc::signal<void> EClassManager::defsLoadingSignal() const
@@ -55,16 +56,16 @@ IEntityClassPtr EClassManager::findOrInsert(const std::string& name, bool has_br
         return IEntityClassPtr();
     }
 
-	// Convert string to lowercase, for case-insensitive lookup
-	std::string lName = string::to_lower_copy(name);
-
-    // Find and return if exists
-    EntityClass::Ptr eclass = findInternal(lName);
+    // Find and return if exists, the lookup is case-insensitive
+    EntityClass::Ptr eclass = findInternal(name);
     if (eclass)
     {
         return eclass;
     }
 
+	// New classes are using lowercase names
+	std::string lName = string::to_lower_copy(name);
+
     // Otherwise insert the new EntityClass
     //IEntityClassPtr eclass = eclass::EntityClass::create(lName, has_brushes);
     // greebo: Changed fallback behaviour when unknown entites are encountered to TRUE
@@ -139,6 +140,13 @@ void EClassManager::parseDefFiles()
 	// Increase the parse stamp for this run
 	_curParseStamp++;
 
+    // The classes are looking up attributes through the inheritance chain
+    // until the inheritance has been resolved again
+    for (const auto& pair : _entityClasses)
+    {
+        pair.second->suspendFlattenedAttributes();
+    }
+
 	{
 		ScopedDebugTimer timer("EntityDefs parsed: ");
         GlobalFileSystem().forEachFile(
@@ -178,6 +186,14 @@ void EClassManager::resolveInheritance()
             }
         }
     }
+
+    // Build the attribute tables of the classes that changed (or whose ancestors did)
+    ++_flatteningPass;
+
+    for (const auto& pair : _entityClasses)
+    {
+        pair.second->flattenAttributes(_flatteningPass);
+    }
 }
 
 void EClassManager::ensureDefsLoaded()
@@ -206,7 +222,7 @@ void EClassManager::applyColours()
 {
     GlobalEclassColourManager().foreachOverrideColour([&](const std::string& eclass, const Vector3& colour)
     {
-        auto foundEclass = _entityClasses.find(string::to_lower_copy(eclass));
+        auto foundEclass = _entityClasses.find(eclass);
         if (foundEclass != _entityClasses.end())
             foundEclass->second->setColour(colour);
     });
@@ -229,10 +245,8 @@ IEntityClassPtr EClassManager::findClass(const std::string& className)
 {
     ensureDefsLoaded();
 
-	// greebo: Convert the lookup className string to lowercase first
-	std::string classNameLower = string::to_lower_copy(className);
-
-    EntityClasses::const_iterator i = _entityClasses.find(classNameLower);
+    // The lookup is case-insensitive
+    EntityClasses::const_iterator i = _entityClasses.find(className);
 
     return i != _entityClasses.end() ? i->second : IEntityClassPtr();
 }
@@ -35,8 +35,8 @@ class EClassManager :
     // Whether the entity classes have been realised
     bool _realised;
 
-    // Map of named entity classes
-    typedef std::map<std::string, EntityClass::Ptr> EntityClasses;
+    // Map of named entity classes, looked up case-insensitively
+    typedef EntityClass::EntityClasses EntityClasses;
     EntityClasses _entityClasses;
 
     typedef std::map<std::string, Doom3ModelDef::Ptr> Models;
@@ -49,6 +49,9 @@ class EClassManager :
 	// definitions have been parsed
 	std::size_t _curParseStamp;
 
+    // Identifies the runs flattening the entity class attributes
+    std::size_t _flatteningPass;
+
     sigc::signal<void> _defsLoadingSignal;
     sigc::signal<void> _defsLoadedSignal;
     sigc::signal<void> _defsReloadedSignal;
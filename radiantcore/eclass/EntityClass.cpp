@@ -7,7 +7,9 @@
 
 #include "string/predicate.h"
 #include <fmt/format.h>
+#include <algorithm>
 #include <functional>
+#include <utility>
 
 namespace eclass
 {
@@ -17,6 +19,24 @@ const std::string EntityClass::DefaultFillShader("(0.3 0.3 1)");
 const Vector3 EntityClass::DefaultEntityColour(0.3, 0.3, 1);
 const EntityClassAttribute EntityClass::_emptyAttribute("", "", "");
 
+namespace
+{
+    inline bool attributeIsEqual(const EntityClassAttribute& a, const EntityClassAttribute& b)
+    {
+        return a.getInternedName() == b.getInternedName() && a.getType() == b.getType() &&
+            a.getValue() == b.getValue() && a.getDescription() == b.getDescription();
+    }
+}
+
+bool EntityClass::attributesAreEqual(const EntityAttributeMap& a, const EntityAttributeMap& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(),
+        [](const EntityAttributeMap::value_type& x, const EntityAttributeMap::value_type& y)
+    {
+        return attributeIsEqual(x.second, y.second);
+    });
+}
+
 EntityClass::EntityClass(const std::string& name, const vfs::FileInfo& fileInfo) :
     EntityClass(name, fileInfo, false)
 {}
@@ -156,8 +176,12 @@ const std::string& EntityClass::getFillShader() const
  */
 void EntityClass::emplaceAttribute(EntityClassAttribute&& attribute)
 {
+    // The flattened attributes are out of date until the next flattening pass
+    ++_attributeRevision;
+    _attributesFlattened = false;
+
     // Try to emplace the class attribute
-    auto result = _attributes.try_emplace(attribute.getName(), std::move(attribute));
+    auto result = _attributes.try_emplace(attribute.getInternedName(), std::move(attribute));
 
     if (!result.second)
     {
@@ -178,6 +202,71 @@ void EntityClass::emplaceAttribute(EntityClassAttribute&& attribute)
     }
 }
 
+void EntityClass::flattenAttributes(std::size_t pass)
+{
+    if (_flatteningPass == pass)
+    {
+        return;
+    }
+
+    _flatteningPass = pass;
+
+    if (_parent)
+    {
+        _parent->flattenAttributes(pass);
+    }
+
+    // The existing table is still valid if neither this class nor any ancestor changed
+    if (_tableRevision > 0 && _flattenedRevision == _attributeRevision && _flattenedParent == _parent &&
+        (!_parent || _flattenedParentTableRevision == _parent->_tableRevision))
+    {
+        _attributesFlattened = true;
+        return;
+    }
+
+    _flattenedAttributes.clear();
+    _flattenedAttributes.reserve((_parent ? _parent->_flattenedAttributes.size() : 0) + _attributes.size());
+
+    if (_parent)
+    {
+        for (const auto& [name, entry] : _parent->_flattenedAttributes)
+        {
+            auto& inherited = _flattenedAttributes.emplace(name, entry).first->second;
+            inherited.inherited = true;
+        }
+    }
+
+    // The names are interned strings, the keys stay valid in any case
+    for (const auto& [name, attribute] : _attributes)
+    {
+        auto result = _flattenedAttributes.try_emplace(AttributeNameRef{ &attribute.getName() },
+            FlattenedAttribute{ &attribute, false, &_emptyAttribute.getType(), &_emptyAttribute.getDescription() });
+
+        // Our own attributes override the inherited ones, but the type and
+        // description is inherited unless it's defined on this class
+        auto& entry = result.first->second;
+        entry.attribute = &attribute;
+        entry.inherited = false;
+
+        if (!attribute.getType().empty())
+        {
+            entry.type = &attribute.getType();
+        }
+
+        if (!attribute.getDescription().empty())
+        {
+            entry.description = &attribute.getDescription();
+        }
+    }
+
+    _flattenedRevision = _attributeRevision;
+    _flattenedParent = _parent;
+    _flattenedParentTableRevision = _parent ? _parent->_tableRevision : 0;
+    ++_tableRevision;
+
+    _attributesFlattened = true;
+}
+
 EntityClass::Ptr EntityClass::create(const std::string& name, bool brushes)
 {
     vfs::FileInfo emptyFileInfo("def/", "_autogenerated_by_darkradiant_.def", vfs::Visibility::HIDDEN);
@@ -322,6 +411,14 @@ EntityClassAttribute& EntityClass::getAttribute(const std::string& name,
 // Find a single attribute
 const EntityClassAttribute& EntityClass::getAttribute(const std::string& name, bool includeInherited) const
 {
+    if (_attributesFlattened)
+    {
+        auto flattened = findFlattenedAttribute(name);
+
+        return flattened && (includeInherited || !flattened->inherited) ?
+            *flattened->attribute : _emptyAttribute;
+    }
+
     // First look up the attribute on this class; if found, we can simply return it
     auto f = _attributes.find(name);
     if (f != _attributes.end())
@@ -339,6 +436,12 @@ const EntityClassAttribute& EntityClass::getAttribute(const std::string& name, b
 
 const std::string& EntityClass::getAttributeType(const std::string& name) const
 {
+    if (_attributesFlattened)
+    {
+        auto flattened = findFlattenedAttribute(name);
+        return flattened ? *flattened->type : _emptyAttribute.getType();
+    }
+
     // Check the attributes on this class
     const auto& attribute = _attributes.find(name);
 
@@ -358,6 +461,12 @@ const std::string& EntityClass::getAttributeType(const std::string& name) const
 
 const std::string& EntityClass::getAttributeDescription(const std::string& name) const
 {
+    if (_attributesFlattened)
+    {
+        auto flattened = findFlattenedAttribute(name);
+        return flattened ? *flattened->description : _emptyAttribute.getDescription();
+    }
+
     // Check the attributes on this class first
     const auto& attribute = _attributes.find(name);
 
@@ -386,6 +495,9 @@ void EntityClass::clear()
     _fixedSize = false;
 
     _attributes.clear();
+    ++_attributeRevision;
+    _attributesFlattened = false;
+
     _model.clear();
     _skin.clear();
     _inheritanceResolved = false;
@@ -430,6 +542,12 @@ void EntityClass::parseEditorSpawnarg(const std::string& key,
 
 void EntityClass::parseFromTokens(parser::DefTokeniser& tokeniser)
 {
+    // Keep the previous attributes, they are restored if the definition didn't
+    // change, which keeps the flattened attribute tables referring to them valid
+    EntityAttributeMap previousAttributes;
+    previousAttributes.swap(_attributes);
+    auto previousRevision = _attributeRevision;
+
     // Clear this structure first, we might be "refreshing" ourselves from tokens
     clear();
 
@@ -489,6 +607,12 @@ void EntityClass::parseFromTokens(parser::DefTokeniser& tokeniser)
         }
     } // while true
 
+    if (attributesAreEqual(_attributes, previousAttributes))
+    {
+        _attributes.swap(previousAttributes);
+        _attributeRevision = previousRevision;
+    }
+
     // Notify the observers
     emitChangedSignal();
 }
@@ -13,6 +13,7 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <unordered_map>
 
 /* FORWARD DECLS */
 
@@ -61,11 +62,79 @@ private:
     // Does this entity have a fixed size?
     bool _fixedSize;
 
+    // Case-insensitive comparison of the interned attribute names, which can
+    // be used to look up attributes by std::string without interning it first
+    struct AttributeNameLess
+    {
+        using is_transparent = void;
+
+        bool operator()(const std::string& lhs, const std::string& rhs) const
+        {
+            return string::icmp(lhs.c_str(), rhs.c_str()) < 0;
+        }
+    };
+
     // Map of named EntityAttribute structures. EntityAttributes are picked
     // up from the DEF file during parsing. Ignores key case.
-    typedef std::map<std::string, EntityClassAttribute, string::ILess> EntityAttributeMap;
+    typedef std::map<string::InternedString, EntityClassAttribute, AttributeNameLess> EntityAttributeMap;
     EntityAttributeMap _attributes;
 
+    // Incremented whenever the attributes of this class are changing
+    std::size_t _attributeRevision = 0;
+
+    // Reference to an attribute name, hashed and compared case-insensitively,
+    // such that a std::string can be looked up without copying it
+    struct AttributeNameRef
+    {
+        const std::string* name;
+    };
+
+    struct AttributeNameRefHash
+    {
+        std::size_t operator()(const AttributeNameRef& ref) const
+        {
+            return string::IHash()(*ref.name);
+        }
+    };
+
+    struct AttributeNameRefEquals
+    {
+        bool operator()(const AttributeNameRef& lhs, const AttributeNameRef& rhs) const
+        {
+            return string::IEquals()(*lhs.name, *rhs.name);
+        }
+    };
+
+    // An entry of the flattened attribute table, pointing to the attribute
+    // getAttribute() returns and to the first non-empty type and description
+    // up the inheritance chain
+    struct FlattenedAttribute
+    {
+        const EntityClassAttribute* attribute;
+        bool inherited;
+        const std::string* type;
+        const std::string* description;
+    };
+
+    // All attributes of this class and its ancestors, built once after the
+    // inheritance has been resolved. Until then, or after a class in the
+    // inheritance chain has changed, lookups walk up the chain instead.
+    typedef std::unordered_map<AttributeNameRef, FlattenedAttribute,
+        AttributeNameRefHash, AttributeNameRefEquals> FlattenedAttributeMap;
+    FlattenedAttributeMap _flattenedAttributes;
+    bool _attributesFlattened = false;
+
+    // The state the flattened table has been built from
+    std::size_t _flattenedRevision = 0;
+    const EntityClass* _flattenedParent = nullptr;
+    std::size_t _flattenedParentTableRevision = 0;
+
+    // Incremented whenever the flattened table is rebuilt
+    std::size_t _tableRevision = 0;
+
+    // The flattening pass this class has last been visited in
+    std::size_t _flatteningPass = 0;
+
     // The model and skin for this entity class (if it has one)
     std::string _model;
     std::string _skin;
@@ -94,11 +163,21 @@ private:
     void parseEditorSpawnarg(const std::string& key, const std::string& value);
     void setIsLight(bool val);
 
+    // Returns true if the two attribute maps have the same contents
+    static bool attributesAreEqual(const EntityAttributeMap& a, const EntityAttributeMap& b);
+
     // Visit attributes recursively, parent first then child
     using InternalAttrVisitor = std::function<void(const EntityClassAttribute&)>;
     void forEachAttributeInternal(InternalAttrVisitor visitor,
                                   bool editorKeys) const;
 
+    // Looks up the attribute in the flattened table, returns nullptr if not present
+    const FlattenedAttribute* findFlattenedAttribute(const std::string& name) const
+    {
+        auto found = _flattenedAttributes.find(AttributeNameRef{ &name });
+        return found != _flattenedAttributes.end() ? &found->second : nullptr;
+    }
+
 public:
     /**
      * Static function to create a default entity class.
@@ -177,9 +256,27 @@ public:
      * A reference to the global map of entity classes, which should be searched
      * for the parent entity.
      */
-    typedef std::map<std::string, EntityClass::Ptr> EntityClasses;
+    typedef std::map<std::string, EntityClass::Ptr, string::ILess> EntityClasses;
     void resolveInheritance(EntityClasses& classmap);
 
+    /**
+     * Builds the flattened attribute table of this class, after making sure
+     * the parent's table is up to date. The table is only rebuilt if this
+     * class or one of its ancestors changed since it has last been built.
+     *
+     * @param pass
+     * A number identifying the current flattening run, each class is only
+     * processed once per run.
+     */
+    void flattenAttributes(std::size_t pass);
+
+    // Disables the flattened attribute table until the next flattenAttributes()
+    // call, to be used before (re-)parsing the definitions
+    void suspendFlattenedAttributes()
+    {
+        _attributesFlattened = false;
+    }
+
     /**
      * Return the mod name.
      */
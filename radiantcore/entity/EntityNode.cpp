@@ -7,6 +7,7 @@
 #include "imap.h"
 #include "itransformable.h"
 #include "math/Hash.h"
+#include "scene/merge/NodeUtils.h"
 #include "string/case_conv.h"
 
 #include "EntitySettings.h"
@@ -162,6 +163,14 @@ void EntityNode::transformChanged()
         attached->transformChanged();
 }
 
+void EntityNode::boundsChanged()
+{
+    Node::boundsChanged();
+
+    // Let the entities targeting this one update their lines
+    TargetableNode::onBoundsChanged();
+}
+
 void EntityNode::onEntityClassChanged()
 {
 	// By default, we notify the KeyObservers attached to this entity
@@ -207,7 +216,7 @@ std::string EntityNode::getFingerprint()
         sortedKeyValues.emplace(string::to_lower_copy(key), string::to_lower_copy(value));
     }, false);
 
-    math::Hash hash;
+    math::FastHash hash;
 
     for (const auto& pair : sortedKeyValues)
     {
@@ -216,7 +225,7 @@ std::string EntityNode::getFingerprint()
     }
 
     // Entities need to include any child hashes, but be insensitive to their order
-    std::set<std::string> childFingerprints;
+    std::vector<std::shared_ptr<scene::IComparableNode>> children;
 
     foreachNode([&](const scene::INodePtr& child)
     {
@@ -224,13 +233,18 @@ std::string EntityNode::getFingerprint()
 
         if (comparable)
         {
-            childFingerprints.insert(comparable->getFingerprint());
+            children.emplace_back(std::move(comparable));
         }
 
         return true;
     });
 
-    for (auto childFingerprint : childFingerprints)
+    auto childFingerprints = scene::merge::NodeUtils::CalculateFingerprints(children);
+
+    std::sort(childFingerprints.begin(), childFingerprints.end());
+    childFingerprints.erase(std::unique(childFingerprints.begin(), childFingerprints.end()), childFingerprints.end());
+
+    for (const auto& childFingerprint : childFingerprints)
     {
         hash.addString(childFingerprint);
     }
@@ -104,6 +104,7 @@ public:
 	Entity& getEntity() override;
 	virtual void refreshModel() override;
     void transformChanged() override;
+    void boundsChanged() override;
 
 	// RenderEntity implementation
 	virtual float getShaderParm(int parmNum) const override;
@@ -10,6 +10,7 @@ namespace entity
 
 SpawnArgs::SpawnArgs(const IEntityClassPtr& eclass) :
 	_eclass(eclass),
+	_keyIndexHasHiddenKeys(false),
 	_undo(_keyValues, std::bind(&SpawnArgs::importState, this, std::placeholders::_1), 
         std::function<void()>(), "EntityKeyValues"),
 	_observerMutex(false),
@@ -23,6 +24,7 @@ SpawnArgs::SpawnArgs(const IEntityClassPtr& eclass) :
 SpawnArgs::SpawnArgs(const SpawnArgs& other) :
 	Entity(other),
 	_eclass(other.getEntityClass()),
+	_keyIndexHasHiddenKeys(false),
 	_undo(_keyValues, std::bind(&SpawnArgs::importState, this, std::placeholders::_1), 
         std::function<void()>(), "EntityKeyValues"),
 	_observerMutex(false),
@@ -65,6 +67,9 @@ bool SpawnArgs::isOfType(const std::string& className)
 
 void SpawnArgs::importState(const KeyValues& keyValues)
 {
+	// The index is rebuilt once enough keys have been inserted again
+	_keyIndex.clear();
+
 	// Remove the entity key values, one by one
 	while (_keyValues.size() > 0)
 	{
@@ -273,11 +278,24 @@ void SpawnArgs::notifyErase(const std::string& key, KeyValue& value)
 	_observerMutex = false;
 }
 
-void SpawnArgs::insert(const std::string& key, const KeyValuePtr& keyValue)
+void SpawnArgs::insert(const string::InternedString& key, const KeyValuePtr& keyValue)
 {
 	// Insert the new key at the end of the list
 	auto& pair = _keyValues.emplace_back(key, keyValue);
 
+	// Keep the index in sync before any observer gets to look up keys
+	if (!_keyIndex.empty())
+	{
+		if (!_keyIndex.emplace(KeyRef{ &key.str() }, _keyValues.size() - 1).second)
+		{
+			_keyIndexHasHiddenKeys = true;
+		}
+	}
+	else if (_keyValues.size() >= MinKeysForIndex)
+	{
+		rebuildKeyIndex();
+	}
+
 	// Dereference the iterator to get a KeyValue& reference and notify the observers
 	notifyInsert(key, *pair.second);
 
@@ -305,9 +323,11 @@ void SpawnArgs::insert(const std::string& key, const std::string& value)
 		_undo.save();
 
 		// Allocate a new KeyValue object and insert it into the map
-        // Capture the key by value in the lambda
-		insert(key, std::make_shared<KeyValue>(value, _eclass->getAttribute(key).getValue(),
-            [key, this](const std::string& value) { notifyChange(key, value); }));
+        // Capture the (interned) key by value in the lambda
+		string::InternedString internedKey(key);
+
+		insert(internedKey, std::make_shared<KeyValue>(value, _eclass->getAttribute(key).getValue(),
+            [internedKey, this](const std::string& value) { notifyChange(internedKey, value); }));
 	}
 }
 
@@ -323,8 +343,14 @@ void SpawnArgs::erase(const KeyValues::iterator& i)
 	KeyValuePtr value(i->second);
 
 	// Actually delete the object from the list
+	auto position = static_cast<std::size_t>(i - _keyValues.begin());
 	_keyValues.erase(i);
 
+	if (!_keyIndex.empty())
+	{
+		removeFromKeyIndex(key, position);
+	}
+
 	// Notify about the deletion
 	notifyErase(key, *value);
 
@@ -346,6 +372,12 @@ void SpawnArgs::erase(const std::string& key)
 
 SpawnArgs::KeyValues::const_iterator SpawnArgs::find(const std::string& key) const
 {
+	if (!_keyIndex.empty())
+	{
+		auto found = _keyIndex.find(KeyRef{ &key });
+		return found != _keyIndex.end() ? _keyValues.begin() + found->second : _keyValues.end();
+	}
+
 	for (KeyValues::const_iterator i = _keyValues.begin();
 		 i != _keyValues.end();
 		 ++i)
@@ -362,6 +394,12 @@ SpawnArgs::KeyValues::const_iterator SpawnArgs::find(const std::string& key) con
 
 SpawnArgs::KeyValues::iterator SpawnArgs::find(const std::string& key)
 {
+	if (!_keyIndex.empty())
+	{
+		auto found = _keyIndex.find(KeyRef{ &key });
+		return found != _keyIndex.end() ? _keyValues.begin() + found->second : _keyValues.end();
+	}
+
 	for (KeyValues::iterator i = _keyValues.begin();
 		 i != _keyValues.end();
 		 ++i)
@@ -376,4 +414,66 @@ SpawnArgs::KeyValues::iterator SpawnArgs::find(const std::string& key)
 	return _keyValues.end();
 }
 
+void SpawnArgs::rebuildKeyIndex()
+{
+	_keyIndex.clear();
+	_keyIndexHasHiddenKeys = false;
+
+	if (_keyValues.size() < MinKeysForIndex)
+	{
+		return;
+	}
+
+	_keyIndex.reserve(_keyValues.size());
+
+	for (std::size_t i = 0; i < _keyValues.size(); ++i)
+	{
+		// The first of any keys differing in case only is the one being found
+		if (!_keyIndex.emplace(KeyRef{ &_keyValues[i].first.str() }, i).second)
+		{
+			_keyIndexHasHiddenKeys = true;
+		}
+	}
+}
+
+void SpawnArgs::removeFromKeyIndex(const std::string& key, std::size_t position)
+{
+	if (_keyValues.size() < MinKeysForIndex)
+	{
+		_keyIndex.clear();
+		_keyIndexHasHiddenKeys = false;
+		return;
+	}
+
+	auto found = _keyIndex.find(KeyRef{ &key });
+	bool erasedIndexedKey = found != _keyIndex.end() && found->second == position;
+
+	if (erasedIndexedKey)
+	{
+		_keyIndex.erase(found);
+	}
+
+	// All subsequent key values moved one slot towards the front
+	for (auto& pair : _keyIndex)
+	{
+		if (pair.second > position)
+		{
+			--pair.second;
+		}
+	}
+
+	// A key differing in case only might have been hidden by the erased one
+	if (erasedIndexedKey && _keyIndexHasHiddenKeys)
+	{
+		for (auto k = position; k < _keyValues.size(); ++k)
+		{
+			if (string::iequals(_keyValues[k].first, key))
+			{
+				_keyIndex.emplace(KeyRef{ &_keyValues[k].first.str() }, k);
+				break;
+			}
+		}
+	}
+}
+
 } // namespace entity
@@ -3,7 +3,10 @@
 #include "AttachmentData.h"
 
 #include <vector>
+#include <unordered_map>
 #include "KeyValue.h"
+#include "string/interned.h"
+#include "string/string.h"
 #include <memory>
 
 class IUndoSystem;
@@ -26,13 +29,49 @@ class SpawnArgs: public Entity
 
 	typedef std::shared_ptr<KeyValue> KeyValuePtr;
 
-	// A key value pair using a dynamically allocated value
-	typedef std::pair<std::string, KeyValuePtr> KeyValuePair;
+	// A key value pair using a dynamically allocated value, the keys
+	// are interned since the same few names are used by all entities
+	typedef std::pair<string::InternedString, KeyValuePtr> KeyValuePair;
 
 	// The unsorted list of KeyValue pairs
 	typedef std::vector<KeyValuePair> KeyValues;
 	KeyValues _keyValues;
 
+	// Reference to a spawnarg key, hashed and compared case-insensitively. The
+	// index refers to the interned keys, which never move, and lookups refer
+	// to the string being searched for, such that no key needs to be copied.
+	struct KeyRef
+	{
+		const std::string* key;
+	};
+
+	struct KeyRefHash
+	{
+		std::size_t operator()(const KeyRef& ref) const
+		{
+			return string::IHash()(*ref.key);
+		}
+	};
+
+	struct KeyRefEquals
+	{
+		bool operator()(const KeyRef& lhs, const KeyRef& rhs) const
+		{
+			return string::IEquals()(*lhs.key, *rhs.key);
+		}
+	};
+
+	// Case-insensitive index into _keyValues, speeding up the lookups on
+	// entities with many spawnargs. It's only filled on entities having at
+	// least MinKeysForIndex spawnargs, the other ones are scanned linearly.
+	typedef std::unordered_map<KeyRef, std::size_t, KeyRefHash, KeyRefEquals> KeyIndex;
+	KeyIndex _keyIndex;
+
+	// True if some keys differ in case only, the index refers to the first of these
+	bool _keyIndexHasHiddenKeys;
+
+	static constexpr std::size_t MinKeysForIndex = 16;
+
 	typedef std::set<Observer*> Observers;
 	Observers _observers;
 
@@ -92,7 +131,7 @@ private:
     void notifyChange(const std::string& k, const std::string& v);
 	void notifyErase(const std::string& key, KeyValue& value);
 
-	void insert(const std::string& key, const KeyValuePtr& keyValue);
+	void insert(const string::InternedString& key, const KeyValuePtr& keyValue);
 	void insert(const std::string& key, const std::string& value);
 
 	void erase(const KeyValues::iterator& i);
@@ -100,6 +139,12 @@ private:
 
 	KeyValues::iterator find(const std::string& key);
 	KeyValues::const_iterator find(const std::string& key) const;
+
+	// Rebuilds the key index from scratch
+	void rebuildKeyIndex();
+
+	// Updates the key index after the given key has been erased at the given position
+	void removeFromKeyIndex(const std::string& key, std::size_t position);
 };
 
 } // namespace entity
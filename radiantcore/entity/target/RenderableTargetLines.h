@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include "TargetKeyCollection.h"
 #include "render.h"
 #include "irenderable.h"
@@ -16,9 +17,14 @@ namespace
 
 /**
  * greebo: This is a helper object owned by the TargetableInstance.
- * It represents a RenderablePointVector which repopulates
- * itself each frame with the coordinates of the targeted
- * instances. It provides a render() method.
+ * It represents a RenderablePointVector holding the lines to all
+ * the targeted instances. It provides a render() method.
+ *
+ * The line geometry is cached and only recalculated if the owner has been
+ * moved or if the TargetKeyCollection reports a change of the targets
+ * (including movements of the targeted nodes). Each frame the cached lines
+ * are only tested against the view, the point vector is left untouched
+ * unless the set of visible lines has changed.
  *
  * The render() method is invoked by the TargetableNode during the
  * frontend render pass.
@@ -28,10 +34,32 @@ class RenderableTargetLines :
 {
 	const TargetKeyCollection& _targetKeys;
 
+	struct TargetLine
+	{
+		TargetPtr target;
+		Segment segment;
+
+		// Whether this line is part of the point vector
+		bool visible;
+	};
+
+	// The cached lines and their vertices (VerticesPerLine per line)
+	std::vector<TargetLine> _lines;
+	std::vector<VertexCb> _lineVertices;
+
+	// The state the cached lines have been calculated for
+	bool _linesValid;
+	std::size_t _revision;
+	Vector3 _worldPosition;
+
+	static constexpr std::size_t VerticesPerLine = 6;
+
 public:
 	RenderableTargetLines(const TargetKeyCollection& targetKeys) :
 		RenderablePointVector(GL_LINES),
-		_targetKeys(targetKeys)
+		_targetKeys(targetKeys),
+		_linesValid(false),
+		_revision(0)
 	{}
 
     bool hasTargets() const
@@ -46,24 +74,39 @@ public:
 			return;
 		}
 
-		// Clear the vector
-		clear();
+		bool pointsChanged = false;
 
-		// Populate the RenderablePointVector with all target coordinates
-        _targetKeys.forEachTarget([&] (const TargetPtr& target)
-        {
-            if (!target || target->isEmpty() || !target->isVisible())
-            {
-                return;
-            }
+		if (!_linesValid || _revision != _targetKeys.getRevision() || _worldPosition != worldPosition)
+		{
+			updateLines(worldPosition);
+			pointsChanged = true;
+		}
 
-            Vector3 targetPosition = target->getPosition();
+		// Check which of the lines are to be rendered in this view
+		for (auto& line : _lines)
+		{
+			bool visible = line.target->isVisible() && volume.TestLine(line.segment);
 
-            if (volume.TestLine(Segment::createForStartEnd(worldPosition, targetPosition)))
-            {
-                addTargetLine(worldPosition, targetPosition);
-            }
-        });
+			if (visible != line.visible)
+			{
+				line.visible = visible;
+				pointsChanged = true;
+			}
+		}
+
+		if (pointsChanged)
+		{
+			// Re-populate the RenderablePointVector with the visible lines
+			clear();
+
+			for (std::size_t i = 0; i < _lines.size(); ++i)
+			{
+				if (!_lines[i].visible) continue;
+
+				auto first = _lineVertices.begin() + i * VerticesPerLine;
+				_vector.insert(_vector.end(), first, first + VerticesPerLine);
+			}
+		}
 
 		// If we hold any objects now, add us as renderable
 		if (!empty())
@@ -73,7 +116,31 @@ public:
 	}
 
 private:
-    // Adds points to the vector, defining a line from start to end, with arrow indicators
+	// Calculates the lines to all non-empty targets
+	void updateLines(const Vector3& worldPosition)
+	{
+		_lines.clear();
+		_lineVertices.clear();
+
+		_targetKeys.forEachTarget([&] (const TargetPtr& target)
+		{
+			if (!target || target->isEmpty())
+			{
+				return;
+			}
+
+			Vector3 targetPosition = target->getPosition();
+
+			_lines.push_back(TargetLine{ target, Segment::createForStartEnd(worldPosition, targetPosition), false });
+			addTargetLine(worldPosition, targetPosition);
+		});
+
+		_linesValid = true;
+		_revision = _targetKeys.getRevision();
+		_worldPosition = worldPosition;
+	}
+
+    // Adds points to the cached vertices, defining a line from start to end, with arrow indicators
     // in the XY plane (located at the midpoint between start/end).
     void addTargetLine(const Vector3& startPosition, const Vector3& endPosition)
     {
@@ -110,15 +177,15 @@ private:
         Vector3 xyPoint2 = arrowBase - xyDir;
 
         // The line from this to the other entity
-        push_back(VertexCb(startPosition));
-        push_back(VertexCb(endPosition));
+        _lineVertices.push_back(VertexCb(startPosition));
+        _lineVertices.push_back(VertexCb(endPosition));
 
         // The "arrow indicators" in the xy plane
-        push_back(VertexCb(mid));
-        push_back(VertexCb(xyPoint1));
+        _lineVertices.push_back(VertexCb(mid));
+        _lineVertices.push_back(VertexCb(xyPoint1));
 
-        push_back(VertexCb(mid));
-        push_back(VertexCb(xyPoint2));
+        _lineVertices.push_back(VertexCb(mid));
+        _lineVertices.push_back(VertexCb(xyPoint2));
     }
 };
 
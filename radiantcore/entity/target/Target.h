@@ -1,5 +1,6 @@
 #pragma once
 
+#include <sigc++/signal.h>
 #include "inode.h"
 #include "ientity.h"
 #include "ilightnode.h"
@@ -21,6 +22,9 @@ namespace entity {
  * All Targets are owned by the TargetManager class.
  *
  * A Target can be referenced by one ore more TargetKey objects.
+ * These are connected to the changed signal of the Target, which is
+ * emitted when the Target is associated with another node or when
+ * the targeted node has been moved.
  */
 class Target :
     public ITargetableObject
@@ -28,8 +32,11 @@ class Target :
 	// The actual node this Target refers to (can be NULL)
 	const scene::INode* _node;
 
+	sigc::signal<void> _sigTargetChanged;
+
 public:
-	Target()
+	Target() :
+		_node(nullptr)
 	{}
 
 	Target(const scene::INode& node) :
@@ -42,6 +49,7 @@ public:
 
 	void setNode(const scene::INode& node) {
 		_node = &node;
+		_sigTargetChanged.emit();
 	}
 
 	bool isEmpty() const override {
@@ -54,6 +62,17 @@ public:
 
 	void clear() {
         _node = nullptr;
+		_sigTargetChanged.emit();
+	}
+
+	// Called by the targeted node when its position or bounds have changed
+	void onPositionChanged() {
+		_sigTargetChanged.emit();
+	}
+
+	// Emitted whenever the position of this target might have changed
+	sigc::signal<void>& signal_TargetChanged() {
+		return _sigTargetChanged;
 	}
 
 	// greebo: Returns the position of this target or <0,0,0> if empty
@@ -9,17 +9,22 @@ TargetKey::TargetKey(TargetKeyCollection& owner) :
     _owner(owner)
 {}
 
+TargetKey::~TargetKey()
+{
+    _targetChangedConn.disconnect();
+}
+
 void TargetKey::onTargetManagerChanged()
 {
     ITargetManager* manager = _owner.getTargetManager();
 
     if (manager == nullptr)
     {
-        _target.reset();
+        setTarget(TargetPtr());
         return;
     }
 
-    _target = std::static_pointer_cast<Target>(manager->getTarget(_curValue));
+    setTarget(std::static_pointer_cast<Target>(manager->getTarget(_curValue)));
     assert(_target);
 }
 
@@ -50,9 +55,29 @@ void TargetKey::onKeyValueChanged(const std::string& newValue)
     {
         // If we have a target manager, acquire the Target right away
         // Acquire the Target object (will be created if nonexistent)
-        _target = std::static_pointer_cast<Target>(targetManager->getTarget(_curValue));
+        setTarget(std::static_pointer_cast<Target>(targetManager->getTarget(_curValue)));
         assert(_target);
     }
 }
 
+void TargetKey::setTarget(const TargetPtr& target)
+{
+    if (target == _target)
+    {
+        return;
+    }
+
+    _targetChangedConn.disconnect();
+
+    _target = target;
+
+    if (_target)
+    {
+        _targetChangedConn = _target->signal_TargetChanged().connect(
+            sigc::mem_fun(_owner, &TargetKeyCollection::onTargetChanged));
+    }
+
+    _owner.onTargetChanged();
+}
+
 } // namespace entity
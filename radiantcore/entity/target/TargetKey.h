@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ientity.h"
+#include <sigc++/connection.h>
 
 #include "Target.h"
 
@@ -18,7 +19,9 @@ class TargetKeyCollection;
  * multiple instances of this TargetKey class. They are stored in and
  * maintainted by the TargetKeyCollection container.
  *
- * Note: Each TargetKey instance can only refer to one Target.
+ * Note: Each TargetKey instance can only refer to one Target. It is connected
+ * to the Target's changed signal to let the owning collection know when
+ * the target lines need to be updated.
  */
 class TargetKey :
 	public KeyObserver
@@ -30,9 +33,18 @@ private:
 
 	// The target this key is pointing to (can be empty)
 	TargetPtr _target;
+
+	sigc::connection _targetChangedConn;
+
 public:
     TargetKey(TargetKeyCollection& owner);
 
+    // Not copyable, the signal connection refers to the owning collection
+    TargetKey(const TargetKey& other) = delete;
+    TargetKey& operator=(const TargetKey& other) = delete;
+
+    ~TargetKey();
+
 	// Accessor method for the contained TargetPtr
     const TargetPtr& getTarget() const;
 
@@ -47,6 +59,10 @@ public:
 
 	// This gets called as soon as the "target" key in the spawnargs changes
 	void onKeyValueChanged(const std::string& newValue) override;
+
+private:
+    // Points this key to the given target (which can be null)
+    void setTarget(const TargetPtr& target);
 };
 
 } // namespace entity
@@ -6,7 +6,8 @@
 namespace entity {
 
 TargetKeyCollection::TargetKeyCollection(TargetableNode& owner) :
-    _owner(owner)
+    _owner(owner),
+    _revision(0)
 {}
 
 ITargetManager* TargetKeyCollection::getTargetManager()
@@ -24,7 +25,7 @@ void TargetKeyCollection::onTargetManagerChanged()
 
 void TargetKeyCollection::forEachTarget(const std::function<void(const TargetPtr&)>& func) const
 {
-	for (auto pair : _targetKeys)
+	for (const auto& pair : _targetKeys)
 	{
 		func(pair.second.getTarget());
 	}
@@ -35,6 +36,16 @@ bool TargetKeyCollection::empty() const
 	return _targetKeys.empty();
 }
 
+void TargetKeyCollection::onTargetChanged()
+{
+    ++_revision;
+}
+
+std::size_t TargetKeyCollection::getRevision() const
+{
+    return _revision;
+}
+
 bool TargetKeyCollection::isTargetKey(const std::string& key) 
 {
 	// A key is a target key if it starts with "target" (any case)
@@ -50,9 +61,10 @@ void TargetKeyCollection::onKeyInsert(const std::string& key, EntityKeyValue& va
 		return;
 	}
 
-	TargetKeyMap::iterator i = _targetKeys.insert(std::make_pair(key, TargetKey(*this))).first;
+	TargetKeyMap::iterator i = _targetKeys.emplace(key, *this).first;
 
 	i->second.attachToKeyValue(value);
+	onTargetChanged();
 
     // Notify the owning node to create the TargetLineNode
     _owner.onTargetKeyCollectionChanged();
@@ -76,6 +88,7 @@ void TargetKeyCollection::onKeyErase(const std::string& key, EntityKeyValue& val
 
 	// Remove the found element
 	_targetKeys.erase(i);
+	onTargetChanged();
 
     // Notify the owner to destruct the target line node
     _owner.onTargetKeyCollectionChanged();
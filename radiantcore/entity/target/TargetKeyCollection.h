@@ -18,6 +18,9 @@ private:
 	typedef std::map<std::string, TargetKey> TargetKeyMap;
 	TargetKeyMap _targetKeys;
 
+	// Incremented each time a target key or one of the targets has changed
+	std::size_t _revision;
+
 public:
     TargetKeyCollection(TargetableNode& owner);
 
@@ -42,6 +45,14 @@ public:
 	// Returns TRUE if there are no "target" keys observed
 	bool empty() const;
 
+	// Invoked by the TargetKeys when they point to a different Target,
+	// or when one of the Targets has been moved or re-associated
+	void onTargetChanged();
+
+	// Returns a number changing each time the set of targets or any of their
+	// positions has changed, to allow the target lines to be cached
+	std::size_t getRevision() const;
+
 private:
 	// Returns TRUE if the given key matches the pattern for target keys
 	bool isTargetKey(const std::string& key);
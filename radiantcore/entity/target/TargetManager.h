@@ -1,7 +1,7 @@
 #pragma once
 
-#include <map>
 #include <string>
+#include <unordered_map>
 #include "ientity.h"
 #include "Target.h"
 
@@ -16,8 +16,9 @@ class TargetManager :
     public ITargetManager
 {
 private:
-	// The list of all named Target objects
-	typedef std::map<std::string, TargetPtr> TargetList;
+	// The list of all named Target objects, hashed by name since it is
+	// queried each time a "name" or "target" spawnarg is changed
+	typedef std::unordered_map<std::string, TargetPtr> TargetList;
 	TargetList _targets;
 
 	// An empty Target (this is returned if an empty name is requested)
@@ -43,28 +43,14 @@ const TargetKeyCollection& TargetableNode::getTargetKeys() const
 // Gets called as soon as the "name" keyvalue changes
 void TargetableNode::onKeyValueChanged(const std::string& name)
 {
-	// Check if we were registered before
-    if (!_targetName.empty() && _targetManager)
-    {
-		// Old name is not empty
-		// Tell the Manager to disassociate us from the target
-        _targetManager->clearTarget(_targetName, _node);
-	}
+	// Tell the Manager to disassociate us from the old target
+	clearTarget();
 
 	// Store the new name, in any case
 	_targetName = name;
 
-	if (_targetName.empty())
-    {
-		// New name is empty, do not associate
-		return;
-	}
-
 	// Tell the TargetManager to associate the name with this scene::INode here
-    if (_targetManager)
-    {
-        _targetManager->associateTarget(_targetName, _node);
-    }
+	associateTarget();
 }
 
 // Entity::Observer implementation, gets called on key insert
@@ -92,10 +78,7 @@ void TargetableNode::onInsertIntoScene(scene::IMapRootNode& root)
     _targetManager = &root.getTargetManager();
 
     // Now that we're in the scene, register this name if we have one already
-    if (!_targetName.empty() && _targetManager)
-    {
-        _targetManager->associateTarget(_targetName, _node);
-    }
+    associateTarget();
 
     // Notify the underlying key collection to reacquire their targets
     _targetKeys.onTargetManagerChanged();
@@ -104,10 +87,7 @@ void TargetableNode::onInsertIntoScene(scene::IMapRootNode& root)
 void TargetableNode::onRemoveFromScene(scene::IMapRootNode& root)
 {
     // On scene removal, unregister this name if we have one
-    if (!_targetName.empty() && _targetManager)
-    {
-        _targetManager->clearTarget(_targetName, _node);
-    }
+    clearTarget();
 
     _targetManager = nullptr;
 
@@ -143,4 +123,38 @@ void TargetableNode::onTargetKeyCollectionChanged()
     }
 }
 
+void TargetableNode::onBoundsChanged()
+{
+    if (_target)
+    {
+        _target->onPositionChanged();
+    }
+}
+
+void TargetableNode::associateTarget()
+{
+    if (_targetName.empty() || !_targetManager)
+    {
+        return;
+    }
+
+    _targetManager->associateTarget(_targetName, _node);
+
+    // The name might be associated with a different node already
+    auto target = std::static_pointer_cast<Target>(_targetManager->getTarget(_targetName));
+    const scene::INode& node = _node;
+
+    _target = target->getNode() == &node ? target : TargetPtr();
+}
+
+void TargetableNode::clearTarget()
+{
+    if (!_targetName.empty() && _targetManager)
+    {
+        _targetManager->clearTarget(_targetName, _node);
+    }
+
+    _target.reset();
+}
+
 } // namespace entity
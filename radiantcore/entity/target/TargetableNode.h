@@ -41,6 +41,10 @@ class TargetableNode :
     // The targetmanager of the map we're in (is nullptr if not in the scene)
     ITargetManager* _targetManager;
 
+    // The Target associated with this node's name (is empty if the name
+    // is not associated with this node)
+    TargetPtr _target;
+
     // The actual scene representation rendering the lines
     TargetLineNodePtr _targetLineNode;
 
@@ -72,6 +76,17 @@ public:
 
     // Invoked by the TargetKeyCollection when the number of observed has changed
     void onTargetKeyCollectionChanged();
+
+    // Invoked by the owning node when its bounds have changed, this notifies
+    // the entities targeting this one
+    void onBoundsChanged();
+
+private:
+    // Associates our name with this node and remembers the Target
+    void associateTarget();
+
+    // Disassociates the name from this node
+    void clearTarget();
 };
 
 } // namespace entity
@@ -1,5 +1,6 @@
 #include "BasicFilterSystem.h"
 
+#include <algorithm>
 #include <functional>
 
 #include "iradiant.h"
@@ -8,6 +9,8 @@
 #include "iregistry.h"
 #include "igame.h"
 #include "ishaders.h"
+#include "ieclass.h"
+#include "ientity.h"
 
 #include "module/StaticModule.h"
 #include "InstanceUpdateWalker.h"
@@ -28,6 +31,9 @@ namespace
 
 	// Registry key for persistent filter setting
 	const std::string RKEY_USER_ACTIVE_FILTERS = RKEY_USER_FILTER_BASE + "//activeFilter";
+
+	// The keyvalue cache is started over when it reaches this size
+	const std::size_t MAX_KEYVALUE_CACHE_SIZE = 8192;
 }
 
 void BasicFilterSystem::setAllFilterStates(bool state)
@@ -43,7 +49,7 @@ void BasicFilterSystem::setAllFilterStates(bool state)
 
 	// Invalidate the visibility cache to force new values to be
 	// loaded from the filters themselves
-	_visibilityCache.clear();
+	invalidateVisibilityCache();
 
 	// Update the scenegraph instances
 	update();
@@ -251,6 +257,9 @@ void BasicFilterSystem::addFiltersFromXML(const xml::NodeList& nodes, bool readO
 			_activeFilters.emplace(filterName, inserted);
 		}
 	}
+
+	// The active rules might have changed
+	invalidateVisibilityCache();
 }
 
 XmlFilterEventAdapter::Ptr BasicFilterSystem::ensureEventAdapter(XMLFilter& filter)
@@ -323,10 +332,10 @@ void BasicFilterSystem::shutdownModule()
 		}
 	}
 
-	_visibilityCache.clear();
 	_eventAdapters.clear();
 	_activeFilters.clear();
 	_availableFilters.clear();
+	invalidateVisibilityCache();
 
 	_filterCollectionChangedSignal.clear();
 	_filterConfigChangedSignal.clear();
@@ -391,7 +400,7 @@ void BasicFilterSystem::setFilterState(const std::string& filter, bool state)
 
 	// Invalidate the visibility cache to force new values to be
 	// loaded from the filters themselves
-	_visibilityCache.clear();
+	invalidateVisibilityCache();
 
 	// Update the scenegraph instances
 	update();
@@ -462,7 +471,7 @@ bool BasicFilterSystem::removeFilter(const std::string& filter)
 	if (wasActive)
 	{
 		// Clear the cache, the rules have changed
-		_visibilityCache.clear();
+		invalidateVisibilityCache();
 
 		_filterConfigChangedSignal.emit();
 
@@ -571,6 +580,82 @@ bool BasicFilterSystem::isVisible(const FilterRule::Type type, const std::string
 
 bool BasicFilterSystem::isEntityVisible(const FilterRule::Type type, const Entity& entity)
 {
+	if (type == FilterRule::TYPE_ENTITYCLASS)
+	{
+		const std::string& eclassName = entity.getEntityClass()->getName();
+
+		auto cacheIter = _entityClassVisibilityCache.find(eclassName);
+
+		if (cacheIter != _entityClassVisibilityCache.end())
+		{
+			return cacheIter->second;
+		}
+
+		bool visFlag = true;
+
+		for (const auto& active : _activeFilters)
+		{
+			if (!active.second->isVisible(type, eclassName))
+			{
+				visFlag = false;
+				break;
+			}
+		}
+
+		_entityClassVisibilityCache.emplace(eclassName, visFlag);
+
+		return visFlag;
+	}
+
+	if (type == FilterRule::TYPE_ENTITYKEYVALUE)
+	{
+		// No keyvalue rules, no need to look at the spawnargs
+		if (_filteredEntityKeys.empty())
+		{
+			return true;
+		}
+
+		// Entities sharing the values of all filtered spawnargs share the same result
+		std::string cacheKey;
+
+		for (const auto& key : _filteredEntityKeys)
+		{
+			std::string value = entity.getKeyValue(key);
+
+			cacheKey += std::to_string(value.size());
+			cacheKey += ':';
+			cacheKey += value;
+		}
+
+		auto cacheIter = _entityKeyValueVisibilityCache.find(cacheKey);
+
+		if (cacheIter != _entityKeyValueVisibilityCache.end())
+		{
+			return cacheIter->second;
+		}
+
+		bool visFlag = true;
+
+		for (const auto& active : _activeFilters)
+		{
+			if (!active.second->isEntityVisible(type, entity))
+			{
+				visFlag = false;
+				break;
+			}
+		}
+
+		// Spawnarg values are arbitrary, don't let the cache grow without limits
+		if (_entityKeyValueVisibilityCache.size() >= MAX_KEYVALUE_CACHE_SIZE)
+		{
+			_entityKeyValueVisibilityCache.clear();
+		}
+
+		_entityKeyValueVisibilityCache.emplace(std::move(cacheKey), visFlag);
+
+		return visFlag;
+	}
+
 	// Otherwise, walk the list of active filters to find a value for
 	// this item.
 	bool visFlag = true; // default if no filters modify it
@@ -590,6 +675,28 @@ bool BasicFilterSystem::isEntityVisible(const FilterRule::Type type, const Entit
 	return visFlag;
 }
 
+void BasicFilterSystem::invalidateVisibilityCache()
+{
+	_visibilityCache.clear();
+	_entityClassVisibilityCache.clear();
+	_entityKeyValueVisibilityCache.clear();
+
+	// Collect the spawnargs the keyvalue rules are looking at
+	_filteredEntityKeys.clear();
+
+	for (const auto& active : _activeFilters)
+	{
+		for (const auto& rule : active.second->getRuleSet())
+		{
+			if (rule.type == FilterRule::TYPE_ENTITYKEYVALUE &&
+				std::find(_filteredEntityKeys.begin(), _filteredEntityKeys.end(), rule.entityKey) == _filteredEntityKeys.end())
+			{
+				_filteredEntityKeys.push_back(rule.entityKey);
+			}
+		}
+	}
+}
+
 FilterRules BasicFilterSystem::getRuleSet(const std::string& filter)
 {
 	auto f = _availableFilters.find(filter);
@@ -607,7 +714,7 @@ bool BasicFilterSystem::setFilterRules(const std::string& filter, const FilterRu
 		f->second->setRules(ruleSet);
 
 		// Clear the cache, the ruleset has changed
-		_visibilityCache.clear();
+		invalidateVisibilityCache();
 
 		_filterConfigChangedSignal.emit();
 
@@ -621,6 +728,10 @@ bool BasicFilterSystem::setFilterRules(const std::string& filter, const FilterRu
 
 void BasicFilterSystem::updateSubgraph(const scene::INodePtr& root) 
 {
+	// Start every pass with an empty keyvalue cache, such that it only holds
+	// the spawnarg values of the nodes that are still around
+	_entityKeyValueVisibilityCache.clear();
+
 	// Construct an InstanceUpdateWalker and traverse the scenegraph to update
 	// all instances
 	InstanceUpdateWalker walker(*this);
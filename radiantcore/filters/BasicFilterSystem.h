@@ -5,6 +5,7 @@
 #include "icommandsystem.h"
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -31,9 +32,18 @@ private:
 
 	// Cache of visibility flags for item names, to avoid having to
 	// traverse the active filter list for each lookup
-	typedef std::map<std::string, bool> StringFlagCache;
+	typedef std::unordered_map<std::string, bool> StringFlagCache;
 	StringFlagCache _visibilityCache;
 
+	// Entity visibility flags, by entity class name and by the values of the
+	// spawnargs the active keyvalue rules are looking at. The latter is
+	// cleared on every filter pass and limited in size.
+	StringFlagCache _entityClassVisibilityCache;
+	StringFlagCache _entityKeyValueVisibilityCache;
+
+	// The spawnargs referenced by the keyvalue rules of the active filters
+	std::vector<std::string> _filteredEntityKeys;
+
     sigc::signal<void> _filterConfigChangedSignal;
     sigc::signal<void> _filterCollectionChangedSignal;
 
@@ -48,6 +58,9 @@ private:
 
 	void updateShaders();
 
+	// Clears the cached visibility flags, to be called when the active rules change
+	void invalidateVisibilityCache();
+
 	void addFiltersFromXML(const xml::NodeList& nodes, bool readOnly);
 
 	XmlFilterEventAdapter::Ptr ensureEventAdapter(XMLFilter& filter);
@@ -5,6 +5,7 @@
 #include "iselectable.h"
 #include "ipatch.h"
 #include "ibrush.h"
+#include <vector>
 
 namespace filters 
 {
@@ -43,6 +44,10 @@ public:
 /**
  * Scenegraph walker to update filtered status of nodes based on the
  * currently active set of filters.
+ *
+ * Entities, brushes and patches are evaluated against the filters, all other
+ * nodes inherit the status of the closest evaluated parent. Every node is
+ * visited only once, the subgraphs of visible entities are not walked twice.
  */
 class InstanceUpdateWalker :
 	public scene::NodeVisitor
@@ -59,6 +64,16 @@ private:
 	bool _patchesAreVisible;
 	bool _brushesAreVisible;
 
+	enum class Status
+	{
+		Unknown, // no evaluated parent node
+		Visible,
+		Hidden,
+	};
+
+	// The status of the nodes on the current path
+	std::vector<Status> _statusStack;
+
 public:
 	InstanceUpdateWalker(IFilterSystem& filterSystem) :
 		_filterSystem(filterSystem),
@@ -75,10 +90,18 @@ public:
 		{
 			bool isVisible = evaluateEntity(node);
 
-			setSubgraphFilterStatus(node, isVisible);
+			if (!isVisible)
+			{
+				// Hide the whole subgraph, don't traverse its child nodes
+				setSubgraphFilterStatus(node, false);
+				_statusStack.push_back(Status::Hidden);
+				return false;
+			}
 
-			// If the entity is hidden, don't traverse its child nodes
-			return isVisible;
+			// The child nodes are updated during the traversal
+			node->setFiltered(false);
+			_statusStack.push_back(Status::Visible);
+			return true;
 		}
 
 		// greebo: Check visibility of Patches
@@ -87,6 +110,7 @@ public:
 			bool isVisible = evaluatePatch(node);
 
 			setSubgraphFilterStatus(node, isVisible);
+			_statusStack.push_back(isVisible ? Status::Visible : Status::Hidden);
 		}
 		// greebo: Check visibility of Brushes
 		else if (Node_isBrush(node))
@@ -94,6 +118,7 @@ public:
 			bool isVisible = evaluateBrush(node);
 
 			setSubgraphFilterStatus(node, isVisible);
+			_statusStack.push_back(isVisible ? Status::Visible : Status::Hidden);
 
 			// In case the brush has at least one visible material trigger a fine-grained update
 			if (isVisible)
@@ -101,11 +126,33 @@ public:
 				Node_getIBrush(node)->updateFaceVisibility();
 			}
 		}
+		else
+		{
+			// Any other node inherits the status of its parent
+			Status status = _statusStack.empty() ? Status::Unknown : _statusStack.back();
+
+			if (status == Status::Visible)
+			{
+				node->setFiltered(false);
+			}
+			else if (status == Status::Hidden)
+			{
+				node->setFiltered(true);
+				Node_setSelected(node, false);
+			}
+
+			_statusStack.push_back(status);
+		}
 
 		// Continue the traversal
 		return true;
 	}
 
+	void post(const scene::INodePtr& node) override
+	{
+		_statusStack.pop_back();
+	}
+
 private:
 	bool evaluateEntity(const scene::INodePtr& node)
 	{
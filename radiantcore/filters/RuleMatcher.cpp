@@ -0,0 +1,202 @@
+#include "RuleMatcher.h"
+
+#include <cctype>
+#include <cstring>
+#include "itextstream.h"
+
+namespace filters
+{
+
+namespace
+{
+	// Characters having a special meaning in ECMAScript regular expressions
+	const char* const REGEX_SPECIAL_CHARACTERS = "\\^$.|?*+()[]{}";
+
+	inline bool isSpecialCharacter(char c)
+	{
+		return c != '\0' && std::strchr(REGEX_SPECIAL_CHARACTERS, c) != nullptr;
+	}
+
+	inline bool startsWith(const std::string& expression, std::size_t pos, const char* token)
+	{
+		return expression.compare(pos, std::strlen(token), token) == 0;
+	}
+}
+
+RuleMatcher::RuleMatcher(const std::string& expression) :
+	_leadingWildcard(false),
+	_trailingWildcard(false),
+	_isWildcardPattern(false),
+	_invalid(false)
+{
+	try
+	{
+		_regex = std::make_shared<std::regex>(expression);
+	}
+	catch (const std::regex_error& ex)
+	{
+		rWarning() << "Invalid filter expression " << expression << ": " << ex.what() << std::endl;
+		_invalid = true;
+		return;
+	}
+
+	_isWildcardPattern = parseWildcardPattern(expression);
+
+	if (!_isWildcardPattern)
+	{
+		_literals.clear();
+	}
+}
+
+bool RuleMatcher::parseWildcardPattern(const std::string& expression)
+{
+	std::string literal;
+	bool lastWasWildcard = false;
+
+	std::size_t pos = 0;
+
+	// Anchors are implied by the full match
+	if (startsWith(expression, pos, "^"))
+	{
+		++pos;
+	}
+
+	std::size_t end = expression.size();
+
+	if (end > pos && expression[end - 1] == '$' && (end < 2 || expression[end - 2] != '\\'))
+	{
+		--end;
+	}
+
+	while (pos < end)
+	{
+		std::size_t wildcardLength = startsWith(expression, pos, ".*") ? 2 :
+			startsWith(expression, pos, "(.*)") ? 4 : 0;
+
+		if (wildcardLength > 0 && pos + wildcardLength <= end)
+		{
+			if (_literals.empty() && literal.empty() && !lastWasWildcard)
+			{
+				_leadingWildcard = true;
+			}
+			else if (!literal.empty())
+			{
+				_literals.push_back(literal);
+				literal.clear();
+			}
+
+			lastWasWildcard = true;
+			pos += wildcardLength;
+			continue;
+		}
+
+		char c = expression[pos];
+
+		if (c == '\\')
+		{
+			// Escaped punctuation is matched literally, anything else is a character class
+			if (pos + 1 >= end || std::isalnum(static_cast<unsigned char>(expression[pos + 1])))
+			{
+				return false;
+			}
+
+			c = expression[pos + 1];
+			pos += 2;
+		}
+		else if (isSpecialCharacter(c))
+		{
+			return false;
+		}
+		else
+		{
+			++pos;
+		}
+
+		// A literal following a wildcard is stored separately
+		lastWasWildcard = false;
+		literal += c;
+	}
+
+	if (lastWasWildcard)
+	{
+		_trailingWildcard = true;
+	}
+
+	if (!literal.empty() || _literals.empty())
+	{
+		_literals.push_back(literal);
+	}
+
+	return true;
+}
+
+bool RuleMatcher::matches(const std::string& str) const
+{
+	if (_invalid)
+	{
+		return false;
+	}
+
+	// No wildcards, this needs to be an exact match
+	if (_isWildcardPattern && !_leadingWildcard && !_trailingWildcard && _literals.size() == 1)
+	{
+		return str == _literals.front();
+	}
+
+	// The ".*" wildcard doesn't match line terminators, leave these strings to the regex
+	if (!_isWildcardPattern || str.find_first_of("\r\n") != std::string::npos)
+	{
+		return std::regex_match(str, *_regex);
+	}
+
+	std::size_t first = 0;
+	std::size_t last = _literals.size();
+
+	std::size_t begin = 0;
+	std::size_t end = str.size();
+
+	// The first and last literal are anchored unless there's a wildcard
+	if (!_leadingWildcard)
+	{
+		const std::string& prefix = _literals.front();
+
+		if (str.compare(0, prefix.size(), prefix) != 0)
+		{
+			return false;
+		}
+
+		begin = prefix.size();
+		++first;
+	}
+
+	if (!_trailingWildcard && last > first)
+	{
+		const std::string& suffix = _literals.back();
+
+		if (suffix.size() > end - begin || str.compare(end - suffix.size(), suffix.size(), suffix) != 0)
+		{
+			return false;
+		}
+
+		end -= suffix.size();
+		--last;
+	}
+
+	// The remaining literals need to be found in this order in between
+	for (std::size_t i = first; i < last; ++i)
+	{
+		const std::string& literal = _literals[i];
+		std::size_t found = str.find(literal, begin);
+
+		if (found == std::string::npos || found + literal.size() > end)
+		{
+			return false;
+		}
+
+		begin = found + literal.size();
+	}
+
+	return true;
+}
+
+}
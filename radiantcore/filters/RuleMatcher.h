@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace filters
+{
+
+/**
+ * Compiled form of the match expression of a filter rule. The expressions are
+ * regular expressions which need to match the whole tested string. Most of them
+ * are plain names or names with ".*" wildcards, these are matched without
+ * going through std::regex. Everything else uses a std::regex compiled once.
+ */
+class RuleMatcher
+{
+private:
+	// The literal parts of the expression, separated by wildcards
+	std::vector<std::string> _literals;
+
+	// Whether the expression starts or ends with a wildcard
+	bool _leadingWildcard;
+	bool _trailingWildcard;
+
+	// True if the expression consists of literals and wildcards only
+	bool _isWildcardPattern;
+
+	// The compiled expression, used for anything else
+	std::shared_ptr<std::regex> _regex;
+
+	// True if the expression failed to compile, nothing will match
+	bool _invalid;
+
+public:
+	RuleMatcher(const std::string& expression);
+
+	// Returns true if the expression matches the whole given string
+	bool matches(const std::string& str) const;
+
+private:
+	// Tries to split the expression into literals and wildcards
+	bool parseWildcardPattern(const std::string& expression);
+};
+
+}
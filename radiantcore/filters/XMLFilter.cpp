@@ -3,7 +3,6 @@
 #include "ientity.h"
 #include "ieclass.h"
 #include "ifilter.h"
-#include <regex>
 #include <algorithm>
 
 namespace filters
@@ -25,24 +24,20 @@ bool XMLFilter::isVisible(const FilterRule::Type type, const std::string& name)
 
 	bool visible = true; // default if unmodified by rules
 
-	for (FilterRules::const_iterator ruleIter = _rules.begin();
-		 ruleIter != _rules.end();
-		 ++ruleIter)
+	for (std::size_t i = 0; i < _rules.size(); ++i)
 	{
 		// Check the item type.
-		if (ruleIter->type != type)
+		if (_rules[i].type != type)
 		{
 			continue;
 		}
 
-		// If we have a rule for this item, use a regex to match the query name
-		// against the "match" parameter
-		std::regex ex(ruleIter->match);
-
-		if (std::regex_match(name, ex))
+		// If we have a rule for this item, match the query name
+		// against the compiled "match" parameter
+		if (_matchers[i].matches(name))
 		{
 			// Overwrite the visible flag with the value from the rule.
-			visible = ruleIter->show;
+			visible = _rules[i].show;
 		}
 	}
 
@@ -52,36 +47,23 @@ bool XMLFilter::isVisible(const FilterRule::Type type, const std::string& name)
 
 bool XMLFilter::isEntityVisible(const FilterRule::Type type, const Entity& entity) const
 {
+	if (type == FilterRule::TYPE_ENTITYCLASS)
+	{
+		return isVisible(type, entity.getEntityClass()->getName());
+	}
+
 	bool visible = true; // default if unmodified by rules
 
-	IEntityClassConstPtr eclass = entity.getEntityClass();
-	
-	for (FilterRules::const_iterator ruleIter = _rules.begin();
-		 ruleIter != _rules.end();
-		 ++ruleIter)
+	if (type != FilterRule::TYPE_ENTITYKEYVALUE)
 	{
-		if (ruleIter->type != type)
-		{
-			continue;
-		}
-
-		if (type == FilterRule::TYPE_ENTITYCLASS)
-		{
-			std::regex ex(ruleIter->match);
+		return visible;
+	}
 
-			if (std::regex_match(eclass->getName(), ex))
-			{
-				visible = ruleIter->show;
-			}
-		}
-		else if (type == FilterRule::TYPE_ENTITYKEYVALUE)
+	for (std::size_t i = 0; i < _rules.size(); ++i)
+	{
+		if (_rules[i].type == type && _matchers[i].matches(entity.getKeyValue(_rules[i].entityKey)))
 		{
-			std::regex ex(ruleIter->match);
-
-			if (std::regex_match(entity.getKeyValue(ruleIter->entityKey), ex))
-			{
-				visible = ruleIter->show;
-			}
+			visible = _rules[i].show;
 		}
 	}
 
@@ -116,6 +98,15 @@ const FilterRules& XMLFilter::getRuleSet() const
 
 void XMLFilter::setRules(const FilterRules& rules) {
 	_rules = rules;
+
+	// Compile the match expressions once, instead of on every query
+	_matchers.clear();
+	_matchers.reserve(_rules.size());
+
+	for (const auto& rule : _rules)
+	{
+		_matchers.emplace_back(rule.match);
+	}
 }
 
 void XMLFilter::updateEventName() {
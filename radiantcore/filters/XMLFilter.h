@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include "ifilter.h"
+#include "RuleMatcher.h"
 
 namespace filters
 {
@@ -24,6 +25,9 @@ private:
 	// Ordered list of rule objects
 	FilterRules _rules;
 
+	// The compiled match expression of each rule, same order as _rules
+	std::vector<RuleMatcher> _matchers;
+
 	// True if this filter can't be changed
 	bool _readonly;
 
@@ -55,6 +59,7 @@ public:
 	void addRule(const FilterRule::Type type, const std::string& match, bool show)
 	{
 		_rules.push_back(FilterRule::Create(type, match, show));
+		_matchers.emplace_back(match);
 	}
 
 	/** Add an entitykeyvalue rule to this filter.
@@ -72,6 +77,7 @@ public:
 	void addEntityKeyValueRule(const std::string& key, const std::string& match, bool show)
 	{
 		_rules.push_back(FilterRule::CreateEntityKeyValueRule(key, match, show));
+		_matchers.emplace_back(match);
 	}
 
 	/** Test a given item for visibility against all of the rules
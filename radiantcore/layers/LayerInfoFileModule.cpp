@@ -8,6 +8,7 @@
 #include "string/convert.h"
 #include "debugging/ScenegraphUtils.h"
 #include "parser/DefTokeniser.h"
+#include "stream/utils.h"
 
 namespace scene
 {
@@ -41,6 +42,9 @@ void LayerInfoFileModule::clear()
 
 	_layerNames.clear();
 	_layerMappings.clear();
+
+	_nodeLayerCounts.clear();
+	_nodeLayerIds.clear();
 }
 
 void LayerInfoFileModule::onInfoFileSaveStart()
@@ -58,6 +62,8 @@ void LayerInfoFileModule::onBeginSaveMap(const scene::IMapRootNodePtr& root)
 	root->getLayerManager().foreachLayer([&](int layerId, const std::string& layerName)
 	{
 		_layerNameBuffer << "\t\t" << LAYER << " " << layerId << " { " << layerName << " }" << std::endl;
+
+		_layerNames.insert(LayerNameMap::value_type(layerId, layerName));
 	});
 
 	_layerNameBuffer << "\t}" << std::endl;
@@ -91,8 +97,11 @@ void LayerInfoFileModule::saveNode(const INodePtr& node)
 	for (const scene::LayerList::value_type& i : layers)
 	{
 		_output << i << " ";
+		_nodeLayerIds.push_back(i);
 	}
 
+	_nodeLayerCounts.push_back(static_cast<std::uint32_t>(layers.size()));
+
 	// Close the Node block
 	_output << "}";
 
@@ -125,6 +134,25 @@ void LayerInfoFileModule::writeBlocks(std::ostream& stream)
 	rMessage() << _layerInfoCount << " node-to-layer mappings written." << std::endl;
 }
 
+bool LayerInfoFileModule::writeBinaryBlock(std::ostream& stream)
+{
+	stream::writeLittleEndian<std::uint32_t>(stream, static_cast<std::uint32_t>(_layerNames.size()));
+
+	for (const auto& pair : _layerNames)
+	{
+		stream::writeLittleEndian<std::int32_t>(stream, pair.first);
+		stream::writeLengthPrefixedString(stream, pair.second);
+	}
+
+	stream::writeLittleEndian<std::uint64_t>(stream, _nodeLayerCounts.size());
+	stream::writeLittleEndianArray(stream, _nodeLayerCounts);
+
+	stream::writeLittleEndian<std::uint64_t>(stream, _nodeLayerIds.size());
+	stream::writeLittleEndianArray(stream, _nodeLayerIds);
+
+	return true;
+}
+
 void LayerInfoFileModule::onInfoFileSaveFinished()
 {
 	clear();
@@ -154,6 +182,62 @@ void LayerInfoFileModule::parseBlock(const std::string& blockName, parser::DefTo
 	}
 }
 
+bool LayerInfoFileModule::readBinaryBlock(std::istream& stream)
+{
+	std::uint32_t layerCount = 0;
+
+	if (!stream::readLittleEndian(stream, layerCount))
+	{
+		return false;
+	}
+
+	for (std::uint32_t i = 0; i < layerCount; ++i)
+	{
+		std::int32_t layerId = 0;
+		std::string name;
+
+		if (!stream::readLittleEndian(stream, layerId) || !stream::readLengthPrefixedString(stream, name))
+		{
+			return false;
+		}
+
+		_layerNames.insert(LayerNameMap::value_type(layerId, name));
+	}
+
+	std::uint64_t nodeCount = 0;
+	std::uint64_t idCount = 0;
+	std::vector<std::uint32_t> nodeLayerCounts;
+	std::vector<std::int32_t> nodeLayerIds;
+
+	if (!stream::readLittleEndian(stream, nodeCount) ||
+		!stream::readLittleEndianArray(stream, nodeLayerCounts, static_cast<std::size_t>(nodeCount)) ||
+		!stream::readLittleEndian(stream, idCount) ||
+		!stream::readLittleEndianArray(stream, nodeLayerIds, static_cast<std::size_t>(idCount)))
+	{
+		return false;
+	}
+
+	_layerMappings.reserve(nodeLayerCounts.size());
+
+	auto id = nodeLayerIds.begin();
+
+	for (auto count : nodeLayerCounts)
+	{
+		if (static_cast<std::size_t>(nodeLayerIds.end() - id) < count)
+		{
+			return false;
+		}
+
+		_layerMappings.emplace_back(id, id + count);
+		id += count;
+	}
+
+	rMessage() << "[InfoFile]: Loaded " << _layerNames.size() << " layers and "
+		<< _layerMappings.size() << " node-to-layer mappings" << std::endl;
+
+	return true;
+}
+
 void LayerInfoFileModule::parseLayerNames(parser::DefTokeniser& tok)
 {
 	// The opening brace
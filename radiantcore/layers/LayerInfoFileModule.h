@@ -1,7 +1,10 @@
 #pragma once
 
 #include "imapinfofile.h"
+#include "ilayer.h"
+#include <cstdint>
 #include <sstream>
+#include <vector>
 
 namespace scene
 {
@@ -27,6 +30,11 @@ private:
 	// The standard list (node is part of layer 0)
 	scene::LayerList _standardLayerList;
 
+	// The node-to-layer mapping collected for the binary block,
+	// the number of layers of each node followed by the flat list of IDs
+	std::vector<std::uint32_t> _nodeLayerCounts;
+	std::vector<std::int32_t> _nodeLayerIds;
+
 public:
 	LayerInfoFileModule();
 
@@ -38,11 +46,13 @@ public:
 	void onSavePrimitive(const INodePtr& node, std::size_t entityNum, std::size_t primitiveNum) override;
 	void onSaveEntity(const INodePtr& node, std::size_t entityNum) override;
 	void writeBlocks(std::ostream& stream) override;
+	bool writeBinaryBlock(std::ostream& stream) override;
 	void onInfoFileSaveFinished() override;
 
 	void onInfoFileLoadStart() override;
 	bool canParseBlock(const std::string& blockName) override;
 	void parseBlock(const std::string& blockName, parser::DefTokeniser& tok) override;
+	bool readBinaryBlock(std::istream& stream) override;
 	void applyInfoToScene(const IMapRootNodePtr& root, const map::NodeIndexMap& nodeMap) override;
 	void onInfoFileLoadFinished() override;
 
@@ -15,6 +15,7 @@
 #include "LayerInfoFileModule.h"
 
 #include <functional>
+#include <algorithm>
 #include <climits>
 
 namespace scene
@@ -24,9 +25,14 @@ namespace
 {
 	const char* const DEFAULT_LAYER_NAME = N_("Default");
 	const int DEFAULT_LAYER = 0;
+
+	// Beyond this number of reassigned nodes, the whole scene is updated instead
+	const std::size_t MAX_CHANGED_NODES_TO_TRACK = 4096;
 }
 
 LayerManager::LayerManager() :
+	_visibleLayerMask(0),
+	_sceneVisibilityUpdateNeeded(false),
 	_activeLayer(DEFAULT_LAYER)
 {
 	// Create the "master" layer with ID DEFAULT_LAYER
@@ -60,6 +66,7 @@ int LayerManager::createLayer(const std::string& name, int layerID)
 
 	// Set the newly created layer to "visible"
 	_layerVisibility[result.first->first] = true;
+	updateVisibleLayerMask();
 
 	// Layers have changed
 	onLayersChanged();
@@ -99,14 +106,36 @@ void LayerManager::deleteLayer(const std::string& name)
 	}
 
 	// Remove all nodes from this layer first, but don't de-select them yet
-	RemoveFromLayerWalker walker(layerID);
-	GlobalSceneGraph().root()->traverse(walker);
+	auto members = _layerMembers.find(layerID);
+
+	if (members != _layerMembers.end())
+	{
+		// Copy the member list, it is changing during removal
+		std::vector<INodePtr> nodes;
+		nodes.reserve(members->second.size());
+
+		for (const auto& pair : members->second)
+		{
+			nodes.emplace_back(pair.second.lock());
+		}
+
+		for (const auto& node : nodes)
+		{
+			if (node)
+			{
+				node->removeFromLayer(layerID);
+			}
+		}
+
+		_layerMembers.erase(layerID);
+	}
 
 	// Remove the layer
 	_layers.erase(layerID);
 
 	// Reset the visibility flag to TRUE
 	_layerVisibility[layerID] = true;
+	updateVisibleLayerMask();
 
 	if (layerID == _activeLayer)
 	{
@@ -139,6 +168,7 @@ void LayerManager::reset()
 
 	_layerVisibility.resize(1);
 	_layerVisibility[DEFAULT_LAYER] = true;
+	updateVisibleLayerMask();
 
 	// Update the LayerControlDialog
 	_layersChangedSignal.emit();
@@ -237,6 +267,7 @@ void LayerManager::setLayerVisibility(int layerID, bool visible)
 
 	// Set the visibility
 	_layerVisibility[layerID] = visible;
+	updateVisibleLayerMask();
 
 	if (!visible && layerID == _activeLayer)
 	{
@@ -253,7 +284,7 @@ void LayerManager::setLayerVisibility(int layerID, bool visible)
     }
 
 	// Fire the visibility changed event
-	onLayerVisibilityChanged();
+	onLayerVisibilityChanged(layerID);
 }
 
 void LayerManager::setLayerVisibility(const std::string& layerName, bool visible) 
@@ -271,13 +302,136 @@ void LayerManager::setLayerVisibility(const std::string& layerName, bool visible
 	setLayerVisibility(layerID, visible);
 }
 
-void LayerManager::updateSceneGraphVisibility()
+void LayerManager::updateNodesVisibility(const NodeSet& nodes)
 {
-	UpdateNodeVisibilityWalker walker(GlobalSceneGraph().root());
-	GlobalSceneGraph().root()->traverseChildren(walker);
+	const auto& root = GlobalSceneGraph().root();
 
-	// Redraw
-	SceneChangeNotify();
+	if (!root || nodes.empty())
+	{
+		return;
+	}
+
+	// The parents of the updated nodes, with their depth in the graph
+	std::vector<std::pair<std::size_t, INodePtr>> ancestors;
+	std::unordered_map<INode*, bool> visitedAncestors;
+
+	UpdateNodeVisibilityWalker walker(root);
+
+	for (const auto& pair : nodes)
+	{
+		auto node = pair.second.lock();
+
+		if (!node || !node->inScene() || node->getNodeType() == INode::Type::MapRoot)
+		{
+			continue;
+		}
+
+		// Nodes below another updated node are covered by the subgraph walk of that one
+		bool ancestorIsUpdated = false;
+		std::vector<INodePtr> path;
+
+		for (auto parent = node->getParent(); parent && parent->getNodeType() != INode::Type::MapRoot;
+			parent = parent->getParent())
+		{
+			if (nodes.count(parent.get()) > 0)
+			{
+				ancestorIsUpdated = true;
+				break;
+			}
+
+			path.push_back(parent);
+		}
+
+		if (ancestorIsUpdated)
+		{
+			continue;
+		}
+
+		node->traverse(walker);
+
+		for (std::size_t i = 0; i < path.size(); ++i)
+		{
+			if (visitedAncestors.emplace(path[i].get(), true).second)
+			{
+				ancestors.emplace_back(path.size() - i, path[i]);
+			}
+		}
+	}
+
+	// Update the parents bottom-up, a parent is visible if one of its children is
+	std::stable_sort(ancestors.begin(), ancestors.end(), [](const auto& a, const auto& b)
+	{
+		return a.first > b.first;
+	});
+
+	for (const auto& pair : ancestors)
+	{
+		const auto& ancestor = pair.second;
+
+		if (updateNodeVisibility(ancestor))
+		{
+			continue;
+		}
+
+		bool childIsVisible = false;
+
+		ancestor->foreachNode([&](const INodePtr& child)
+		{
+			childIsVisible = !child->checkStateFlag(Node::eLayered);
+			return !childIsVisible;
+		});
+
+		if (childIsVisible)
+		{
+			ancestor->disable(Node::eLayered);
+		}
+		else
+		{
+			Node_setSelected(ancestor, false);
+		}
+	}
+}
+
+bool LayerManager::nodeIsInVisibleLayer(const INode& node) const
+{
+	auto mask = node.getLayerMask();
+
+	if ((mask & _visibleLayerMask) != 0)
+	{
+		return true;
+	}
+
+	if ((mask & getLayerMaskBit(LAYER_MASK_OVERFLOW_BIT)) == 0)
+	{
+		return false;
+	}
+
+	// The node is member of layers not fitting into the mask, check these one by one
+	const auto& layers = node.getLayers();
+
+	for (auto i = layers.lower_bound(LAYER_MASK_OVERFLOW_BIT); i != layers.end(); ++i)
+	{
+		if (*i < static_cast<int>(_layerVisibility.size()) && _layerVisibility[*i])
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void LayerManager::updateVisibleLayerMask()
+{
+	_visibleLayerMask = 0;
+
+	for (int layerId = 0; layerId < LAYER_MASK_OVERFLOW_BIT &&
+		layerId < static_cast<int>(_layerVisibility.size()); ++layerId)
+	{
+		if (_layerVisibility[layerId])
+		{
+			_visibleLayerMask |= getLayerMaskBit(layerId);
+		}
+	}
 }
 
 void LayerManager::onLayersChanged()
@@ -289,13 +443,56 @@ void LayerManager::onNodeMembershipChanged()
 {
 	_nodeMembershipChangedSignal.emit();
 
-	updateSceneGraphVisibility();
+	// Update the nodes which have been assigned to different layers
+	processChangedNodes();
+
+	// Redraw
+	SceneChangeNotify();
 }
 
-void LayerManager::onLayerVisibilityChanged()
+void LayerManager::processChangedNodes()
 {
-	// Update all nodes and views
-	updateSceneGraphVisibility();
+	if (_sceneVisibilityUpdateNeeded)
+	{
+		_sceneVisibilityUpdateNeeded = false;
+		updateSceneGraphVisibility();
+		return;
+	}
+
+	NodeSet changedNodes;
+	changedNodes.swap(_nodesWithChangedLayers);
+
+	updateNodesVisibility(changedNodes);
+}
+
+void LayerManager::updateSceneGraphVisibility()
+{
+	const auto& root = GlobalSceneGraph().root();
+
+	if (!root)
+	{
+		return;
+	}
+
+	UpdateNodeVisibilityWalker walker(root);
+	root->traverseChildren(walker);
+}
+
+void LayerManager::onLayerVisibilityChanged(int layerID)
+{
+	// Nodes might have been reassigned without a membership change being
+	// processed afterwards (e.g. through undo), bring these up to date first
+	processChangedNodes();
+
+	// Update the members of this layer and the views
+	auto members = _layerMembers.find(layerID);
+
+	if (members != _layerMembers.end())
+	{
+		updateNodesVisibility(members->second);
+	}
+
+	SceneChangeNotify();
 
 	// Update the LayerControlDialog
 	_layerVisibilityChangedSignal.emit();
@@ -389,25 +586,14 @@ bool LayerManager::updateNodeVisibility(const scene::INodePtr& node)
         return true; // doesn't support layers, return true for visible
     }
 
-	// Get the list of layers the node is associated with
-	const auto& layers = node->getLayers();
-
-	// We start with the assumption that a node is hidden
-	node->enable(Node::eLayered);
-
-	// Cycle through the Node's layers, and show the node as soon as
-	// a visible layer is found.
-	for (int layerId : layers)
+	if (nodeIsInVisibleLayer(*node))
 	{
-		if (_layerVisibility[layerId])
-		{
-			// The layer is visible, set the visibility to true and quit
-			node->disable(Node::eLayered);
-			return true;
-		}
+		node->disable(Node::eLayered);
+		return true;
 	}
 
 	// Node is hidden, return FALSE
+	node->enable(Node::eLayered);
 	return false;
 }
 
@@ -421,6 +607,59 @@ void LayerManager::setSelected(int layerID, bool selected)
     }
 }
 
+void LayerManager::registerNode(const INodePtr& node)
+{
+	for (int layerId : node->getLayers())
+	{
+		_layerMembers[layerId].emplace(node.get(), node);
+	}
+}
+
+void LayerManager::unregisterNode(const INodePtr& node)
+{
+	for (int layerId : node->getLayers())
+	{
+		auto members = _layerMembers.find(layerId);
+
+		if (members != _layerMembers.end())
+		{
+			members->second.erase(node.get());
+		}
+	}
+
+	_nodesWithChangedLayers.erase(node.get());
+}
+
+void LayerManager::onNodeLayersChanged(const INodePtr& node, const LayerList& previousLayers)
+{
+	for (int layerId : previousLayers)
+	{
+		auto members = _layerMembers.find(layerId);
+
+		if (members != _layerMembers.end())
+		{
+			members->second.erase(node.get());
+		}
+	}
+
+	registerNode(node);
+
+	if (_sceneVisibilityUpdateNeeded)
+	{
+		return; // the node will be covered by the full update
+	}
+
+	if (_nodesWithChangedLayers.size() >= MAX_CHANGED_NODES_TO_TRACK)
+	{
+		// Bulk assignment, don't keep references to all of these nodes
+		_nodesWithChangedLayers.clear();
+		_sceneVisibilityUpdateNeeded = true;
+		return;
+	}
+
+	_nodesWithChangedLayers.emplace(node.get(), node);
+}
+
 sigc::signal<void> LayerManager::signal_layersChanged()
 {
 	return _layersChangedSignal;
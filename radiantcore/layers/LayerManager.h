@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include "ilayer.h"
 #include "imap.h"
 
@@ -18,6 +19,20 @@ private:
 	typedef std::vector<bool> LayerVisibilityList;
 	LayerVisibilityList _layerVisibility;
 
+	// The same information as bitmask, for the layers fitting into it
+	LayerMask _visibleLayerMask;
+
+	// The nodes of the scene, indexed by the layers they're member of
+	typedef std::unordered_map<INode*, INodeWeakPtr> NodeSet;
+	std::map<int, NodeSet> _layerMembers;
+
+	// The nodes which changed their layer assignment since the last update
+	NodeSet _nodesWithChangedLayers;
+
+	// Set when too many nodes changed their layers to track them one by one
+	// (e.g. when importing a map), the whole scene is updated the next time
+	bool _sceneVisibilityUpdateNeeded;
+
 	// The list of named layers, indexed by an integer ID
 	typedef std::map<int, std::string> LayerMap;
 	LayerMap _layers;
@@ -114,6 +129,11 @@ public:
 	// Selects/unselects an entire layer
 	void setSelected(int layerID, bool selected) override;
 
+	// Member index maintenance
+	void registerNode(const INodePtr& node) override;
+	void unregisterNode(const INodePtr& node) override;
+	void onNodeLayersChanged(const INodePtr& node, const LayerList& previousLayers) override;
+
 	sigc::signal<void> signal_layersChanged() override;
 	sigc::signal<void> signal_layerVisibilityChanged() override;
 	sigc::signal<void> signal_nodeMembershipChanged() override;
@@ -122,15 +142,27 @@ private:
 	// Internal event emitter
 	void onLayersChanged();
 
-	// Internal event, updates the scenegraph
-	void onLayerVisibilityChanged();
+	// Internal event, updates the members of the given layer
+	void onLayerVisibilityChanged(int layerID);
 
 	// Internal event emitter
 	void onNodeMembershipChanged();
 
-	// Updates the visibility state of the entire scenegraph
+	// Updates the visibility of the given nodes, their subgraphs and their ancestors
+	void updateNodesVisibility(const NodeSet& nodes);
+
+	// Updates the nodes which changed their layers since the last call
+	void processChangedNodes();
+
+	// Updates the visibility of all nodes in the scene
 	void updateSceneGraphVisibility();
 
+	// Returns true if the node is member of at least one visible layer
+	bool nodeIsInVisibleLayer(const INode& node) const;
+
+	// Updates the visible layer mask after the layer visibility has changed
+	void updateVisibleLayerMask();
+
 	// Returns the highest used layer Id
 	int getHighestLayerID() const;
 
@@ -26,6 +26,7 @@
 #include "gamelib.h"
 #include "os/path.h"
 #include "os/file.h"
+#include "os/filesize.h"
 #include "time/ScopeTimer.h"
 
 #include "brush/BrushModule.h"
@@ -234,6 +235,8 @@ void Map::finishMergeOperation()
     // At this point the scene should look the same as before the merge
     {
         UndoableCommand cmd("mergeMap");
+        scene::GraphTransaction transaction(GlobalSceneGraph());
+
         _mergeOperation->applyActions();
 
         cleanupMergeOperation();
@@ -992,12 +995,14 @@ void Map::registerCommands()
     // Add undo commands
     GlobalCommandSystem().addCommand("Undo", std::bind(&Map::undoCmd, this, std::placeholders::_1));
     GlobalCommandSystem().addCommand("Redo", std::bind(&Map::redoCmd, this, std::placeholders::_1));
+    GlobalCommandSystem().addCommand("PrintUndoMemoryUsage", std::bind(&Map::printUndoMemoryUsageCmd, this, std::placeholders::_1));
 }
 
 void Map::undoCmd(const cmd::ArgumentList& args)
 {
     try
     {
+        scene::GraphTransaction transaction(GlobalSceneGraph());
         getUndoSystem().undo();
     }
     catch (const std::runtime_error& err)
@@ -1010,6 +1015,7 @@ void Map::redoCmd(const cmd::ArgumentList& args)
 {
     try
     {
+        scene::GraphTransaction transaction(GlobalSceneGraph());
         getUndoSystem().redo();
     }
     catch (const std::runtime_error& err)
@@ -1018,6 +1024,30 @@ void Map::redoCmd(const cmd::ArgumentList& args)
     }
 }
 
+void Map::printUndoMemoryUsageCmd(const cmd::ArgumentList& args)
+{
+    try
+    {
+        auto& undoSystem = getUndoSystem();
+        std::size_t numOperations = 0;
+
+        undoSystem.updateMemoryUsage();
+
+        undoSystem.foreachOperation([&](const std::string& name, std::size_t size)
+        {
+            rMessage() << "  " << name << ": " << os::getFormattedFileSize(size) << std::endl;
+            ++numOperations;
+        });
+
+        rMessage() << "Undo history: " << numOperations << " operation(s), " <<
+            os::getFormattedFileSize(undoSystem.getMemoryUsage()) << " including the redo stack" << std::endl;
+    }
+    catch (const std::runtime_error& err)
+    {
+        throw cmd::ExecutionNotPossible(err.what());
+    }
+}
+
 // Static command targets
 void Map::newMap(const cmd::ArgumentList& args)
 {
@@ -1294,11 +1324,15 @@ void Map::startMergeOperation(const std::string& sourceMap)
     {
         if (sourceMapResource->load())
         {
-            // Compare the scenes and get the report
-            auto result = scene::merge::GraphComparer::Compare(sourceMapResource->getRootNode(), getRoot());
+            {
+                radiant::ScopedLongRunningOperation blocker(_("Comparing maps..."));
 
-            // Create the merge actions
-            _mergeOperation = scene::merge::MergeOperation::CreateFromComparisonResult(*result);
+                // Compare the scenes and get the report
+                auto result = scene::merge::GraphComparer::Compare(sourceMapResource->getRootNode(), getRoot());
+
+                // Create the merge actions
+                _mergeOperation = scene::merge::MergeOperation::CreateFromComparisonResult(*result);
+            }
 
             if (_mergeOperation->hasActions())
             {
@@ -1336,8 +1370,12 @@ void Map::startMergeOperation(const std::string& sourceMap, const std::string& b
     {
         if (sourceMapResource->load() && baseMapResource->load())
         {
-            _mergeOperation = scene::merge::ThreeWayMergeOperation::Create(
-                baseMapResource->getRootNode(), sourceMapResource->getRootNode(), getRoot());
+            {
+                radiant::ScopedLongRunningOperation blocker(_("Comparing maps..."));
+
+                _mergeOperation = scene::merge::ThreeWayMergeOperation::Create(
+                    baseMapResource->getRootNode(), sourceMapResource->getRootNode(), getRoot());
+            }
 
             if (_mergeOperation->hasActions())
             {
@@ -302,6 +302,7 @@ private:
 
     void undoCmd(const cmd::ArgumentList& args);
     void redoCmd(const cmd::ArgumentList& args);
+    void printUndoMemoryUsageCmd(const cmd::ArgumentList& args);
 };
 
 } // namespace map
@@ -31,6 +31,7 @@
 #include "algorithm/MapExporter.h"
 #include "algorithm/Import.h"
 #include "infofile/InfoFileExporter.h"
+#include "infofile/BinaryInfoFile.h"
 #include "messages/MapFileOperation.h"
 #include "NodeCounter.h"
 #include "MapResourceLoader.h"
@@ -318,7 +319,8 @@ RootNodePtr MapResource::loadMapNode()
 
             if (infoFileStream && infoFileStream->isOpen())
             {
-                loader.loadInfoFile(infoFileStream->getStream(), rootNode);
+                auto binaryStream = openBinaryInfofileStream();
+                loader.loadInfoFile(infoFileStream->getStream(), binaryStream.get(), rootNode);
             }
         }
 
@@ -356,11 +358,7 @@ stream::MapResourceStream::Ptr MapResource::openInfofileStream()
 {
     try
     {
-        auto fullpath = getAbsoluteResourcePath();
-        auto infoFilename = fullpath.substr(0, fullpath.rfind('.'));
-        infoFilename += game::current::getInfoFileExtension();
-
-        return openFileStream(infoFilename);
+        return openFileStream(getAbsoluteInfoFilePath());
     }
     catch (const OperationException& ex)
     {
@@ -370,6 +368,34 @@ stream::MapResourceStream::Ptr MapResource::openInfofileStream()
     }
 }
 
+std::unique_ptr<std::istream> MapResource::openBinaryInfofileStream()
+{
+    auto path = getAbsoluteInfoFilePath() + BinaryInfoFile::EXTENSION;
+
+    if (!os::fileOrDirExists(path))
+    {
+        return std::unique_ptr<std::istream>();
+    }
+
+    std::unique_ptr<std::istream> stream(new std::ifstream(path, std::ios::binary));
+
+    if (!stream->good())
+    {
+        rWarning() << "Could not open binary info file " << path << std::endl;
+        return std::unique_ptr<std::istream>();
+    }
+
+    return stream;
+}
+
+std::string MapResource::getAbsoluteInfoFilePath()
+{
+    auto fullpath = getAbsoluteResourcePath();
+    auto infoFilename = fullpath.substr(0, fullpath.rfind('.'));
+
+    return infoFilename + game::current::getInfoFileExtension();
+}
+
 void MapResource::refreshLastModifiedTime()
 {
     auto fullPath = getAbsoluteResourcePath();
@@ -405,6 +431,7 @@ void MapResource::saveFile(const MapFormat& format, const scene::IMapRootNodePtr
 	fs::path outFile = filename;
 	fs::path auxFile = outFile;
 	auxFile.replace_extension(game::current::getInfoFileExtension());
+	fs::path binaryAuxFile = auxFile.string() + BinaryInfoFile::EXTENSION;
 
 	// Check writeability of the primary output file
 	throwIfNotWriteable(outFile);
@@ -415,6 +442,7 @@ void MapResource::saveFile(const MapFormat& format, const scene::IMapRootNodePtr
 	// Open the stream to the primary output file
 	std::ofstream outFileStream(outFile.string());
 	std::unique_ptr<std::ofstream> auxFileStream; // aux stream is optional
+	std::unique_ptr<std::ofstream> binaryAuxFileStream; // binary aux stream is optional
 
 	// Check writeability of the auxiliary output file if necessary
 	if (format.allowInfoFileCreation())
@@ -424,6 +452,12 @@ void MapResource::saveFile(const MapFormat& format, const scene::IMapRootNodePtr
 		throwIfNotWriteable(auxFile);
 
 		auxFileStream.reset(new std::ofstream(auxFile.string()));
+
+		// The binary companion is not essential, it is ignored on load if it's out of date
+		if (FileIsWriteable(binaryAuxFile))
+		{
+			binaryAuxFileStream.reset(new std::ofstream(binaryAuxFile.string(), std::ios::binary));
+		}
 	}
 
 	rMessage() << " for writing... ";
@@ -451,7 +485,11 @@ void MapResource::saveFile(const MapFormat& format, const scene::IMapRootNodePtr
 	MapExporterPtr exporter;
 	auto mapWriter = format.getMapWriter();
 
-	if (format.allowInfoFileCreation())
+	if (format.allowInfoFileCreation() && binaryAuxFileStream && binaryAuxFileStream->is_open())
+	{
+		exporter.reset(new MapExporter(*mapWriter, root, outFileStream, *auxFileStream, *binaryAuxFileStream, counter.getCount()));
+	}
+	else if (format.allowInfoFileCreation())
 	{
 		exporter.reset(new MapExporter(*mapWriter, root, outFileStream, *auxFileStream, counter.getCount()));
 	}
@@ -482,6 +520,11 @@ void MapResource::saveFile(const MapFormat& format, const scene::IMapRootNodePtr
 	{
 		throw OperationException(fmt::format(_("Failure writing to file {0}"), auxFile.string()));
 	}
+
+	if (binaryAuxFileStream && binaryAuxFileStream->fail())
+	{
+		rWarning() << "Failure writing to file " << binaryAuxFile.string() << std::endl;
+	}
 }
 
 } // namespace map
@@ -5,6 +5,8 @@
 #include "imodel.h"
 #include "imap.h"
 #include <set>
+#include <memory>
+#include <istream>
 #include "RootNode.h"
 #include "os/fs.h"
 #include "stream/MapResourceStream.h"
@@ -75,6 +77,10 @@ protected:
     // May return an empty reference, may throw OperationException on failure
     virtual stream::MapResourceStream::Ptr openInfofileStream();
 
+    // Opens the binary companion of the info file, returns an empty pointer if
+    // there is none. Only physical files are considered by this implementation.
+    virtual std::unique_ptr<std::istream> openBinaryInfofileStream();
+
     // Returns true if the file can be written to. Also returns true if the file
     // doesn't exist (assuming the file can always be created).
     static bool FileIsWriteable(const fs::path& path);
@@ -82,6 +88,7 @@ protected:
 private:
     void constructPaths(const std::string& resourcePath);
     std::string getAbsoluteResourcePath();
+    std::string getAbsoluteInfoFilePath();
 
     void refreshLastModifiedTime();
 	void mapSave();
@@ -1,7 +1,11 @@
 #include "MapResourceLoader.h"
 
+#include <set>
 #include "i18n.h"
+#include "ieclass.h"
+#include "imodelcache.h"
 #include "fmt/format.h"
+#include "time/StopWatch.h"
 #include "scene/ChildPrimitives.h"
 #include "scenelib.h"
 #include "algorithm/MapImporter.h"
@@ -10,6 +14,37 @@
 namespace map
 {
 
+namespace
+{
+    // Returns the value of the given key if the line contains a key/value pair,
+    // either quoted (Doom 3 and Quake formats) or as XML attributes (portable format)
+    std::string findKeyValue(const std::string& line, const std::string& key)
+    {
+        auto pos = line.find("key=\"" + key + "\"");
+        std::size_t valueStart = std::string::npos;
+
+        if (pos != std::string::npos)
+        {
+            valueStart = line.find("value=\"", pos);
+            valueStart = valueStart != std::string::npos ? valueStart + 7 : valueStart;
+        }
+        else if (pos = line.find("\"" + key + "\""); pos != std::string::npos)
+        {
+            valueStart = line.find('"', pos + key.length() + 2);
+            valueStart = valueStart != std::string::npos ? valueStart + 1 : valueStart;
+        }
+
+        if (valueStart == std::string::npos)
+        {
+            return std::string();
+        }
+
+        auto valueEnd = line.find('"', valueStart);
+
+        return valueEnd != std::string::npos ? line.substr(valueStart, valueEnd - valueStart) : std::string();
+    }
+}
+
 MapResourceLoader::MapResourceLoader(std::istream& stream, const MapFormat& format) :
     _stream(stream),
     _format(format)
@@ -30,12 +65,32 @@ RootNodePtr MapResourceLoader::load()
 
         rMessage() << "Using " << _format.getMapFormatName() << " format to load the data." << std::endl;
 
+        util::StopWatch stopWatch;
+
+        prefetchModels();
+
+        auto prefetchTime = stopWatch.getMilliSecondsPassed();
+        auto modelStatistics = GlobalModelCache().getStatistics();
+        stopWatch.restart();
+
         // Start parsing
         reader->readFromStream(_stream);
 
+        auto parseTime = stopWatch.getMilliSecondsPassed();
+        stopWatch.restart();
+
         // Prepare child primitives
         scene::addOriginToChildPrimitives(root);
 
+        auto newModelStatistics = GlobalModelCache().getStatistics();
+
+        rMessage() << fmt::format("Map load breakdown: scanning for models {0} ms, parsing {1} ms "
+            "(of which {2} ms spent on {3} models, {4} of them prefetched), child primitives {5} ms",
+            prefetchTime, parseTime, newModelStatistics.loadMilliseconds - modelStatistics.loadMilliseconds,
+            newModelStatistics.modelsLoaded - modelStatistics.modelsLoaded,
+            newModelStatistics.modelsPrefetched - modelStatistics.modelsPrefetched,
+            stopWatch.getMilliSecondsPassed()) << std::endl;
+
         // Move the index mapping to this class before destroying the import filter
         _indexMapping.swap(importFilter.getNodeMap());
 
@@ -60,7 +115,46 @@ RootNodePtr MapResourceLoader::load()
     }
 }
 
-void MapResourceLoader::loadInfoFile(std::istream& stream, const RootNodePtr& root)
+void MapResourceLoader::prefetchModels()
+{
+    std::set<std::string> modelPaths;
+    std::set<std::string> classNames;
+
+    // This is a plain text scan, the parser will find out about the details later
+    std::string line;
+
+    while (std::getline(_stream, line))
+    {
+        if (auto model = findKeyValue(line, "model"); !model.empty())
+        {
+            modelPaths.insert(model);
+        }
+        else if (auto className = findKeyValue(line, "classname"); !className.empty())
+        {
+            classNames.insert(className);
+        }
+    }
+
+    // Rewind the stream for the map reader
+    _stream.clear();
+    _stream.seekg(0, std::ios_base::beg);
+
+    // Entities without a model spawnarg might inherit it from their class
+    for (const auto& className : classNames)
+    {
+        if (auto eclass = GlobalEntityClassManager().findClass(className); eclass)
+        {
+            if (const auto& model = eclass->getAttribute("model").getValue(); !model.empty())
+            {
+                modelPaths.insert(model);
+            }
+        }
+    }
+
+    GlobalModelCache().prefetchModels(modelPaths);
+}
+
+void MapResourceLoader::loadInfoFile(std::istream& stream, std::istream* binaryStream, const RootNodePtr& root)
 {
     if (!stream.good())
     {
@@ -73,7 +167,7 @@ void MapResourceLoader::loadInfoFile(std::istream& stream, const RootNodePtr& ro
     try
     {
         // Read the infofile
-        InfoFile infoFile(stream, root, _indexMapping);
+        InfoFile infoFile(stream, binaryStream, root, _indexMapping);
 
         // Start parsing, this will throw if any errors occur
         infoFile.parse();
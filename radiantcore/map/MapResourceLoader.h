@@ -33,8 +33,14 @@ public:
     // Throws IMapResource::OperationException on failure or cancel
     RootNodePtr load();
 
-    // Load the info file from the given stream, apply it to the root node
-    void loadInfoFile(std::istream& stream, const RootNodePtr& root);
+    // Load the info file from the given stream, apply it to the root node.
+    // The binary companion of the info file is optional and can be null.
+    void loadInfoFile(std::istream& stream, std::istream* binaryStream, const RootNodePtr& root);
+
+private:
+    // Scans the stream for the models referenced by the entities and
+    // lets the model cache load them while the map is being parsed
+    void prefetchModels();
 };
 
 }
@@ -0,0 +1,199 @@
+#include "AasAreaTree.h"
+
+#include <algorithm>
+
+namespace map
+{
+
+namespace
+{
+    // Leaves are not split any further below this number of areas
+    const std::size_t MAX_AREAS_PER_LEAF = 4;
+}
+
+void AasAreaTree::build(const std::vector<AABB>& areaBounds)
+{
+    clear();
+
+    _areaBounds = areaBounds;
+
+    for (std::size_t areaNum = 0; areaNum < areaBounds.size(); ++areaNum)
+    {
+        if (areaBounds[areaNum].isValid())
+        {
+            _areaNumbers.push_back(static_cast<int>(areaNum));
+        }
+    }
+
+    if (_areaNumbers.empty()) return;
+
+    // Two nodes per leaf is an upper bound for the node count
+    _nodes.reserve(2 * (_areaNumbers.size() / MAX_AREAS_PER_LEAF + 1));
+
+    buildNode(_areaNumbers.begin(), _areaNumbers.end());
+}
+
+void AasAreaTree::clear()
+{
+    _nodes.clear();
+    _areaNumbers.clear();
+    _areaBounds.clear();
+}
+
+std::size_t AasAreaTree::buildNode(std::vector<int>::iterator begin, std::vector<int>::iterator end)
+{
+    std::size_t nodeIndex = _nodes.size();
+    _nodes.emplace_back();
+
+    AABB bounds;
+    AABB centers;
+
+    for (auto i = begin; i != end; ++i)
+    {
+        bounds.includeAABB(_areaBounds[*i]);
+        centers.includePoint(_areaBounds[*i].getOrigin());
+    }
+
+    std::size_t numAreas = static_cast<std::size_t>(end - begin);
+
+    if (numAreas <= MAX_AREAS_PER_LEAF)
+    {
+        _nodes[nodeIndex] = Node{ bounds, static_cast<std::size_t>(begin - _areaNumbers.begin()), numAreas };
+        return nodeIndex;
+    }
+
+    // Split at the median of the area centers along the longest axis
+    const Vector3& extents = centers.getExtents();
+    std::size_t axis = extents.x() >= extents.y() ?
+        (extents.x() >= extents.z() ? 0 : 2) : (extents.y() >= extents.z() ? 1 : 2);
+
+    auto middle = begin + numAreas / 2;
+
+    std::nth_element(begin, middle, end, [&](int a, int b)
+    {
+        return _areaBounds[a].getOrigin()[axis] < _areaBounds[b].getOrigin()[axis];
+    });
+
+    buildNode(begin, middle);
+    std::size_t secondChild = buildNode(middle, end);
+
+    // The vector might have been reallocated, don't hold references across the recursion
+    _nodes[nodeIndex] = Node{ bounds, secondChild, 0 };
+
+    return nodeIndex;
+}
+
+void AasAreaTree::forEachAreaInVolume(const VolumeTest& volume, const std::function<void(int)>& functor) const
+{
+    if (_nodes.empty()) return;
+
+    std::vector<std::size_t> stack(1, 0);
+
+    while (!stack.empty())
+    {
+        std::size_t nodeIndex = stack.back();
+        stack.pop_back();
+
+        const Node& node = _nodes[nodeIndex];
+
+        VolumeIntersectionValue intersection = volume.TestAABB(node.bounds);
+
+        if (intersection == VOLUME_OUTSIDE)
+        {
+            continue;
+        }
+
+        if (intersection == VOLUME_INSIDE)
+        {
+            // No need to test anything below this node
+            forEachAreaInSubtree(nodeIndex, functor);
+            continue;
+        }
+
+        if (node.numAreas == 0)
+        {
+            stack.push_back(node.index);
+            stack.push_back(nodeIndex + 1);
+            continue;
+        }
+
+        for (std::size_t i = node.index; i < node.index + node.numAreas; ++i)
+        {
+            if (volume.TestAABB(_areaBounds[_areaNumbers[i]]) != VOLUME_OUTSIDE)
+            {
+                functor(_areaNumbers[i]);
+            }
+        }
+    }
+}
+
+void AasAreaTree::forEachAreaInSubtree(std::size_t nodeIndex, const std::function<void(int)>& functor) const
+{
+    const Node& node = _nodes[nodeIndex];
+
+    if (node.numAreas > 0)
+    {
+        for (std::size_t i = node.index; i < node.index + node.numAreas; ++i)
+        {
+            functor(_areaNumbers[i]);
+        }
+
+        return;
+    }
+
+    forEachAreaInSubtree(nodeIndex + 1, functor);
+    forEachAreaInSubtree(node.index, functor);
+}
+
+int AasAreaTree::findFirstAreaAlongRay(const Ray& ray) const
+{
+    int closestArea = -1;
+    double closestDistance = 0;
+
+    if (_nodes.empty()) return closestArea;
+
+    std::vector<std::size_t> stack(1, 0);
+
+    while (!stack.empty())
+    {
+        const Node& node = _nodes[stack.back()];
+        std::size_t nodeIndex = stack.back();
+        stack.pop_back();
+
+        Vector3 intersection;
+
+        // Nodes entered farther away than the best hit so far can't contain a closer one
+        if (!ray.intersectAABB(node.bounds, intersection) ||
+            (closestArea != -1 && (intersection - ray.origin).getLengthSquared() > closestDistance))
+        {
+            continue;
+        }
+
+        if (node.numAreas == 0)
+        {
+            stack.push_back(node.index);
+            stack.push_back(nodeIndex + 1);
+            continue;
+        }
+
+        for (std::size_t i = node.index; i < node.index + node.numAreas; ++i)
+        {
+            int areaNum = _areaNumbers[i];
+
+            if (!ray.intersectAABB(_areaBounds[areaNum], intersection)) continue;
+
+            double distance = (intersection - ray.origin).getLengthSquared();
+
+            if (closestArea == -1 || distance < closestDistance ||
+                (distance == closestDistance && areaNum < closestArea))
+            {
+                closestArea = areaNum;
+                closestDistance = distance;
+            }
+        }
+    }
+
+    return closestArea;
+}
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "ivolumetest.h"
+#include "math/AABB.h"
+#include "math/Ray.h"
+
+namespace map
+{
+
+/**
+ * Bounding volume hierarchy over the area bounds of an AAS file. Used to
+ * find the areas intersecting a view volume or a ray without testing each
+ * one of them. Areas without valid bounds are not part of the tree.
+ */
+class AasAreaTree
+{
+private:
+    struct Node
+    {
+        AABB bounds;
+
+        // Inner nodes: index of the second child, the first one follows directly
+        // Leaf nodes: index of the first entry in _areaNumbers
+        std::size_t index;
+
+        // Number of areas in this leaf, 0 for inner nodes
+        std::size_t numAreas;
+    };
+
+    // Nodes in depth-first order, the root is the first one
+    std::vector<Node> _nodes;
+
+    // Area numbers referenced by the leaves
+    std::vector<int> _areaNumbers;
+
+    // Area bounds by area number
+    std::vector<AABB> _areaBounds;
+
+public:
+    // Builds the tree from the given area bounds, indexed by area number
+    void build(const std::vector<AABB>& areaBounds);
+
+    void clear();
+
+    // Invokes the functor for each area whose bounds are not outside the given volume
+    void forEachAreaInVolume(const VolumeTest& volume, const std::function<void(int)>& functor) const;
+
+    // Returns the area whose bounds are hit first by the given ray, or -1 if there is none
+    int findFirstAreaAlongRay(const Ray& ray) const;
+
+private:
+    std::size_t buildNode(std::vector<int>::iterator begin, std::vector<int>::iterator end);
+
+    void forEachAreaInSubtree(std::size_t nodeIndex, const std::function<void(int)>& functor) const;
+};
+
+}
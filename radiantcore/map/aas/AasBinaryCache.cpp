@@ -0,0 +1,154 @@
+#include "AasBinaryCache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <fmt/format.h>
+
+#include "itextstream.h"
+#include "os/fs.h"
+#include "os/path.h"
+#include "math/Hash.h"
+#include "stream/TemporaryOutputStream.h"
+
+namespace map
+{
+
+namespace
+{
+    constexpr char CacheFileMagic[4] = { 'D', 'R', 'A', 'C' };
+
+    // Increase this whenever the file layout or the parser changes
+    constexpr std::uint32_t CacheFileVersion = 1;
+
+    constexpr const char* const CacheFileExtension = ".drac";
+
+    // Entries of maps that are no longer loaded are removed beyond this count
+    constexpr std::size_t MaxCacheEntries = 64;
+
+    struct FileHeader
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::uint64_t sourceSize;
+        std::uint64_t sourceHash;
+    };
+
+    static_assert(sizeof(FileHeader) == 24, "Unexpected padding in the cache file header");
+}
+
+AasBinaryCache::AasBinaryCache(const std::string& cacheDirectory) :
+    _cacheDirectory(os::standardPathWithSlash(cacheDirectory))
+{}
+
+std::uint64_t AasBinaryCache::getContentHash(const std::string& contents)
+{
+    math::FastHash hash;
+    hash.addString(contents);
+
+    return hash.getDigest64();
+}
+
+std::string AasBinaryCache::getCacheFilePath(std::uint64_t contentHash) const
+{
+    return _cacheDirectory + fmt::format("{0:016x}", contentHash) + CacheFileExtension;
+}
+
+Doom3AasFilePtr AasBinaryCache::load(const std::string& sourceContents)
+{
+    auto sourceHash = getContentHash(sourceContents);
+
+    std::ifstream stream(getCacheFilePath(sourceHash), std::ios::binary | std::ios::ate);
+
+    if (!stream)
+    {
+        return Doom3AasFilePtr();
+    }
+
+    std::vector<char> buffer(static_cast<std::size_t>(stream.tellg()));
+    stream.seekg(0, std::ios::beg);
+
+    if (buffer.size() < sizeof(FileHeader) || !stream.read(buffer.data(), buffer.size()))
+    {
+        return Doom3AasFilePtr();
+    }
+
+    FileHeader header;
+    std::memcpy(&header, buffer.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, CacheFileMagic, sizeof(CacheFileMagic)) != 0 ||
+        header.version != CacheFileVersion || header.sourceSize != sourceContents.size() ||
+        header.sourceHash != sourceHash)
+    {
+        return Doom3AasFilePtr(); // outdated or not ours
+    }
+
+    auto aasFile = std::make_shared<Doom3AasFile>();
+
+    if (!aasFile->readBinary(buffer, sizeof(FileHeader)))
+    {
+        rWarning() << "Corrupt AAS cache entry " << getCacheFilePath(sourceHash) << std::endl;
+        return Doom3AasFilePtr();
+    }
+
+    return aasFile;
+}
+
+void AasBinaryCache::store(const std::string& sourceContents, const Doom3AasFile& aasFile)
+{
+    FileHeader header;
+    std::memcpy(header.magic, CacheFileMagic, sizeof(CacheFileMagic));
+    header.version = CacheFileVersion;
+    header.sourceSize = sourceContents.size();
+    header.sourceHash = getContentHash(sourceContents);
+
+    std::vector<char> buffer(sizeof(FileHeader));
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    aasFile.writeBinary(buffer);
+
+    try
+    {
+        stream::TemporaryOutputStream::WriteFile(getCacheFilePath(header.sourceHash), buffer);
+    }
+    catch (const std::exception& ex)
+    {
+        rWarning() << "Could not store the AAS file in the cache: " << ex.what() << std::endl;
+        return;
+    }
+
+    prune();
+}
+
+void AasBinaryCache::prune()
+{
+    try
+    {
+        std::vector<std::pair<fs::file_time_type, fs::path>> entries;
+
+        for (const auto& entry : fs::directory_iterator(_cacheDirectory))
+        {
+            if (entry.path().extension() == CacheFileExtension)
+            {
+                entries.emplace_back(fs::last_write_time(entry.path()), entry.path());
+            }
+        }
+
+        if (entries.size() <= MaxCacheEntries) return;
+
+        // Remove the entries that have been written least recently
+        std::sort(entries.begin(), entries.end());
+
+        for (std::size_t i = 0; i < entries.size() - MaxCacheEntries; ++i)
+        {
+            fs::remove(entries[i].second);
+        }
+    }
+    catch (const fs::filesystem_error& ex)
+    {
+        rWarning() << "Could not prune the AAS cache in " << _cacheDirectory << ": " << ex.what() << std::endl;
+    }
+}
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Doom3AasFile.h"
+
+namespace map
+{
+
+/**
+ * On-disk cache of parsed AAS files. Each entry holds the geometry arrays of
+ * a Doom3AasFile, including the calculated area bounds and centers, so that
+ * the text parser can be skipped when the same file is loaded again.
+ *
+ * Entries are keyed by a hash of the source file contents, which works
+ * regardless of whether the file comes from disk or from a PK4. The hash
+ * and size of the source are stored in the entry and compared on load.
+ * Only the most recently written entries are kept, older ones are removed
+ * whenever a new entry is stored.
+ */
+class AasBinaryCache
+{
+private:
+    std::string _cacheDirectory;
+
+public:
+    // Constructs a cache storing its files in the given directory,
+    // which is created on demand
+    AasBinaryCache(const std::string& cacheDirectory);
+
+    // Returns the file stored for the given source contents, or an empty pointer
+    Doom3AasFilePtr load(const std::string& sourceContents);
+
+    // Stores the given file, parsed from the given source contents
+    void store(const std::string& sourceContents, const Doom3AasFile& aasFile);
+
+    // Hash of the given file contents, used as cache key
+    static std::uint64_t getContentHash(const std::string& contents);
+
+private:
+    std::string getCacheFilePath(std::uint64_t contentHash) const;
+
+    // Removes the oldest entries exceeding the maximum entry count
+    void prune();
+};
+
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "parser/DefTokeniser.h"
+
+namespace map
+{
+
+/**
+ * Tokeniser working directly on an in-memory AAS file. Tokens are separated
+ * by whitespace, the characters {}() are returned as tokens of their own,
+ * quoted strings and C/C++ style comments are handled like in DefTokeniser.
+ *
+ * Apart from the DefTokeniser interface used by the settings block, this
+ * offers methods reading numbers and single-character tokens without
+ * constructing any strings, which is what the large blocks are made of.
+ * The buffer must be null-terminated and outlive the tokeniser.
+ */
+class AasTokeniser :
+    public parser::DefTokeniser
+{
+private:
+    const char* _pos;
+    const char* _end;
+
+public:
+    AasTokeniser(const char* begin, const char* end) :
+        _pos(begin),
+        _end(end)
+    {
+        skipWhitespace();
+    }
+
+    bool hasMoreTokens() const override
+    {
+        return _pos < _end;
+    }
+
+    std::string nextToken() override
+    {
+        const char* tokenEnd = findTokenEnd(_pos);
+
+        // Strip the quotes from quoted strings
+        std::string token = *_pos == '"' ?
+            std::string(_pos + 1, tokenEnd - 1 > _pos + 1 ? tokenEnd - 1 : _pos + 1) :
+            std::string(_pos, tokenEnd);
+
+        advanceTo(tokenEnd);
+
+        return token;
+    }
+
+    std::string peek() const override
+    {
+        const char* tokenEnd = findTokenEnd(_pos);
+
+        return *_pos == '"' ?
+            std::string(_pos + 1, tokenEnd - 1 > _pos + 1 ? tokenEnd - 1 : _pos + 1) :
+            std::string(_pos, tokenEnd);
+    }
+
+    // Requires the next token to be the given single character, throws otherwise
+    void assertNextCharacter(char expected)
+    {
+        if (_pos >= _end || *_pos != expected || findTokenEnd(_pos) != _pos + 1)
+        {
+            throw parser::ParseException(std::string("AasTokeniser: Assertion failed: Required \"") +
+                expected + "\", found \"" + (_pos < _end ? peek() : std::string()) + "\"");
+        }
+
+        advanceTo(_pos + 1);
+    }
+
+    // Parses the next token as integer, the whole token needs to be a number
+    long nextInteger()
+    {
+        const char* tokenEnd = findTokenEnd(_pos);
+        char* numberEnd = nullptr;
+
+        long value = std::strtol(_pos, &numberEnd, 10);
+
+        if (numberEnd != tokenEnd || tokenEnd == _pos)
+        {
+            throw parser::ParseException("AasTokeniser: Invalid integer: " + peek());
+        }
+
+        advanceTo(tokenEnd);
+
+        return value;
+    }
+
+    // Parses the next token as floating point number
+    double nextFloat()
+    {
+        const char* tokenEnd = findTokenEnd(_pos);
+        char* numberEnd = nullptr;
+
+        double value = std::strtod(_pos, &numberEnd);
+
+        if (numberEnd != tokenEnd || tokenEnd == _pos)
+        {
+            throw parser::ParseException("AasTokeniser: Invalid number: " + peek());
+        }
+
+        advanceTo(tokenEnd);
+
+        return value;
+    }
+
+    // Skips everything up to and including the closing brace of the current block,
+    // assuming that the opening brace has been consumed already
+    void skipBlock()
+    {
+        std::size_t depth = 1;
+
+        while (_pos < _end)
+        {
+            char c = *_pos;
+            advanceTo(findTokenEnd(_pos));
+
+            if (c == '{')
+            {
+                ++depth;
+            }
+            else if (c == '}' && --depth == 0)
+            {
+                return;
+            }
+        }
+
+        throw parser::ParseException("AasTokeniser: Missing closing brace");
+    }
+
+private:
+    static bool isWhitespace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v';
+    }
+
+    static bool isKeptDelimiter(char c)
+    {
+        return c == '{' || c == '}' || c == '(' || c == ')';
+    }
+
+    void advanceTo(const char* pos)
+    {
+        _pos = pos;
+        skipWhitespace();
+    }
+
+    // Moves the position to the start of the next token, skipping comments
+    void skipWhitespace()
+    {
+        while (_pos < _end)
+        {
+            if (isWhitespace(*_pos))
+            {
+                ++_pos;
+            }
+            else if (*_pos == '/' && _pos + 1 < _end && _pos[1] == '/')
+            {
+                while (_pos < _end && *_pos != '\n') ++_pos;
+            }
+            else if (*_pos == '/' && _pos + 1 < _end && _pos[1] == '*')
+            {
+                const char* commentEnd = _pos + 2;
+
+                while (commentEnd + 1 < _end && !(commentEnd[0] == '*' && commentEnd[1] == '/')) ++commentEnd;
+
+                _pos = commentEnd + 1 < _end ? commentEnd + 2 : _end;
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    const char* findTokenEnd(const char* start) const
+    {
+        if (start >= _end)
+        {
+            throw parser::ParseException("AasTokeniser: no more tokens");
+        }
+
+        if (isKeptDelimiter(*start))
+        {
+            return start + 1;
+        }
+
+        const char* pos = start;
+
+        if (*pos == '"')
+        {
+            // Quoted string, including the closing quote
+            for (++pos; pos < _end && *pos != '"'; ++pos) {}
+
+            return pos < _end ? pos + 1 : _end;
+        }
+
+        while (pos < _end && !isWhitespace(*pos) && !isKeptDelimiter(*pos) &&
+               !(*pos == '/' && pos + 1 < _end && (pos[1] == '/' || pos[1] == '*')))
+        {
+            ++pos;
+        }
+
+        return pos;
+    }
+};
+
+}
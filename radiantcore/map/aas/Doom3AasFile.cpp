@@ -1,8 +1,8 @@
 #include "Doom3AasFile.h"
 
+#include <cstdint>
+#include <cstring>
 #include "itextstream.h"
-#include "string/convert.h"
-#include "Util.h"
 
 namespace map
 {
@@ -95,7 +95,17 @@ const IAasFile::Area& Doom3AasFile::getArea(int areaNum) const
     return _areas[areaNum];
 }
 
-void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
+void Doom3AasFile::forEachAreaInVolume(const VolumeTest& volume, const std::function<void(int)>& functor) const
+{
+    _areaTree.forEachAreaInVolume(volume, functor);
+}
+
+int Doom3AasFile::findAreaAlongRay(const Ray& ray) const
+{
+    return _areaTree.findFirstAreaAlongRay(ray);
+}
+
+void Doom3AasFile::parseFromTokens(AasTokeniser& tok)
 {
     while (tok.hasMoreTokens())
     {
@@ -107,74 +117,84 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
         }
         else if (token == "planes")
         {
-            std::size_t planesCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t planesCount = static_cast<std::size_t>(tok.nextInteger());
 
             _planes.reserve(planesCount);
 
-            tok.assertNextToken("{");
+            tok.assertNextCharacter('{');
 
             // num ( a b c dist )
             for (std::size_t i = 0; i < planesCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // plane index
+                tok.nextInteger(); // plane index
 
-                tok.assertNextToken("(");
+                tok.assertNextCharacter('(');
 
                 Plane3 plane;
-                plane.normal().x() = string::convert<Vector3::ElementType>(tok.nextToken());
-                plane.normal().y() = string::convert<Vector3::ElementType>(tok.nextToken());
-                plane.normal().z() = string::convert<Vector3::ElementType>(tok.nextToken());
-                plane.dist() = string::convert<Vector3::ElementType>(tok.nextToken());
+                plane.normal().x() = tok.nextFloat();
+                plane.normal().y() = tok.nextFloat();
+                plane.normal().z() = tok.nextFloat();
+                plane.dist() = tok.nextFloat();
 
                 _planes.push_back(plane);
 
-                tok.assertNextToken(")");
+                tok.assertNextCharacter(')');
             }
 
-            tok.assertNextToken("}");
+            tok.assertNextCharacter('}');
         }
         else if (token == "vertices")
         {
-            std::size_t vertCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t vertCount = static_cast<std::size_t>(tok.nextInteger());
 
             _vertices.reserve(vertCount);
 
-            tok.assertNextToken("{");
+            tok.assertNextCharacter('{');
 
             // num ( x y z )
             for (std::size_t i = 0; i < vertCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // index
-                _vertices.push_back(parseVector3(tok)); // components
+                tok.nextInteger(); // index
+
+                tok.assertNextCharacter('(');
+
+                Vector3 vertex;
+                vertex.x() = tok.nextFloat();
+                vertex.y() = tok.nextFloat();
+                vertex.z() = tok.nextFloat();
+
+                _vertices.push_back(vertex);
+
+                tok.assertNextCharacter(')');
             }
 
-            tok.assertNextToken("}");
+            tok.assertNextCharacter('}');
         }
         else if (token == "edges")
         {
-            std::size_t edgeCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t edgeCount = static_cast<std::size_t>(tok.nextInteger());
 
             _edges.reserve(edgeCount);
 
-            tok.assertNextToken("{");
+            tok.assertNextCharacter('{');
 
             // num ( vertIdx1 vertIdx2 )
             for (std::size_t i = 0; i < edgeCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // index
+                tok.nextInteger(); // index
 
-                tok.assertNextToken("(");
+                tok.assertNextCharacter('(');
 
                 Edge edge;
-                edge.vertexNumber[0] = string::convert<int>(tok.nextToken());
-                edge.vertexNumber[1] = string::convert<int>(tok.nextToken());
+                edge.vertexNumber[0] = static_cast<int>(tok.nextInteger());
+                edge.vertexNumber[1] = static_cast<int>(tok.nextInteger());
 
-                tok.assertNextToken(")");
+                tok.assertNextCharacter(')');
 
                 _edges.push_back(edge); // components
             }
 
-            tok.assertNextToken("}");
+            tok.assertNextCharacter('}');
         }
         else if (token == "edgeIndex")
         {
@@ -182,34 +202,34 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
         }
         else if (token == "faces")
         {
-            std::size_t faceCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t faceCount = static_cast<std::size_t>(tok.nextInteger());
 
             _faces.reserve(faceCount);
 
-            tok.assertNextToken("{");
+            tok.assertNextCharacter('{');
 
             // num ( planeNum flags areas[0] areas[1] firstEdge numEdges )
             for (std::size_t i = 0; i < faceCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // number
+                tok.nextInteger(); // number
 
-                tok.assertNextToken("(");
+                tok.assertNextCharacter('(');
 
                 Face face;
 
-                face.planeNum = string::convert<int>(tok.nextToken());
-                face.flags = string::convert<unsigned short>(tok.nextToken());
-                face.areas[0] = string::convert<short>(tok.nextToken());
-                face.areas[1] = string::convert<short>(tok.nextToken());
-                face.firstEdge = string::convert<int>(tok.nextToken());
-                face.numEdges = string::convert<int>(tok.nextToken());
+                face.planeNum = static_cast<int>(tok.nextInteger());
+                face.flags = static_cast<unsigned short>(tok.nextInteger());
+                face.areas[0] = static_cast<short>(tok.nextInteger());
+                face.areas[1] = static_cast<short>(tok.nextInteger());
+                face.firstEdge = static_cast<int>(tok.nextInteger());
+                face.numEdges = static_cast<int>(tok.nextInteger());
 
                 _faces.push_back(face);
 
-                tok.assertNextToken(")");
+                tok.assertNextCharacter(')');
             }
 
-            tok.assertNextToken("}");
+            tok.assertNextCharacter('}');
         }
         else if (token == "faceIndex")
         {
@@ -217,55 +237,48 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
         }
         else if (token == "areas")
         {
-            std::size_t areaCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t areaCount = static_cast<std::size_t>(tok.nextInteger());
 
             _areas.reserve(areaCount);
 
-            tok.assertNextToken("{");
+            tok.assertNextCharacter('{');
 
             // num ( flags contents firstFace numFaces cluster clusterAreaNum ) reachabilityCount { reachabilities }
             for (std::size_t i = 0; i < areaCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // number
+                tok.nextInteger(); // number
 
-                tok.assertNextToken("(");
+                tok.assertNextCharacter('(');
 
                 Area area;
 
-                area.flags = string::convert<unsigned short>(tok.nextToken());
-                area.contents = string::convert<unsigned short>(tok.nextToken());
-                area.firstFace = string::convert<int>(tok.nextToken());
-                area.numFaces = string::convert<int>(tok.nextToken());
-                area.cluster = string::convert<short>(tok.nextToken());
-                area.clusterAreaNum = string::convert<short>(tok.nextToken());
+                area.flags = static_cast<unsigned short>(tok.nextInteger());
+                area.contents = static_cast<unsigned short>(tok.nextInteger());
+                area.firstFace = static_cast<int>(tok.nextInteger());
+                area.numFaces = static_cast<int>(tok.nextInteger());
+                area.cluster = static_cast<short>(tok.nextInteger());
+                area.clusterAreaNum = static_cast<short>(tok.nextInteger());
+                area.travelFlags = 0;
 
                 _areas.push_back(area);
 
-                tok.assertNextToken(")");
+                tok.assertNextCharacter(')');
 
                 // Skip over reachabilities for the moment being
-                /*std::size_t reachCount = */string::convert<std::size_t>(tok.nextToken());
-                tok.assertNextToken("{");
-
-                while (tok.nextToken() != "}")
-                {
-                    // do nothing
-                }
+                /*std::size_t reachCount = */tok.nextInteger();
+                tok.assertNextCharacter('{');
+                tok.skipBlock();
             }
 
             // Skip the step LinkReversedReachability();
 
-            tok.assertNextToken("}");
+            tok.assertNextCharacter('}');
         }
         else if (token == "nodes" || token == "portals" || token == "portalIndex" || token == "clusters")
         {
-            tok.nextToken(); // integer
-            tok.assertNextToken("{");
-
-            while (tok.nextToken() != "}")
-            {
-                // do nothing
-            }
+            tok.nextInteger(); // integer
+            tok.assertNextCharacter('{');
+            tok.skipBlock();
         }
         else
         {
@@ -278,11 +291,18 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
 
 void Doom3AasFile::finishAreas()
 {
+    std::vector<AABB> areaBounds;
+    areaBounds.reserve(_areas.size());
+
     for (Area& area : _areas)
     {
         area.center = calcReachableGoalForArea(area);
 		area.bounds = calcAreaBounds(area);
+
+        areaBounds.push_back(area.bounds);
     }
+
+    _areaTree.build(areaBounds);
 }
 
 #define INTSIGNBITSET(i)		(((const unsigned int)(i)) >> 31)
@@ -389,25 +409,134 @@ Vector3 Doom3AasFile::calcReachableGoalForArea(const IAasFile::Area& area) const
     return center;
 }
 
-void Doom3AasFile::parseIndex(parser::DefTokeniser& tok, Index& index)
+void Doom3AasFile::parseIndex(AasTokeniser& tok, Index& index)
 {
-    std::size_t idxCount = string::convert<std::size_t>(tok.nextToken());
+    std::size_t idxCount = static_cast<std::size_t>(tok.nextInteger());
 
     index.reserve(idxCount);
 
-    tok.assertNextToken("{");
+    tok.assertNextCharacter('{');
 
     // num ( idx )
     for (std::size_t i = 0; i < idxCount; ++i)
     {
-        string::convert<int>(tok.nextToken()); // number
+        tok.nextInteger(); // number
 
-        tok.assertNextToken("(");
-        index.push_back(string::convert<int>(tok.nextToken()));
-        tok.assertNextToken(")");
+        tok.assertNextCharacter('(');
+        index.push_back(static_cast<int>(tok.nextInteger()));
+        tok.assertNextCharacter(')');
     }
 
-    tok.assertNextToken("}");
+    tok.assertNextCharacter('}');
+}
+
+namespace
+{
+    // Describes one array in the binary layout
+    struct BinaryBlock
+    {
+        std::uint64_t offset;
+        std::uint64_t count;
+        std::uint64_t elementSize;
+    };
+
+    constexpr std::size_t NumBinaryBlocks = 7;
+
+    inline std::size_t alignOffset(std::size_t offset)
+    {
+        return (offset + 7) & ~static_cast<std::size_t>(7);
+    }
+
+    template<typename T>
+    void appendBlock(std::vector<char>& buffer, BinaryBlock& block, const std::vector<T>& elements)
+    {
+        buffer.resize(alignOffset(buffer.size()), 0);
+
+        block.offset = buffer.size();
+        block.count = elements.size();
+        block.elementSize = sizeof(T);
+
+        buffer.resize(buffer.size() + elements.size() * sizeof(T));
+
+        if (!elements.empty())
+        {
+            std::memcpy(buffer.data() + block.offset, elements.data(), elements.size() * sizeof(T));
+        }
+    }
+
+    template<typename T>
+    bool readBlock(const std::vector<char>& buffer, const BinaryBlock& block, std::vector<T>& elements)
+    {
+        if (block.elementSize != sizeof(T) || block.offset > buffer.size() ||
+            block.count > (buffer.size() - block.offset) / sizeof(T))
+        {
+            return false;
+        }
+
+        elements.resize(static_cast<std::size_t>(block.count));
+
+        if (!elements.empty())
+        {
+            std::memcpy(elements.data(), buffer.data() + block.offset, elements.size() * sizeof(T));
+        }
+
+        return true;
+    }
+}
+
+void Doom3AasFile::writeBinary(std::vector<char>& buffer) const
+{
+    // The block table comes first, it is filled in once the offsets are known
+    std::size_t tableOffset = buffer.size();
+    buffer.resize(tableOffset + NumBinaryBlocks * sizeof(BinaryBlock), 0);
+
+    BinaryBlock blocks[NumBinaryBlocks];
+
+    appendBlock(buffer, blocks[0], _planes);
+    appendBlock(buffer, blocks[1], _vertices);
+    appendBlock(buffer, blocks[2], _edges);
+    appendBlock(buffer, blocks[3], _edgeIndex);
+    appendBlock(buffer, blocks[4], _faces);
+    appendBlock(buffer, blocks[5], _faceIndex);
+    appendBlock(buffer, blocks[6], _areas);
+
+    std::memcpy(buffer.data() + tableOffset, blocks, sizeof(blocks));
+}
+
+bool Doom3AasFile::readBinary(const std::vector<char>& buffer, std::size_t offset)
+{
+    BinaryBlock blocks[NumBinaryBlocks];
+
+    if (offset > buffer.size() || buffer.size() - offset < sizeof(blocks))
+    {
+        return false;
+    }
+
+    std::memcpy(blocks, buffer.data() + offset, sizeof(blocks));
+
+    if (!readBlock(buffer, blocks[0], _planes) ||
+        !readBlock(buffer, blocks[1], _vertices) ||
+        !readBlock(buffer, blocks[2], _edges) ||
+        !readBlock(buffer, blocks[3], _edgeIndex) ||
+        !readBlock(buffer, blocks[4], _faces) ||
+        !readBlock(buffer, blocks[5], _faceIndex) ||
+        !readBlock(buffer, blocks[6], _areas))
+    {
+        return false;
+    }
+
+    // The area centers and bounds have been stored, only the index needs to be rebuilt
+    std::vector<AABB> areaBounds;
+    areaBounds.reserve(_areas.size());
+
+    for (const Area& area : _areas)
+    {
+        areaBounds.push_back(area.bounds);
+    }
+
+    _areaTree.build(areaBounds);
+
+    return true;
 }
 
 }
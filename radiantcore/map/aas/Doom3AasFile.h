@@ -1,7 +1,8 @@
 #pragma once
 
 #include "iaasfile.h"
-#include "parser/DefTokeniser.h"
+#include "AasTokeniser.h"
+#include "AasAreaTree.h"
 #include "Doom3AasFileSettings.h"
 #include <vector>
 #include "math/Plane3.h"
@@ -28,6 +29,9 @@ private:
 
     std::vector<Area> _areas;
 
+    // Spatial index over the area bounds
+    AasAreaTree _areaTree;
+
 public:
     virtual std::size_t     getNumPlanes() const override;
     virtual const Plane3&   getPlane(std::size_t planeNum) const override;
@@ -49,10 +53,21 @@ public:
     virtual std::size_t     getNumAreas() const override;
     virtual const Area&     getArea(int areaNum) const override;
 
-    void parseFromTokens(parser::DefTokeniser& tok);
+    virtual void forEachAreaInVolume(const VolumeTest& volume, const std::function<void(int)>& functor) const override;
+    virtual int findAreaAlongRay(const Ray& ray) const override;
+
+    void parseFromTokens(AasTokeniser& tok);
+
+    // Appends the geometry of this file to the given buffer, in a flat layout
+    // of 8-byte aligned arrays. The settings are not stored.
+    void writeBinary(std::vector<char>& buffer) const;
+
+    // Restores the geometry stored by writeBinary() at the given offset,
+    // returns false if the data is incomplete or has a different layout
+    bool readBinary(const std::vector<char>& buffer, std::size_t offset);
 
 private:
-    void parseIndex(parser::DefTokeniser& tok, Index& index);
+    void parseIndex(AasTokeniser& tok, Index& index);
     void finishAreas();
     Vector3 calcReachableGoalForArea(const IAasFile::Area& area) const;
     Vector3 calcFaceCenter(int faceNum) const;
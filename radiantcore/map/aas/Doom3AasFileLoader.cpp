@@ -4,6 +4,8 @@
 
 #include "parser/DefTokeniser.h"
 #include "string/convert.h"
+#include "AasBinaryCache.h"
+#include "AasTokeniser.h"
 #include "Doom3AasFile.h"
 #include "module/StaticModule.h"
 
@@ -13,8 +15,28 @@ namespace map
 namespace
 {
     const float DEWM3_AAS_VERSION = 1.07f;
+
+    // Reads the remaining contents of the given stream into a string
+    std::string readStreamContents(std::istream& stream)
+    {
+        std::string contents;
+        char chunk[65536];
+
+        while (stream.read(chunk, sizeof(chunk)) || stream.gcount() > 0)
+        {
+            contents.append(chunk, static_cast<std::size_t>(stream.gcount()));
+        }
+
+        return contents;
+    }
 }
 
+Doom3AasFileLoader::Doom3AasFileLoader()
+{}
+
+Doom3AasFileLoader::~Doom3AasFileLoader()
+{}
+
 const std::string& Doom3AasFileLoader::getAasFormatName() const
 {
     static std::string _name = "Doom 3 AAS";
@@ -50,12 +72,21 @@ bool Doom3AasFileLoader::canLoad(std::istream& stream) const
 
 IAasFilePtr Doom3AasFileLoader::loadFromStream(std::istream& stream)
 {
-    Doom3AasFilePtr aasFile = std::make_shared<Doom3AasFile>();
-
     // We assume that the stream is rewound to the beginning
+    std::string contents = readStreamContents(stream);
 
-    // Instantiate a tokeniser to read the version tag
-	parser::BasicDefTokeniser<std::istream> tok(stream);
+    if (_binaryCache)
+    {
+        if (auto cachedFile = _binaryCache->load(contents); cachedFile)
+        {
+            return cachedFile;
+        }
+    }
+
+    Doom3AasFilePtr aasFile = std::make_shared<Doom3AasFile>();
+
+    // Tokenise the file contents in place
+    AasTokeniser tok(contents.data(), contents.data() + contents.size());
 
     try
 	{
@@ -63,7 +94,7 @@ IAasFilePtr Doom3AasFileLoader::loadFromStream(std::istream& stream)
         parseVersion(tok);
 
         // Checksum (will throw if the string conversion fails)
-        string::convert<long>(tok.nextToken());
+        tok.nextInteger();
 
         aasFile->parseFromTokens(tok);
 	}
@@ -78,6 +109,11 @@ IAasFilePtr Doom3AasFileLoader::loadFromStream(std::istream& stream)
         return IAasFilePtr();
     }
 
+    if (_binaryCache)
+    {
+        _binaryCache->store(contents, *aasFile);
+    }
+
     return aasFile;
 }
 
@@ -115,6 +151,8 @@ void Doom3AasFileLoader::initialiseModule(const IApplicationContext& ctx)
 {
 	rMessage() << getName() << ": initialiseModule called." << std::endl;
 
+    _binaryCache.reset(new AasBinaryCache(ctx.getCacheDataPath() + "aas/"));
+
 	// Register ourselves as aas format
     GlobalAasFileManager().registerLoader(shared_from_this());
 }
@@ -123,6 +161,8 @@ void Doom3AasFileLoader::shutdownModule()
 {
 	// Unregister now that we're shutting down
 	GlobalAasFileManager().unregisterLoader(shared_from_this());
+
+    _binaryCache.reset();
 }
 
 // Static module instances
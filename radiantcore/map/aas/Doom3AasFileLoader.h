@@ -1,12 +1,15 @@
 #pragma once
 
 #include "iaasfile.h"
+#include <memory>
 
 namespace parser { class DefTokeniser; }
 
 namespace map
 {
 
+class AasBinaryCache;
+
 /**
  * A loader class designed to parse Doom 3 AAS Files.
  */
@@ -14,7 +17,14 @@ class Doom3AasFileLoader :
     public IAasFileLoader,
     public std::enable_shared_from_this<Doom3AasFileLoader>
 {
+private:
+    // Parsed files are stored here to skip the text parser next time
+    std::unique_ptr<AasBinaryCache> _binaryCache;
+
 public:
+    Doom3AasFileLoader();
+    ~Doom3AasFileLoader();
+
     virtual const std::string& getAasFormatName() const override;
 	virtual const std::string& getGameType() const override;
 
@@ -237,6 +237,9 @@ void importMap(const scene::INodePtr& node)
 		return;
 	}
 
+	// Link the incoming nodes into the scene in one go
+	scene::GraphTransaction transaction(GlobalSceneGraph());
+
 	// Discard all layer information found in the data to be merged
 	// We move everything into the active layer
 	{
@@ -55,6 +55,22 @@ MapExporter::MapExporter(IMapWriter& writer, const scene::IMapRootNodePtr& root,
 	construct();
 }
 
+MapExporter::MapExporter(IMapWriter& writer, const scene::IMapRootNodePtr& root, std::ostream& mapStream,
+				std::ostream& auxStream, std::ostream& binaryAuxStream, std::size_t nodeCount) :
+	_writer(writer),
+	_mapStream(mapStream),
+	_infoFileExporter(new InfoFileExporter(auxStream, binaryAuxStream)),
+	_root(root),
+	_dialogEventLimiter(registry::getValue<int>(RKEY_MAP_SAVE_STATUS_INTERLEAVE)),
+	_totalNodeCount(nodeCount),
+	_curNodeCount(0),
+	_entityNum(0),
+	_primitiveNum(0),
+    _sendProgressMessages(true)
+{
+	construct();
+}
+
 MapExporter::~MapExporter()
 {
 	// Close any info file stream
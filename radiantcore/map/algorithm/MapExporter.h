@@ -64,6 +64,10 @@ public:
 	MapExporter(IMapWriter& writer, const scene::IMapRootNodePtr& root,
 				std::ostream& mapStream, std::ostream& auxStream, std::size_t nodeCount = 0);
 
+	// Additional constructor writing the binary companion of the .darkradiant file too
+	MapExporter(IMapWriter& writer, const scene::IMapRootNodePtr& root, std::ostream& mapStream,
+				std::ostream& auxStream, std::ostream& binaryAuxStream, std::size_t nodeCount = 0);
+
 	// Cleans up the scene on destruction
 	~MapExporter();
 
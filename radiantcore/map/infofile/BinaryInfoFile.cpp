@@ -0,0 +1,87 @@
+#include "BinaryInfoFile.h"
+
+#include <cstring>
+#include "math/Hash.h"
+#include "stream/utils.h"
+
+namespace map
+{
+
+const char* const BinaryInfoFile::EXTENSION = ".bin";
+const char* const BinaryInfoFile::MAGIC = "DRINFBIN";
+
+namespace
+{
+	const std::size_t MAGIC_LENGTH = 8;
+}
+
+void BinaryInfoFile::Write(std::ostream& stream, const std::string& text, const std::vector<Block>& blocks)
+{
+	stream.write(MAGIC, MAGIC_LENGTH);
+	stream::writeLittleEndian<std::uint32_t>(stream, VERSION);
+	stream::writeLittleEndian<std::uint64_t>(stream, text.size());
+	stream::writeLengthPrefixedString(stream, GetTextHash(text));
+	stream::writeLittleEndian<std::uint32_t>(stream, static_cast<std::uint32_t>(blocks.size()));
+
+	for (const auto& block : blocks)
+	{
+		stream::writeLengthPrefixedString(stream, block.moduleName);
+		stream::writeLittleEndian<std::uint64_t>(stream, block.textStart);
+		stream::writeLittleEndian<std::uint64_t>(stream, block.textEnd);
+		stream::writeLengthPrefixedString(stream, block.data);
+	}
+}
+
+bool BinaryInfoFile::ReadHeader(std::istream& stream, Header& header)
+{
+	char magic[MAGIC_LENGTH];
+	stream.read(magic, MAGIC_LENGTH);
+
+	if (stream.fail() || std::memcmp(magic, MAGIC, MAGIC_LENGTH) != 0)
+	{
+		return false;
+	}
+
+	std::uint32_t version = 0;
+
+	return stream::readLittleEndian(stream, version) && version == VERSION &&
+		stream::readLittleEndian(stream, header.textSize) &&
+		stream::readLengthPrefixedString(stream, header.textHash) &&
+		stream::readLittleEndian(stream, header.blockCount);
+}
+
+bool BinaryInfoFile::MatchesText(const Header& header, const std::string& text)
+{
+	// Compare the size first, to avoid hashing the text if possible
+	return header.textSize == text.size() && header.textHash == GetTextHash(text);
+}
+
+bool BinaryInfoFile::ReadBlock(std::istream& stream, Block& block)
+{
+	std::uint64_t textStart = 0;
+	std::uint64_t textEnd = 0;
+
+	if (!stream::readLengthPrefixedString(stream, block.moduleName) ||
+		!stream::readLittleEndian(stream, textStart) ||
+		!stream::readLittleEndian(stream, textEnd) ||
+		!stream::readLengthPrefixedString(stream, block.data))
+	{
+		return false;
+	}
+
+	block.textStart = static_cast<std::size_t>(textStart);
+	block.textEnd = static_cast<std::size_t>(textEnd);
+
+	return true;
+}
+
+std::string BinaryInfoFile::GetTextHash(const std::string& text)
+{
+	// The hash is stored on disk, it needs to be stable across sessions
+	math::Hash hash;
+	hash.addString(text);
+
+	return hash;
+}
+
+} // namespace map
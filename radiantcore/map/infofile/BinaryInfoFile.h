@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace map
+{
+
+/**
+ * The binary companion of the .darkradiant info file, written next to it
+ * using the same file name plus an additional extension.
+ *
+ * It holds the blocks of those info file modules supporting binary data,
+ * together with the range of their blocks in the text file. The header
+ * contains the size and a hash of the text file it has been written with,
+ * it's ignored if the text file doesn't match (e.g. if the map has been
+ * saved by an older version in the meantime).
+ *
+ * Layout (numbers in little endian byte order, strings length-prefixed):
+ * Magic, uint32 version, uint64 text size, string text hash (SHA256, hex), uint32 block count,
+ * then for each block: string module name, uint64 text start, uint64 text end, string data
+ */
+class BinaryInfoFile
+{
+public:
+	// The extension added to the info file name
+	static const char* const EXTENSION;
+
+	static const char* const MAGIC;
+
+	// Version 2: The text hash is a SHA256 hash instead of the fast non-cryptographic one
+	static const std::uint32_t VERSION = 2;
+
+	struct Block
+	{
+		// The name of the module this block belongs to
+		std::string moduleName;
+
+		// The range of the module's text blocks in the info file
+		std::size_t textStart;
+		std::size_t textEnd;
+
+		// The data written by the module
+		std::string data;
+	};
+
+	// Writes the header and all blocks to the given stream. The text is the
+	// full contents of the text info file the blocks belong to.
+	static void Write(std::ostream& stream, const std::string& text, const std::vector<Block>& blocks);
+
+	struct Header
+	{
+		// Size and hash of the text info file this binary file has been written with
+		std::uint64_t textSize;
+		std::string textHash;
+
+		std::uint32_t blockCount;
+	};
+
+	// Reads the header, returns false if the stream is not a valid binary info file
+	static bool ReadHeader(std::istream& stream, Header& header);
+
+	// Returns true if the header belongs to the given text info file contents
+	static bool MatchesText(const Header& header, const std::string& text);
+
+	// Reads the next block, returns false if the stream is invalid
+	static bool ReadBlock(std::istream& stream, Block& block);
+
+private:
+	static std::string GetTextHash(const std::string& text);
+};
+
+} // namespace map
@@ -1,5 +1,8 @@
 #include "InfoFile.h"
 
+#include <algorithm>
+#include <iterator>
+#include <sstream>
 #include "itextstream.h"
 #include "imapinfofile.h"
 #include "string/convert.h"
@@ -14,7 +17,13 @@ const char* const InfoFile::HEADER_SEQUENCE = "DarkRadiant Map Information File
 
 // Pass the input stream to the constructor
 InfoFile::InfoFile(std::istream& infoStream, const scene::IMapRootNodePtr& root, const NodeIndexMap& nodeMap) :
-	_tok(infoStream),
+	InfoFile(infoStream, nullptr, root, nodeMap)
+{}
+
+InfoFile::InfoFile(std::istream& infoStream, std::istream* binaryStream,
+	const scene::IMapRootNodePtr& root, const NodeIndexMap& nodeMap) :
+	_infoStream(infoStream),
+	_binaryStream(binaryStream),
 	_isValid(true),
 	_root(root),
 	_nodeMap(nodeMap)
@@ -28,11 +37,33 @@ void InfoFile::parse()
 		module.onInfoFileLoadStart();
 	});
 
-	// Parse the Header
-	parseInfoFileHeader();
+	BinaryInfoFile::Header binaryHeader;
 
-	// Parse the blocks
-	parseInfoFileBody();
+	if (_binaryStream == nullptr || !_binaryStream->good() ||
+		!BinaryInfoFile::ReadHeader(*_binaryStream, binaryHeader))
+	{
+		// No binary blocks to load, parse the text directly from the stream
+		parser::BasicDefTokeniser<std::istream> tok(_infoStream);
+		parseInfoFile(tok);
+	}
+	else
+	{
+		std::string text((std::istreambuf_iterator<char>(_infoStream)), std::istreambuf_iterator<char>());
+
+		// The binary file has been written along the text using plain line breaks
+		text.erase(std::remove(text.begin(), text.end(), '\r'), text.end());
+
+		// Cut out the blocks of all modules which could load their binary data
+		auto loadedRanges = loadBinaryBlocks(text, binaryHeader);
+
+		for (auto range = loadedRanges.rbegin(); range != loadedRanges.rend(); ++range)
+		{
+			text.erase(range->first, range->second - range->first);
+		}
+
+		parser::BasicDefTokeniser<std::string> tok(text);
+		parseInfoFile(tok);
+	}
 
 	// Apply the parsed info to the scene
 	GlobalMapInfoFileManager().foreachModule([&](IMapInfoFileModule& module)
@@ -47,7 +78,70 @@ void InfoFile::parse()
 	});
 }
 
-void InfoFile::parseInfoFileHeader()
+void InfoFile::parseInfoFile(parser::DefTokeniser& tok)
+{
+	// Parse the Header
+	parseInfoFileHeader(tok);
+
+	// Parse the blocks
+	parseInfoFileBody(tok);
+}
+
+std::vector<std::pair<std::size_t, std::size_t>> InfoFile::loadBinaryBlocks(const std::string& text,
+	const BinaryInfoFile::Header& header)
+{
+	std::vector<std::pair<std::size_t, std::size_t>> loadedRanges;
+
+	if (!BinaryInfoFile::MatchesText(header, text))
+	{
+		rMessage() << "[InfoFile] Binary info file doesn't match the info file, ignoring it" << std::endl;
+		return loadedRanges;
+	}
+
+	for (std::uint32_t i = 0; i < header.blockCount; ++i)
+	{
+		BinaryInfoFile::Block block;
+
+		if (!BinaryInfoFile::ReadBlock(*_binaryStream, block))
+		{
+			rWarning() << "[InfoFile] Binary info file is truncated" << std::endl;
+			break;
+		}
+
+		// The ranges are ordered and must not overlap
+		auto rangeStart = loadedRanges.empty() ? 0 : loadedRanges.back().second;
+
+		if (block.textStart < rangeStart || block.textEnd < block.textStart || block.textEnd > text.size())
+		{
+			rWarning() << "[InfoFile] Invalid text range in binary block of " << block.moduleName << std::endl;
+			continue;
+		}
+
+		GlobalMapInfoFileManager().foreachModule([&](IMapInfoFileModule& module)
+		{
+			if (module.getName() != block.moduleName)
+			{
+				return;
+			}
+
+			std::istringstream blockStream(block.data);
+
+			if (module.readBinaryBlock(blockStream))
+			{
+				loadedRanges.emplace_back(block.textStart, block.textEnd);
+				return;
+			}
+
+			// Discard anything the module has loaded, its text blocks will be parsed instead
+			rWarning() << "[InfoFile] Could not load binary block of " << block.moduleName << std::endl;
+			module.onInfoFileLoadStart();
+		});
+	}
+
+	return loadedRanges;
+}
+
+void InfoFile::parseInfoFileHeader(parser::DefTokeniser& tok)
 {
 	try
 	{
@@ -57,10 +151,10 @@ void InfoFile::parseInfoFileHeader()
 		// Parse the string "DarkRadiant Map Information File Version"
 		for (std::size_t i = 0; i < parts.size(); i++)
 		{
-			_tok.assertNextToken(parts[i]);
+			tok.assertNextToken(parts[i]);
 		}
 
-		float version = std::stof(_tok.nextToken());
+		float version = std::stof(tok.nextToken());
 
 		if (version != MAP_INFO_VERSION)
 		{
@@ -82,14 +176,14 @@ void InfoFile::parseInfoFileHeader()
 	}
 }
 
-void InfoFile::parseInfoFileBody()
+void InfoFile::parseInfoFileBody(parser::DefTokeniser& tok)
 {
 	// The opening brace of the master block
-	_tok.assertNextToken("{");
+	tok.assertNextToken("{");
 
-	while (_tok.hasMoreTokens())
+	while (tok.hasMoreTokens())
 	{
-		std::string token = _tok.nextToken();
+		std::string token = tok.nextToken();
 
 		bool blockParsed = false;
 
@@ -98,7 +192,7 @@ void InfoFile::parseInfoFileBody()
 		{
 			if (!blockParsed && module.canParseBlock(token))
 			{
-				module.parseBlock(token, _tok);
+				module.parseBlock(token, tok);
 				blockParsed = true;
 			}
 		});
@@ -117,14 +211,14 @@ void InfoFile::parseInfoFileBody()
 		rWarning() << "Unknown keyword " << token << " encountered, will try to ignore this block." << std::endl;
 
 		// We can only ignore a block if there is a block beginning curly brace
-		_tok.assertNextToken("{");
+		tok.assertNextToken("{");
 
 		// Ignore the block
 		int depth = 1;
 
-		while (_tok.hasMoreTokens() && depth > 0)
+		while (tok.hasMoreTokens() && depth > 0)
 		{
-			std::string token2 = _tok.nextToken();
+			std::string token2 = tok.nextToken();
 
 			if (token2 == "{") 
 			{
@@ -2,7 +2,12 @@
 
 #include "imap.h"
 #include "imapinfofile.h"
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
 #include "parser/DefTokeniser.h"
+#include "BinaryInfoFile.h"
 
 namespace map
 {
@@ -18,8 +23,9 @@ public:
 	static const char* const HEADER_SEQUENCE;
 
 private:
-	// The actual DefTokeniser to split the infoStream into pieces
-	parser::BasicDefTokeniser<std::istream> _tok;
+	// The text stream and its optional binary companion
+	std::istream& _infoStream;
+	std::istream* _binaryStream;
 
 	// TRUE if the map info file was found to be valid
 	bool _isValid;
@@ -34,12 +40,22 @@ public:
 	// Pass the input stream to the constructor, plus some info about the map we're dealing with
 	InfoFile(std::istream& infoStream, const scene::IMapRootNodePtr& root, const NodeIndexMap& nodeMap);
 
+	// Constructor taking the binary companion stream of the info file, which can be null
+	InfoFile(std::istream& infoStream, std::istream* binaryStream,
+		const scene::IMapRootNodePtr& root, const NodeIndexMap& nodeMap);
+
 	// Parse the entire file
 	void parse();
 
 private:
-	void parseInfoFileHeader();
-	void parseInfoFileBody();
+	// Lets the modules load their binary blocks, returns the text ranges
+	// of the modules which succeeded, these don't need to be parsed anymore
+	std::vector<std::pair<std::size_t, std::size_t>> loadBinaryBlocks(const std::string& text,
+		const BinaryInfoFile::Header& header);
+
+	void parseInfoFile(parser::DefTokeniser& tok);
+	void parseInfoFileHeader(parser::DefTokeniser& tok);
+	void parseInfoFileBody(parser::DefTokeniser& tok);
 };
 
 } // namespace map
@@ -3,44 +3,87 @@
 #include "imapinfofile.h"
 #include "itextstream.h"
 #include "InfoFile.h"
+#include "BinaryInfoFile.h"
 
 namespace map
 {
 
 InfoFileExporter::InfoFileExporter(std::ostream& stream) :
-    _stream(stream)
+    _stream(stream),
+    _binaryStream(nullptr)
 {
-	GlobalMapInfoFileManager().foreachModule([](IMapInfoFileModule& module)
-	{
-		module.onInfoFileSaveStart();
-	});
+	construct();
+}
 
-    // Write the information file header
-    _stream << InfoFile::HEADER_SEQUENCE << " " << InfoFile::MAP_INFO_VERSION << std::endl;
-    _stream << "{" << std::endl;
+InfoFileExporter::InfoFileExporter(std::ostream& stream, std::ostream& binaryStream) :
+    _stream(stream),
+    _binaryStream(&binaryStream)
+{
+	construct();
 }
 
 InfoFileExporter::~InfoFileExporter()
 {
+	std::vector<BinaryInfoFile::Block> binaryBlocks;
+
 	// Tell the info file modules to write their data now
 	GlobalMapInfoFileManager().foreachModule([&](IMapInfoFileModule& module)
 	{
 		rMessage() << "Writing info file blocks for " << module.getName() << std::endl;
 
-		module.writeBlocks(_stream);
+		std::size_t textStart = static_cast<std::size_t>(_buffer.tellp());
+
+		module.writeBlocks(_buffer);
+
+		if (_binaryStream == nullptr)
+		{
+			return;
+		}
+
+		// Remember where the text blocks are, these can be skipped when loading the binary data
+		std::ostringstream binaryData;
+
+		if (module.writeBinaryBlock(binaryData))
+		{
+			binaryBlocks.push_back(BinaryInfoFile::Block
+			{
+				module.getName(), textStart, static_cast<std::size_t>(_buffer.tellp()), binaryData.str()
+			});
+		}
 	});
 
 	// Write the closing braces of the information file
-    _stream << "}" << std::endl;
+    _buffer << "}" << std::endl;
 
+	auto text = _buffer.str();
+
+	_stream << text;
 	_stream.flush();
 
+	if (_binaryStream != nullptr)
+	{
+		BinaryInfoFile::Write(*_binaryStream, text, binaryBlocks);
+		_binaryStream->flush();
+	}
+
 	GlobalMapInfoFileManager().foreachModule([](IMapInfoFileModule& module)
 	{
 		module.onInfoFileSaveFinished();
 	});
 }
 
+void InfoFileExporter::construct()
+{
+	GlobalMapInfoFileManager().foreachModule([](IMapInfoFileModule& module)
+	{
+		module.onInfoFileSaveStart();
+	});
+
+    // Write the information file header
+    _buffer << InfoFile::HEADER_SEQUENCE << " " << InfoFile::MAP_INFO_VERSION << std::endl;
+    _buffer << "{" << std::endl;
+}
+
 void InfoFileExporter::beginSaveMap(const scene::IMapRootNodePtr& root)
 {
 	GlobalMapInfoFileManager().foreachModule([&](IMapInfoFileModule& module)
@@ -15,10 +15,19 @@ private:
 	// The stream we're writing to
 	std::ostream& _stream;
 
+	// The optional stream receiving the binary companion file (can be NULL)
+	std::ostream* _binaryStream;
+
+	// The text file contents, written to the stream when done
+	std::ostringstream _buffer;
+
 public:
 	// The constructor prepares the output stream
 	InfoFileExporter(std::ostream& stream);
 
+	// Additional constructor writing the binary companion file too
+	InfoFileExporter(std::ostream& stream, std::ostream& binaryStream);
+
 	// Cleans up the scene on destruction
 	~InfoFileExporter();
 
@@ -28,6 +37,9 @@ public:
 	void finishSaveMap(const scene::IMapRootNodePtr& root);
 	void visitEntity(const scene::INodePtr& node, std::size_t entityNum);
 	void visitPrimitive(const scene::INodePtr& node, std::size_t entityNum, std::size_t primitiveNum);
+
+private:
+	void construct();
 };
 typedef std::shared_ptr<InfoFileExporter> InfoFileExporterPtr;
 
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <climits>
+#include <set>
+#include <string>
+#include <unordered_set>
+
+/**
+ * \brief
+ * Set of unique postfixes, e.g. "1", "6" or "04"
+ *
+ * Next to the postfix strings the set keeps track of the numbers which are
+ * used in their plain form ("4" but not "04"), such that the lowest unused
+ * number can be found without testing all the numbers from 1 upwards.
+ */
+class PostfixSet
+{
+    // All postfixes in this set, including non-numeric ones like "-"
+    std::unordered_set<std::string> _postfixes;
+
+    // The numbers used by the postfixes in their plain form
+    std::unordered_set<int> _numbers;
+
+    // All numbers below this one are used, except the ones in _releasedNumbers
+    mutable int _nextCandidate = 1;
+
+    // Numbers below _nextCandidate which have been erased again
+    std::set<int> _releasedNumbers;
+
+public:
+    bool empty() const
+    {
+        return _postfixes.empty();
+    }
+
+    bool contains(const std::string& postfix) const
+    {
+        return _postfixes.count(postfix) > 0;
+    }
+
+    /// Returns true if the postfix was not present before
+    bool insert(const std::string& postfix)
+    {
+        if (!_postfixes.insert(postfix).second)
+        {
+            return false;
+        }
+
+        int number = 0;
+
+        if (getPlainNumber(postfix, number))
+        {
+            _numbers.insert(number);
+            _releasedNumbers.erase(number);
+        }
+
+        return true;
+    }
+
+    /// Returns true if the postfix was present
+    bool erase(const std::string& postfix)
+    {
+        if (_postfixes.erase(postfix) == 0)
+        {
+            return false;
+        }
+
+        int number = 0;
+
+        if (getPlainNumber(postfix, number))
+        {
+            _numbers.erase(number);
+
+            if (number < _nextCandidate)
+            {
+                _releasedNumbers.insert(number);
+            }
+        }
+
+        return true;
+    }
+
+    /// Adds all postfixes of the other set
+    void merge(const PostfixSet& other)
+    {
+        for (const auto& postfix : other._postfixes)
+        {
+            insert(postfix);
+        }
+    }
+
+    /// Returns the lowest number (starting at 1) not used as postfix, in string form
+    std::string getLowestUnusedNumber() const
+    {
+        if (!_releasedNumbers.empty())
+        {
+            return std::to_string(*_releasedNumbers.begin());
+        }
+
+        // Advancing past the used numbers is paid for by their insertion
+        while (_nextCandidate < INT_MAX && _numbers.count(_nextCandidate) > 0)
+        {
+            ++_nextCandidate;
+        }
+
+        return std::to_string(_nextCandidate);
+    }
+
+private:
+    // Returns true if the postfix is the plain decimal form of a positive
+    // number, without leading zeros
+    static bool getPlainNumber(const std::string& postfix, int& number)
+    {
+        if (postfix.empty() || postfix.size() > 10 || postfix[0] < '1' || postfix[0] > '9')
+        {
+            return false;
+        }
+
+        long long value = 0;
+
+        for (auto c : postfix)
+        {
+            if (c < '0' || c > '9')
+            {
+                return false;
+            }
+
+            value = value * 10 + (c - '0');
+        }
+
+        if (value > INT_MAX)
+        {
+            return false;
+        }
+
+        number = static_cast<int>(value);
+        return true;
+    }
+};
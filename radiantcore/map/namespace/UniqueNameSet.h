@@ -1,7 +1,6 @@
 #pragma once
 
-#include <set>
-#include <map>
+#include <unordered_map>
 
 #include "ComplexName.h"
 
@@ -14,8 +13,8 @@ class UniqueNameSet
 {
     // This maps name prefixes to a set of used postfixes
     // e.g. "func_static_" => ["1","3","4","5","05","10"]
-    // Allows fairly quick lookup of used names and postfixes
-    typedef std::map<std::string, PostfixSet> Names;
+    // Allows quick lookup of used names and of the lowest free postfix
+    typedef std::unordered_map<std::string, PostfixSet> Names;
     Names _names;
 
 public:
@@ -59,10 +58,8 @@ public:
         }
 
         // The prefix is inserted at this point, add the postfix to the set
-        auto result = found->second.insert(name.getPostfix());
-
-        // Return the boolean of the insertion result, it is true on successful insertion
-        return result.second;
+        // The result is true on successful insertion
+        return found->second.insert(name.getPostfix());
     }
 
     /**
@@ -83,7 +80,7 @@ public:
 
         // The prefix has been found, remove the postfix from the set
         // Return true if the erase method removed any elements
-        return found->second.erase(name.getPostfix()) > 0;
+        return found->second.erase(name.getPostfix());
     }
 
     /**
@@ -155,7 +152,7 @@ public:
             const PostfixSet& postfixSet = found->second;
 
             // If we know the number too, the full name exists
-            return postfixSet.find(name.getPostfix()) != postfixSet.end();
+            return postfixSet.contains(name.getPostfix());
         }
 
         // Prefix is not known, hence full name is not known
@@ -178,7 +175,7 @@ public:
             if (local != _names.end())
 			{
                 // Prefix exists, merge the postfixes
-                local->second.insert(i.second.begin(), i.second.end());
+                local->second.merge(i.second);
             }
             else
 			{
@@ -0,0 +1,302 @@
+#include "BinaryModelCache.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <fmt/format.h>
+
+#include "ifilesystem.h"
+#include "itextstream.h"
+#include "os/fs.h"
+#include "os/path.h"
+#include "math/Hash.h"
+#include "stream/TemporaryOutputStream.h"
+#include "StaticModelSurface.h"
+
+namespace model
+{
+
+namespace
+{
+    constexpr char CacheFileMagic[4] = { 'D', 'R', 'M', 'C' };
+
+    // Increase this whenever the file layout or the import code changes
+    constexpr std::uint32_t CacheFileVersion = 3;
+
+    constexpr const char* const CacheFileExtension = ".drmc";
+
+    struct FileHeader
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t vertexSize;
+        std::uint32_t numSurfaces;
+        std::uint64_t sourceSize;
+        std::int64_t sourceTime;
+        std::uint64_t pathOffset;
+        std::uint64_t pathLength;
+        std::uint64_t contextOffset;
+        std::uint64_t contextLength;
+    };
+
+    struct SurfaceEntry
+    {
+        std::uint64_t materialOffset;
+        std::uint64_t materialLength;
+        std::uint64_t fallbackMaterialOffset;
+        std::uint64_t fallbackMaterialLength;
+        std::uint64_t vertexOffset;
+        std::uint64_t numVertices;
+        std::uint64_t indexOffset;
+        std::uint64_t numIndices;
+    };
+
+    static_assert(sizeof(FileHeader) == 64, "Unexpected padding in the cache file header");
+    static_assert(sizeof(SurfaceEntry) == 64, "Unexpected padding in the cache surface table");
+
+    struct SourceFileInfo
+    {
+        bool valid = false;
+        std::uint64_t size = 0;
+        std::int64_t time = 0;
+    };
+
+    std::int64_t getModificationTime(const std::string& path)
+    {
+        return static_cast<std::int64_t>(fs::last_write_time(path).time_since_epoch().count());
+    }
+
+    SourceFileInfo getSourceFileInfo(const std::string& modelPath)
+    {
+        SourceFileInfo result;
+
+        try
+        {
+            if (path_is_absolute(modelPath.c_str()))
+            {
+                result.size = static_cast<std::uint64_t>(fs::file_size(modelPath));
+                result.time = getModificationTime(modelPath);
+                result.valid = true;
+                return result;
+            }
+
+            auto info = GlobalFileSystem().getFileInfo(modelPath);
+
+            if (info.isEmpty())
+            {
+                return result;
+            }
+
+            // Files in PK4s are checked against the archive's modification time
+            auto archivePath = info.getArchivePath();
+
+            result.size = info.getSize();
+            result.time = getModificationTime(info.getIsPhysicalFile() ?
+                os::standardPathWithSlash(archivePath) + modelPath : archivePath);
+            result.valid = true;
+        }
+        catch (const fs::filesystem_error&)
+        {
+            result.valid = false;
+        }
+
+        return result;
+    }
+
+    inline std::uint64_t alignOffset(std::uint64_t offset)
+    {
+        return (offset + 7) & ~static_cast<std::uint64_t>(7);
+    }
+
+    // Returns true if the given block lies within the buffer
+    inline bool isInBuffer(const std::vector<char>& buffer, std::uint64_t offset, std::uint64_t length)
+    {
+        return offset <= buffer.size() && length <= buffer.size() - offset;
+    }
+}
+
+BinaryModelCache::BinaryModelCache(const std::string& cacheDirectory, const std::string& context) :
+    _cacheDirectory(os::standardPathWithSlash(cacheDirectory)),
+    _context(context)
+{}
+
+std::string BinaryModelCache::getCacheFilePath(const std::string& modelPath) const
+{
+    // Different contexts are not replacing each other's files
+    math::FastHash hash;
+    hash.addString(_context + '\n' + modelPath);
+
+    return _cacheDirectory + fmt::format("{0:016x}", hash.getDigest64()) + CacheFileExtension;
+}
+
+StaticModelPtr BinaryModelCache::load(const std::string& modelPath)
+{
+    auto sourceInfo = getSourceFileInfo(modelPath);
+
+    if (!sourceInfo.valid)
+    {
+        return StaticModelPtr();
+    }
+
+    // Read the whole file in one go, the surfaces are constructed from the blocks
+    std::ifstream stream(getCacheFilePath(modelPath), std::ios::binary | std::ios::ate);
+
+    if (!stream)
+    {
+        return StaticModelPtr();
+    }
+
+    std::vector<char> buffer(static_cast<std::size_t>(stream.tellg()));
+    stream.seekg(0, std::ios::beg);
+
+    if (buffer.size() < sizeof(FileHeader) || !stream.read(buffer.data(), buffer.size()))
+    {
+        return StaticModelPtr();
+    }
+
+    FileHeader header;
+    std::memcpy(&header, buffer.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, CacheFileMagic, sizeof(CacheFileMagic)) != 0 ||
+        header.version != CacheFileVersion || header.vertexSize != sizeof(ArbitraryMeshVertex) ||
+        header.sourceSize != sourceInfo.size || header.sourceTime != sourceInfo.time ||
+        !isInBuffer(buffer, sizeof(FileHeader), header.numSurfaces * sizeof(SurfaceEntry)) ||
+        !isInBuffer(buffer, header.pathOffset, header.pathLength) ||
+        !isInBuffer(buffer, header.contextOffset, header.contextLength) ||
+        modelPath.compare(0, std::string::npos, buffer.data() + header.pathOffset, header.pathLength) != 0 ||
+        _context.compare(0, std::string::npos, buffer.data() + header.contextOffset, header.contextLength) != 0)
+    {
+        return StaticModelPtr(); // outdated or not ours
+    }
+
+    std::vector<StaticModelSurfacePtr> surfaces;
+    surfaces.reserve(header.numSurfaces);
+
+    for (std::uint32_t i = 0; i < header.numSurfaces; ++i)
+    {
+        SurfaceEntry entry;
+        std::memcpy(&entry, buffer.data() + sizeof(FileHeader) + i * sizeof(SurfaceEntry), sizeof(entry));
+
+        if (!isInBuffer(buffer, entry.materialOffset, entry.materialLength) ||
+            !isInBuffer(buffer, entry.fallbackMaterialOffset, entry.fallbackMaterialLength) ||
+            entry.numVertices > buffer.size() / sizeof(ArbitraryMeshVertex) ||
+            entry.numIndices > buffer.size() / sizeof(unsigned int) ||
+            !isInBuffer(buffer, entry.vertexOffset, entry.numVertices * sizeof(ArbitraryMeshVertex)) ||
+            !isInBuffer(buffer, entry.indexOffset, entry.numIndices * sizeof(unsigned int)))
+        {
+            rWarning() << "Corrupt model cache entry for " << modelPath << std::endl;
+            return StaticModelPtr();
+        }
+
+        std::vector<ArbitraryMeshVertex> vertices(entry.numVertices);
+        std::memcpy(vertices.data(), buffer.data() + entry.vertexOffset, entry.numVertices * sizeof(ArbitraryMeshVertex));
+
+        std::vector<unsigned int> indices(entry.numIndices);
+        std::memcpy(indices.data(), buffer.data() + entry.indexOffset, entry.numIndices * sizeof(unsigned int));
+
+        auto& surface = surfaces.emplace_back(std::make_shared<StaticModelSurface>(
+            std::move(vertices), std::move(indices), true));
+
+        surface->setDefaultMaterial(std::string(buffer.data() + entry.materialOffset, entry.materialLength));
+        surface->setFallbackMaterial(std::string(buffer.data() + entry.fallbackMaterialOffset, entry.fallbackMaterialLength));
+    }
+
+    auto model = std::make_shared<StaticModel>(surfaces);
+
+    model->setFilename(os::getFilename(modelPath));
+    model->setModelPath(modelPath);
+
+    return model;
+}
+
+void BinaryModelCache::store(const std::string& modelPath, const StaticModel& model)
+{
+    auto sourceInfo = getSourceFileInfo(modelPath);
+
+    if (!sourceInfo.valid)
+    {
+        return;
+    }
+
+    const auto& surfaces = model.getSurfaces();
+
+    FileHeader header;
+    std::memcpy(header.magic, CacheFileMagic, sizeof(CacheFileMagic));
+    header.version = CacheFileVersion;
+    header.vertexSize = static_cast<std::uint32_t>(sizeof(ArbitraryMeshVertex));
+    header.numSurfaces = static_cast<std::uint32_t>(surfaces.size());
+    header.sourceSize = sourceInfo.size;
+    header.sourceTime = sourceInfo.time;
+
+    // The strings follow the surface table, then the aligned geometry blocks
+    std::uint64_t offset = sizeof(FileHeader) + surfaces.size() * sizeof(SurfaceEntry);
+
+    header.pathOffset = offset;
+    header.pathLength = modelPath.length();
+    offset += modelPath.length();
+
+    header.contextOffset = offset;
+    header.contextLength = _context.length();
+    offset += _context.length();
+
+    std::vector<SurfaceEntry> entries(surfaces.size());
+
+    for (std::size_t i = 0; i < surfaces.size(); ++i)
+    {
+        entries[i].materialOffset = offset;
+        entries[i].materialLength = surfaces[i].originalSurface->getDefaultMaterial().length();
+        offset += entries[i].materialLength;
+
+        entries[i].fallbackMaterialOffset = offset;
+        entries[i].fallbackMaterialLength = surfaces[i].originalSurface->getFallbackMaterial().length();
+        offset += entries[i].fallbackMaterialLength;
+    }
+
+    for (std::size_t i = 0; i < surfaces.size(); ++i)
+    {
+        const auto& surface = *surfaces[i].originalSurface;
+
+        entries[i].vertexOffset = offset = alignOffset(offset);
+        entries[i].numVertices = surface.getVertexArray().size();
+        offset += entries[i].numVertices * sizeof(ArbitraryMeshVertex);
+
+        entries[i].indexOffset = offset = alignOffset(offset);
+        entries[i].numIndices = surface.getIndexArray().size();
+        offset += entries[i].numIndices * sizeof(unsigned int);
+    }
+
+    std::vector<char> buffer(static_cast<std::size_t>(offset), 0);
+
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    std::memcpy(buffer.data() + sizeof(header), entries.data(), entries.size() * sizeof(SurfaceEntry));
+    std::memcpy(buffer.data() + header.pathOffset, modelPath.data(), modelPath.length());
+    std::memcpy(buffer.data() + header.contextOffset, _context.data(), _context.length());
+
+    for (std::size_t i = 0; i < surfaces.size(); ++i)
+    {
+        const auto& surface = *surfaces[i].originalSurface;
+        const auto& material = surface.getDefaultMaterial();
+        const auto& fallbackMaterial = surface.getFallbackMaterial();
+
+        std::memcpy(buffer.data() + entries[i].materialOffset, material.data(), material.length());
+        std::memcpy(buffer.data() + entries[i].fallbackMaterialOffset, fallbackMaterial.data(), fallbackMaterial.length());
+        std::memcpy(buffer.data() + entries[i].vertexOffset, surface.getVertexArray().data(),
+            entries[i].numVertices * sizeof(ArbitraryMeshVertex));
+        std::memcpy(buffer.data() + entries[i].indexOffset, surface.getIndexArray().data(),
+            entries[i].numIndices * sizeof(unsigned int));
+    }
+
+    auto cacheFilePath = getCacheFilePath(modelPath);
+
+    try
+    {
+        stream::TemporaryOutputStream::WriteFile(cacheFilePath, buffer);
+    }
+    catch (const std::exception& ex)
+    {
+        rWarning() << "Could not store " << modelPath << " in the model cache: " << ex.what() << std::endl;
+    }
+}
+
+}
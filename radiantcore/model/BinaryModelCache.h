@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include "StaticModel.h"
+
+namespace model
+{
+
+/**
+ * On-disk cache of imported static models, storing the finished vertex
+ * and index arrays of each surface along with its default and fallback
+ * material. Which of the two is used is decided after loading the model.
+ * Loading a model from this cache skips the format parsers and the
+ * vertex welding and tangent calculation done during import.
+ *
+ * Each model is stored in its own file, the entry is keyed by the source
+ * path and the context string (the game, mod and import settings) and is
+ * only used as long as the size and modification time of the source file
+ * are unchanged. For models in PK4 files the archive's time is taken into
+ * account.
+ *
+ * The file layout is flat: a header, a fixed-size surface table and the
+ * 8-byte aligned vertex and index blocks, referenced by their offsets.
+ * The vertex data is stored in the native ArbitraryMeshVertex layout.
+ */
+class BinaryModelCache
+{
+private:
+    std::string _cacheDirectory;
+
+    // Everything next to the model path deciding the imported data
+    std::string _context;
+
+public:
+    // Constructs a cache storing its files in the given directory, which
+    // is created on demand. Entries stored with a different context are ignored.
+    BinaryModelCache(const std::string& cacheDirectory, const std::string& context);
+
+    // Returns the model stored for the given path, or an empty pointer if it
+    // is not in the cache or the source file has changed since it was stored
+    StaticModelPtr load(const std::string& modelPath);
+
+    // Stores the surfaces of the given model, loaded from the given path
+    void store(const std::string& modelPath, const StaticModel& model);
+
+private:
+    std::string getCacheFilePath(const std::string& modelPath) const;
+};
+
+}
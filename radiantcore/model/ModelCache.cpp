@@ -2,6 +2,7 @@
 
 #include "ieclass.h"
 #include "ifilesystem.h"
+#include "igame.h"
 #include "imodel.h"
 #include "imd5model.h"
 #include "imd5anim.h"
@@ -9,19 +10,62 @@
 #include "iparticlenode.h"
 
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include "os/path.h"
 #include "os/file.h"
+#include "gamelib.h"
 
 #include "module/StaticModule.h"
 #include <functional>
 
 #include "map/algorithm/Models.h"
+#include "StaticModel.h"
 
 namespace model 
 {
 
+namespace
+{
+	// name may be absolute or relative
+	inline std::string rootPath(const std::string& name)
+	{
+		return GlobalFileSystem().findRoot(
+			path_is_absolute(name.c_str()) ? name : GlobalFileSystem().findFile(name)
+		);
+	}
+
+	struct PrefetchJob
+	{
+		std::string path;
+		IModelImporterPtr importer;
+		std::promise<IModelPtr> result;
+		std::shared_ptr<std::atomic<PrefetchState>> state;
+	};
+
+	// Shared by all workers of a prefetchModels() call, each worker
+	// is picking the next unprocessed job until all are done
+	struct PrefetchQueue
+	{
+		std::vector<PrefetchJob> jobs;
+		std::atomic<std::size_t> nextJob{ 0 };
+	};
+
+	// The materials of a loaded model can only be looked up on the main thread
+	inline void resolveMaterialFallbacks(const IModelPtr& model)
+	{
+		if (auto staticModel = std::dynamic_pointer_cast<StaticModel>(model); staticModel)
+		{
+			staticModel->resolveMaterialFallbacks();
+		}
+	}
+}
+
 ModelCache::ModelCache() :
-	_enabled(true)
+	_enabled(true),
+	_loadTime(0),
+	_binaryCacheHits(0)
 {}
 
 scene::INodePtr ModelCache::getModelNode(const std::string& modelPath)
@@ -101,6 +145,8 @@ scene::INodePtr ModelCache::getModelNode(const std::string& modelPath)
 
 IModelPtr ModelCache::getModel(const std::string& modelPath)
 {
+	collectPrefetchedModels();
+
 	// Try to lookup the existing model
 	auto found = _modelMap.find(modelPath);
 
@@ -109,18 +155,36 @@ IModelPtr ModelCache::getModel(const std::string& modelPath)
 		return found->second;
 	}
 
-	// The model is not cached or the cache is disabled, load afresh
+	auto startTime = std::chrono::steady_clock::now();
 
-	// Get the extension of this model
-	std::string type = os::getExtension(modelPath);
+	IModelPtr model;
+	auto pending = _pendingModels.find(modelPath);
 
-	// Find a suitable model loader
-	IModelImporterPtr modelLoader = GlobalModelFormatManager().getImporter(type);
+	if (pending != _pendingModels.end())
+	{
+		// This model has been prefetched, the worker might still be busy
+		model = takePrefetchedModel(pending);
+	}
+	else
+	{
+		// The model is not cached or the cache is disabled, load afresh
+
+		// Get the extension of this model
+		std::string type = os::getExtension(modelPath);
 
-	IModelPtr model = modelLoader->loadModelFromPath(modelPath);
+		// Find a suitable model loader
+		IModelImporterPtr modelLoader = GlobalModelFormatManager().getImporter(type);
+
+		model = loadModelFromPath(modelLoader, modelPath);
+		++_statistics.modelsLoaded;
+	}
+
+	_loadTime += std::chrono::steady_clock::now() - startTime;
 
 	if (model)
 	{
+		resolveMaterialFallbacks(model);
+
 		// Model successfully loaded, insert a reference into the map
 		_modelMap.emplace(modelPath, model);
 	}
@@ -128,6 +192,190 @@ IModelPtr ModelCache::getModel(const std::string& modelPath)
 	return model;
 }
 
+void ModelCache::prefetchModels(const std::set<std::string>& modelPaths)
+{
+	// Forget about the workers which are done
+	_prefetchWorkers.erase(std::remove_if(_prefetchWorkers.begin(), _prefetchWorkers.end(), [](const std::future<void>& worker)
+	{
+		return worker.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	}), _prefetchWorkers.end());
+
+	auto queue = std::make_shared<PrefetchQueue>();
+	auto nullModelLoader = GlobalModelFormatManager().getImporter("");
+
+	// Resolve the paths to the keys used by the model importers, this is
+	// involving the modelDefs and the VFS and is done on this thread
+	for (const auto& modelPath : modelPaths)
+	{
+		auto modelDef = GlobalEntityClassManager().findModel(modelPath);
+		const auto& actualModelPath = modelDef ? modelDef->mesh : modelPath;
+
+		auto type = actualModelPath.substr(actualModelPath.rfind(".") + 1);
+		auto importer = GlobalModelFormatManager().getImporter(type);
+
+		if (type == "prt" || importer == nullModelLoader)
+		{
+			continue;
+		}
+
+		auto key = os::getRelativePath(actualModelPath, rootPath(actualModelPath));
+
+		if (_modelMap.count(key) > 0 || _pendingModels.count(key) > 0)
+		{
+			continue;
+		}
+
+		auto state = std::make_shared<std::atomic<PrefetchState>>(PrefetchState::Queued);
+		auto& job = queue->jobs.emplace_back(PrefetchJob{ key, importer, std::promise<IModelPtr>(), state });
+		_pendingModels.emplace(key, PendingModel{ job.result.get_future(), state });
+	}
+
+	if (queue->jobs.empty())
+	{
+		return;
+	}
+
+	_statistics.modelsPrefetched += queue->jobs.size();
+	_statistics.modelsLoaded += queue->jobs.size();
+
+	auto numWorkers = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), queue->jobs.size());
+
+	for (std::size_t i = 0; i < numWorkers; ++i)
+	{
+		_prefetchWorkers.emplace_back(std::async(std::launch::async, [this, queue]()
+		{
+			for (auto i = queue->nextJob++; i < queue->jobs.size(); i = queue->nextJob++)
+			{
+				auto& job = queue->jobs[i];
+				auto expected = PrefetchState::Queued;
+
+				// Models removed before they have been started are skipped
+				if (!job.state->compare_exchange_strong(expected, PrefetchState::Loading))
+				{
+					job.result.set_value(IModelPtr());
+					continue;
+				}
+
+				try
+				{
+					job.result.set_value(loadModelFromPath(job.importer, job.path));
+				}
+				catch (...)
+				{
+					job.result.set_exception(std::current_exception());
+				}
+
+				std::lock_guard<std::mutex> lock(_completedModelsLock);
+				_completedModels.push_back(job.path);
+			}
+		}));
+	}
+}
+
+ModelCacheStatistics ModelCache::getStatistics() const
+{
+	auto statistics = _statistics;
+	statistics.modelsReadFromBinaryCache = _binaryCacheHits;
+	statistics.loadMilliseconds = static_cast<std::size_t>(
+		std::chrono::duration_cast<std::chrono::milliseconds>(_loadTime).count());
+
+	return statistics;
+}
+
+IModelPtr ModelCache::loadModelFromPath(const IModelImporterPtr& importer, const std::string& modelPath)
+{
+	if (_binaryCache)
+	{
+		if (auto cachedModel = _binaryCache->load(modelPath); cachedModel)
+		{
+			++_binaryCacheHits;
+			return cachedModel;
+		}
+	}
+
+	auto model = importer->loadModelFromPath(modelPath);
+
+	// Only static models can be restored from the binary cache
+	if (auto staticModel = std::dynamic_pointer_cast<StaticModel>(model); staticModel && _binaryCache)
+	{
+		_binaryCache->store(modelPath, *staticModel);
+	}
+
+	return model;
+}
+
+IModelPtr ModelCache::takePrefetchedModel(PendingModelMap::iterator pending)
+{
+	IModelPtr model;
+
+	try
+	{
+		model = pending->second.result.get();
+	}
+	catch (const std::exception& ex)
+	{
+		rError() << "Failed to load model " << pending->first << ": " << ex.what() << std::endl;
+	}
+
+	_pendingModels.erase(pending);
+
+	return model;
+}
+
+void ModelCache::collectPrefetchedModels()
+{
+	if (!_enabled) return;
+
+	std::vector<std::string> completedModels;
+
+	{
+		std::lock_guard<std::mutex> lock(_completedModelsLock);
+		completedModels.swap(_completedModels);
+	}
+
+	for (const auto& modelPath : completedModels)
+	{
+		auto pending = _pendingModels.find(modelPath);
+
+		// The entry might have been discarded or requeued in the meantime
+		if (pending == _pendingModels.end() ||
+			pending->second.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			continue;
+		}
+
+		if (auto model = takePrefetchedModel(pending); model)
+		{
+			resolveMaterialFallbacks(model);
+			_modelMap.emplace(modelPath, model);
+		}
+	}
+}
+
+void ModelCache::cancelPrefetchedModel(PendingModelMap::iterator pending)
+{
+	auto expected = PrefetchState::Queued;
+
+	// A worker which already started loading must be done before the model
+	// can be loaded again, they would both write it to the binary cache
+	if (!pending->second.state->compare_exchange_strong(expected, PrefetchState::Cancelled))
+	{
+		pending->second.result.wait();
+	}
+
+	_pendingModels.erase(pending);
+}
+
+void ModelCache::discardPrefetchedModels()
+{
+	// Destroying the futures returned by std::async waits for the tasks
+	_prefetchWorkers.clear();
+	_pendingModels.clear();
+
+	std::lock_guard<std::mutex> lock(_completedModelsLock);
+	_completedModels.clear();
+}
+
 scene::INodePtr ModelCache::getModelNodeForStaticResource(const std::string& resourcePath)
 {
     // Get the extension of this model
@@ -164,6 +412,12 @@ void ModelCache::removeModel(const std::string& modelPath)
 		_modelMap.erase(found);
 	}
 
+	// A prefetched model will be outdated too
+	if (auto pending = _pendingModels.find(modelPath); pending != _pendingModels.end())
+	{
+		cancelPrefetchedModel(pending);
+	}
+
 	// Allow usage of the modelnodemap again.
 	_enabled = true;
 }
@@ -174,6 +428,7 @@ void ModelCache::clear()
 	// get cleared, which might trigger a loopback to insert().
 	_enabled = false;
 
+	discardPrefetchedModels();
 	_modelMap.clear();
 
 	// Allow usage of the modelnodemap again.
@@ -200,6 +455,7 @@ const StringSet& ModelCache::getDependencies() const
 	{
 		_dependencies.insert(MODULE_MODELFORMATMANAGER);
 		_dependencies.insert(MODULE_COMMANDSYSTEM);
+		_dependencies.insert(MODULE_GAMEMANAGER);
 	}
 
 	return _dependencies;
@@ -209,6 +465,12 @@ void ModelCache::initialiseModule(const IApplicationContext& ctx)
 {
 	rMessage() << getName() << "::initialiseModule called." << std::endl;
 
+	// Models imported for a different game or with different import settings must not be reused
+	auto cacheContext = GlobalGameManager().currentGame()->getKeyValue("type") + ";" +
+		(game::current::getValue<bool>("/modelFormat/ase/useMaterialNameIfNoBitmapFound") ? "1" : "0");
+
+	_binaryCache = std::make_unique<BinaryModelCache>(ctx.getCacheDataPath() + "models/", cacheContext);
+
 	GlobalCommandSystem().addCommand("RefreshModels", 
 		std::bind(&ModelCache::refreshModelsCmd, this, std::placeholders::_1));
 	GlobalCommandSystem().addCommand("RefreshSelectedModels", 
@@ -218,6 +480,8 @@ void ModelCache::initialiseModule(const IApplicationContext& ctx)
 void ModelCache::shutdownModule()
 {
 	clear();
+
+	_binaryCache.reset();
 }
 
 void ModelCache::refreshModels(bool blockScreenUpdates)
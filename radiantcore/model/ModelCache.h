@@ -1,13 +1,27 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <map>
+#include <mutex>
 #include <string>
+#include <vector>
 #include "imodelcache.h"
 #include "icommandsystem.h"
+#include "BinaryModelCache.h"
 
 namespace model
 {
 
+// The state of a model handed to the prefetch workers
+enum class PrefetchState
+{
+	Queued,
+	Loading,
+	Cancelled,
+};
+
 class ModelCache :
 	public IModelCache
 {
@@ -16,9 +30,35 @@ private:
 	typedef std::map<std::string, IModelPtr> ModelMap;
 	ModelMap _modelMap;
 
+	// A model handed to the prefetch workers. The state is shared with the
+	// worker, which skips the model if it has been cancelled before it started.
+	struct PendingModel
+	{
+		std::future<IModelPtr> result;
+		std::shared_ptr<std::atomic<PrefetchState>> state;
+	};
+
+	// Models handed to the prefetch workers, not yet moved to the model map
+	typedef std::map<std::string, PendingModel> PendingModelMap;
+	PendingModelMap _pendingModels;
+
+	// Paths of the prefetched models the workers have finished with
+	std::mutex _completedModelsLock;
+	std::vector<std::string> _completedModels;
+
+	// The worker tasks processing the prefetched models
+	std::vector<std::future<void>> _prefetchWorkers;
+
 	// Flag to disable the cache on demand (used during clear())
 	bool _enabled;
 
+	// Imported static models stored on disk, shared with the prefetch workers
+	std::unique_ptr<BinaryModelCache> _binaryCache;
+
+	ModelCacheStatistics _statistics;
+	std::chrono::steady_clock::duration _loadTime;
+	std::atomic<std::size_t> _binaryCacheHits;
+
 	sigc::signal<void> _sigModelsReloaded;
 
 public:
@@ -30,6 +70,9 @@ public:
 	// greebo: For documentation, see the abstract base class.
 	IModelPtr getModel(const std::string& modelPath) override;
 
+    void prefetchModels(const std::set<std::string>& modelPaths) override;
+    ModelCacheStatistics getStatistics() const override;
+
     scene::INodePtr getModelNodeForStaticResource(const std::string& resourcePath) override;
 
 	// Clear methods
@@ -51,6 +94,21 @@ public:
 private:
     scene::INodePtr loadNullModel(const std::string& modelPath);
 
+    // Loads the model using the binary cache if possible, invoked by the prefetch workers too
+    IModelPtr loadModelFromPath(const IModelImporterPtr& importer, const std::string& modelPath);
+
+    // Waits for the given prefetched model and removes it from the pending map
+    IModelPtr takePrefetchedModel(PendingModelMap::iterator pending);
+
+    // Removes the given prefetched model, waiting for the worker if it is already loading it
+    void cancelPrefetchedModel(PendingModelMap::iterator pending);
+
+    // Moves the models the workers have finished with from the pending to the model map
+    void collectPrefetchedModels();
+
+    // Blocks until all worker tasks are done, discarding any unclaimed models
+    void discardPrefetchedModels();
+
 	// Command targets
 	void refreshModelsCmd(const cmd::ArgumentList& args);
 	void refreshSelectedModelsCmd(const cmd::ArgumentList& args);
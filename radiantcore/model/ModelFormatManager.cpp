@@ -10,6 +10,7 @@
 #include "module/StaticModule.h"
 
 #include "import/FbxModelLoader.h"
+#include "StaticModel.h"
 #include "export/AseExporter.h"
 #include "export/Lwo2Exporter.h"
 #include "export/WavefrontExporter.h"
@@ -214,6 +215,11 @@ void ModelFormatManager::convertModelCmd(const cmd::ArgumentList& args)
         throw cmd::ExecutionFailure(fmt::format(_("Could not load model file {0}"), inputPath));
     }
 
+    if (auto staticModel = std::dynamic_pointer_cast<StaticModel>(model); staticModel)
+    {
+        staticModel->resolveMaterialFallbacks();
+    }
+
     // Stream all model surfaces to the exporter
     for (int i = 0; i < model->getSurfaceCount(); ++i)
     {
@@ -11,6 +11,7 @@
 #include "VolumeIntersectionValue.h"
 #include "math/Ray.h"
 #include "BasicUndoMemento.h"
+#include "gamelib.h"
 
 namespace model
 {
@@ -48,6 +49,31 @@ StaticModel::StaticModel(const StaticModel& other) :
     }
 }
 
+void StaticModel::resolveMaterialFallbacks()
+{
+    // #4644: Doom3 / TDM don't use the *MATERIAL_NAME in ASE models, only *BITMAP is used
+    // Use the fallback (introduced in #2499) only when the game allows it
+    auto useFallbacks = game::current::getValue<bool>("/modelFormat/ase/useMaterialNameIfNoBitmapFound");
+
+    for (const auto& surface : _surfVec)
+    {
+        const auto& fallback = surface.originalSurface->getFallbackMaterial();
+
+        if (fallback.empty()) continue;
+
+        const auto& defaultMaterial = surface.originalSurface->getDefaultMaterial();
+
+        if (useFallbacks && (defaultMaterial.empty() || !GlobalMaterialManager().materialExists(defaultMaterial)))
+        {
+            surface.originalSurface->setDefaultMaterial(fallback);
+        }
+
+        surface.originalSurface->setFallbackMaterial(std::string());
+    }
+
+    updateMaterialList();
+}
+
 void StaticModel::connectUndoSystem(IUndoSystem& undoSystem)
 {
     assert(_undoStateSaver == nullptr);
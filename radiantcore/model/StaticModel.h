@@ -211,6 +211,13 @@ public:
 	 */
 	const SurfaceList& getSurfaces() const;
 
+	/**
+	 * Switch the surfaces to their fallback material if their default material
+	 * doesn't exist (and the game allows it). This is looking up materials, so it
+	 * must be called on the main thread, after the model has been loaded.
+	 */
+	void resolveMaterialFallbacks();
+
 	// Revert to base scale
 	void revertScale();
 
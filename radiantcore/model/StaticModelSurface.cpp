@@ -9,13 +9,29 @@
 #include "gamelib.h"
 
 #include "string/replace.h"
+#include <atomic>
 
 namespace model
 {
 
+namespace
+{
+	std::size_t generateGeometryId()
+	{
+		static std::atomic<std::size_t> nextGeometryId(1);
+		return nextGeometryId++;
+	}
+}
+
 StaticModelSurface::StaticModelSurface(std::vector<ArbitraryMeshVertex>&& vertices, std::vector<unsigned int>&& indices) :
-    _vertices(vertices),
-    _indices(indices),
+    StaticModelSurface(std::move(vertices), std::move(indices), false)
+{}
+
+StaticModelSurface::StaticModelSurface(std::vector<ArbitraryMeshVertex>&& vertices, std::vector<unsigned int>&& indices,
+    bool tangentsCalculated) :
+    _vertices(std::move(vertices)),
+    _indices(std::move(indices)),
+    _geometryId(generateGeometryId()),
     _dlRegular(0),
     _dlProgramVcol(0),
     _dlProgramNoVCol(0)
@@ -26,29 +42,29 @@ StaticModelSurface::StaticModelSurface(std::vector<ArbitraryMeshVertex>&& vertic
         _localAABB.includePoint(vertex.vertex);
     }
 
-    calculateTangents();
-    createDisplayLists();
+    if (!tangentsCalculated)
+    {
+        calculateTangents();
+    }
 }
 
 StaticModelSurface::StaticModelSurface(const StaticModelSurface& other) :
 	_defaultMaterial(other._defaultMaterial),
+	_fallbackMaterial(other._fallbackMaterial),
 	_vertices(other._vertices),
 	_indices(other._indices),
 	_nIndices(other._nIndices),
 	_localAABB(other._localAABB),
+	_geometryId(generateGeometryId()),
 	_dlRegular(0),
 	_dlProgramVcol(0),
 	_dlProgramNoVCol(0)
-{
-	createDisplayLists();
-}
+{}
 
 // Destructor. Release the GL display lists.
 StaticModelSurface::~StaticModelSurface()
 {
-	glDeleteLists(_dlRegular, 1);
-	glDeleteLists(_dlProgramNoVCol, 1);
-	glDeleteLists(_dlProgramVcol, 1);
+	releaseDisplayLists();
 }
 
 // Tangent calculation
@@ -81,6 +97,11 @@ void StaticModelSurface::calculateTangents()
 // Back-end render function
 void StaticModelSurface::render(const RenderInfo& info) const
 {
+	if (_dlRegular == 0)
+	{
+		createDisplayLists();
+	}
+
 	// Invoke appropriate display list
 	if (info.checkFlag(RENDER_PROGRAM))
     {
@@ -100,7 +121,7 @@ void StaticModelSurface::render(const RenderInfo& info) const
 }
 
 // Construct a list for GLProgram mode, either with or without vertex colour
-GLuint StaticModelSurface::compileProgramList(bool includeColour)
+GLuint StaticModelSurface::compileProgramList(bool includeColour) const
 {
     GLuint list = glGenLists(1);
 	assert(list != 0); // check if we run out of display lists
@@ -112,7 +133,7 @@ GLuint StaticModelSurface::compileProgramList(bool includeColour)
 		 ++i)
 	{
 		// Get the vertex for this index
-		ArbitraryMeshVertex& v = _vertices[*i];
+		const ArbitraryMeshVertex& v = _vertices[*i];
 
 		// Submit the vertex attributes and coordinate
 		if (GLEW_ARB_vertex_program)
@@ -140,7 +161,7 @@ GLuint StaticModelSurface::compileProgramList(bool includeColour)
 }
 
 // Construct the two display lists
-void StaticModelSurface::createDisplayLists()
+void StaticModelSurface::createDisplayLists() const
 {
 	// Generate the lists for lighting mode
     _dlProgramNoVCol = compileProgramList(false);
@@ -157,7 +178,7 @@ void StaticModelSurface::createDisplayLists()
 		 ++i)
 	{
 		// Get the vertex for this index
-		ArbitraryMeshVertex& v = _vertices[*i];
+		const ArbitraryMeshVertex& v = _vertices[*i];
 
 		// Submit attributes
 		glNormal3dv(v.normal);
@@ -169,6 +190,20 @@ void StaticModelSurface::createDisplayLists()
 	glEndList();
 }
 
+void StaticModelSurface::releaseDisplayLists()
+{
+	if (_dlRegular == 0)
+	{
+		return; // never rendered, nothing to release
+	}
+
+	glDeleteLists(_dlRegular, 1);
+	glDeleteLists(_dlProgramNoVCol, 1);
+	glDeleteLists(_dlProgramVcol, 1);
+
+	_dlRegular = _dlProgramNoVCol = _dlProgramVcol = 0;
+}
+
 // Perform selection test for this surface
 void StaticModelSurface::testSelect(Selector& selector, SelectionTest& test,
     const Matrix4& localToWorld, bool twoSided) const
@@ -236,6 +271,11 @@ const std::vector<unsigned int>& StaticModelSurface::getIndexArray() const
 	return _indices;
 }
 
+std::size_t StaticModelSurface::getGeometryId() const
+{
+	return _geometryId;
+}
+
 const std::string& StaticModelSurface::getDefaultMaterial() const
 {
 	return _defaultMaterial;
@@ -246,6 +286,16 @@ void StaticModelSurface::setDefaultMaterial(const std::string& defaultMaterial)
 	_defaultMaterial = defaultMaterial;
 }
 
+const std::string& StaticModelSurface::getFallbackMaterial() const
+{
+	return _fallbackMaterial;
+}
+
+void StaticModelSurface::setFallbackMaterial(const std::string& fallbackMaterial)
+{
+	_fallbackMaterial = fallbackMaterial;
+}
+
 const std::string& StaticModelSurface::getActiveMaterial() const
 {
     return !_activeMaterial.empty() ? _activeMaterial : _defaultMaterial;
@@ -323,11 +373,10 @@ void StaticModelSurface::applyScale(const Vector3& scale, const StaticModelSurfa
 
 	calculateTangents();
 
-	glDeleteLists(_dlRegular, 1);
-	glDeleteLists(_dlProgramNoVCol, 1);
-	glDeleteLists(_dlProgramVcol, 1);
+	_geometryId = generateGeometryId();
 
-	createDisplayLists();
+	// The lists are re-compiled on the next render call
+	releaseDisplayLists();
 }
 
 } // namespace model
@@ -28,12 +28,16 @@ namespace model
  */
 class StaticModelSurface :
 	public IIndexedModelSurface,
-	public OpenGLRenderable
+	public InstanceableRenderable
 {
 private:
 	// Name of the material this surface is using by default (without any skins)
 	std::string _defaultMaterial;
 
+	// Material to use instead of the default one if that doesn't exist, see
+	// StaticModel::resolveMaterialFallbacks()
+	std::string _fallbackMaterial;
+
 	// Name of the material with skin remaps applied
 	std::string _activeMaterial;
 
@@ -54,23 +58,33 @@ private:
 	// The AABB containing this surface, in local object space.
 	AABB _localAABB;
 
-	// The GL display lists for this surface's geometry
-	GLuint _dlRegular;
-	GLuint _dlProgramVcol;
-    GLuint _dlProgramNoVCol;
+	// Identifies the current state of the vertex and index arrays
+	std::size_t _geometryId;
+
+	// The GL display lists for this surface's geometry, compiled on first
+	// render, such that surfaces can be constructed without a GL context
+	mutable GLuint _dlRegular;
+	mutable GLuint _dlProgramVcol;
+	mutable GLuint _dlProgramNoVCol;
 
 private:
 	// Calculate tangent and bitangent vectors for all vertices.
 	void calculateTangents();
 
 	// Create the display lists
-    GLuint compileProgramList(bool includeColour);
-	void createDisplayLists();
+    GLuint compileProgramList(bool includeColour) const;
+	void createDisplayLists() const;
+	void releaseDisplayLists();
 
 public:
     // Move-construct this static model surface from the given vertex- and index array
 	StaticModelSurface(std::vector<ArbitraryMeshVertex>&& vertices, std::vector<unsigned int>&& indices);
 
+	// Move-construct a surface from vertices which already carry their tangents and
+	// bitangents (as returned by getVertexArray()), these are taken over unchanged
+	StaticModelSurface(std::vector<ArbitraryMeshVertex>&& vertices, std::vector<unsigned int>&& indices,
+		bool tangentsCalculated);
+
 	// Copy-constructor.
 	StaticModelSurface(const StaticModelSurface& other);
 
@@ -103,9 +117,15 @@ public:
 	const std::vector<ArbitraryMeshVertex>& getVertexArray() const override;
 	const std::vector<unsigned int>& getIndexArray() const override;
 
+	// InstanceableRenderable
+	std::size_t getGeometryId() const override;
+
 	const std::string& getDefaultMaterial() const override;
 	void setDefaultMaterial(const std::string& defaultMaterial);
 
+	const std::string& getFallbackMaterial() const;
+	void setFallbackMaterial(const std::string& fallbackMaterial);
+
 	const std::string& getActiveMaterial() const override;
 	void setActiveMaterial(const std::string& activeMaterial);
 
@@ -6,6 +6,8 @@
 #include "string/replace.h"
 #include <fmt/format.h>
 
+#include "TextExportBuffer.h"
+
 namespace model
 {
 
@@ -38,18 +40,21 @@ void AseExporter::exportToPath(const std::string& outputPath, const std::string&
 
 void AseExporter::exportToStream(std::ostream& stream)
 {
+	// Collect the text in a large buffer, which is written in blocks
+	TextExportBuffer out(stream);
+
 	// Header / scene block
-	stream << "*3DSMAX_ASCIIEXPORT	200" << std::endl;
-	stream << "*COMMENT \"DarkRadiant ASCII Scene Export(*.ase)\"" << std::endl;
-	stream << "*SCENE {" << std::endl;
-	stream << "\t*SCENE_FILENAME \"" << GlobalMapModule().getMapName() << "\"" << std::endl;
-	stream << "\t*SCENE_FIRSTFRAME 0" << std::endl;
-	stream << "\t*SCENE_LASTFRAME 100" << std::endl;
-	stream << "\t*SCENE_FRAMESPEED 30" << std::endl;
-	stream << "\t*SCENE_TICKSPERFRAME 160" << std::endl;
-	stream << "\t*SCENE_BACKGROUND_STATIC 0.0000	0.0000	0.0000" << std::endl;
-	stream << "\t*SCENE_AMBIENT_STATIC 0.0000	0.0000	0.0000" << std::endl;
-	stream << "}" << std::endl;
+	out << "*3DSMAX_ASCIIEXPORT	200\n";
+	out << "*COMMENT \"DarkRadiant ASCII Scene Export(*.ase)\"\n";
+	out << "*SCENE {\n";
+	out << "\t*SCENE_FILENAME \"" << GlobalMapModule().getMapName() << "\"\n";
+	out << "\t*SCENE_FIRSTFRAME 0\n";
+	out << "\t*SCENE_LASTFRAME 100\n";
+	out << "\t*SCENE_FRAMESPEED 30\n";
+	out << "\t*SCENE_TICKSPERFRAME 160\n";
+	out << "\t*SCENE_BACKGROUND_STATIC 0.0000	0.0000	0.0000\n";
+	out << "\t*SCENE_AMBIENT_STATIC 0.0000	0.0000	0.0000\n";
+	out << "}\n";
 
 	// Remove empty surfaces before exporting (#5104)
 	for (auto it = _surfaces.begin(); it != _surfaces.end();)
@@ -65,8 +70,8 @@ void AseExporter::exportToStream(std::ostream& stream)
 	}
 
 	// Materials
-	stream << "*MATERIAL_LIST {" << std::endl;
-	stream << "\t*MATERIAL_COUNT " << _surfaces.size() << std::endl;
+	out << "*MATERIAL_LIST {\n";
+	out << "\t*MATERIAL_COUNT " << _surfaces.size() << '\n';
 
 	std::size_t m = 0;
 
@@ -75,47 +80,47 @@ void AseExporter::exportToStream(std::ostream& stream)
 		std::string aseMaterial = pair.second.materialName;
 		string::replace_all(aseMaterial, "/", "\\");
 
-		stream << "\t*MATERIAL " << m << " {" << std::endl;
-		stream << "\t\t*MATERIAL_NAME \"" << aseMaterial << "\"" << std::endl;
-		stream << "\t\t*MATERIAL_CLASS \"Standard\"" << std::endl;
-		stream << "\t\t*MATERIAL_AMBIENT 0.5882	0.5882	0.5882" << std::endl;
-		stream << "\t\t*MATERIAL_DIFFUSE 0.5882	0.5882	0.5882" << std::endl;
-		stream << "\t\t*MATERIAL_SPECULAR 0.9000	0.9000	0.9000" << std::endl;
-		stream << "\t\t*MATERIAL_SHINE 0.1000" << std::endl;
-		stream << "\t\t*MATERIAL_SHINESTRENGTH 0.0000" << std::endl;
-		stream << "\t\t*MATERIAL_TRANSPARENCY 0.0000" << std::endl;
-		stream << "\t\t*MATERIAL_WIRESIZE 1.0000" << std::endl;
-		stream << "\t\t*MATERIAL_SHADING Blinn" << std::endl;
-		stream << "\t\t*MATERIAL_XP_FALLOFF 0.0000" << std::endl;
-		stream << "\t\t*MATERIAL_SELFILLUM 0.0000" << std::endl;
-		stream << "\t\t*MATERIAL_FALLOFF In" << std::endl;
-		stream << "\t\t*MATERIAL_XP_TYPE Filter" << std::endl;
-		stream << "\t\t*MAP_DIFFUSE {" << std::endl;
-		stream << "\t\t\t*MAP_NAME \"" << aseMaterial << "\"" << std::endl;
-		stream << "\t\t\t*MAP_CLASS \"Bitmap\"" << std::endl;
-		stream << "\t\t\t*MAP_SUBNO 1" << std::endl;
-		stream << "\t\t\t*MAP_AMOUNT 1.0000" << std::endl;
-		stream << "\t\t\t*BITMAP \"\\\\base\\" << aseMaterial << "\"" << std::endl;
-		stream << "\t\t\t*MAP_TYPE Screen" << std::endl;
-		stream << "\t\t\t*UVW_U_OFFSET 0.0000" << std::endl;
-		stream << "\t\t\t*UVW_V_OFFSET 0.0000" << std::endl;
-		stream << "\t\t\t*UVW_U_TILING 1.0000" << std::endl;
-		stream << "\t\t\t*UVW_V_TILING 1.0000" << std::endl;
-		stream << "\t\t\t*UVW_ANGLE 0.0000" << std::endl;
-		stream << "\t\t\t*UVW_BLUR 1.0000" << std::endl;
-		stream << "\t\t\t*UVW_BLUR_OFFSET 0.0000" << std::endl;
-		stream << "\t\t\t*UVW_NOUSE_AMT 1.0000" << std::endl;
-		stream << "\t\t\t*UVW_NOISE_SIZE 1.0000" << std::endl;
-		stream << "\t\t\t*UVW_NOISE_LEVEL 1" << std::endl;
-		stream << "\t\t\t*UVW_NOISE_PHASE 0.0000" << std::endl;
-		stream << "\t\t\t*BITMAP_FILTER Pyramidal" << std::endl;
-		stream << "\t\t}" << std::endl;
-		stream << "\t}" << std::endl;
+		out << "\t*MATERIAL " << m << " {\n";
+		out << "\t\t*MATERIAL_NAME \"" << aseMaterial << "\"\n";
+		out << "\t\t*MATERIAL_CLASS \"Standard\"\n";
+		out << "\t\t*MATERIAL_AMBIENT 0.5882	0.5882	0.5882\n";
+		out << "\t\t*MATERIAL_DIFFUSE 0.5882	0.5882	0.5882\n";
+		out << "\t\t*MATERIAL_SPECULAR 0.9000	0.9000	0.9000\n";
+		out << "\t\t*MATERIAL_SHINE 0.1000\n";
+		out << "\t\t*MATERIAL_SHINESTRENGTH 0.0000\n";
+		out << "\t\t*MATERIAL_TRANSPARENCY 0.0000\n";
+		out << "\t\t*MATERIAL_WIRESIZE 1.0000\n";
+		out << "\t\t*MATERIAL_SHADING Blinn\n";
+		out << "\t\t*MATERIAL_XP_FALLOFF 0.0000\n";
+		out << "\t\t*MATERIAL_SELFILLUM 0.0000\n";
+		out << "\t\t*MATERIAL_FALLOFF In\n";
+		out << "\t\t*MATERIAL_XP_TYPE Filter\n";
+		out << "\t\t*MAP_DIFFUSE {\n";
+		out << "\t\t\t*MAP_NAME \"" << aseMaterial << "\"\n";
+		out << "\t\t\t*MAP_CLASS \"Bitmap\"\n";
+		out << "\t\t\t*MAP_SUBNO 1\n";
+		out << "\t\t\t*MAP_AMOUNT 1.0000\n";
+		out << "\t\t\t*BITMAP \"\\\\base\\" << aseMaterial << "\"\n";
+		out << "\t\t\t*MAP_TYPE Screen\n";
+		out << "\t\t\t*UVW_U_OFFSET 0.0000\n";
+		out << "\t\t\t*UVW_V_OFFSET 0.0000\n";
+		out << "\t\t\t*UVW_U_TILING 1.0000\n";
+		out << "\t\t\t*UVW_V_TILING 1.0000\n";
+		out << "\t\t\t*UVW_ANGLE 0.0000\n";
+		out << "\t\t\t*UVW_BLUR 1.0000\n";
+		out << "\t\t\t*UVW_BLUR_OFFSET 0.0000\n";
+		out << "\t\t\t*UVW_NOUSE_AMT 1.0000\n";
+		out << "\t\t\t*UVW_NOISE_SIZE 1.0000\n";
+		out << "\t\t\t*UVW_NOISE_LEVEL 1\n";
+		out << "\t\t\t*UVW_NOISE_PHASE 0.0000\n";
+		out << "\t\t\t*BITMAP_FILTER Pyramidal\n";
+		out << "\t\t}\n";
+		out << "\t}\n";
 
 		++m;
 	}
 
-	stream << "}" << std::endl; // Material List End
+	out << "}\n"; // Material List End
 
 	// Geom Objects
 	m = 0;
@@ -124,114 +129,114 @@ void AseExporter::exportToStream(std::ostream& stream)
 	{
 		const Surface& surface = pair.second;
 
-		stream << "*GEOMOBJECT {" << std::endl;
-
-		stream << "\t*NODE_NAME \"mesh" << m << "\"" << std::endl;
-		stream << "\t*NODE_TM {" << std::endl;
-		stream << "\t\t*NODE_NAME \"mesh" << m << "\"" << std::endl;
-		stream << "\t\t*INHERIT_POS 0 0 0" << std::endl;
-		stream << "\t\t*INHERIT_ROT 0 0 0" << std::endl;
-		stream << "\t\t*INHERIT_SCL 0 0 0" << std::endl;
-		stream << "\t\t*TM_ROW0 1.0000	0.0000	0.0000" << std::endl;
-		stream << "\t\t*TM_ROW1 0.0000	1.0000	0.0000" << std::endl;
-		stream << "\t\t*TM_ROW2 0.0000	0.0000	1.0000" << std::endl;
-		stream << "\t\t*TM_ROW3 0.0000	0.0000	0.0000" << std::endl;
-		stream << "\t\t*TM_POS 0.0000	0.0000	0.0000" << std::endl;
-		stream << "\t\t*TM_ROTAXIS 0.0000	0.0000	0.0000" << std::endl;
-		stream << "\t\t*TM_ROTANGLE 0.0000" << std::endl;
-		stream << "\t\t*TM_SCALE 1.0000	1.0000	1.0000" << std::endl;
-		stream << "\t\t*TM_SCALEAXIS 0.0000	0.0000	0.0000" << std::endl;
-		stream << "\t\t*TM_SCALEAXISANG 0.0000" << std::endl;
-		stream << "\t}" << std::endl;
-
-		stream << "\t*MESH {" << std::endl;
-
-		stream << "\t\t*TIMEVALUE 0" << std::endl;
-		stream << "\t\t*MESH_NUMVERTEX " << surface.vertices.size() << std::endl;
-		stream << "\t\t*MESH_NUMFACES " << (surface.indices.size() / 3) << std::endl;
+		out << "*GEOMOBJECT {\n";
+
+		out << "\t*NODE_NAME \"mesh" << m << "\"\n";
+		out << "\t*NODE_TM {\n";
+		out << "\t\t*NODE_NAME \"mesh" << m << "\"\n";
+		out << "\t\t*INHERIT_POS 0 0 0\n";
+		out << "\t\t*INHERIT_ROT 0 0 0\n";
+		out << "\t\t*INHERIT_SCL 0 0 0\n";
+		out << "\t\t*TM_ROW0 1.0000	0.0000	0.0000\n";
+		out << "\t\t*TM_ROW1 0.0000	1.0000	0.0000\n";
+		out << "\t\t*TM_ROW2 0.0000	0.0000	1.0000\n";
+		out << "\t\t*TM_ROW3 0.0000	0.0000	0.0000\n";
+		out << "\t\t*TM_POS 0.0000	0.0000	0.0000\n";
+		out << "\t\t*TM_ROTAXIS 0.0000	0.0000	0.0000\n";
+		out << "\t\t*TM_ROTANGLE 0.0000\n";
+		out << "\t\t*TM_SCALE 1.0000	1.0000	1.0000\n";
+		out << "\t\t*TM_SCALEAXIS 0.0000	0.0000	0.0000\n";
+		out << "\t\t*TM_SCALEAXISANG 0.0000\n";
+		out << "\t}\n";
+
+		out << "\t*MESH {\n";
+
+		out << "\t\t*TIMEVALUE 0\n";
+		out << "\t\t*MESH_NUMVERTEX " << surface.vertices.size() << '\n';
+		out << "\t\t*MESH_NUMFACES " << (surface.indices.size() / 3) << '\n';
 
 		// Vertices
-		stream << "\t\t*MESH_VERTEX_LIST {" << std::endl;
+		out << "\t\t*MESH_VERTEX_LIST {\n";
 
 		for (std::size_t v = 0; v < surface.vertices.size(); ++v)
 		{
 			const Vertex3f& vert = surface.vertices[v].vertex;
 
-			stream << "\t\t\t*MESH_VERTEX " << v << "\t" << vert.x() << "\t" << vert.y() << "\t" << vert.z() << std::endl;
+			out << "\t\t\t*MESH_VERTEX " << v << "\t" << vert.x() << "\t" << vert.y() << "\t" << vert.z() << '\n';
 		}
 
-		stream << "\t\t}" << std::endl;
+		out << "\t\t}\n";
 
 		// Faces
-		stream << "\t\t*MESH_FACE_LIST {" << std::endl;
+		out << "\t\t*MESH_FACE_LIST {\n";
 
 		for (std::size_t i = 0; i+2 < surface.indices.size(); i += 3)
 		{
 			std::size_t faceNum = i / 3;
 
-			stream << fmt::format("\t\t\t*MESH_FACE {:3d}:  A: {:3d} B: {:3d} C: {:3d} AB:       0 BC:    0 CA:    0	 *MESH_SMOOTHING 1 	*MESH_MTLID {:3d}",
-				faceNum, surface.indices[i], surface.indices[i + 1], surface.indices[i + 2], m) << std::endl;
+			out.format("\t\t\t*MESH_FACE {:3d}:  A: {:3d} B: {:3d} C: {:3d} AB:       0 BC:    0 CA:    0	 *MESH_SMOOTHING 1 	*MESH_MTLID {:3d}\n",
+				faceNum, surface.indices[i], surface.indices[i + 1], surface.indices[i + 2], m);
 		}
 
-		stream << "\t\t}" << std::endl;
+		out << "\t\t}\n";
 
-		stream << "\t\t*MESH_NUMTVERTEX " << surface.vertices.size() << std::endl;
+		out << "\t\t*MESH_NUMTVERTEX " << surface.vertices.size() << '\n';
 
-		stream << "\t\t*MESH_TVERTLIST {" << std::endl;
+		out << "\t\t*MESH_TVERTLIST {\n";
 
 		for (std::size_t v = 0; v < surface.vertices.size(); ++v)
 		{
 			const TexCoord2f& tex = surface.vertices[v].texcoord;
 			
 			// Invert the T coordinate
-			stream << "\t\t\t*MESH_TVERT " << v << "\t" << tex.x() << "\t" << (-tex.y()) << "\t0.0000" << std::endl;
+			out << "\t\t\t*MESH_TVERT " << v << "\t" << tex.x() << "\t" << (-tex.y()) << "\t0.0000\n";
 		}
 
-		stream << "\t\t}" << std::endl;
+		out << "\t\t}\n";
 		
 		// TFaces
-		stream << "\t\t*MESH_NUMTVFACES " << (surface.indices.size() / 3) << std::endl;
-		stream << "\t\t*MESH_TFACELIST {" << std::endl;
+		out << "\t\t*MESH_NUMTVFACES " << (surface.indices.size() / 3) << '\n';
+		out << "\t\t*MESH_TFACELIST {\n";
 
 		for (std::size_t i = 0; i + 2 < surface.indices.size(); i += 3)
 		{
 			std::size_t faceNum = i / 3;
 
-			stream << fmt::format("\t\t\t*MESH_TFACE {:3d}\t{:3d}\t{:3d}\t{:3d}",
-				faceNum, surface.indices[i], surface.indices[i + 1], surface.indices[i + 2]) << std::endl;
+			out.format("\t\t\t*MESH_TFACE {:3d}\t{:3d}\t{:3d}\t{:3d}\n",
+				faceNum, surface.indices[i], surface.indices[i + 1], surface.indices[i + 2]);
 		}
 
-		stream << "\t\t}" << std::endl;
+		out << "\t\t}\n";
 
 		// CVerts
-		stream << "\t\t*MESH_NUMCVERTEX " << surface.vertices.size() << std::endl;
+		out << "\t\t*MESH_NUMCVERTEX " << surface.vertices.size() << '\n';
 
-		stream << "\t\t*MESH_CVERTLIST {" << std::endl;
+		out << "\t\t*MESH_CVERTLIST {\n";
 
 		for (std::size_t v = 0; v < surface.vertices.size(); ++v)
 		{
 			const Vector3& vcol = surface.vertices[v].colour;
 
-			stream << "\t\t\t*MESH_VERTCOL " << v << "\t" << vcol.x() << "\t" << vcol.y() << "\t" << vcol.z() << std::endl;
+			out << "\t\t\t*MESH_VERTCOL " << v << "\t" << vcol.x() << "\t" << vcol.y() << "\t" << vcol.z() << '\n';
 		}
 
-		stream << "\t\t}" << std::endl;
+		out << "\t\t}\n";
 
 		// CFaces
-		stream << "\t\t*MESH_NUMCVFACES " << (surface.indices.size() / 3) << std::endl;
-		stream << "\t\t*MESH_CFACELIST {" << std::endl;
+		out << "\t\t*MESH_NUMCVFACES " << (surface.indices.size() / 3) << '\n';
+		out << "\t\t*MESH_CFACELIST {\n";
 
 		for (std::size_t i = 0; i + 2 < surface.indices.size(); i += 3)
 		{
 			std::size_t faceNum = i / 3;
 
-			stream << fmt::format("\t\t\t*MESH_CFACE {:3d}\t{:3d}\t{:3d}\t{:3d}",
-				faceNum, surface.indices[i], surface.indices[i + 1], surface.indices[i + 2]) << std::endl;
+			out.format("\t\t\t*MESH_CFACE {:3d}\t{:3d}\t{:3d}\t{:3d}\n",
+				faceNum, surface.indices[i], surface.indices[i + 1], surface.indices[i + 2]);
 		}
 
-		stream << "\t\t}" << std::endl;
+		out << "\t\t}\n";
 		
-		stream << "\t\t*MESH_NORMALS { " << std::endl;
+		out << "\t\t*MESH_NORMALS { \n";
 
 		for (std::size_t i = 0; i + 2 < surface.indices.size(); i += 3)
 		{
@@ -241,23 +246,23 @@ void AseExporter::exportToStream(std::ostream& stream)
 			const Normal3f& normal2 = surface.vertices[surface.indices[i+1]].normal;
 			const Normal3f& normal3 = surface.vertices[surface.indices[i+2]].normal;
 
-			stream << "\t\t\t*MESH_FACENORMAL " << faceNum << "\t" << normal1.x() << "\t" << normal1.y() << "\t" << normal1.z() << std::endl;
+			out << "\t\t\t*MESH_FACENORMAL " << faceNum << "\t" << normal1.x() << "\t" << normal1.y() << "\t" << normal1.z() << '\n';
 
-			stream << "\t\t\t\t*MESH_VERTEXNORMAL " << surface.indices[i] << "\t" << normal1.x() << "\t" << normal1.y() << "\t" << normal1.z() << std::endl;
-			stream << "\t\t\t\t*MESH_VERTEXNORMAL " << surface.indices[i+1] << "\t" << normal2.x() << "\t" << normal2.y() << "\t" << normal2.z() << std::endl;
-			stream << "\t\t\t\t*MESH_VERTEXNORMAL " << surface.indices[i+2] << "\t" << normal3.x() << "\t" << normal3.y() << "\t" << normal3.z() << std::endl;
+			out << "\t\t\t\t*MESH_VERTEXNORMAL " << surface.indices[i] << "\t" << normal1.x() << "\t" << normal1.y() << "\t" << normal1.z() << '\n';
+			out << "\t\t\t\t*MESH_VERTEXNORMAL " << surface.indices[i+1] << "\t" << normal2.x() << "\t" << normal2.y() << "\t" << normal2.z() << '\n';
+			out << "\t\t\t\t*MESH_VERTEXNORMAL " << surface.indices[i+2] << "\t" << normal3.x() << "\t" << normal3.y() << "\t" << normal3.z() << '\n';
 		}
 
-		stream << "\t\t}" << std::endl;
+		out << "\t\t}\n";
 
-		stream << "\t}" << std::endl;
+		out << "\t}\n";
 
-		stream << "\t*PROP_MOTIONBLUR 0" << std::endl;
-		stream << "\t*PROP_CASTSHADOW 1" << std::endl;
-		stream << "\t*PROP_RECVSHADOW 1" << std::endl;
-		stream << "\t*MATERIAL_REF " << m << std::endl;
+		out << "\t*PROP_MOTIONBLUR 0\n";
+		out << "\t*PROP_CASTSHADOW 1\n";
+		out << "\t*PROP_RECVSHADOW 1\n";
+		out << "\t*MATERIAL_REF " << m << '\n';
 
-		stream << "}" << std::endl;
+		out << "}\n";
 
 		++m;
 	}
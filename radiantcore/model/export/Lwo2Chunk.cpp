@@ -19,9 +19,14 @@ unsigned int Lwo2Chunk::getContentSize() const
 {
 	unsigned int totalSize = 0;
 
-	// Start with the size of the contents 
-	// (don't use seek as we don't know if the client still wants to write stuff)
-	totalSize += static_cast<unsigned int>(stream.str().length());
+	// Start with the size of the contents, which is the current write position.
+	// Querying it doesn't move the position and doesn't copy the buffer like str() does.
+	auto contentSize = stream.rdbuf()->pubseekoff(0, std::ios_base::cur, std::ios_base::out);
+
+	if (contentSize > 0)
+	{
+		totalSize += static_cast<unsigned int>(contentSize);
+	}
 
 	if (!subChunks.empty())
 	{
@@ -85,9 +90,14 @@ void Lwo2Chunk::writeToStream(std::ostream& output)
 		stream::writeBigEndian<uint16_t>(output, static_cast<uint16_t>(getContentSize()));
 	}
 
-	// Write the direct contents of this chunk
-	std::string str = stream.str();
-	output.write(str.c_str(), str.length());
+	// Write the direct contents of this chunk, copying the buffer
+	// to the output without creating a temporary string
+	stream.seekg(0, std::ios_base::beg);
+
+	if (stream.rdbuf()->in_avail() > 0)
+	{
+		output << stream.rdbuf();
+	}
 
 	// Write all subchunks
 	for (const Lwo2Chunk::Ptr& chunk : subChunks)
@@ -1,5 +1,8 @@
 #include "Lwo2Exporter.h"
 
+#include <algorithm>
+#include <cstring>
+#include <string>
 #include <vector>
 #include "itextstream.h"
 #include "imodelsurface.h"
@@ -57,6 +60,33 @@ void writeString(std::ostream& stream, const std::string& str)
 	}
 }
 
+// Appends the given value to the buffer in Big Endian byte order
+template<typename ValueType>
+void appendBigEndian(std::string& buffer, ValueType value)
+{
+	char bytes[sizeof(ValueType)];
+	std::memcpy(bytes, &value, sizeof(ValueType));
+
+#ifndef __BIG_ENDIAN__
+	std::reverse(bytes, bytes + sizeof(ValueType));
+#endif
+
+	buffer.append(bytes, sizeof(ValueType));
+}
+
+// Appends a Variable Index (VX) data type to the given buffer, see writeVariableIndex
+void appendVariableIndex(std::string& buffer, std::size_t index)
+{
+	if (index < 0xFF00)
+	{
+		appendBigEndian<uint16_t>(buffer, static_cast<uint16_t>(index));
+	}
+	else
+	{
+		appendBigEndian<uint32_t>(buffer, static_cast<uint32_t>(index) | 0xFF000000);
+	}
+}
+
 } // namespace stream
 
 namespace model
@@ -170,27 +200,41 @@ void Lwo2Exporter::exportToStream(std::ostream& stream)
 	{
 		Surface& surface = pair.second;
 
+		// The per-value stream writes are expensive, assemble the data of this
+		// surface in memory and hand it to the chunks in one go
+		std::string points;
+		std::string uvs;
+		std::string colours;
+		std::string polygons;
+		std::string polygonTags;
+
+		points.reserve(surface.vertices.size() * 12);
+		uvs.reserve(surface.vertices.size() * 12);
+		colours.reserve(surface.vertices.size() * 20);
+		polygons.reserve(surface.indices.size() / 3 * 14);
+		polygonTags.reserve(surface.indices.size() / 3 * 6);
+
 		for (std::size_t v = 0; v < surface.vertices.size(); ++v)
 		{
 			const ArbitraryMeshVertex& vertex = surface.vertices[v];
 			std::size_t vertNum = vertexIdxStart + v;
 
 			// "The LightWave coordinate system is left-handed, with +X to the right or east, +Y upward, and +Z forward or north."
-			stream::writeBigEndian<float>(pnts->stream, static_cast<float>(vertex.vertex.x()));
-			stream::writeBigEndian<float>(pnts->stream, static_cast<float>(vertex.vertex.z()));
-			stream::writeBigEndian<float>(pnts->stream, static_cast<float>(vertex.vertex.y()));
+			stream::appendBigEndian<float>(points, static_cast<float>(vertex.vertex.x()));
+			stream::appendBigEndian<float>(points, static_cast<float>(vertex.vertex.z()));
+			stream::appendBigEndian<float>(points, static_cast<float>(vertex.vertex.y()));
 
 			// Write the UV map data (invert the T axis)
-			stream::writeVariableIndex(vmap->stream, vertNum);
-			stream::writeBigEndian<float>(vmap->stream, static_cast<float>(vertex.texcoord.x()));
-			stream::writeBigEndian<float>(vmap->stream, 1.0f - static_cast<float>(vertex.texcoord.y()));
+			stream::appendVariableIndex(uvs, vertNum);
+			stream::appendBigEndian<float>(uvs, static_cast<float>(vertex.texcoord.x()));
+			stream::appendBigEndian<float>(uvs, 1.0f - static_cast<float>(vertex.texcoord.y()));
 
 			// Write the vertex colour data
-			stream::writeVariableIndex(colourVmap->stream, vertNum);
-			stream::writeBigEndian<float>(colourVmap->stream, static_cast<float>(vertex.colour.x()));
-			stream::writeBigEndian<float>(colourVmap->stream, static_cast<float>(vertex.colour.y()));
-			stream::writeBigEndian<float>(colourVmap->stream, static_cast<float>(vertex.colour.z()));
-			stream::writeBigEndian<float>(colourVmap->stream, 1.0f);
+			stream::appendVariableIndex(colours, vertNum);
+			stream::appendBigEndian<float>(colours, static_cast<float>(vertex.colour.x()));
+			stream::appendBigEndian<float>(colours, static_cast<float>(vertex.colour.y()));
+			stream::appendBigEndian<float>(colours, static_cast<float>(vertex.colour.z()));
+			stream::appendBigEndian<float>(colours, 1.0f);
 
 			// Accumulate the BBOX
 			bounds.includePoint(vertex.vertex);
@@ -204,20 +248,26 @@ void Lwo2Exporter::exportToStream(std::ostream& stream)
 
 		for (std::size_t i = 0; i + 2 < surface.indices.size(); i += 3)
 		{
-			stream::writeBigEndian<uint16_t>(pols->stream, numVerts); // [U2]
+			stream::appendBigEndian<uint16_t>(polygons, numVerts); // [U2]
 
 			// The three vertices defining this polygon (reverse indices to produce LWO2 windings)
-			stream::writeVariableIndex(pols->stream, vertexIdxStart + surface.indices[i+2]); // [VX]
-			stream::writeVariableIndex(pols->stream, vertexIdxStart + surface.indices[i+1]); // [VX]
-			stream::writeVariableIndex(pols->stream, vertexIdxStart + surface.indices[i+0]); // [VX]
+			stream::appendVariableIndex(polygons, vertexIdxStart + surface.indices[i+2]); // [VX]
+			stream::appendVariableIndex(polygons, vertexIdxStart + surface.indices[i+1]); // [VX]
+			stream::appendVariableIndex(polygons, vertexIdxStart + surface.indices[i+0]); // [VX]
 
 			// The surface mapping in the PTAG
-			stream::writeVariableIndex(ptag->stream, polyNum); // [VX]
-			stream::writeBigEndian<uint16_t>(ptag->stream, static_cast<uint16_t>(surfNum)); // [U2]
+			stream::appendVariableIndex(polygonTags, polyNum); // [VX]
+			stream::appendBigEndian<uint16_t>(polygonTags, static_cast<uint16_t>(surfNum)); // [U2]
 
 			++polyNum;
 		}
 
+		pnts->stream.write(points.data(), points.size());
+		vmap->stream.write(uvs.data(), uvs.size());
+		colourVmap->stream.write(colours.data(), colours.size());
+		pols->stream.write(polygons.data(), polygons.size());
+		ptag->stream.write(polygonTags.data(), polygonTags.size());
+
 		// Write the SURF chunk for the surface
 		Lwo2Chunk::Ptr surf = fileChunk.addChunk("SURF");
 
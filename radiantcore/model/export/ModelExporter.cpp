@@ -12,7 +12,11 @@
 #include "registry/registry.h"
 #include <stdexcept>
 #include <fstream>
+#include <map>
+#include <mutex>
+#include "util/Parallel.h"
 
+#include "ModelExporterBase.h"
 #include "PatchSurface.h"
 
 namespace model
@@ -21,6 +25,9 @@ namespace model
 namespace
 {
 
+// Selections with fewer nodes than this are collected on the calling thread
+const std::size_t MIN_NODES_FOR_PARALLEL_COLLECTION = 256;
+
 // Adapter methods to convert brush vertices to ArbitraryMeshVertex type
 ArbitraryMeshVertex convertWindingVertex(const WindingVertex& in)
 {
@@ -120,38 +127,80 @@ void ModelExporter::processNodes()
 			Matrix4::getTranslation(-bounds.origin);
 	}
 
+	// Transforms and patch tesselations are calculated on demand,
+	// evaluate them here before the nodes are processed in parallel
+	std::vector<ExportItem> items;
+	items.reserve(_nodes.size());
+
 	for (const scene::INodePtr& node : _nodes)
 	{
-		if (Node_isModel(node))
+		items.emplace_back(ExportItem{ node, node->localToWorld().getPremultipliedBy(_centerTransform), PatchMesh() });
+
+		IPatch* patch = Node_isPatch(node) ? Node_getIPatch(node) : nullptr;
+
+		if (patch != nullptr && isExportableMaterial(patch->getShader()))
 		{
-			model::ModelNodePtr modelNode = Node_getModel(node);
+			items.back().patchMesh = patch->getTesselatedPatchMesh();
+		}
+	}
+
+	// The surfaces of the exporters can be merged, in that case every task
+	// fills its own exporter instance and the results are appended in order
+	auto targetExporter = std::dynamic_pointer_cast<ModelExporterBase>(_exporter);
+
+	if (!targetExporter || items.size() < MIN_NODES_FOR_PARALLEL_COLLECTION)
+	{
+		processItems(items.begin(), items.end(), *_exporter);
+		return;
+	}
 
-			// Push the geometry into the exporter
-			model::IModel& model = modelNode->getIModel();
+	// Chunk exporters by the index of their first item, to append them in order
+	std::map<std::size_t, std::shared_ptr<ModelExporterBase>> chunkExporters;
+	std::mutex chunkExportersLock;
 
-			Matrix4 exportTransform = node->localToWorld().getPremultipliedBy(_centerTransform);
+	util::forEachChunkInParallel(items.size(), MIN_NODES_FOR_PARALLEL_COLLECTION,
+		[&](std::size_t start, std::size_t end)
+	{
+		std::shared_ptr<ModelExporterBase> chunkExporter;
 
-			for (int s = 0; s < model.getSurfaceCount(); ++s)
-			{
-				const model::IModelSurface& surface = model.getSurface(s);
+		{
+			std::lock_guard<std::mutex> lock(chunkExportersLock);
 
-				if (isExportableMaterial(surface.getActiveMaterial()))
-				{
-					_exporter->addSurface(surface, exportTransform);
-				}
-			}
+			chunkExporter = std::dynamic_pointer_cast<ModelExporterBase>(_exporter->clone());
+			chunkExporters.emplace(start, chunkExporter);
+		}
+
+		processItems(items.begin() + start, items.begin() + end, *chunkExporter);
+	});
+
+	for (const auto& [start, chunkExporter] : chunkExporters)
+	{
+		targetExporter->appendSurfaces(*chunkExporter);
+	}
+}
+
+void ModelExporter::processItems(std::vector<ExportItem>::iterator begin,
+	std::vector<ExportItem>::iterator end, model::IModelExporter& exporter) const
+{
+	for (auto item = begin; item != end; ++item)
+	{
+		const scene::INodePtr& node = item->node;
+
+		if (Node_isModel(node))
+		{
+			processModel(*item, exporter);
 		}
 		else if (Node_isBrush(node))
 		{
-			processBrush(node);
+			processBrush(*item, exporter);
 		}
 		else if (Node_isPatch(node))
 		{
-			processPatch(node);
+			processPatch(*item, exporter);
 		}
 		else if (_exportLightsAsObjects && Node_getLightNode(node))
 		{
-			processLight(node);
+			processLight(*item, exporter);
 		}
 	}
 }
@@ -174,9 +223,27 @@ AABB ModelExporter::calculateModelBounds()
 	return bounds;
 }
 
-void ModelExporter::processPatch(const scene::INodePtr& node)
+void ModelExporter::processModel(const ExportItem& item, model::IModelExporter& exporter) const
 {
-	IPatch* patch = Node_getIPatch(node);
+	model::ModelNodePtr modelNode = Node_getModel(item.node);
+
+	// Push the geometry into the exporter
+	model::IModel& model = modelNode->getIModel();
+
+	for (int s = 0; s < model.getSurfaceCount(); ++s)
+	{
+		const model::IModelSurface& surface = model.getSurface(s);
+
+		if (isExportableMaterial(surface.getActiveMaterial()))
+		{
+			exporter.addSurface(surface, item.exportTransform);
+		}
+	}
+}
+
+void ModelExporter::processPatch(ExportItem& item, model::IModelExporter& exporter) const
+{
+	IPatch* patch = Node_getIPatch(item.node);
 
 	if (patch == nullptr) return;
 
@@ -184,22 +251,17 @@ void ModelExporter::processPatch(const scene::INodePtr& node)
 
 	if (!isExportableMaterial(materialName)) return;
 
-	PatchMesh mesh = patch->getTesselatedPatchMesh();
-    Matrix4 exportTransform = node->localToWorld().getPremultipliedBy(_centerTransform);
-
-    // Convert the patch mesh to an indexed surface
-    PatchSurface surface(materialName, mesh);
-    _exporter->addSurface(surface, exportTransform);
+    // Convert the patch mesh (tesselated in processNodes) to an indexed surface
+    PatchSurface surface(materialName, item.patchMesh);
+    exporter.addSurface(surface, item.exportTransform);
 }
 
-void ModelExporter::processBrush(const scene::INodePtr& node)
+void ModelExporter::processBrush(const ExportItem& item, model::IModelExporter& exporter) const
 {
-	IBrush* brush = Node_getIBrush(node);
+	IBrush* brush = Node_getIBrush(item.node);
 
 	if (brush == nullptr) return;
 
-	Matrix4 exportTransform = node->localToWorld().getPremultipliedBy(_centerTransform);
-
 	for (std::size_t b = 0; b < brush->getNumFaces(); ++b)
 	{
 		const IFace& face = brush->getFace(b);
@@ -230,11 +292,11 @@ void ModelExporter::processBrush(const scene::INodePtr& node)
 			polys.push_back(poly);
 		}
 
-		_exporter->addPolygons(materialName, polys, exportTransform);
+		exporter.addPolygons(materialName, polys, item.exportTransform);
 	}
 }
 
-void ModelExporter::processLight(const scene::INodePtr& node)
+void ModelExporter::processLight(const ExportItem& item, model::IModelExporter& exporter) const
 {
 	// Export lights as small polyhedron
 	static const double EXTENTS = 8.0;
@@ -259,12 +321,10 @@ void ModelExporter::processLight(const scene::INodePtr& node)
 	polys.push_back(createPolyCCW(down, north, east));
 	polys.push_back(createPolyCCW(down, east, south));
 
-	Matrix4 exportTransform = node->localToWorld().getPremultipliedBy(_centerTransform);
-
-	_exporter->addPolygons("lights/default", polys, exportTransform);
+	exporter.addPolygons("lights/default", polys, item.exportTransform);
 }
 
-bool ModelExporter::isExportableMaterial(const std::string& materialName)
+bool ModelExporter::isExportableMaterial(const std::string& materialName) const
 {
 	return !_skipCaulk || materialName != _caulkMaterial;
 }
@@ -3,11 +3,13 @@
 #include "inode.h"
 #include "imodel.h"
 #include "imodelsurface.h"
+#include "ipatch.h"
 #include "math/AABB.h"
 #include "math/Matrix4.h"
 #include "math/Vector3.h"
 #include <map>
 #include <list>
+#include <vector>
 
 namespace model
 {
@@ -63,13 +65,27 @@ public:
 	const Matrix4& getCenterTransform();
 
 private:
+	// A node prepared for export, with everything that is
+	// evaluated on demand (and therefore not thread-safe) filled in
+	struct ExportItem
+	{
+		scene::INodePtr node;
+		Matrix4 exportTransform;
+		PatchMesh patchMesh;
+	};
+
 	AABB calculateModelBounds();
 
-	bool isExportableMaterial(const std::string& materialName);
+	bool isExportableMaterial(const std::string& materialName) const;
+
+	// Passes the geometry of the given items to the target exporter
+	void processItems(std::vector<ExportItem>::iterator begin,
+		std::vector<ExportItem>::iterator end, model::IModelExporter& exporter) const;
 
-	void processBrush(const scene::INodePtr& node);
-	void processPatch(const scene::INodePtr& node);
-	void processLight(const scene::INodePtr& node);
+	void processModel(const ExportItem& item, model::IModelExporter& exporter) const;
+	void processBrush(const ExportItem& item, model::IModelExporter& exporter) const;
+	void processPatch(ExportItem& item, model::IModelExporter& exporter) const;
+	void processLight(const ExportItem& item, model::IModelExporter& exporter) const;
 };
 
 }
@@ -143,6 +143,39 @@ public:
 		}
 	}
 
+	// Moves all the geometry of the given exporter into this one, the vertices
+	// and indices are appended to the surfaces of the same material.
+	// The result is the same as if all the surfaces and polygons added to the
+	// other exporter had been added to this one, after the ones already present.
+	void appendSurfaces(ModelExporterBase& other)
+	{
+		for (auto& pair : other._surfaces)
+		{
+			Surface& source = pair.second;
+			Surface& surface = ensureSurface(pair.first);
+
+			if (surface.vertices.empty())
+			{
+				surface.vertices.swap(source.vertices);
+				surface.indices.swap(source.indices);
+				continue;
+			}
+
+			unsigned int indexStart = static_cast<unsigned int>(surface.vertices.size());
+
+			surface.vertices.insert(surface.vertices.end(), source.vertices.begin(), source.vertices.end());
+
+			surface.indices.reserve(surface.indices.size() + source.indices.size());
+
+			for (auto index : source.indices)
+			{
+				surface.indices.push_back(index + indexStart);
+			}
+		}
+
+		other._surfaces.clear();
+	}
+
 private:
 	Surface& ensureSurface(const std::string& materialName)
 	{
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <fmt/format.h>
+
+namespace model
+{
+
+/**
+ * Write buffer used by the text-based model exporters. The data is collected
+ * in a large memory block which is handed to the target stream at once,
+ * instead of going through the formatting and locale machinery of std::ostream
+ * for every single value.
+ *
+ * The number formatting is the same as the one of a default-constructed
+ * std::ostream: floating point values are written using "%g" (6 significant
+ * digits), integers in decimal notation.
+ */
+class TextExportBuffer
+{
+private:
+	std::ostream& _stream;
+	fmt::memory_buffer _buffer;
+
+	// The buffer is handed to the stream once it grows beyond this size
+	static constexpr std::size_t FlushThreshold = 1 << 20;
+
+public:
+	TextExportBuffer(std::ostream& stream) :
+		_stream(stream)
+	{
+		_buffer.reserve(FlushThreshold + (FlushThreshold >> 2));
+	}
+
+	TextExportBuffer(const TextExportBuffer& other) = delete;
+	TextExportBuffer& operator=(const TextExportBuffer& other) = delete;
+
+	~TextExportBuffer()
+	{
+		flush();
+	}
+
+	TextExportBuffer& operator<<(char c)
+	{
+		_buffer.push_back(c);
+		return *this;
+	}
+
+	TextExportBuffer& operator<<(const char* str)
+	{
+		append(str, str + std::char_traits<char>::length(str));
+		return *this;
+	}
+
+	TextExportBuffer& operator<<(const std::string& str)
+	{
+		append(str.data(), str.data() + str.size());
+		return *this;
+	}
+
+	TextExportBuffer& operator<<(double value)
+	{
+		if (!appendFixedNotation(value))
+		{
+			fmt::format_to(_buffer, "{:g}", value);
+		}
+
+		return afterWrite();
+	}
+
+	TextExportBuffer& operator<<(float value)
+	{
+		// std::ostream promotes floats to double as well
+		return operator<<(static_cast<double>(value));
+	}
+
+	template<typename IntegerType>
+	typename std::enable_if<std::is_integral<IntegerType>::value, TextExportBuffer&>::type
+	operator<<(IntegerType value)
+	{
+		fmt::format_int formatted(value);
+		append(formatted.data(), formatted.data() + formatted.size());
+		return *this;
+	}
+
+	// Appends the formatted string, see fmt::format()
+	template<typename... Args>
+	void format(const char* formatString, const Args&... args)
+	{
+		fmt::format_to(_buffer, formatString, args...);
+		afterWrite();
+	}
+
+	// Hands all buffered data to the target stream
+	void flush()
+	{
+		if (_buffer.size() > 0)
+		{
+			_stream.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+			_buffer.clear();
+		}
+	}
+
+private:
+	// Fast path for the numbers "%g" writes in fixed notation, which are most of
+	// the ones in model files. The value is rounded to 6 significant digits, using
+	// a single (exact) scaling by a power of ten. Returns false for the values this
+	// can't handle, or if the value is too close to the rounding boundary to
+	// decide without exact decimal conversion.
+	bool appendFixedNotation(double value)
+	{
+		static constexpr double PowersOfTen[] = { 1.0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+
+		if (value == 0)
+		{
+			if (std::signbit(value))
+			{
+				_buffer.push_back('-');
+			}
+
+			_buffer.push_back('0');
+			return true;
+		}
+
+		double absolute = std::abs(value);
+
+		// Between 1e-4 and the largest value not being rounded to 1e6
+		if (!(absolute >= 1e-4 && absolute < 999999.5))
+		{
+			return false;
+		}
+
+		// The decimal exponent of the value
+		int exponent = 5;
+
+		while (exponent > -4 && absolute < (exponent >= 0 ? PowersOfTen[exponent] : 1.0 / PowersOfTen[-exponent]))
+		{
+			--exponent;
+		}
+
+		// Scale to 6 digits before the decimal point, this involves only one rounding
+		double scaled = absolute * PowersOfTen[5 - exponent];
+
+		if (scaled < 100000.0 || scaled >= 1000000.0)
+		{
+			return false; // the exponent is off due to the rounding of the power of ten
+		}
+
+		double integral = std::floor(scaled);
+		double fraction = scaled - integral;
+
+		if (std::abs(fraction - 0.5) < 1e-6)
+		{
+			return false; // too close to call
+		}
+
+		auto digits = static_cast<std::uint32_t>(integral) + (fraction > 0.5 ? 1 : 0);
+
+		if (digits >= 1000000)
+		{
+			// Rounded up to the next power of ten
+			digits /= 10;
+			++exponent;
+		}
+
+		if (exponent >= 6)
+		{
+			return false;
+		}
+
+		char text[24];
+		char* end = text;
+
+		if (value < 0)
+		{
+			*end++ = '-';
+		}
+
+		char digitText[6];
+
+		for (int i = 5; i >= 0; --i)
+		{
+			digitText[i] = static_cast<char>('0' + digits % 10);
+			digits /= 10;
+		}
+
+		// Trailing zeros are not written
+		int numDigits = 6;
+
+		while (numDigits > exponent + 1 && numDigits > 1 && digitText[numDigits - 1] == '0')
+		{
+			--numDigits;
+		}
+
+		if (exponent >= 0)
+		{
+			for (int i = 0; i <= exponent; ++i)
+			{
+				*end++ = digitText[i];
+			}
+
+			if (numDigits > exponent + 1)
+			{
+				*end++ = '.';
+
+				for (int i = exponent + 1; i < numDigits; ++i)
+				{
+					*end++ = digitText[i];
+				}
+			}
+		}
+		else
+		{
+			*end++ = '0';
+			*end++ = '.';
+
+			for (int i = -1; i > exponent; --i)
+			{
+				*end++ = '0';
+			}
+
+			for (int i = 0; i < numDigits; ++i)
+			{
+				*end++ = digitText[i];
+			}
+		}
+
+		_buffer.append(text, end);
+		return true;
+	}
+
+	void append(const char* begin, const char* end)
+	{
+		_buffer.append(begin, end);
+		afterWrite();
+	}
+
+	TextExportBuffer& afterWrite()
+	{
+		if (_buffer.size() >= FlushThreshold)
+		{
+			flush();
+		}
+
+		return *this;
+	}
+};
+
+}
@@ -5,6 +5,8 @@
 #include "imap.h"
 #include "ishaders.h"
 
+#include "TextExportBuffer.h"
+
 namespace model
 {
 
@@ -48,12 +50,15 @@ void WavefrontExporter::exportToPath(const std::string& outputPath, const std::s
 
 void WavefrontExporter::writeObjFile(std::ostream& stream, const std::string& mtlFilename)
 {
+    // Collect the text in a large buffer, which is written in blocks
+    TextExportBuffer out(stream);
+
     // Write export comment
-    stream << EXPORT_COMMENT_HEADER << std::endl;
+    out << EXPORT_COMMENT_HEADER << '\n';
 
     // Write mtllib file
-    stream << "mtllib " << mtlFilename << std::endl;
-    stream << std::endl;
+    out << "mtllib " << mtlFilename << '\n';
+    out << '\n';
 
 	// Count exported vertices. Exported indices are 1-based though.
 	std::size_t vertexCount = 0;
@@ -67,29 +72,31 @@ void WavefrontExporter::writeObjFile(std::ostream& stream, const std::string& mt
 		std::size_t vertBaseIndex = vertexCount;
 
 		// Store the material into the group name
-		stream << "g " << surface.materialName << std::endl;
+		out << "g " << surface.materialName << '\n';
 
         // Reference the material we're going to export to the .mtl file
-        stream << "usemtl " << surface.materialName << std::endl;
-		stream << std::endl;
-
-		// Temporary buffers for vertices, texcoords and polys
-		std::stringstream vertexBuf;
-		std::stringstream texCoordBuf;
-		std::stringstream polyBuf;
+        out << "usemtl " << surface.materialName << '\n';
+		out << '\n';
 
+		// Write the vertex coordinates first, then the texcoords and the polys
 		for (const ArbitraryMeshVertex& meshVertex : surface.vertices)
 		{
-			// Write coordinates into the export buffers
 			const Vector3& vert = meshVertex.vertex;
-			const Vector2& uv = meshVertex.texcoord;
+			out << "v " << vert.x() << " " << vert.y() << " " << vert.z() << "\n";
+		}
 
-			vertexBuf << "v " << vert.x() << " " << vert.y() << " " << vert.z() << "\n";
-			texCoordBuf << "vt " << uv.x() << " " << -uv.y() << "\n"; // invert the V coordinate
+		out << '\n';
 
-			vertexCount++;
+		for (const ArbitraryMeshVertex& meshVertex : surface.vertices)
+		{
+			const Vector2& uv = meshVertex.texcoord;
+			out << "vt " << uv.x() << " " << -uv.y() << "\n"; // invert the V coordinate
 		}
 
+		out << '\n';
+
+		vertexCount += surface.vertices.size();
+
 		// Every three indices form a triangle. Indices are 1-based so add +1 to each index
 		for (std::size_t i = 0; i + 2 < surface.indices.size(); i += 3)
 		{
@@ -98,16 +105,14 @@ void WavefrontExporter::writeObjFile(std::ostream& stream, const std::string& mt
 			std::size_t index3 = vertBaseIndex + static_cast<std::size_t>(surface.indices[i+2]) + 1;
 
 			// f 1/1 3/3 2/2
-			polyBuf << "f";
-			polyBuf << " " << index1 << "/" << index1;
-			polyBuf << " " << index2 << "/" << index2;
-			polyBuf << " " << index3 << "/" << index3;
-			polyBuf << "\n";
+			out << "f";
+			out << " " << index1 << "/" << index1;
+			out << " " << index2 << "/" << index2;
+			out << " " << index3 << "/" << index3;
+			out << "\n";
 		}
 
-		stream << vertexBuf.str() << std::endl;
-		stream << texCoordBuf.str() << std::endl;
-		stream << polyBuf.str() << std::endl;
+		out << '\n';
 	}
 }
 
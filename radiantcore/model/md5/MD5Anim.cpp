@@ -1,14 +1,26 @@
 #include "MD5Anim.h"
 
+#include <algorithm>
 #include "itextstream.h"
 #include "string/convert.h"
 
 namespace md5
 {
 
-MD5Anim::MD5Anim() :
+namespace
+{
+	// Number of consecutive frames decoded at once
+	constexpr std::size_t FramesPerBlock = 16;
+
+	constexpr float MaxQuantisedValue = 65535.0f;
+}
+
+MD5Anim::MD5Anim(const MD5FrameBlockCachePtr& blockCache) :
 	_frameRate(0),
-	_numAnimatedComponents(0)
+	_numAnimatedComponents(0),
+	_numFrames(0),
+	_numParsedFrames(0),
+	_blockCache(blockCache)
 {}
 
 void MD5Anim::parseJointHierarchy(parser::DefTokeniser& tok)
@@ -50,7 +62,7 @@ void MD5Anim::parseFrameBounds(parser::DefTokeniser& tok)
 	tok.assertNextToken("bounds");
 	tok.assertNextToken("{");
 		
-	for (std::size_t i = 0; i < _frames.size(); ++i)
+	for (std::size_t i = 0; i < _bounds.size(); ++i)
 	{
 		tok.assertNextToken("(");
 
@@ -121,18 +133,193 @@ void MD5Anim::parseFrame(std::size_t frame, parser::DefTokeniser& tok)
 
 	tok.assertNextToken("{");
 
-	// Reserve space for the floats
-	_frames[parsedFrameNum].resize(_numAnimatedComponents);
+	// A frame cut short by a parse error keeps zeros for the remaining values
+	_numParsedFrames = frame + 1;
+
+	float* values = &_parsedFrames[frame * _numAnimatedComponents];
 
 	// Each frame block has <numAnimatedComponents> float values
 	for (std::size_t i = 0; i < _numAnimatedComponents; ++i)
 	{
-		_frames[parsedFrameNum][i] = string::convert<float>(tok.nextToken());
+		values[i] = string::convert<float>(tok.nextToken());
 	}
 
 	tok.assertNextToken("}");
 }
 
+namespace
+{
+	inline std::size_t getNumAnimatedComponents(const Joint& joint)
+	{
+		std::size_t count = 0;
+
+		for (std::size_t flag = Joint::X; flag < Joint::INVALID_COMPONENT; flag <<= 1)
+		{
+			if (joint.animComponents & flag) ++count;
+		}
+
+		return count;
+	}
+}
+
+void MD5Anim::quantiseFrames()
+{
+	if (_parsedFrames.size() < _numFrames * _numAnimatedComponents)
+	{
+		_numAnimatedComponents = 0; // header incomplete, all frames use the base frame
+	}
+
+	_componentMinimum.assign(_numAnimatedComponents, 0.0f);
+	_componentScale.assign(_numAnimatedComponents, 0.0f);
+	_quantisedFrames.assign(_numParsedFrames * _numAnimatedComponents, 0);
+
+	for (std::size_t component = 0; _numParsedFrames > 0 && component < _numAnimatedComponents; ++component)
+	{
+		float minimum = _parsedFrames[component];
+		float maximum = minimum;
+
+		for (std::size_t frame = 1; frame < _numParsedFrames; ++frame)
+		{
+			float value = _parsedFrames[frame * _numAnimatedComponents + component];
+
+			minimum = std::min(minimum, value);
+			maximum = std::max(maximum, value);
+		}
+
+		_componentMinimum[component] = minimum;
+		_componentScale[component] = (maximum - minimum) / MaxQuantisedValue;
+	}
+
+	for (std::size_t frame = 0; frame < _numParsedFrames; ++frame)
+	{
+		const float* values = _parsedFrames.data() + frame * _numAnimatedComponents;
+		std::uint16_t* quantised = _quantisedFrames.data() + frame * _numAnimatedComponents;
+
+		for (std::size_t component = 0; component < _numAnimatedComponents; ++component)
+		{
+			float scale = _componentScale[component];
+
+			// Constant components are stored as their minimum
+			quantised[component] = scale > 0 ? static_cast<std::uint16_t>(
+				(values[component] - _componentMinimum[component]) / scale + 0.5f) : 0;
+		}
+	}
+
+	// The parsed values are not needed anymore
+	std::vector<float>().swap(_parsedFrames);
+
+	_frameBlocks.resize((_numFrames + FramesPerBlock - 1) / FramesPerBlock);
+}
+
+MD5FrameBlockPtr MD5Anim::decodeFrameBlock(std::size_t blockIndex) const
+{
+	auto block = std::make_shared<MD5FrameBlock>();
+
+	std::size_t firstFrame = blockIndex * FramesPerBlock;
+	std::size_t numFrames = std::min(FramesPerBlock, _numFrames - firstFrame);
+
+	block->poses.resize(numFrames);
+	block->memoryUsage = sizeof(MD5FrameBlock) + numFrames * _baseFrame.size() * sizeof(Key);
+
+	std::vector<float> frameKeys(_numAnimatedComponents);
+
+	for (std::size_t i = 0; i < numFrames; ++i)
+	{
+		Keys& pose = block->poses[i];
+
+		// Start from the base frame and replace the animated components
+		pose = _baseFrame;
+
+		if (firstFrame + i >= _numParsedFrames)
+		{
+			continue; // not in the file, keep the base frame
+		}
+
+		const std::uint16_t* quantised = _quantisedFrames.data() + (firstFrame + i) * _numAnimatedComponents;
+
+		for (std::size_t component = 0; component < _numAnimatedComponents; ++component)
+		{
+			frameKeys[component] = _componentMinimum[component] +
+				quantised[component] * _componentScale[component];
+		}
+
+		for (std::size_t j = 0; j < _joints.size(); ++j)
+		{
+			const Joint& joint = _joints[j];
+			Key& key = pose[j];
+
+			// The joint.firstKey member holds the offset into the frame data array
+			std::size_t component = joint.firstKey;
+
+			if (component + getNumAnimatedComponents(joint) > frameKeys.size())
+			{
+				continue; // inconsistent header, keep the base frame
+			}
+
+			if (joint.animComponents & Joint::X) key.origin.x() = frameKeys[component++];
+			if (joint.animComponents & Joint::Y) key.origin.y() = frameKeys[component++];
+			if (joint.animComponents & Joint::Z) key.origin.z() = frameKeys[component++];
+
+			if (joint.animComponents & Joint::YAW) key.orientation.x() = frameKeys[component++];
+			if (joint.animComponents & Joint::PITCH) key.orientation.y() = frameKeys[component++];
+			if (joint.animComponents & Joint::ROLL) key.orientation.z() = frameKeys[component++];
+
+			if (joint.animComponents & (Joint::YAW | Joint::PITCH | Joint::ROLL))
+			{
+				// Calculate the fourth component of the quaternion
+				auto lSq = key.orientation.getVector3().getLengthSquared();
+				auto w = -sqrt(1.0 - lSq);
+
+				key.orientation.w() = isNaN(w) ? 0 : w;
+			}
+		}
+	}
+
+	return block;
+}
+
+IMD5Anim::KeysPtr MD5Anim::getFramePose(std::size_t index) const
+{
+	assert(index < _numFrames);
+
+	std::size_t blockIndex = index / FramesPerBlock;
+	MD5FrameBlockPtr block;
+	bool decoded = false;
+
+	{
+		std::lock_guard<std::mutex> lock(_frameBlockLock);
+
+		block = _frameBlocks[blockIndex].lock();
+
+		if (!block)
+		{
+			block = decodeFrameBlock(blockIndex);
+			_frameBlocks[blockIndex] = block;
+			decoded = true;
+		}
+	}
+
+	if (decoded)
+	{
+		_blockCache->insert(block);
+	}
+	else
+	{
+		_blockCache->touch(block);
+	}
+
+	// The returned pointer keeps the whole block alive
+	return KeysPtr(block, &block->poses[index % FramesPerBlock]);
+}
+
+std::size_t MD5Anim::getMemoryUsage() const
+{
+	return sizeof(MD5Anim) + _quantisedFrames.size() * sizeof(std::uint16_t) +
+		(_componentMinimum.size() + _componentScale.size()) * sizeof(float) +
+		_baseFrame.size() * sizeof(Key) + _joints.size() * sizeof(Joint) +
+		_bounds.size() * sizeof(AABB);
+}
+
 void MD5Anim::parseFromStream(std::istream& stream)
 {
 	parser::BasicDefTokeniser<std::istream> tokeniser(stream);
@@ -166,7 +353,7 @@ void MD5Anim::parseFromTokens(parser::DefTokeniser& tok)
 		_joints.resize(numJoints);
 		_bounds.resize(numFrames);
 		_baseFrame.resize(numJoints);
-		_frames.resize(numFrames);
+		_numFrames = numFrames > 0 ? static_cast<std::size_t>(numFrames) : 0;
 
 		tok.assertNextToken("frameRate");
 		_frameRate = string::convert<int>(tok.nextToken());
@@ -174,6 +361,8 @@ void MD5Anim::parseFromTokens(parser::DefTokeniser& tok)
 		tok.assertNextToken("numAnimatedComponents");
 		_numAnimatedComponents = string::convert<std::size_t>(tok.nextToken());
 
+		_parsedFrames.assign(_numFrames * _numAnimatedComponents, 0.0f);
+
 		// Parse hierarchy block
 		parseJointHierarchy(tok);
 		
@@ -184,7 +373,7 @@ void MD5Anim::parseFromTokens(parser::DefTokeniser& tok)
 		parseBaseFrame(tok);
 
 		// Parse each actual frame
-		for (std::size_t i = 0; i < _frames.size(); ++i)
+		for (std::size_t i = 0; i < _numFrames; ++i)
 		{
 			parseFrame(i, tok);
 		}
@@ -193,6 +382,8 @@ void MD5Anim::parseFromTokens(parser::DefTokeniser& tok)
 	{
 		rError() << "Error parsing MD5 Animation: " << ex.what() << std::endl;
 	}
+
+	quantiseFrames();
 }
 
 } // namespace
@@ -1,17 +1,26 @@
 #pragma once
 
 #include "imd5anim.h"
+#include <cstdint>
+#include <mutex>
 #include <vector>
 #include "parser/DefTokeniser.h"
 #include "math/AABB.h"
 #include "math/Vector3.h"
 #include "math/Quaternion.h"
+#include "MD5FrameBlockCache.h"
 
 namespace md5
 {
 
 class MD5AnimTokeniser;
 
+/**
+ * An MD5 animation, keeping its frame data in a compact form: each animated
+ * component is quantised to 16 bits within the range it covers over all
+ * frames. The frame poses are decoded in blocks of consecutive frames when
+ * they are first requested, the blocks are kept by the given block cache.
+ */
 class MD5Anim :
 	public IMD5Anim
 {
@@ -27,15 +36,30 @@ private:
 	// One AABB per frame
 	std::vector<AABB> _bounds;
 
-	typedef std::vector<IMD5Anim::Key> Keys;
-
 	Keys _baseFrame;
 
-	// Each frame has <numAnimatedComponents> float values
-	std::vector<FrameKeys> _frames;
+	std::size_t _numFrames;
+
+	// Frames missing from the file (after a parse error) use the base frame
+	std::size_t _numParsedFrames;
+
+	// The quantised frame data, <numAnimatedComponents> values per parsed frame.
+	// The decoded value is minimum + quantised * scale.
+	std::vector<std::uint16_t> _quantisedFrames;
+	std::vector<float> _componentMinimum;
+	std::vector<float> _componentScale;
+
+	// Frame values as parsed, released once they have been quantised
+	std::vector<float> _parsedFrames;
+
+	// The decoded blocks, which are owned by the block cache
+	mutable std::vector<std::weak_ptr<MD5FrameBlock>> _frameBlocks;
+	mutable std::mutex _frameBlockLock;
+
+	MD5FrameBlockCachePtr _blockCache;
 
 public:
-	MD5Anim();
+	MD5Anim(const MD5FrameBlockCachePtr& blockCache);
 
 	const std::string& getCommandLine() const
 	{
@@ -64,22 +88,28 @@ public:
 
 	std::size_t getNumFrames() const
 	{
-		return _frames.size();
+		return _numFrames;
 	}
 
-	const FrameKeys& getFrameKeys(std::size_t index) const
-	{
-		return _frames[index];
-	}
+	KeysPtr getFramePose(std::size_t index) const;
 
 	void parseFromStream(std::istream& stream);
 
+	// Returns the memory used by the compact frame data
+	std::size_t getMemoryUsage() const;
+
 private:
 	void parseFromTokens(parser::DefTokeniser& tok);
 	void parseJointHierarchy(parser::DefTokeniser& tok);
 	void parseFrameBounds(parser::DefTokeniser& tok);
 	void parseBaseFrame(parser::DefTokeniser& tok);
 	void parseFrame(std::size_t frame, parser::DefTokeniser& tok);
+
+	// Converts the parsed frame values to the compact representation
+	void quantiseFrames();
+
+	// Applies the frame data of the given block to the base frame
+	MD5FrameBlockPtr decodeFrameBlock(std::size_t blockIndex) const;
 };
 typedef std::shared_ptr<MD5Anim> MD5AnimPtr;
 
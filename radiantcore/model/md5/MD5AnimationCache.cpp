@@ -1,44 +1,194 @@
 #include "MD5AnimationCache.h"
 
+#include <iterator>
+#include <sstream>
 #include "iarchive.h"
 #include "ifilesystem.h"
 #include "itextstream.h"
+#include "math/Hash.h"
 #include "parser/DefTokeniser.h"
+#include "MD5PoseCache.h"
 
 namespace md5
 {
 
+namespace
+{
+	// Budget for the decoded frame poses of all anims
+	constexpr std::size_t FrameBlockMemoryBudget = 16 * 1024 * 1024;
+
+	// Budget for the compact frame data of the cached anims
+	constexpr std::size_t AnimMemoryBudget = 32 * 1024 * 1024;
+}
+
+MD5AnimationCache::MD5AnimationCache() :
+	_blockCache(std::make_shared<MD5FrameBlockCache>(FrameBlockMemoryBudget)),
+	_memoryUsage(0),
+	_numLoaded(0),
+	_numShared(0),
+	_numEvicted(0)
+{}
+
 IMD5AnimPtr MD5AnimationCache::getAnim(const std::string& vfsPath)
 {
+	std::lock_guard<std::mutex> lock(_lock);
+
 	// Check the cache first
 	AnimationMap::iterator found = _animations.find(vfsPath);
 
 	if (found != _animations.end())
 	{
-		return found->second;
+		_lru.splice(_lru.begin(), _lru, found->second.lruPosition);
+		return found->second.anim;
+	}
+
+	MD5AnimPtr anim = loadAnim(vfsPath);
+
+	if (!anim)
+	{
+		return IMD5AnimPtr();
+	}
+
+	// Store the anim in our cache
+	_lru.push_front(vfsPath);
+	_animations.insert(AnimationMap::value_type(vfsPath, CachedAnim{ anim, _lru.begin() }));
+
+	if (_memoryUsage > AnimMemoryBudget)
+	{
+		evictUnusedAnims();
 	}
 
+	return anim;
+}
+
+MD5AnimPtr MD5AnimationCache::loadAnim(const std::string& vfsPath)
+{
 	// Not found, construct new animation with the given path
 	ArchiveTextFilePtr file = GlobalFileSystem().openTextFile(vfsPath);
 
 	if (file == NULL)
 	{
 		rWarning() << "Animation file " << vfsPath << " does not exist." << std::endl;
-		return IMD5AnimPtr();
+		return MD5AnimPtr();
 	}
 
 	std::istream inputStream(&file->getInputStream());
-	
+	std::string contents(std::istreambuf_iterator<char>(inputStream), {});
+
+	math::FastHash contentHash;
+	contentHash.addString(contents);
+
+	ContentKey contentKey(contentHash.getDigest64(), contents.size());
+
+	// Re-use the anim of an identical file if it's still around
+	auto existing = _animsByContent.find(contentKey);
+
+	if (existing != _animsByContent.end())
+	{
+		MD5AnimPtr shared = existing->second.lock();
+
+		if (shared)
+		{
+			++_numShared;
+			return shared;
+		}
+	}
+
 	// Create the anim from scratch
-	MD5AnimPtr anim(new MD5Anim);
-	anim->parseFromStream(inputStream);
+	std::istringstream contentStream(contents);
 
-	// Store the anim in our cache
-	_animations.insert(AnimationMap::value_type(vfsPath, anim));
+	MD5AnimPtr anim(new MD5Anim(_blockCache));
+	anim->parseFromStream(contentStream);
+
+	_animsByContent[contentKey] = anim;
+	_memoryUsage += anim->getMemoryUsage();
+	++_numLoaded;
 
 	return anim;
 }
 
+void MD5AnimationCache::evictUnusedAnims()
+{
+	// Number of cache entries referencing each anim, files with identical
+	// contents are sharing one
+	std::map<const MD5Anim*, long> entriesPerAnim;
+
+	for (const auto& pair : _animations)
+	{
+		++entriesPerAnim[pair.second.anim.get()];
+	}
+
+	auto path = _lru.end();
+
+	while (_memoryUsage > AnimMemoryBudget && path != _lru.begin())
+	{
+		--path;
+
+		auto found = _animations.find(*path);
+		const MD5Anim* anim = found->second.anim.get();
+
+		// Anims referenced by anything but the cache entries are kept
+		if (found->second.anim.use_count() > entriesPerAnim[anim])
+		{
+			continue;
+		}
+
+		_memoryUsage -= anim->getMemoryUsage();
+		++_numEvicted;
+
+		// Release the anim with all the paths sharing it
+		for (auto i = _animations.begin(); i != _animations.end();)
+		{
+			if (i->second.anim.get() != anim)
+			{
+				++i;
+				continue;
+			}
+
+			if (i->second.lruPosition == path)
+			{
+				path = _lru.erase(path);
+			}
+			else
+			{
+				_lru.erase(i->second.lruPosition);
+			}
+
+			_animations.erase(i++);
+		}
+
+		entriesPerAnim.erase(anim);
+	}
+
+	// Drop the content entries of the released anims
+	for (auto i = _animsByContent.begin(); i != _animsByContent.end();)
+	{
+		if (i->second.expired())
+		{
+			_animsByContent.erase(i++);
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	logStatistics();
+}
+
+void MD5AnimationCache::logStatistics()
+{
+	auto blockStatistics = _blockCache->getStatistics();
+
+	rMessage() << "MD5AnimationCache: " << _numLoaded << " anims loaded, "
+		<< _numShared << " shared, " << _numEvicted << " evicted, "
+		<< (_memoryUsage / 1024) << " KB of frame data; "
+		<< blockStatistics.decodedBlocks << " frame blocks decoded, "
+		<< blockStatistics.hits << " hits, "
+		<< blockStatistics.evictedBlocks << " evicted, "
+		<< (blockStatistics.memoryUsage / 1024) << " KB of decoded poses" << std::endl;
+}
+
 const std::string& MD5AnimationCache::getName() const
 {
 	static std::string _name(MODULE_ANIMATIONCACHE);
@@ -64,7 +214,17 @@ void MD5AnimationCache::initialiseModule(const IApplicationContext& ctx)
 
 void MD5AnimationCache::shutdownModule()
 {
+	std::lock_guard<std::mutex> lock(_lock);
+
+	logStatistics();
+
 	_animations.clear();
+	_lru.clear();
+	_animsByContent.clear();
+	_memoryUsage = 0;
+
+	MD5PoseCache::Instance().clear();
+	_blockCache->clear();
 }
 
 } // namespace
@@ -1,22 +1,57 @@
 #pragma once
 
 #include "imd5anim.h"
+#include <cstdint>
+#include <list>
 #include <map>
+#include <mutex>
 
 #include "MD5Anim.h"
+#include "MD5FrameBlockCache.h"
 
 namespace md5
 {
 
+/**
+ * Keeps the loaded animations by VFS path. Files with identical contents
+ * share one MD5Anim instance. Animations no longer used elsewhere are
+ * released in least-recently-used order once the compact frame data of all
+ * cached animations exceeds the memory budget.
+ */
 class MD5AnimationCache :
 	public IAnimationCache
 {
 private:
+	struct CachedAnim
+	{
+		MD5AnimPtr anim;
+		std::list<std::string>::iterator lruPosition;
+	};
+
 	// The path => anim mapping
-	typedef std::map<std::string, MD5AnimPtr> AnimationMap;
+	typedef std::map<std::string, CachedAnim> AnimationMap;
 	AnimationMap _animations;
 
+	// Paths, most recently requested first
+	std::list<std::string> _lru;
+
+	// The anims by content hash and file size, to share identical files
+	typedef std::pair<std::uint64_t, std::size_t> ContentKey;
+	std::map<ContentKey, std::weak_ptr<MD5Anim>> _animsByContent;
+
+	// The decoded frame poses of all anims
+	MD5FrameBlockCachePtr _blockCache;
+
+	std::size_t _memoryUsage;
+	std::size_t _numLoaded;
+	std::size_t _numShared;
+	std::size_t _numEvicted;
+
+	std::mutex _lock;
+
 public:
+	MD5AnimationCache();
+
 	// IAnimationCache implementation
 	IMD5AnimPtr getAnim(const std::string& vfsPath);
 
@@ -25,6 +60,14 @@ public:
 	const StringSet& getDependencies() const;
 	void initialiseModule(const IApplicationContext& ctx);
 	void shutdownModule();
+
+private:
+	MD5AnimPtr loadAnim(const std::string& vfsPath);
+
+	// Releases unused anims until the memory budget is met again
+	void evictUnusedAnims();
+
+	void logStatistics();
 };
 typedef std::shared_ptr<MD5AnimationCache> MD5AnimationCachePtr;
 
@@ -77,6 +77,22 @@ struct MD5Weight
 
 typedef std::vector<MD5Weight> MD5Weights;
 
+/**
+ * The weights of a mesh in structure-of-arrays layout, as used by the
+ * skinning code. The positions are pre-multiplied with the weight factor.
+ */
+struct MD5SkinningWeights
+{
+	std::vector<unsigned int> joints;
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+	std::vector<float> t;
+
+	// The number of joints needed by these weights
+	std::size_t numJoints = 0;
+};
+
 // The combination of vertices, triangles and weighting information
 // represents our MD5 mesh - using this info it's possible to create
 // the actual rendered geometry (position, normals, etc.)
@@ -85,6 +101,9 @@ struct MD5Mesh
 	MD5Verts	vertices;
 	MD5Tris		triangles;
 	MD5Weights	weights;
+
+	// Built from the weights after parsing
+	MD5SkinningWeights skinningWeights;
 };
 typedef std::shared_ptr<MD5Mesh> MD5MeshPtr;
 
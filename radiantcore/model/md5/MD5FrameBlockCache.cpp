@@ -0,0 +1,73 @@
+#include "MD5FrameBlockCache.h"
+
+namespace md5
+{
+
+MD5FrameBlockCache::MD5FrameBlockCache(std::size_t memoryBudget) :
+	_memoryBudget(memoryBudget)
+{}
+
+void MD5FrameBlockCache::insert(const MD5FrameBlockPtr& block)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+
+	_blocks.push_front(block);
+	block->cached = true;
+	block->lruPosition = _blocks.begin();
+
+	_statistics.memoryUsage += block->memoryUsage;
+	++_statistics.decodedBlocks;
+
+	// Never evict the block which has just been inserted
+	while (_statistics.memoryUsage > _memoryBudget && _blocks.size() > 1)
+	{
+		const MD5FrameBlockPtr& oldest = _blocks.back();
+
+		oldest->cached = false;
+		_statistics.memoryUsage -= oldest->memoryUsage;
+		++_statistics.evictedBlocks;
+
+		_blocks.pop_back();
+	}
+}
+
+void MD5FrameBlockCache::touch(const MD5FrameBlockPtr& block)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+
+	++_statistics.hits;
+
+	if (block->cached)
+	{
+		_blocks.splice(_blocks.begin(), _blocks, block->lruPosition);
+	}
+	else
+	{
+		// Evicted but still in use, take it back in
+		_blocks.push_front(block);
+		block->cached = true;
+		block->lruPosition = _blocks.begin();
+		_statistics.memoryUsage += block->memoryUsage;
+	}
+}
+
+MD5FrameBlockCache::Statistics MD5FrameBlockCache::getStatistics() const
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	return _statistics;
+}
+
+void MD5FrameBlockCache::clear()
+{
+	std::lock_guard<std::mutex> lock(_lock);
+
+	for (const auto& block : _blocks)
+	{
+		block->cached = false;
+	}
+
+	_blocks.clear();
+	_statistics.memoryUsage = 0;
+}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include "imd5anim.h"
+
+namespace md5
+{
+
+// The decoded poses of a range of consecutive frames of an animation
+struct MD5FrameBlock
+{
+	std::vector<IMD5Anim::Keys> poses;
+
+	// Approximate memory used by the poses
+	std::size_t memoryUsage = 0;
+
+	// Position in the cache's LRU list, only valid while the block is cached
+	bool cached = false;
+	std::list<std::shared_ptr<MD5FrameBlock>>::iterator lruPosition;
+};
+typedef std::shared_ptr<MD5FrameBlock> MD5FrameBlockPtr;
+
+/**
+ * Holds the decoded frame blocks of all animations under a memory budget.
+ * The animations only keep weak references to their blocks, the blocks
+ * evicted by this cache are released as soon as no skeleton uses them.
+ */
+class MD5FrameBlockCache
+{
+public:
+	struct Statistics
+	{
+		std::size_t hits = 0;
+		std::size_t decodedBlocks = 0;
+		std::size_t evictedBlocks = 0;
+		std::size_t memoryUsage = 0;
+	};
+
+private:
+	// Most recently used blocks first
+	std::list<MD5FrameBlockPtr> _blocks;
+
+	std::size_t _memoryBudget;
+	Statistics _statistics;
+
+	mutable std::mutex _lock;
+
+public:
+	MD5FrameBlockCache(std::size_t memoryBudget);
+
+	// Adds a freshly decoded block, evicting the least recently used ones
+	// as long as the budget is exceeded
+	void insert(const MD5FrameBlockPtr& block);
+
+	// Marks the given block as most recently used
+	void touch(const MD5FrameBlockPtr& block);
+
+	Statistics getStatistics() const;
+
+	void clear();
+};
+typedef std::shared_ptr<MD5FrameBlockCache> MD5FrameBlockCachePtr;
+
+}
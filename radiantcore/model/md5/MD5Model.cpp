@@ -4,6 +4,7 @@
 #include "ishaders.h"
 #include "texturelib.h"
 #include "ifilter.h"
+#include "itextstream.h"
 #include "string/convert.h"
 #include "math/Quaternion.h"
 #include "math/Ray.h"
@@ -14,6 +15,7 @@ namespace md5 {
 MD5Model::MD5Model() :
 	_polyCount(0),
 	_vertexCount(0),
+	_surfacesMatchSkeleton(false),
 	_renderableSkeleton(_skeleton)
 {}
 
@@ -25,6 +27,7 @@ MD5Model::MD5Model(const MD5Model& other) :
 	_vertexCount(other._vertexCount),
 	_filename(other._filename),
 	_modelPath(other._modelPath),
+	_surfacesMatchSkeleton(false),
 	_renderableSkeleton(_skeleton)
 {
 	// Copy-construct the other model's surfaces, but not its shaders, revert to default
@@ -362,6 +365,7 @@ Vector3 MD5Model::parseVector3(parser::DefTokeniser& tok) {
 void MD5Model::setAnim(const IMD5AnimPtr& anim)
 {
 	_anim = anim;
+	_surfacesMatchSkeleton = false;
 
 	if (!_anim)
 	{
@@ -369,6 +373,18 @@ void MD5Model::setAnim(const IMD5AnimPtr& anim)
 		{
 			i->surface->updateToDefaultPose(_joints);
 		}
+
+		return;
+	}
+
+	// Surfaces the anim can't deform keep their previous pose, report these once
+	for (const auto& surface : _surfaces)
+	{
+		if (!surface.surface->isCompatibleWith(*_anim))
+		{
+			rWarning() << "The animation doesn't provide all joints needed by the mesh using " <<
+				surface.surface->getDefaultMaterial() << std::endl;
+		}
 	}
 }
 
@@ -381,13 +397,28 @@ void MD5Model::updateAnim(std::size_t time)
 {
 	if (!_anim) return; // nothing to do
 
+	auto previousAnim = _skeleton.getAnim();
+	auto previousFrame = _skeleton.getCurrentFrame();
+	auto previousNextFrame = _skeleton.getNextFrame();
+	auto previousFraction = _skeleton.getNextFrameFraction();
+
 	// Update our joint hierarchy first
 	_skeleton.update(_anim, time);
 
+	// Don't re-skin the surfaces as long as the pose doesn't change
+	if (_surfacesMatchSkeleton && previousAnim == _anim &&
+		previousFrame == _skeleton.getCurrentFrame() && previousNextFrame == _skeleton.getNextFrame() &&
+		previousFraction == _skeleton.getNextFrameFraction())
+	{
+		return;
+	}
+
 	for (SurfaceList::iterator i = _surfaces.begin(); i != _surfaces.end(); ++i)
 	{
 		i->surface->updateToSkeleton(_skeleton);
 	}
+
+	_surfacesMatchSkeleton = true;
 }
 
 } // namespace
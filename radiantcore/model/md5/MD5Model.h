@@ -68,6 +68,9 @@ private:
 	// The current state of our animated skeleton
 	MD5Skeleton _skeleton;
 
+	// True if the surfaces have been skinned to the current skeleton pose
+	bool _surfacesMatchSkeleton;
+
 	// The OpenGLRenderable visualising the MD5Skeleton
 	RenderableMD5Skeleton _renderableSkeleton;
 
@@ -0,0 +1,72 @@
+#include "MD5PoseCache.h"
+
+namespace md5
+{
+
+namespace
+{
+	// About 9 MB worth of vertices
+	constexpr std::size_t DefaultMaxVertices = 1 << 16;
+}
+
+MD5PoseCache::MD5PoseCache(std::size_t maxVertices) :
+	_numVertices(0),
+	_maxVertices(maxVertices)
+{}
+
+MD5PoseCache::PosePtr MD5PoseCache::find(const Key& key)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+
+	auto found = _index.find(key);
+
+	if (found == _index.end())
+	{
+		return PosePtr();
+	}
+
+	// Move the entry to the front
+	_entries.splice(_entries.begin(), _entries, found->second);
+
+	return found->second->pose;
+}
+
+void MD5PoseCache::insert(const Key& key, const MD5MeshPtr& mesh, const IMD5AnimPtr& anim, const PosePtr& pose)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+
+	if (_index.count(key) > 0 || pose->vertices.size() > _maxVertices)
+	{
+		return;
+	}
+
+	_entries.push_front(Entry{ key, mesh, anim, pose });
+	_index[key] = _entries.begin();
+	_numVertices += pose->vertices.size();
+
+	while (_numVertices > _maxVertices)
+	{
+		const Entry& oldest = _entries.back();
+
+		_numVertices -= oldest.pose->vertices.size();
+		_index.erase(oldest.key);
+		_entries.pop_back();
+	}
+}
+
+void MD5PoseCache::clear()
+{
+	std::lock_guard<std::mutex> lock(_lock);
+
+	_index.clear();
+	_entries.clear();
+	_numVertices = 0;
+}
+
+MD5PoseCache& MD5PoseCache::Instance()
+{
+	static MD5PoseCache _instance(DefaultMaxVertices);
+	return _instance;
+}
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include "imd5anim.h"
+#include "math/AABB.h"
+#include "render/ArbitraryMeshVertex.h"
+#include "MD5DataStructures.h"
+
+namespace md5
+{
+
+/**
+ * Keeps the skinned vertices of recently posed MD5 meshes, such that
+ * models showing the same mesh in the same animation frame don't need to
+ * be skinned again. Entries are keyed by mesh, animation and frame
+ * position, and are evicted in least recently used order once the
+ * number of stored vertices exceeds the budget.
+ */
+class MD5PoseCache
+{
+public:
+	struct Key
+	{
+		const MD5Mesh* mesh;
+		const IMD5Anim* anim;
+		std::size_t curFrame;
+		std::size_t nextFrame;
+		float nextFrameFraction;
+
+		bool operator<(const Key& other) const
+		{
+			return std::tie(mesh, anim, curFrame, nextFrame, nextFrameFraction) <
+				std::tie(other.mesh, other.anim, other.curFrame, other.nextFrame, other.nextFrameFraction);
+		}
+	};
+
+	// The finished vertices of a surface, including normals and tangents
+	struct Pose
+	{
+		std::vector<ArbitraryMeshVertex> vertices;
+		AABB localAABB;
+	};
+	typedef std::shared_ptr<const Pose> PosePtr;
+
+private:
+	struct Entry
+	{
+		Key key;
+
+		// Keep mesh and anim alive, their addresses are part of the key
+		MD5MeshPtr mesh;
+		IMD5AnimPtr anim;
+
+		PosePtr pose;
+	};
+
+	// Most recently used entries first
+	std::list<Entry> _entries;
+	std::map<Key, std::list<Entry>::iterator> _index;
+
+	std::size_t _numVertices;
+	std::size_t _maxVertices;
+
+	std::mutex _lock;
+
+public:
+	MD5PoseCache(std::size_t maxVertices);
+
+	// Returns the pose stored for the given key, or an empty pointer
+	PosePtr find(const Key& key);
+
+	// Stores the given pose, evicting old entries if the budget is exceeded
+	void insert(const Key& key, const MD5MeshPtr& mesh, const IMD5AnimPtr& anim, const PosePtr& pose);
+
+	void clear();
+
+	// The cache shared by all MD5 surfaces
+	static MD5PoseCache& Instance();
+};
+
+} // namespace
@@ -67,10 +67,12 @@ namespace
 
 void MD5Skeleton::update(const IMD5AnimPtr& anim, std::size_t time)
 {
-	_anim = anim;
+	if (_anim != anim)
+	{
+		_anim = anim;
+		buildJointOrder();
+	}
 
-	// Update the joint positions, recursively, starting from the first
-	// Only root nodes need to be processed, the children are reached through them
 	std::size_t numJoints = _anim ? _anim->getNumJoints() : 0;
 
 	// Ensure the correct size
@@ -79,6 +81,12 @@ void MD5Skeleton::update(const IMD5AnimPtr& anim, std::size_t time)
 		_skeleton.resize(numJoints);
 	}
 
+	if (numJoints == 0 || _anim->getNumFrames() == 0)
+	{
+		buildJointMatrices();
+		return;
+	}
+
 	// Calculate the current frame number
 	float timePerFrameMsec = 1000 / static_cast<float>(_anim->getFrameRate());
 	
@@ -88,119 +96,111 @@ void MD5Skeleton::update(const IMD5AnimPtr& anim, std::size_t time)
 	float nextFrameFrac = float_mod(frameTime, 1.0f);
 	float curFrameFrac = 1.0f - nextFrameFrac;
 
-	std::size_t curFrame = static_cast<std::size_t>(std::floor(frameTime)) % _anim->getNumFrames();
-	std::size_t nextFrame = curFrame == _anim->getNumFrames() -1 ? curFrame : (curFrame + 1) % _anim->getNumFrames();
+	_curFrame = static_cast<std::size_t>(std::floor(frameTime)) % _anim->getNumFrames();
+	_nextFrame = _curFrame == _anim->getNumFrames() -1 ? _curFrame : (_curFrame + 1) % _anim->getNumFrames();
+	_nextFrameFraction = nextFrameFrac;
+
+	// The poses have the frame data applied to the base frame already,
+	// hold on to them while interpolating
+	IMD5Anim::KeysPtr curPose = _anim->getFramePose(_curFrame);
+	IMD5Anim::KeysPtr nextPose = _anim->getFramePose(_nextFrame);
 
-	// Apply the current frame keys to the base frame
+	const IMD5Anim::Keys& cur = *curPose;
+	const IMD5Anim::Keys& next = *nextPose;
+
+	// Interpolate the joints between the two frames
 	for (std::size_t i = 0; i < numJoints; ++i)
 	{
 		const Joint& joint = _anim->getJoint(i);
-		const IMD5Anim::Key& baseKey = _anim->getBaseFrameKey(joint.id);
-
-		// Apply base frame
-		_skeleton[i].origin = baseKey.origin;
-		_skeleton[i].orientation = baseKey.orientation;
-		
-		// Apply actual frame data
-		const IMD5Anim::FrameKeys& cur = _anim->getFrameKeys(curFrame);
-		const IMD5Anim::FrameKeys& next = _anim->getFrameKeys(nextFrame);
-
-		// The joint.firstKey member holds the offset into the frame data array
-		std::size_t key = joint.firstKey;
 
-		// Shortcuts for handling the rotations
-		Quaternion& orientation = _skeleton[i].orientation;
-		Quaternion nextOrientation = baseKey.orientation;
+		_skeleton[i].origin = cur[i].origin * curFrameFrac + next[i].origin * nextFrameFrac;
 
-		// Animate each vector component, interpolating values in between frames
-
-		if (joint.animComponents & Joint::X)
+		if (joint.animComponents & (Joint::YAW | Joint::PITCH | Joint::ROLL))
 		{
-			_skeleton[i].origin.x() = cur[key]*curFrameFrac + next[key]*nextFrameFrac;
-			key++;
+			_skeleton[i].orientation = slerp(cur[i].orientation, next[i].orientation, nextFrameFrac).getNormalised();
 		}
-
-		if (joint.animComponents & Joint::Y)
+		else
 		{
-			_skeleton[i].origin.y() = cur[key]*curFrameFrac + next[key]*nextFrameFrac;
-			key++;
+			_skeleton[i].orientation = cur[i].orientation;
 		}
+	}
 
-		if (joint.animComponents & Joint::Z)
-		{
-			_skeleton[i].origin.z() = cur[key]*curFrameFrac + next[key]*nextFrameFrac;
-			key++;
-		}
+	// Apply the hierarchy, parents have been updated before their children
+	for (std::size_t i : _jointOrder)
+	{
+		const Joint& joint = _anim->getJoint(i);
 
-		if (joint.animComponents & Joint::YAW)
+		if (joint.parentId >= 0)
 		{
-			orientation.x() = cur[key];
-			nextOrientation.x() = next[key];
-			key++;
-		}
+			const IMD5Anim::Key& parent = _skeleton[joint.parentId];
 
-		if (joint.animComponents & Joint::PITCH)
-		{
-			orientation.y() = cur[key];
-			nextOrientation.y() = next[key];
-			key++;
-		}
+			// Joint has a parent, update this position and rotation
+			_skeleton[i].orientation.preMultiplyBy(parent.orientation);
 
-		if (joint.animComponents & Joint::ROLL)
-		{
-			orientation.z() = cur[key];
-			nextOrientation.z() = next[key];
-			key++;
+			// Transform the origin of this joint using the rotation of the parent joint
+			// and apply the parent joint's translation to this child bone
+			_skeleton[i].origin = parent.orientation.transformPoint(_skeleton[i].origin) + parent.origin;
 		}
+	}
 
-		if (joint.animComponents & (Joint::YAW | Joint::PITCH | Joint::ROLL))
-		{
-			auto lSq = orientation.getVector3().getLengthSquared();
-            auto w = -sqrt(1.0 - lSq);
-
-			orientation.w() = isNaN(w) ? 0 : w;
+	buildJointMatrices();
+}
 
-			lSq = nextOrientation.getVector3().getLengthSquared();
-			w = -sqrt(1.0f - lSq);
+void MD5Skeleton::buildJointOrder()
+{
+	_jointOrder.clear();
 
-			nextOrientation.w() = isNaN(w) ? 0 : w;
+	std::size_t numJoints = _anim ? _anim->getNumJoints() : 0;
+	std::vector<std::size_t> pending;
 
-			orientation = slerp(orientation, nextOrientation, nextFrameFrac).getNormalised();
+	// Depth-first, starting from the root joints
+	for (std::size_t i = numJoints; i-- > 0;)
+	{
+		if (_anim->getJoint(i).parentId == -1)
+		{
+			pending.push_back(i);
 		}
 	}
 
-	for (std::size_t i = 0; i < numJoints; ++i)
+	while (!pending.empty())
 	{
-		const Joint& joint = _anim->getJoint(i);
+		std::size_t jointId = pending.back();
+		pending.pop_back();
+
+		_jointOrder.push_back(jointId);
 
-		if (joint.parentId == -1)
+		const auto& children = _anim->getJoint(jointId).children;
+
+		for (auto child = children.rbegin(); child != children.rend(); ++child)
 		{
-			updateJointRecursively(i);
+			pending.push_back(static_cast<std::size_t>(*child));
 		}
 	}
 }
 
-void MD5Skeleton::updateJointRecursively(std::size_t jointId)
+void MD5Skeleton::buildJointMatrices()
 {
-	// Reset info to base first
-	const Joint& joint = _anim->getJoint(jointId);
+	_jointMatrices.resize(_skeleton.size());
 
-	if (joint.parentId >= 0)
+	for (std::size_t i = 0; i < _skeleton.size(); ++i)
 	{
-		// Joint has a parent, update this position and rotation
-		_skeleton[joint.id].orientation.preMultiplyBy(_skeleton[joint.parentId].orientation);
-
-		// Transform the origin of this joint using the rotation of the parent joint
-		_skeleton[joint.id].origin = _skeleton[joint.parentId].orientation.transformPoint(_skeleton[joint.id].origin);
-			
-		// Apply the parent joint's translation to this child bone
-		_skeleton[joint.id].origin += _skeleton[joint.parentId].origin;
-	}
+		const IMD5Anim::Key& key = _skeleton[i];
+		float* m = _jointMatrices[i].m;
 
-	// Update all children as well
-	for (std::vector<int>::const_iterator i = joint.children.begin(); i != joint.children.end(); ++i)
-	{
-		updateJointRecursively(*i);
+		// The columns of the rotation are the rotated unit vectors
+		for (int column = 0; column < 3; ++column)
+		{
+			Vector3 axis(column == 0 ? 1 : 0, column == 1 ? 1 : 0, column == 2 ? 1 : 0);
+			Vector3 rotated = key.orientation.transformPoint(axis);
+
+			m[column] = static_cast<float>(rotated.x());
+			m[4 + column] = static_cast<float>(rotated.y());
+			m[8 + column] = static_cast<float>(rotated.z());
+		}
+
+		m[3] = static_cast<float>(key.origin.x());
+		m[7] = static_cast<float>(key.origin.y());
+		m[11] = static_cast<float>(key.origin.z());
 	}
 }
 
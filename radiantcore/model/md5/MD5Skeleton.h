@@ -13,17 +13,62 @@ namespace md5
  */
 class MD5Skeleton
 {
+public:
+	// The model space transform of a joint in the form used by the skinning
+	// code: a row-major 3x4 matrix, the last column holding the translation
+	struct JointMatrix
+	{
+		float m[12];
+	};
+
 protected:
 	// The position and orientation of the animated joints at the current time
 	std::vector<IMD5Anim::Key> _skeleton;
 
+	// The same joints as matrices, built after each update
+	std::vector<JointMatrix> _jointMatrices;
+
 	// The current animation, needed to get joint information etc.
 	IMD5AnimPtr _anim;
 
+	// The joint indices of the current animation, each parent listed before
+	// its children, such that the hierarchy can be applied in one pass
+	std::vector<std::size_t> _jointOrder;
+
+	// The two frames blended by the last update and the weight of the second one
+	std::size_t _curFrame = 0;
+	std::size_t _nextFrame = 0;
+	float _nextFrameFraction = 0;
+
 public:
 	// Update the skeleton to match the given animation at the given time
 	void update(const IMD5AnimPtr& anim, std::size_t time);
 
+	const IMD5AnimPtr& getAnim() const
+	{
+		return _anim;
+	}
+
+	std::size_t getCurrentFrame() const
+	{
+		return _curFrame;
+	}
+
+	std::size_t getNextFrame() const
+	{
+		return _nextFrame;
+	}
+
+	float getNextFrameFraction() const
+	{
+		return _nextFrameFraction;
+	}
+
+	const std::vector<JointMatrix>& getJointMatrices() const
+	{
+		return _jointMatrices;
+	}
+
 	std::size_t size() const
 	{
 		return _skeleton.size();
@@ -40,7 +85,8 @@ public:
 	}
 
 private:
-	void updateJointRecursively(std::size_t jointId);
+	void buildJointOrder();
+	void buildJointMatrices();
 };
 
 } // namespace
@@ -1,9 +1,11 @@
 #include "MD5Surface.h"
 
 #include "ivolumetest.h"
+#include "itextstream.h"
 #include "GLProgramAttributes.h"
 #include "string/convert.h"
 #include "MD5Model.h"
+#include "MD5PoseCache.h"
 #include "math/Ray.h"
 
 namespace md5
@@ -65,13 +67,19 @@ void MD5Surface::updateGeometry()
 		i->bitangent.normalise();
 	}
 
-	// Build the display lists
-	createDisplayLists();
+	// The display lists are compiled on the next render, this might be called
+	// from a worker thread without a GL context
+	releaseDisplayLists();
 }
 
 // Back-end render
 void MD5Surface::render(const RenderInfo& info) const
 {
+	if (_normalList == 0)
+	{
+		createDisplayLists();
+	}
+
 	if (info.checkFlag(RENDER_BUMP))
     {
 		glCallList(_lightingList);
@@ -83,11 +91,8 @@ void MD5Surface::render(const RenderInfo& info) const
 }
 
 // Construct the display lists
-void MD5Surface::createDisplayLists()
+void MD5Surface::createDisplayLists() const
 {
-    // Release old display lists first
-    releaseDisplayLists();
-
 	// Create the list for lighting mode
 	_lightingList = glGenLists(1);
 	assert(_lightingList != 0);
@@ -99,7 +104,7 @@ void MD5Surface::createDisplayLists()
 		 ++i)
 	{
 		// Get the vertex for this index
-		ArbitraryMeshVertex& v = _vertices[*i];
+		const ArbitraryMeshVertex& v = _vertices[*i];
 
 		// Submit the vertex attributes and coordinate
 		if (GLEW_ARB_vertex_program) {
@@ -126,7 +131,7 @@ void MD5Surface::createDisplayLists()
 		 ++i)
 	{
 		// Get the vertex for this index
-		ArbitraryMeshVertex& v = _vertices[*i];
+		const ArbitraryMeshVertex& v = _vertices[*i];
 
 		// Submit attributes
 		glNormal3dv(v.normal);
@@ -317,6 +322,26 @@ void MD5Surface::updateToDefaultPose(const MD5Joints& joints)
 
 void MD5Surface::updateToSkeleton(const MD5Skeleton& skeleton)
 {
+	// Other models showing this mesh in the same frame might have skinned it already
+	MD5PoseCache::Key key{ _mesh.get(), skeleton.getAnim().get(), skeleton.getCurrentFrame(),
+		skeleton.getNextFrame(), skeleton.getNextFrameFraction() };
+
+	auto& poseCache = MD5PoseCache::Instance();
+
+	if (auto pose = poseCache.find(key); pose)
+	{
+		_vertices = pose->vertices;
+		_aabb_local = pose->localAABB;
+
+		if (_indices.empty())
+		{
+			buildIndexArray();
+		}
+
+		releaseDisplayLists();
+		return;
+	}
+
 	// Ensure we have all vertices allocated
 	if (_vertices.size() != _mesh->vertices.size())
 	{
@@ -324,36 +349,116 @@ void MD5Surface::updateToSkeleton(const MD5Skeleton& skeleton)
 	}
 
 	// Deform vertices to fit the skeleton
+	if (!skinVertices(skeleton.getJointMatrices()))
+	{
+		return;
+	}
+
+	// Ensure the index array is ok
+	if (_indices.empty())
+	{
+		buildIndexArray();
+	}
+
+	buildVertexNormals();
+
+	updateGeometry();
+
+	poseCache.insert(key, _mesh, skeleton.getAnim(),
+		std::make_shared<MD5PoseCache::Pose>(MD5PoseCache::Pose{ _vertices, _aabb_local }));
+}
+
+bool MD5Surface::isCompatibleWith(const IMD5Anim& anim) const
+{
+	return _mesh->skinningWeights.numJoints <= anim.getNumJoints();
+}
+
+bool MD5Surface::skinVertices(const std::vector<MD5Skeleton::JointMatrix>& joints)
+{
+	const MD5SkinningWeights& weights = _mesh->skinningWeights;
+
+	if (weights.numJoints > joints.size())
+	{
+		return false; // reported when the anim is set
+	}
+
+	std::size_t numWeights = weights.t.size();
+
+	// Transform the weight positions into model space first, the loop body has
+	// no branches and reads and writes contiguous float arrays, which
+	// allows the compiler to vectorise it
+	thread_local std::vector<float> skinnedX, skinnedY, skinnedZ;
+
+	skinnedX.resize(numWeights);
+	skinnedY.resize(numWeights);
+	skinnedZ.resize(numWeights);
+
+	const unsigned int* jointIndices = weights.joints.data();
+	const float* wx = weights.x.data();
+	const float* wy = weights.y.data();
+	const float* wz = weights.z.data();
+	const float* wt = weights.t.data();
+	float* sx = skinnedX.data();
+	float* sy = skinnedY.data();
+	float* sz = skinnedZ.data();
+
+	for (std::size_t i = 0; i < numWeights; ++i)
+	{
+		const float* m = joints[jointIndices[i]].m;
+
+		// The weight factor is already applied to the position, apply it to the translation
+		sx[i] = m[0] * wx[i] + m[1] * wy[i] + m[2] * wz[i] + m[3] * wt[i];
+		sy[i] = m[4] * wx[i] + m[5] * wy[i] + m[6] * wz[i] + m[7] * wt[i];
+		sz[i] = m[8] * wx[i] + m[9] * wy[i] + m[10] * wz[i] + m[11] * wt[i];
+	}
+
+	// Accumulate the weights of each vertex, they are stored consecutively
 	for (std::size_t j = 0; j < _mesh->vertices.size(); ++j)
 	{
-		MD5Vert& vert = _mesh->vertices[j];
+		const MD5Vert& vert = _mesh->vertices[j];
 
-		Vector3 skinned(0, 0, 0);
+		float x = 0, y = 0, z = 0;
+		std::size_t end = vert.weight_index + vert.weight_count;
 
-		for (std::size_t k = 0; k != vert.weight_count; ++k)
+		for (std::size_t k = vert.weight_index; k < end; ++k)
 		{
-			MD5Weight& weight = _mesh->weights[vert.weight_index + k];
-			const IMD5Anim::Key& key = skeleton.getKey(weight.joint);
-			//const Joint& joint = skeleton.getJoint(weight.joint);
-
-			Vector3 rotatedPoint = key.orientation.transformPoint(weight.v);
-			skinned += (rotatedPoint + key.origin) * weight.t;
+			x += sx[k];
+			y += sy[k];
+			z += sz[k];
 		}
 
-		_vertices[j].vertex = skinned;
+		_vertices[j].vertex = Vertex3f(x, y, z);
 		_vertices[j].texcoord = TexCoord2f(vert.u, vert.v);
 		_vertices[j].normal = Normal3f(0,0,0);
 	}
 
-	// Ensure the index array is ok
-	if (_indices.empty())
+	return true;
+}
+
+void MD5Surface::buildSkinningWeights()
+{
+	const MD5Weights& weights = _mesh->weights;
+	MD5SkinningWeights& result = _mesh->skinningWeights;
+
+	result.joints.resize(weights.size());
+	result.x.resize(weights.size());
+	result.y.resize(weights.size());
+	result.z.resize(weights.size());
+	result.t.resize(weights.size());
+	result.numJoints = 0;
+
+	for (std::size_t i = 0; i < weights.size(); ++i)
 	{
-		buildIndexArray();
-	}
+		const MD5Weight& weight = weights[i];
 
-	buildVertexNormals();
+		result.joints[i] = static_cast<unsigned int>(weight.joint);
+		result.x[i] = static_cast<float>(weight.v.x() * weight.t);
+		result.y[i] = static_cast<float>(weight.v.y() * weight.t);
+		result.z[i] = static_cast<float>(weight.v.z() * weight.t);
+		result.t[i] = weight.t;
 
-	updateGeometry();
+		result.numJoints = std::max(result.numJoints, weight.joint + 1);
+	}
 }
 
 void MD5Surface::buildVertexNormals()
@@ -487,6 +592,8 @@ void MD5Surface::parseFromTokens(parser::DefTokeniser& tok)
 	// ----- END OF MESH DECL -----
 
 	tok.assertNextToken("}");
+
+	buildSkinningWeights();
 }
 
 } // namespace md5
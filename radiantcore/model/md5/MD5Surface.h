@@ -10,6 +10,7 @@
 #include "imodelsurface.h"
 
 #include "MD5DataStructures.h"
+#include "MD5Skeleton.h"
 #include "parser/DefTokeniser.h"
 
 class Ray;
@@ -17,8 +18,6 @@ class Ray;
 namespace md5
 {
 
-class MD5Skeleton;
-
 class MD5Surface :
 	public model::IIndexedModelSurface,
 	public OpenGLRenderable
@@ -44,14 +43,14 @@ private:
 	Vertices _vertices;
 	Indices _indices;
 
-	// The GL display lists for this surface's geometry
-	GLuint _normalList;
-	GLuint _lightingList;
+	// The GL display lists for this surface's geometry, compiled on demand
+	mutable GLuint _normalList;
+	mutable GLuint _lightingList;
 
 private:
 
 	// Create the display lists
-	void createDisplayLists();
+	void createDisplayLists() const;
 
     // Frees any display list in use
     void releaseDisplayLists();
@@ -59,6 +58,13 @@ private:
 	// Re-calculate the normal vectors
 	void buildVertexNormals();
 
+	// Sets the vertex positions to the weights transformed by the given joints,
+	// returns false (without a warning) if there are not enough joints
+	bool skinVertices(const std::vector<MD5Skeleton::JointMatrix>& joints);
+
+	// Fills in the mesh's skinning weights
+	void buildSkinningWeights();
+
 public:
 
 	/**
@@ -80,7 +86,8 @@ public:
 	void setDefaultMaterial(const std::string& name);
 	
 	/**
-	 * Calculate the AABB and build the display lists for rendering.
+	 * Calculate the AABB and tangents, the display lists for rendering are
+	 * rebuilt the next time the surface is rendered.
 	 */
 	void updateGeometry();
 
@@ -91,6 +98,9 @@ public:
 	// Updates this mesh to the state of the given skeleton
 	void updateToSkeleton(const MD5Skeleton& skeleton);
 
+	// Returns true if the given animation provides all joints needed by this mesh
+	bool isCompatibleWith(const IMD5Anim& anim) const;
+
 	// Applies the given Skin to this surface.
 	void applySkin(const ModelSkin& skin);
 
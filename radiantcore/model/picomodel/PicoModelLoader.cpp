@@ -1,12 +1,12 @@
 #include "PicoModelLoader.h"
 
+#include <mutex>
+
 #include "ifilesystem.h"
 #include "iarchive.h"
 #include "imodelcache.h"
-#include "ishaders.h"
 
 #include "lib/picomodel.h"
-#include "gamelib.h"
 
 #include "os/path.h"
 
@@ -19,6 +19,10 @@ namespace model {
 
 namespace
 {
+	// The picomodel library keeps some global parser state (like the LWO reader's
+	// error tracking), models loaded by worker threads need to take turns
+	std::mutex picoModelLibraryLock;
+
 	size_t picoInputStreamReam(void* inputStream, unsigned char* buffer, size_t length)
     {
 		return reinterpret_cast<InputStream*>(inputStream)->read(buffer, length);
@@ -60,13 +64,19 @@ IModelPtr PicoModelLoader::loadModelFromPath(const std::string& path)
 	string::to_lower(fName);
 	std::string fExt = fName.substr(fName.size() - 3, 3);
 
-	picoModel_t* model = PicoModuleLoadModelStream(
-		_module,
-		&file->getInputStream(),
-		picoInputStreamReam,
-		file->size(),
-		0
-	);
+	picoModel_t* model = nullptr;
+
+	{
+		std::lock_guard<std::mutex> lock(picoModelLibraryLock);
+
+		model = PicoModuleLoadModelStream(
+			_module,
+			&file->getInputStream(),
+			picoInputStreamReam,
+			file->size(),
+			0
+		);
+	}
 
 	// greebo: Check if the model load was successful
 	if (!model || model->numSurfaces == 0)
@@ -161,42 +171,36 @@ std::string PicoModelLoader::DetermineDefaultMaterial(picoSurface_t* picoSurface
     // the material name to select the shader, while for an ASE model the
     // bitmap path should be used.
     picoShader_t* shader = PicoGetSurfaceShader(picoSurface);
-    std::string rawName = "";
-    std::string defaultMaterial;
 
-    if (shader != 0)
+    if (shader == 0)
     {
-        if (extension == "lwo")
-        {
-            defaultMaterial = PicoGetShaderName(shader);
-        }
-        else if (extension == "ase")
-        {
-            rawName = PicoGetShaderName(shader);
-            std::string rawMapName = PicoGetShaderMapName(shader);
-            defaultMaterial = CleanupShaderName(rawMapName);
-        }
-        else // if extension is not handled explicitly, use at least something
-        {
-            defaultMaterial = PicoGetShaderName(shader);
-        }
+        return std::string();
     }
 
-    // #4644: Doom3 / TDM don't use the *MATERIAL_NAME in ASE models, only *BITMAP is used
-    // Use the fallback (introduced in #2499) only when the game allows it
-    if (game::current::getValue<bool>("/modelFormat/ase/useMaterialNameIfNoBitmapFound"))
+    if (extension == "ase")
     {
-        // If shader not found, fallback to alternative if available
-        // _defaultMaterial is empty if the ase material has no BITMAP
-        // materialIsValid is false if _defaultMaterial is not an existing shader
-        if ((defaultMaterial.empty() || !GlobalMaterialManager().materialExists(defaultMaterial)) &&
-            !rawName.empty())
-        {
-            defaultMaterial = CleanupShaderName(rawName);
-        }
+        return CleanupShaderName(PicoGetShaderMapName(shader));
     }
 
-    return defaultMaterial;
+    // LWO, or the extension is not handled explicitly, use at least something
+    return PicoGetShaderName(shader);
+}
+
+std::string PicoModelLoader::DetermineFallbackMaterial(picoSurface_t* picoSurface, const std::string& extension)
+{
+    picoShader_t* shader = PicoGetSurfaceShader(picoSurface);
+
+    // ASE models can fall back to their *MATERIAL_NAME if the bitmap is not an
+    // existing material, this is resolved by StaticModel::resolveMaterialFallbacks()
+    // since material lookups can't be done by the threads loading the models
+    if (shader == 0 || extension != "ase")
+    {
+        return std::string();
+    }
+
+    std::string rawName = PicoGetShaderName(shader);
+
+    return rawName.empty() ? std::string() : CleanupShaderName(rawName);
 }
 
 StaticModelSurfacePtr PicoModelLoader::CreateSurface(picoSurface_t* picoSurface, const std::string& extension)
@@ -250,6 +254,7 @@ StaticModelSurfacePtr PicoModelLoader::CreateSurface(picoSurface_t* picoSurface,
     }
 
     staticSurface->setDefaultMaterial(DetermineDefaultMaterial(picoSurface, extension));
+    staticSurface->setFallbackMaterial(DetermineFallbackMaterial(picoSurface, extension));
 
     return staticSurface;
 }
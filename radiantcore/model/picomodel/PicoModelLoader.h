@@ -26,6 +26,7 @@ public:
     static std::vector<StaticModelSurfacePtr> CreateSurfaces(picoModel_t* picoModel, const std::string& extension);
 
     static std::string DetermineDefaultMaterial(picoSurface_t* picoSurface, const std::string& extension);
+    static std::string DetermineFallbackMaterial(picoSurface_t* picoSurface, const std::string& extension);
     static std::string CleanupShaderName(const std::string& inName);
 
 private:
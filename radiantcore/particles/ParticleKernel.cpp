@@ -0,0 +1,554 @@
+#include "ParticleKernel.h"
+
+#include <cmath>
+#include "itextstream.h"
+#include "math/FloatTools.h"
+#include "math/pi.h"
+
+namespace particles
+{
+
+namespace
+{
+	const float TwoPi = 2 * static_cast<float>(math::PI);
+	const float DegreesToRadians = static_cast<float>(math::PI) / 180.0f;
+
+	// Same as RenderableParticleBunch::integrate(), time is measured in seconds
+	inline float integrate(float from, float to, float duration, float time)
+	{
+		return (to - from) / duration * time * time * 0.5f + from * time;
+	}
+
+	inline Vector3f toVector3f(const Vector3& v)
+	{
+		return Vector3f(static_cast<float>(v.x()), static_cast<float>(v.y()), static_cast<float>(v.z()));
+	}
+
+	inline Vector4f toVector4f(const Vector4& v)
+	{
+		return Vector4f(static_cast<float>(v.x()), static_cast<float>(v.y()),
+			static_cast<float>(v.z()), static_cast<float>(v.w()));
+	}
+
+	inline void resizeArray(std::vector<float>& array, std::size_t size)
+	{
+		if (array.size() != size)
+		{
+			array.resize(size);
+		}
+	}
+}
+
+void ParticleKernel::clear()
+{
+	timeSecs.clear();
+	timeFraction.clear();
+	indexFraction.clear();
+	rotationSign.clear();
+	angle.clear();
+
+	for (auto& r : rand)
+	{
+		r.clear();
+	}
+}
+
+void ParticleKernel::addParticle(float timeSecs_, float timeFraction_, float indexFraction_,
+	float rotationSign_, float angle_, const float (&randomNumbers)[5])
+{
+	timeSecs.push_back(timeSecs_);
+	timeFraction.push_back(timeFraction_);
+	indexFraction.push_back(indexFraction_);
+	rotationSign.push_back(rotationSign_);
+	angle.push_back(angle_);
+
+	for (int i = 0; i < 5; ++i)
+	{
+		rand[i].push_back(randomNumbers[i]);
+	}
+}
+
+void ParticleKernel::resizeWorkingSet()
+{
+	std::size_t count = size();
+
+	for (auto array : { &_originX, &_originY, &_originZ, &_distX, &_distY, &_distZ,
+		&_red, &_green, &_blue, &_alpha, &_size, &_aspect, &_widthX, &_widthY, &_widthZ,
+		&_heightX, &_heightY, &_heightZ, &_curScale, &_nextScale, &_curS0, &_nextS0 })
+	{
+		resizeArray(*array, count);
+	}
+}
+
+void ParticleKernel::evaluate(const IStageDef& stage, const Vector3& direction,
+	const Vector3& entityColour, const Matrix4& viewRotation, ParticleVertices& vertices)
+{
+	std::size_t count = size();
+
+	if (count == 0) return;
+
+	resizeWorkingSet();
+
+	calculateOrigins(stage, direction);
+	calculateColours(stage, entityColour);
+	calculateSizesAndAngles(stage);
+	calculateQuadEdges(viewRotation);
+
+	std::size_t animFrames = static_cast<std::size_t>(std::max(stage.getAnimationFrames(), 0));
+	std::size_t firstQuad = vertices.size() / 4;
+
+	if (animFrames == 0)
+	{
+		vertices.resize(vertices.size() + count * 4);
+		emitQuads(viewRotation, nullptr, nullptr, 1.0f, firstQuad, 1, vertices);
+		return;
+	}
+
+	// Animated particles are drawn as two crossfaded quads
+	float frameRate = stage.getAnimationRate();
+
+	// The time interval for cross-fading, fall back to entire duration * 3 for zero animation rates
+	float frameIntervalSecs = frameRate > 0 ? 1.0f / frameRate : 3 * stage.getDuration();
+	float sWidth = 1.0f / animFrames;
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		std::size_t curFrame = static_cast<std::size_t>(floor(timeSecs[i] / frameIntervalSecs)) % animFrames;
+		std::size_t nextFrame = (curFrame + 1) % animFrames;
+
+		float frameMicrotime = float_mod(timeSecs[i], frameIntervalSecs);
+
+		// The "current" quad is always fading out, the next one is fading in
+		_curScale[i] = 1.0f - frameRate * frameMicrotime;
+		_nextScale[i] = frameRate * frameMicrotime;
+
+		_curS0[i] = sWidth * curFrame;
+		_nextS0[i] = sWidth * nextFrame;
+	}
+
+	vertices.resize(vertices.size() + count * 8);
+	emitQuads(viewRotation, &_curScale, &_curS0, sWidth, firstQuad, 2, vertices);
+	emitQuads(viewRotation, &_nextScale, &_nextS0, sWidth, firstQuad + 1, 2, vertices);
+}
+
+void ParticleKernel::calculateOrigins(const IStageDef& stage, const Vector3& direction)
+{
+	std::size_t count = size();
+
+	// Check if the main direction is different to the z axis
+	Vector3 dir = direction.getNormalised();
+	Vector3 zDir(0, 0, 1);
+
+	Matrix4 rotation = dir.angle(zDir) != 0 ? Matrix4::getRotation(zDir, dir) : Matrix4::getIdentity();
+
+	// Consider offset as starting point
+	Vector3 start = rotation.transformPoint(stage.getOffset());
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		_originX[i] = static_cast<float>(start.x());
+		_originY[i] = static_cast<float>(start.y());
+		_originZ[i] = static_cast<float>(start.z());
+	}
+
+	switch (stage.getCustomPathType())
+	{
+	case IStageDef::PATH_STANDARD:
+		calculateStandardPath(stage, rotation);
+		break;
+
+	case IStageDef::PATH_FLIES:
+		{
+			// Particles moving on the surface of a sphere, see RenderableParticleBunch::calculateOrigin
+			float radius = stage.getCustomPathParm(2);
+			float radialParm = stage.getCustomPathParm(0);
+			float axialParm = stage.getCustomPathParm(1);
+
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				float rand0 = 2 * rand[0][i] - 1.0f;
+				float rand1 = 2 * rand[1][i] - 1.0f;
+
+				float radialSpeed = radialParm * (1.0f + 0.5f * rand0 * rand0) * 0.4f;
+				float axialSpeed = axialParm * (1.0f + 0.5f * rand1 * rand1) * 0.4f;
+
+				float phi = TwoPi * rand[2][i] + axialSpeed * timeSecs[i];
+				float theta = static_cast<float>(math::PI) * rand[3][i] + radialSpeed * timeSecs[i];
+
+				float sinPhi = std::sin(phi);
+
+				_originX[i] += radius * std::cos(theta) * sinPhi;
+				_originY[i] += radius * std::sin(theta) * sinPhi;
+				_originZ[i] += radius * std::cos(phi);
+			}
+		}
+		break;
+
+	case IStageDef::PATH_HELIX:
+		{
+			// Particles moving on an elliptic cylinder
+			float sizeX = stage.getCustomPathParm(0);
+			float sizeY = stage.getCustomPathParm(1);
+			float sizeZ = stage.getCustomPathParm(2);
+			float radialParm = stage.getCustomPathParm(3);
+			float axialParm = stage.getCustomPathParm(4);
+
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				float radialSpeed = radialParm * (2 * rand[0][i] - 1.0f);
+				float axialSpeed = axialParm * (2 * rand[1][i] - 1.0f);
+
+				float phi = TwoPi * rand[2][i] + radialSpeed * timeSecs[i];
+				float z0 = sizeZ * (2 * rand[3][i] - 1.0f);
+
+				_originX[i] += sizeX * std::cos(phi);
+				_originY[i] += sizeY * std::sin(phi);
+				_originZ[i] += z0 + axialSpeed * timeSecs[i];
+			}
+		}
+		break;
+
+	case IStageDef::PATH_ORBIT:
+	case IStageDef::PATH_DRIP:
+		// These are actually unsupported by the engine ("bad path type")
+		rWarning() << "Unsupported path type (drip/orbit)." << std::endl;
+		break;
+
+	default:
+		break;
+	};
+
+	// Consider gravity
+	// if "world" is set, use -z as gravity direction, otherwise use the reverse emitter direction
+	Vector3 gravity = (stage.getWorldGravityFlag() ? Vector3(0, 0, -1) : -dir) * stage.getGravity() * 0.5f;
+
+	float gravityX = static_cast<float>(gravity.x());
+	float gravityY = static_cast<float>(gravity.y());
+	float gravityZ = static_cast<float>(gravity.z());
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		float timeSquared = timeSecs[i] * timeSecs[i];
+
+		_originX[i] += gravityX * timeSquared;
+		_originY[i] += gravityY * timeSquared;
+		_originZ[i] += gravityZ * timeSquared;
+	}
+}
+
+void ParticleKernel::calculateStandardPath(const IStageDef& stage, const Matrix4& rotation)
+{
+	std::size_t count = size();
+
+	calculateDistribution(stage);
+
+	// Speed integrated over the particle time
+	const IParticleParameter& speed = stage.getSpeed();
+	float speedFrom = speed.getFrom();
+	float speedTo = speed.getTo();
+	float duration = stage.getDuration();
+
+	switch (stage.getDirectionType())
+	{
+	case IStageDef::DIRECTION_CONE:
+		{
+			// Random vectors on the sphere surface defined by the cone with apex 2*angle
+			float angleRad = stage.getDirectionParm(0) * DegreesToRadians;
+			float v0 = (1 + std::cos(angleRad)) * 0.5f;
+
+			Vector3f xCol = toVector3f(rotation.xCol3());
+			Vector3f yCol = toVector3f(rotation.yCol3());
+			Vector3f zCol = toVector3f(rotation.zCol3());
+
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				float v = v0 + rand[4][i] * (1 - v0);
+
+				float theta = TwoPi * rand[3][i];
+				float phi = std::acos(2 * v - 1);
+
+				float sinPhi = std::sin(phi);
+				float x = std::cos(theta) * sinPhi;
+				float y = std::sin(theta) * sinPhi;
+				float z = std::cos(phi);
+
+				// Rotate the vector into the particle's main direction
+				float dirX = xCol.x() * x + yCol.x() * y + zCol.x() * z;
+				float dirY = xCol.y() * x + yCol.y() * y + zCol.y() * z;
+				float dirZ = xCol.z() * x + yCol.z() * y + zCol.z() * z;
+
+				float distance = integrate(speedFrom, speedTo, duration, timeSecs[i]) /
+					std::sqrt(dirX * dirX + dirY * dirY + dirZ * dirZ);
+
+				_originX[i] += _distX[i] + dirX * distance;
+				_originY[i] += _distY[i] + dirY * distance;
+				_originZ[i] += _distZ[i] + dirZ * distance;
+			}
+		}
+		break;
+
+	case IStageDef::DIRECTION_OUTWARD:
+		{
+			// Away from the spawn origin, plus the upwards bias
+			float upwardsBias = stage.getDirectionParm(0);
+
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				float inverseLength = 1.0f / std::sqrt(_distX[i] * _distX[i] + _distY[i] * _distY[i] + _distZ[i] * _distZ[i]);
+				float distance = integrate(speedFrom, speedTo, duration, timeSecs[i]);
+
+				_originX[i] += _distX[i] + _distX[i] * inverseLength * distance;
+				_originY[i] += _distY[i] + _distY[i] * inverseLength * distance;
+				_originZ[i] += _distZ[i] + (_distZ[i] * inverseLength + upwardsBias) * distance;
+			}
+		}
+		break;
+
+	default:
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			_originX[i] += _distX[i];
+			_originY[i] += _distY[i];
+			_originZ[i] += _distZ[i] + integrate(speedFrom, speedTo, duration, timeSecs[i]);
+		}
+		break;
+	};
+}
+
+void ParticleKernel::calculateDistribution(const IStageDef& stage)
+{
+	std::size_t count = size();
+	bool distributeRandomly = stage.getRandomDistribution();
+
+	float sizeX = stage.getDistributionParm(0);
+	float sizeY = stage.getDistributionParm(1);
+	float sizeZ = stage.getDistributionParm(2);
+	float ringFrac = stage.getDistributionParm(3);
+
+	auto setConstantOffset = [&](float x, float y, float z)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			_distX[i] = x;
+			_distY[i] = y;
+			_distZ[i] = z;
+		}
+	};
+
+	// If random distribution is off, particles get spawned at <sizex, sizey, sizez>
+	switch (stage.getDistributionType())
+	{
+	case IStageDef::DISTRIBUTION_RECT:
+		if (!distributeRandomly)
+		{
+			setConstantOffset(sizeX, sizeY, sizeZ);
+			break;
+		}
+
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			_distX[i] = (2 * rand[0][i] - 1.0f) * sizeX;
+			_distY[i] = (2 * rand[1][i] - 1.0f) * sizeY;
+			_distZ[i] = (2 * rand[2][i] - 1.0f) * sizeZ;
+		}
+		break;
+
+	case IStageDef::DISTRIBUTION_CYLINDER:
+		// The ring fraction is only effective if > 1, it scales the elliptic shape
+		if (ringFrac > 1.0f)
+		{
+			sizeX *= ringFrac;
+			sizeY *= ringFrac;
+		}
+
+		if (!distributeRandomly)
+		{
+			setConstantOffset(sizeX, sizeY, sizeZ);
+			break;
+		}
+
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			float angle = TwoPi * rand[0][i];
+
+			_distX[i] = std::cos(angle) * sizeX;
+			_distY[i] = std::sin(angle) * sizeY;
+			_distZ[i] = sizeZ * (2 * rand[1][i] - 1.0f);
+		}
+		break;
+
+	case IStageDef::DISTRIBUTION_SPHERE:
+		if (!distributeRandomly)
+		{
+			setConstantOffset(sizeX, sizeY, sizeZ);
+			break;
+		}
+
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			float theta = TwoPi * rand[0][i];
+			float phi = std::acos(2 * rand[1][i] - 1);
+
+			// Take the sqrt(radius) to correct bunching at the center of the sphere
+			float r = ringFrac + (1 - ringFrac) * std::sqrt(rand[2][i]);
+			float sinPhi = std::sin(phi);
+
+			_distX[i] = sizeX * r * std::cos(theta) * sinPhi;
+			_distY[i] = sizeY * r * std::sin(theta) * sinPhi;
+			_distZ[i] = sizeZ * r * std::cos(phi);
+		}
+		break;
+
+	default:
+		setConstantOffset(0, 0, 0);
+		break;
+	};
+}
+
+void ParticleKernel::calculateColours(const IStageDef& stage, const Vector3& entityColour)
+{
+	std::size_t count = size();
+
+	Vector4f mainColour = !stage.getUseEntityColour() ? toVector4f(stage.getColour()) :
+		Vector4f(toVector3f(entityColour), 1);
+	Vector4f fadeColour = toVector4f(stage.getFadeColour());
+
+	float fadeIndexFraction = stage.getFadeIndexFraction();
+	float fadeInFraction = stage.getFadeInFraction();
+	float fadeOutFraction = stage.getFadeOutFraction();
+	float fadeOutFractionInverse = 1.0f - fadeOutFraction;
+	float fadeIndexStart = 1.0f - fadeIndexFraction;
+
+	// Each particle ends up with one lerp between the main and the fade colour,
+	// these are the fractions of the fade colour
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		float fade = 0;
+
+		// Particles with a higher index start more faded
+		if (fadeIndexFraction > 0)
+		{
+			float frac = (fadeIndexStart - indexFraction[i]) / (fadeIndexStart - 1.0f);
+			fade = frac > 0 ? frac : 0;
+		}
+
+		if (fadeInFraction > 0 && timeFraction[i] <= fadeInFraction)
+		{
+			fade = 1.0f - timeFraction[i] / fadeInFraction;
+		}
+
+		if (fadeOutFraction > 0 && timeFraction[i] >= fadeOutFractionInverse)
+		{
+			fade = (timeFraction[i] - fadeOutFractionInverse) / fadeOutFraction;
+		}
+
+		_red[i] = mainColour.x() * (1.0f - fade) + fadeColour.x() * fade;
+		_green[i] = mainColour.y() * (1.0f - fade) + fadeColour.y() * fade;
+		_blue[i] = mainColour.z() * (1.0f - fade) + fadeColour.z() * fade;
+		_alpha[i] = mainColour.w() * (1.0f - fade) + fadeColour.w() * fade;
+	}
+}
+
+void ParticleKernel::calculateSizesAndAngles(const IStageDef& stage)
+{
+	std::size_t count = size();
+
+	float sizeFrom = stage.getSize().getFrom();
+	float sizeDelta = stage.getSize().getTo() - sizeFrom;
+	float aspectFrom = stage.getAspect().getFrom();
+	float aspectDelta = stage.getAspect().getTo() - aspectFrom;
+	float rotationFrom = stage.getRotationSpeed().getFrom();
+	float rotationTo = stage.getRotationSpeed().getTo();
+	float duration = stage.getDuration();
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		_size[i] = sizeFrom + timeFraction[i] * sizeDelta;
+		_aspect[i] = aspectFrom + timeFraction[i] * aspectDelta;
+
+		angle[i] += rotationSign[i] * integrate(rotationFrom, rotationTo, duration, timeSecs[i]);
+	}
+}
+
+void ParticleKernel::calculateQuadEdges(const Matrix4& viewRotation)
+{
+	std::size_t count = size();
+
+	Vector3f xCol = toVector3f(viewRotation.xCol3());
+	Vector3f yCol = toVector3f(viewRotation.yCol3());
+
+	// The quad is rotated by its angle in the xy plane, then oriented by the view rotation
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		float radians = angle[i] * DegreesToRadians;
+		float cosPhi = std::cos(radians);
+		float sinPhi = std::sin(radians);
+
+		float halfWidth = _size[i];
+		float halfHeight = _size[i] * _aspect[i];
+
+		float widthU = cosPhi * halfWidth;
+		float widthV = -sinPhi * halfWidth;
+		float heightU = sinPhi * halfHeight;
+		float heightV = cosPhi * halfHeight;
+
+		_widthX[i] = xCol.x() * widthU + yCol.x() * widthV;
+		_widthY[i] = xCol.y() * widthU + yCol.y() * widthV;
+		_widthZ[i] = xCol.z() * widthU + yCol.z() * widthV;
+
+		_heightX[i] = xCol.x() * heightU + yCol.x() * heightV;
+		_heightY[i] = xCol.y() * heightU + yCol.y() * heightV;
+		_heightZ[i] = xCol.z() * heightU + yCol.z() * heightV;
+	}
+}
+
+void ParticleKernel::emitQuads(const Matrix4& viewRotation, const std::vector<float>* colourScale,
+	const std::vector<float>* s0, float sWidth, std::size_t firstQuad, std::size_t quadStride,
+	ParticleVertices& vertices)
+{
+	std::size_t count = size();
+
+	Vector3f normal = toVector3f(viewRotation.zCol3());
+	Vector3f translation = toVector3f(viewRotation.translation());
+
+	// Corner signs of the width and height vectors, and the texcoords
+	static const float widthSign[4] = { -1, +1, +1, -1 };
+	static const float heightSign[4] = { +1, +1, -1, -1 };
+	static const float sFactor[4] = { 0, 1, 1, 0 };
+	static const float tCoord[4] = { 0, 0, 1, 1 };
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		ParticleVertex* quad = &vertices[(firstQuad + i * quadStride) * 4];
+
+		float scale = colourScale != nullptr ? (*colourScale)[i] : 1.0f;
+		float sStart = s0 != nullptr ? (*s0)[i] : 0.0f;
+
+		float centreX = _originX[i] + translation.x();
+		float centreY = _originY[i] + translation.y();
+		float centreZ = _originZ[i] + translation.z();
+
+		for (int corner = 0; corner < 4; ++corner)
+		{
+			ParticleVertex& v = quad[corner];
+
+			v.vertex[0] = centreX + widthSign[corner] * _widthX[i] + heightSign[corner] * _heightX[i];
+			v.vertex[1] = centreY + widthSign[corner] * _widthY[i] + heightSign[corner] * _heightY[i];
+			v.vertex[2] = centreZ + widthSign[corner] * _widthZ[i] + heightSign[corner] * _heightZ[i];
+
+			v.texcoord[0] = sStart + sFactor[corner] * sWidth;
+			v.texcoord[1] = tCoord[corner];
+
+			v.normal[0] = normal.x();
+			v.normal[1] = normal.y();
+			v.normal[2] = normal.z();
+
+			v.colour[0] = _red[i] * scale;
+			v.colour[1] = _green[i] * scale;
+			v.colour[2] = _blue[i] * scale;
+			v.colour[3] = _alpha[i] * scale;
+		}
+	}
+}
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vector>
+#include "iparticlestage.h"
+#include "math/Matrix4.h"
+#include "math/Vector3.h"
+
+namespace particles
+{
+
+/// Interleaved vertex as sent to OpenGL, all particle geometry ends up in this format
+struct ParticleVertex
+{
+	float vertex[3];
+	float texcoord[2];
+	float normal[3];
+	float colour[4];
+};
+typedef std::vector<ParticleVertex> ParticleVertices;
+
+/**
+ * Evaluates the particles of a bunch in structure-of-arrays form, each
+ * quantity (origin, size, colour, angle) is calculated for all particles
+ * in a single loop over plain float arrays without cross-iteration
+ * dependencies. The colour, size and quad emission loops are plain
+ * arithmetic the compiler can vectorise, the origin, path, distribution and
+ * quad edge loops call sin/cos/acos/sqrt and are only vectorised where the
+ * compiler has vector versions of these functions.
+ *
+ * The random numbers and start times are filled in by the owning bunch,
+ * since they need to be drawn from the bunch's generator in particle order.
+ * This doesn't handle aimed particles, whose quad trails depend on each other.
+ */
+class ParticleKernel
+{
+public:
+	// Inputs, one entry per live particle
+	std::vector<float> timeSecs;
+	std::vector<float> timeFraction;
+	std::vector<float> indexFraction;	// particle index / stage count
+	std::vector<float> rotationSign;	// half the particles rotate backwards
+	std::vector<float> angle;			// initial angle in degrees
+	std::vector<float> rand[5];			// random numbers needed for pathing
+
+private:
+	// Working set
+	std::vector<float> _originX, _originY, _originZ;
+	std::vector<float> _distX, _distY, _distZ;
+	std::vector<float> _red, _green, _blue, _alpha;
+	std::vector<float> _size, _aspect;
+
+	// The quad edges in object space, half width and half height vectors
+	std::vector<float> _widthX, _widthY, _widthZ;
+	std::vector<float> _heightX, _heightY, _heightZ;
+
+	// Animation crossfade, colour scale and horizontal texcoord of both quads
+	std::vector<float> _curScale, _nextScale;
+	std::vector<float> _curS0, _nextS0;
+
+public:
+	std::size_t size() const
+	{
+		return timeSecs.size();
+	}
+
+	// Removes all particles, keeping the allocated memory
+	void clear();
+
+	// Adds a particle, the random numbers are expected in [0..1]
+	void addParticle(float timeSecs, float timeFraction, float indexFraction,
+		float rotationSign, float angle, const float (&randomNumbers)[5]);
+
+	// Evaluates all particles and appends the resulting quads to the given buffer
+	void evaluate(const IStageDef& stage, const Vector3& direction, const Vector3& entityColour,
+		const Matrix4& viewRotation, ParticleVertices& vertices);
+
+private:
+	void resizeWorkingSet();
+
+	void calculateOrigins(const IStageDef& stage, const Vector3& direction);
+	void calculateStandardPath(const IStageDef& stage, const Matrix4& rotation);
+	void calculateDistribution(const IStageDef& stage);
+	void calculateColours(const IStageDef& stage, const Vector3& entityColour);
+	void calculateSizesAndAngles(const IStageDef& stage);
+	void calculateQuadEdges(const Matrix4& viewRotation);
+
+	// Writes one quad per particle into the given (pre-sized) buffer, starting at firstQuad
+	// and advancing by quadStride quads per particle. The colour scale and horizontal
+	// texcoords are optional.
+	void emitQuads(const Matrix4& viewRotation, const std::vector<float>* colourScale,
+		const std::vector<float>* s0, float sWidth, std::size_t firstQuad, std::size_t quadStride,
+		ParticleVertices& vertices);
+};
+
+}
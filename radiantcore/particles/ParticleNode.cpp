@@ -2,12 +2,22 @@
 
 #include "ivolumetest.h"
 #include "itextstream.h"
+#include "registry/CachedKey.h"
 
 namespace particles
 {
 
-ParticleNode::ParticleNode(const RenderableParticlePtr& particle) :
+namespace
+{
+	// Emitters farther away from the viewer are simulated at a lower rate
+	const char* const RKEY_REDUCED_RATE_DISTANCE = "user/ui/particles/reducedRateDistance";
+	const char* const RKEY_REDUCED_RATE_INTERVAL = "user/ui/particles/reducedRateInterval";
+}
+
+ParticleNode::ParticleNode(const RenderableParticlePtr& particle, const ParticleSimulationCachePtr& simulationCache) :
 	_renderableParticle(particle),
+	_simulationCache(simulationCache),
+	_lastUpdateTime(0),
 	_local2Parent(Matrix4::getIdentity())
 {}
 
@@ -28,7 +38,7 @@ IRenderableParticlePtr ParticleNode::getParticle() const
 
 const AABB& ParticleNode::localAABB() const
 {
-	return _renderableParticle->getBounds();
+	return _activeParticle ? _activeParticle->getBounds() : _renderableParticle->getBounds();
 }
 
 std::size_t ParticleNode::getHighlightFlags()
@@ -64,10 +74,10 @@ void ParticleNode::renderSolid(RenderableCollector& collector,
 {
 	if (!_renderableParticle) return;
 
-	// Update the particle system before rendering
-	update(volume);
+	// Update the particle system before rendering, nothing to do if culled
+	if (!update(volume)) return;
 
-	_renderableParticle->renderSolid(collector, volume, localToWorld(), _renderEntity);
+	_activeParticle->renderSolid(collector, volume, localToWorld(), _renderEntity);
 }
 
 void ParticleNode::renderWireframe(RenderableCollector& collector,
@@ -91,8 +101,17 @@ void ParticleNode::setRenderSystem(const RenderSystemPtr& renderSystem)
 	_renderableParticle->setRenderSystem(renderSystem);
 }
 
-void ParticleNode::update(const VolumeTest& viewVolume) const
+bool ParticleNode::update(const VolumeTest& viewVolume) const
 {
+	const Matrix4& localToWorld = this->localToWorld();
+
+	// The conservative bounds don't depend on the simulation, check them before doing any work
+	if (viewVolume.TestAABB(_renderableParticle->getConservativeBounds(), localToWorld) == VOLUME_OUTSIDE)
+	{
+		_simulationCache->countSkippedEmitter();
+		return false;
+	}
+
 	// Get the view rotation and cancel out the translation part
 	Matrix4 viewRotation = viewVolume.GetModelview();
 	viewRotation.tx() = 0;
@@ -107,7 +126,47 @@ void ParticleNode::update(const VolumeTest& viewVolume) const
 	_renderableParticle->setEntityColour(Vector3(
 		_renderEntity->getShaderParm(0), _renderEntity->getShaderParm(1), _renderEntity->getShaderParm(2)));
 
+	std::size_t time = _renderableParticle->getRenderTime();
+
+	// Distant emitters keep their geometry for a few frames, as long as it is their own
+	static registry::CachedKey<float> reducedRateDistance(RKEY_REDUCED_RATE_DISTANCE);
+	static registry::CachedKey<int> reducedRateInterval(RKEY_REDUCED_RATE_INTERVAL);
+
+	if (_activeParticle == _renderableParticle && time >= _lastUpdateTime &&
+		time - _lastUpdateTime < static_cast<std::size_t>(std::max(reducedRateInterval.get(), 0)))
+	{
+		Vector3 viewer = viewVolume.GetModelview().getFullInverse().translation();
+
+		if ((localToWorld.translation() - viewer).getLength() > reducedRateDistance.get())
+		{
+			_simulationCache->countSkippedEmitter();
+			return true;
+		}
+	}
+
+	// Emitters with the same inputs produce the same geometry, re-use the first one
+	ParticleSimulationCache::Key key(_renderableParticle->getParticleDef().get(), time,
+		_renderEntity->getDirection(), Vector3(_renderEntity->getShaderParm(0),
+		_renderEntity->getShaderParm(1), _renderEntity->getShaderParm(2)), viewRotation);
+
+	RenderableParticlePtr simulated = _simulationCache->find(key);
+
+	if (simulated && simulated != _renderableParticle)
+	{
+		_activeParticle = simulated;
+		_simulationCache->countSkippedEmitter();
+		return true;
+	}
+
 	_renderableParticle->update(viewRotation);
+
+	_simulationCache->insert(key, _renderableParticle);
+	_simulationCache->countActiveEmitter();
+
+	_activeParticle = _renderableParticle;
+	_lastUpdateTime = time;
+
+	return true;
 }
 
 } // namespace
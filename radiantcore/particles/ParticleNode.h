@@ -6,6 +6,7 @@
 #include "itransformnode.h"
 
 #include "RenderableParticle.h"
+#include "ParticleSimulationCache.h"
 
 namespace particles
 {
@@ -22,11 +23,21 @@ class ParticleNode :
     // The actual particle system that will be rendered
 	RenderableParticlePtr _renderableParticle;
 
+	// Shared among all particle nodes to look up identical simulations
+	ParticleSimulationCachePtr _simulationCache;
+
+	// The particle whose geometry is rendered in the current frame, this is either
+	// our own one or the one of an emitter with identical simulation inputs
+	mutable RenderableParticlePtr _activeParticle;
+
+	// The render time our own particle has last been simulated at
+	mutable std::size_t _lastUpdateTime;
+
 	mutable Matrix4 _local2Parent;
 
 public:
 	// Construct the node giving a renderable particle
-	ParticleNode(const RenderableParticlePtr& particle);
+	ParticleNode(const RenderableParticlePtr& particle, const ParticleSimulationCachePtr& simulationCache);
 
 	std::string name() const override;
 	Type getNodeType() const override;
@@ -44,7 +55,8 @@ public:
 	Matrix4 localToParent() const override;
 
 private:
-	void update(const VolumeTest& viewVolume) const;
+	// Prepares the geometry for rendering, returns false if the emitter is not visible
+	bool update(const VolumeTest& viewVolume) const;
 };
 typedef std::shared_ptr<ParticleNode> ParticleNodePtr;
 
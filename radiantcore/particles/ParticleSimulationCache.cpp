@@ -0,0 +1,73 @@
+#include "ParticleSimulationCache.h"
+
+#include <algorithm>
+#include "RenderableParticle.h"
+
+namespace particles
+{
+
+ParticleSimulationCache::Key::Key(const IParticleDef* def_, std::size_t time_,
+	const Vector3& direction, const Vector3& entityColour, const Matrix4& viewRotation) :
+	def(def_),
+	time(time_)
+{
+	parameters[0] = direction.x();
+	parameters[1] = direction.y();
+	parameters[2] = direction.z();
+	parameters[3] = entityColour.x();
+	parameters[4] = entityColour.y();
+	parameters[5] = entityColour.z();
+
+	const double* matrix = viewRotation;
+	std::copy(matrix, matrix + 16, parameters.begin() + 6);
+}
+
+ParticleSimulationCache::ParticleSimulationCache() :
+	_time(0)
+{}
+
+RenderableParticlePtr ParticleSimulationCache::find(const Key& key)
+{
+	setTime(key.time);
+
+	auto found = _simulations.find(key);
+
+	return found != _simulations.end() ? found->second.particle.lock() : RenderableParticlePtr();
+}
+
+void ParticleSimulationCache::insert(const Key& key, const RenderableParticlePtr& particle)
+{
+	setTime(key.time);
+
+	// The particle's previous geometry is gone
+	auto previous = _keyByParticle.find(particle.get());
+
+	if (previous != _keyByParticle.end())
+	{
+		_simulations.erase(previous->second);
+		_keyByParticle.erase(previous);
+	}
+
+	auto result = _simulations.insert(SimulationMap::value_type(key, Simulation{ particle, particle.get() }));
+
+	if (!result.second)
+	{
+		// Take over the entry, its old particle is expired or has been re-simulated meanwhile
+		_keyByParticle.erase(result.first->second.owner);
+		result.first->second = Simulation{ particle, particle.get() };
+	}
+
+	_keyByParticle[particle.get()] = result.first;
+}
+
+void ParticleSimulationCache::setTime(std::size_t time)
+{
+	if (time != _time)
+	{
+		_simulations.clear();
+		_keyByParticle.clear();
+		_time = time;
+	}
+}
+
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <map>
+#include <memory>
+#include <tuple>
+#include "iparticles.h"
+#include "math/Matrix4.h"
+#include "math/Vector3.h"
+
+namespace particles
+{
+
+class RenderableParticle;
+typedef std::shared_ptr<RenderableParticle> RenderableParticlePtr;
+
+/**
+ * Remembers which renderable particle has been simulated with which inputs
+ * at the current render time. Emitters sharing a particle def, direction,
+ * colour and view can render the geometry of the first one instead of
+ * simulating their own, their random seed is derived from the def name.
+ * Also counts the simulated and skipped emitters.
+ */
+class ParticleSimulationCache
+{
+public:
+	struct Key
+	{
+		const IParticleDef* def;
+		std::size_t time;
+
+		// Main direction, entity colour and view rotation
+		std::array<double, 22> parameters;
+
+		Key(const IParticleDef* def_, std::size_t time_, const Vector3& direction,
+			const Vector3& entityColour, const Matrix4& viewRotation);
+
+		bool operator<(const Key& other) const
+		{
+			return std::tie(def, time, parameters) < std::tie(other.def, other.time, other.parameters);
+		}
+	};
+
+private:
+	struct Simulation
+	{
+		std::weak_ptr<RenderableParticle> particle;
+
+		// Kept separately, such that expired entries can still be unregistered
+		const RenderableParticle* owner;
+	};
+
+	typedef std::map<Key, Simulation> SimulationMap;
+	SimulationMap _simulations;
+
+	// The key each particle has last been simulated with
+	std::map<const RenderableParticle*, SimulationMap::iterator> _keyByParticle;
+
+	// Entries are only kept for a single render time
+	std::size_t _time;
+
+	IParticlesManager::EmitterStatistics _statistics;
+
+public:
+	ParticleSimulationCache();
+
+	// Returns the particle simulated with the given inputs, or an empty pointer
+	RenderableParticlePtr find(const Key& key);
+
+	// Registers the given particle as having been simulated with the given inputs
+	void insert(const Key& key, const RenderableParticlePtr& particle);
+
+	void countActiveEmitter()
+	{
+		++_statistics.active;
+	}
+
+	void countSkippedEmitter()
+	{
+		++_statistics.skipped;
+	}
+
+	const IParticlesManager::EmitterStatistics& getStatistics() const
+	{
+		return _statistics;
+	}
+
+	void resetStatistics()
+	{
+		_statistics = IParticlesManager::EmitterStatistics();
+	}
+
+private:
+	// Drops all entries if the given time differs from the stored one
+	void setTime(std::size_t time);
+};
+typedef std::shared_ptr<ParticleSimulationCache> ParticleSimulationCachePtr;
+
+}
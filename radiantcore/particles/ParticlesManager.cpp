@@ -6,6 +6,7 @@
 #include "RenderableParticle.h"
 
 #include "icommandsystem.h"
+#include "iregistry.h"
 #include "itextstream.h"
 #include "ifilesystem.h"
 #include "ifiletypes.h"
@@ -43,7 +44,8 @@ namespace
 }
 
 ParticlesManager::ParticlesManager() :
-    _defLoader(std::bind(&ParticlesManager::reloadParticleDefs, this))
+    _defLoader(std::bind(&ParticlesManager::reloadParticleDefs, this)),
+    _simulationCache(std::make_shared<ParticleSimulationCache>())
 {}
 
 sigc::signal<void> ParticlesManager::signal_particlesReloaded() const
@@ -92,7 +94,7 @@ IParticleNodePtr ParticlesManager::createParticleNode(const std::string& name)
 	}
 
 	RenderableParticlePtr renderable(new RenderableParticle(found->second));
-	return ParticleNodePtr(new ParticleNode(renderable));
+	return ParticleNodePtr(new ParticleNode(renderable, _simulationCache));
 }
 
 IRenderableParticlePtr ParticlesManager::getRenderableParticle(const std::string& name)
@@ -223,6 +225,7 @@ const StringSet& ParticlesManager::getDependencies() const
 		_dependencies.insert(MODULE_VIRTUALFILESYSTEM);
 		_dependencies.insert(MODULE_COMMANDSYSTEM);
 		_dependencies.insert(MODULE_FILETYPES);
+		_dependencies.insert(MODULE_XMLREGISTRY);
 	}
 
 	return _dependencies;
@@ -243,6 +246,16 @@ void ParticlesManager::initialiseModule(const IApplicationContext& ctx)
 	GlobalFiletypes().registerPattern("particle", FileTypePattern(_("Particle File"), "prt", "*.prt"));
 }
 
+IParticlesManager::EmitterStatistics ParticlesManager::getEmitterStatistics() const
+{
+	return _simulationCache->getStatistics();
+}
+
+void ParticlesManager::resetEmitterStatistics()
+{
+	_simulationCache->resetStatistics();
+}
+
 void ParticlesManager::reloadParticleDefs()
 {
 	ScopedDebugTimer timer("Particle definitions parsed: ");
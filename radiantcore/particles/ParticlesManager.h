@@ -3,6 +3,7 @@
 #include "ParticleDef.h"
 #include "StageDef.h"
 
+#include "ParticleSimulationCache.h"
 #include "ThreadedDefLoader.h"
 #include "iparticles.h"
 #include "parser/DefTokeniser.h"
@@ -25,6 +26,9 @@ class ParticlesManager :
     // Reloaded signal
     sigc::signal<void> _particlesReloadedSignal;
 
+    // Shared by all particle nodes
+    ParticleSimulationCachePtr _simulationCache;
+
 public:
     ParticlesManager();
 
@@ -46,6 +50,9 @@ public:
 
 	void saveParticleDef(const std::string& particle) override;
 
+	EmitterStatistics getEmitterStatistics() const override;
+	void resetEmitterStatistics() override;
+
 	// RegisterableModule implementation
 	const std::string& getName() const override;
     const StringSet& getDependencies() const override;
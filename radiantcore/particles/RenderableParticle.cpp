@@ -1,11 +1,13 @@
 #include "RenderableParticle.h"
 
+#include <functional>
+
 namespace particles
 {
 
 RenderableParticle::RenderableParticle(const IParticleDefPtr& particleDef) :
 	_particleDef(), // don't initialise the ptr yet
-	_random(rand()), // use a random seed
+	_random(), // seeded by the particle def
 	_direction(0,0,1), // default direction
 	_entityColour(1,1,1) // default entity colour
 {
@@ -147,6 +149,30 @@ const AABB& RenderableParticle::getBounds()
 	return _bounds;
 }
 
+AABB RenderableParticle::getConservativeBounds() const
+{
+	AABB bounds;
+
+	for (const ShaderMap::value_type& pair : _shaderMap)
+	{
+		for (const RenderableParticleStagePtr& stage : pair.second.stages)
+		{
+			if (!stage->getDef().isVisible()) continue;
+
+			bounds.includeAABB(stage->getConservativeBounds());
+		}
+	}
+
+	return bounds;
+}
+
+std::size_t RenderableParticle::getRenderTime() const
+{
+	RenderSystemPtr renderSystem = _renderSystem.lock();
+
+	return renderSystem ? renderSystem->getTime() : 0;
+}
+
 void RenderableParticle::calculateBounds()
 {
 	for (ShaderMap::const_iterator i = _shaderMap.begin(); i != _shaderMap.end(); ++i)
@@ -166,6 +192,10 @@ void RenderableParticle::setupStages()
 
 	if (_particleDef == NULL) return; // nothing to do.
 
+	// Seed the stages from the def name, such that all emitters of this def
+	// produce the same particles and can share their simulation
+	_random.seed(static_cast<Rand48::result_type>(std::hash<std::string>()(_particleDef->getName())));
+
 	for (std::size_t i = 0; i < _particleDef->getNumStages(); ++i)
 	{
 		const IStageDef& stage = _particleDef->getStage(i);
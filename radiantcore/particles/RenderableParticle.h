@@ -87,6 +87,12 @@ public:
 	// Updates bounds from stages and returns the value
 	const AABB& getBounds() override;
 
+	// Returns the bounds the visible stages can occupy at any time, in local space
+	AABB getConservativeBounds() const;
+
+	// The time of the rendersystem, or 0 if there is none
+	std::size_t getRenderTime() const;
+
 private:
 	void calculateBounds();
 
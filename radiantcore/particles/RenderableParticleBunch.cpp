@@ -27,7 +27,9 @@ RenderableParticleBunch::RenderableParticleBunch(std::size_t index,
 void RenderableParticleBunch::update(std::size_t time)
 {
     _bounds = AABB();
+    _vertices.clear();
     _quads.clear();
+    _kernel.clear();
 
     // Length of one cycle (duration + deadtime)
     std::size_t cycleMsec = static_cast<std::size_t>(_stage.getCycleMsec());
@@ -37,9 +39,6 @@ void RenderableParticleBunch::update(std::size_t time)
         return;
     }
 
-    // Reserve enough space for all the particles (non-animated case)
-    _quads.reserve(_stage.getCount() * 4);
-
     // Normalise the global input time into local cycle time
     // The cycleTime may be larger than the _stage.cycleMsec argument if bunching is turned off
     std::size_t cycleTime = time - cycleMsec * _index;
@@ -56,6 +55,9 @@ void RenderableParticleBunch::update(std::size_t time)
     // This is the spacing between each particle
     std::size_t spawnSpacingMsec = static_cast<std::size_t>(spawnSpacing);
 
+    // Aimed particles are calculated one by one, all others are passed to the kernel
+    bool aimed = _stage.getOrientationType() == IStageDef::ORIENTATION_AIMED;
+
     // Generate all particle quads, regardless of their visibility
     // Visibility is considered by not rendering particles that haven't been spawned yet
     for (std::size_t i = 0; i < static_cast<std::size_t>(_stage.getCount()); ++i)
@@ -83,9 +85,6 @@ void RenderableParticleBunch::update(std::size_t time)
         // We need the particle time in seconds for the location/angle integrations
         particle.timeSecs = MS2SEC(particleTime);
 
-        // Calculate particle origin at time t
-        calculateOrigin(particle);
-
         // Get the initial angle value
         particle.angle = _stage.getInitialAngle();
 
@@ -106,9 +105,21 @@ void RenderableParticleBunch::update(std::size_t time)
             continue; // particle has expired
         }
 
-        // Calculate the time-dependent angle
         // according to docs, half the quads have negative rotation speed
         int rotFactor = i % 2 == 0 ? -1 : 1;
+
+        if (!aimed)
+        {
+            _kernel.addParticle(particle.timeSecs, particle.timeFraction,
+                static_cast<float>(i) / _stage.getCount(), static_cast<float>(rotFactor),
+                particle.angle, particle.rand);
+            continue;
+        }
+
+        // Calculate particle origin at time t
+        calculateOrigin(particle);
+
+        // Calculate the time-dependent angle
         particle.angle += rotFactor * integrate(_stage.getRotationSpeed(), particle.timeSecs);
 
         // Calculate render colour for this particle
@@ -130,40 +141,32 @@ void RenderableParticleBunch::update(std::size_t time)
         }
 
         // For aimed orientation, we need to override particle height and aspect
-        if (_stage.getOrientationType() == IStageDef::ORIENTATION_AIMED)
-        {
-            pushAimedParticles(particle, stageDurationMsec);
-        }
-        else
-        {
-            if (particle.animFrames > 0)
-            {
-                // Animated, push two crossfaded quads
-                pushQuad(particle, particle.curColour, particle.sWidth * particle.curFrame, particle.sWidth);
-                pushQuad(particle, particle.nextColour, particle.sWidth * particle.nextFrame, particle.sWidth);
-            }
-            else
-            {
-                // Non-animated quad
-                pushQuad(particle, particle.colour);
-            }
-        }
+        pushAimedParticles(particle, stageDurationMsec);
+    }
+
+    if (aimed)
+    {
+        copyQuadsToVertices();
+    }
+    else
+    {
+        _kernel.evaluate(_stage, _direction, _entityColour, _viewRotation, _vertices);
     }
 }
 
 void RenderableParticleBunch::render(const RenderInfo& info) const
 {
-    if (_quads.empty()) return;
+    if (_vertices.empty()) return;
 
     glEnableClientState(GL_TEXTURE_COORD_ARRAY);
     glEnableClientState(GL_COLOR_ARRAY);
 
-    glVertexPointer(3, GL_DOUBLE, sizeof(ParticleQuad::Vertex), &(_quads.front().verts[0].vertex));
-    glTexCoordPointer(2, GL_DOUBLE, sizeof(ParticleQuad::Vertex), &(_quads.front().verts[0].texcoord));
-    glNormalPointer(GL_DOUBLE, sizeof(ParticleQuad::Vertex), &(_quads.front().verts[0].normal));
-    glColorPointer(4, GL_DOUBLE, sizeof(ParticleQuad::Vertex), &(_quads.front().verts[0].colour));
+    glVertexPointer(3, GL_FLOAT, sizeof(ParticleVertex), _vertices.front().vertex);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(ParticleVertex), _vertices.front().texcoord);
+    glNormalPointer(GL_FLOAT, sizeof(ParticleVertex), _vertices.front().normal);
+    glColorPointer(4, GL_FLOAT, sizeof(ParticleVertex), _vertices.front().colour);
 
-    glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(_quads.size())*4);
+    glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(_vertices.size()));
 
 	glDisableClientState(GL_COLOR_ARRAY);
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
@@ -558,18 +561,6 @@ Vector3 RenderableParticleBunch::getDistributionOffset(ParticleRenderInfo& parti
     };
 }
 
-void RenderableParticleBunch::pushQuad(ParticleRenderInfo& particle, const Vector4& colour, float s0, float sWidth)
-{
-    // greebo: Create a (rotated) quad facing the z axis
-    // then rotate it to fit the requested orientation
-    // finally translate it to its position.
-    const Vector3 normal = _viewRotation.zCol3();
-
-    _quads.push_back(ParticleQuad(particle.size, particle.aspect, particle.angle, colour, normal, s0, sWidth));
-    _quads.back().transform(_viewRotation);
-    _quads.back().translate(particle.origin);
-}
-
 void RenderableParticleBunch::pushAimedParticles(ParticleRenderInfo& particle, std::size_t stageDurationMsec)
 {
     int trails = static_cast<int>(_stage.getOrientationParm(0)); // trails
@@ -702,12 +693,37 @@ void RenderableParticleBunch::snapQuads(ParticleQuad& curQuad, ParticleQuad& pre
 
 void RenderableParticleBunch::calculateBounds()
 {
-    for (Quads::const_iterator i = _quads.begin(); i != _quads.end(); ++i)
+    for (const ParticleVertex& v : _vertices)
+    {
+        _bounds.includePoint(Vector3(v.vertex[0], v.vertex[1], v.vertex[2]));
+    }
+}
+
+void RenderableParticleBunch::copyQuadsToVertices()
+{
+    _vertices.reserve(_quads.size() * 4);
+
+    for (const ParticleQuad& quad : _quads)
     {
-        _bounds.includePoint(i->verts[0].vertex);
-        _bounds.includePoint(i->verts[1].vertex);
-        _bounds.includePoint(i->verts[2].vertex);
-        _bounds.includePoint(i->verts[3].vertex);
+        for (const ParticleQuad::Vertex& source : quad.verts)
+        {
+            ParticleVertex v;
+
+            v.vertex[0] = static_cast<float>(source.vertex.x());
+            v.vertex[1] = static_cast<float>(source.vertex.y());
+            v.vertex[2] = static_cast<float>(source.vertex.z());
+            v.texcoord[0] = static_cast<float>(source.texcoord.x());
+            v.texcoord[1] = static_cast<float>(source.texcoord.y());
+            v.normal[0] = static_cast<float>(source.normal.x());
+            v.normal[1] = static_cast<float>(source.normal.y());
+            v.normal[2] = static_cast<float>(source.normal.z());
+            v.colour[0] = static_cast<float>(source.colour.x());
+            v.colour[1] = static_cast<float>(source.colour.y());
+            v.colour[2] = static_cast<float>(source.colour.z());
+            v.colour[3] = static_cast<float>(source.colour.w());
+
+            _vertices.push_back(v);
+        }
     }
 }
 
@@ -10,6 +10,7 @@
 
 #include "ParticleQuad.h"
 #include "ParticleRenderInfo.h"
+#include "ParticleKernel.h"
 
 namespace particles
 {
@@ -27,7 +28,13 @@ class RenderableParticleBunch : public OpenGLRenderable
 	// The stage this bunch is part of
 	const IStageDef& _stage;
 
-	// The quads of this particle bunch
+	// The geometry of this particle bunch, four vertices per quad
+	ParticleVertices _vertices;
+
+	// Evaluates the non-aimed particles, re-used between updates
+	ParticleKernel _kernel;
+
+	// Aimed particles are assembled as quads before being copied to the vertices
 	typedef std::vector<ParticleQuad> Quads;
 	Quads _quads;
 
@@ -108,14 +115,13 @@ private:
 	// Handles aimed particles
 	void pushAimedParticles(ParticleRenderInfo& particle, std::size_t stageDurationMsec);
 
-	// Generates a new quad using the given struct as data source.
-	// colour, s0 and sWidth override the values in info
-	void pushQuad(ParticleRenderInfo& particle, const Vector4& colour, float s0 = 0.0f, float sWidth = 1.0f);
-
 	// Makes the quad transition seamless by snapping the adjacent vertices at the midpoint
 	void snapQuads(ParticleQuad& curQuad, ParticleQuad& prevQuad);
 
 	void calculateBounds();
+
+	// Converts the aimed particle quads into the vertex buffer
+	void copyQuadsToVertices();
 };
 typedef std::shared_ptr<RenderableParticleBunch> RenderableParticleBunchPtr;
 
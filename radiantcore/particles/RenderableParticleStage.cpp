@@ -91,6 +91,83 @@ const AABB& RenderableParticleStage::getBounds()
 	return _bounds;
 }
 
+namespace
+{
+	// Upper bound of the distance covered by integrating the given parameter over <time> seconds
+	inline float getMaxTravelDistance(const IParticleParameter& param, float duration, float time)
+	{
+		float from = fabs(param.getFrom());
+		float delta = fabs(param.getTo() - param.getFrom());
+
+		return (duration > 0 ? delta / duration * time * time * 0.5f : 0) + from * time;
+	}
+}
+
+AABB RenderableParticleStage::getConservativeBounds() const
+{
+	float duration = _stageDef.getDuration();
+	bool aimed = _stageDef.getOrientationType() == IStageDef::ORIENTATION_AIMED;
+
+	// Aimed trails are calculated at earlier times, even before the particle spawned
+	float maxTime = aimed ? duration + fabs(_stageDef.getOrientationParm(1)) + 0.5f : duration;
+
+	float radius = static_cast<float>(_stageDef.getOffset().getLength());
+
+	Vector3 distribution(_stageDef.getDistributionParm(0), _stageDef.getDistributionParm(1),
+		_stageDef.getDistributionParm(2));
+	float ringFrac = fabs(_stageDef.getDistributionParm(3));
+
+	switch (_stageDef.getCustomPathType())
+	{
+	case IStageDef::PATH_STANDARD:
+		{
+			if (_stageDef.getDistributionType() == IStageDef::DISTRIBUTION_CYLINDER && ringFrac > 1)
+			{
+				distribution.x() *= ringFrac;
+				distribution.y() *= ringFrac;
+			}
+			else if (_stageDef.getDistributionType() == IStageDef::DISTRIBUTION_SPHERE)
+			{
+				distribution *= std::max(ringFrac, 1.0f);
+			}
+
+			radius += static_cast<float>(distribution.getLength());
+
+			// Outward directions are not normalised after adding the upward bias
+			float directionLength = _stageDef.getDirectionType() == IStageDef::DIRECTION_OUTWARD ?
+				1 + fabs(_stageDef.getDirectionParm(0)) : 1;
+
+			radius += directionLength * getMaxTravelDistance(_stageDef.getSpeed(), duration, maxTime);
+		}
+		break;
+
+	case IStageDef::PATH_FLIES:
+		radius += fabs(_stageDef.getCustomPathParm(2));
+		break;
+
+	case IStageDef::PATH_HELIX:
+		radius += static_cast<float>(Vector3(_stageDef.getCustomPathParm(0), _stageDef.getCustomPathParm(1), 0).getLength());
+		radius += fabs(_stageDef.getCustomPathParm(2)) + fabs(_stageDef.getCustomPathParm(4)) * maxTime;
+		break;
+
+	default:
+		break;
+	};
+
+	radius += fabs(_stageDef.getGravity()) * maxTime * maxTime * 0.5f;
+
+	// The quad extends from the particle origin by its rotated corners
+	float size = std::max(fabs(_stageDef.getSize().getFrom()), fabs(_stageDef.getSize().getTo()));
+	float aspect = std::max(fabs(_stageDef.getAspect().getFrom()), fabs(_stageDef.getAspect().getTo()));
+
+	// Aimed quads span between two points of the path, their width is <size>
+	radius += aimed ? size : size * sqrt(1 + aspect * aspect);
+
+	radius += fabs(_stageDef.getBoundsExpansion());
+
+	return AABB(Vector3(0, 0, 0), Vector3(radius, radius, radius));
+}
+
 const IStageDef& RenderableParticleStage::getDef() const
 {
 	return _stageDef;
@@ -54,6 +54,14 @@ public:
 
 	const AABB& getBounds();
 
+	/**
+	 * Returns a conservative estimate of the space the particles of this stage
+	 * can occupy at any time, calculated from the stage definition alone. The
+	 * box is centered at the emitter origin and large enough for any main
+	 * direction, such that it can be used for culling before simulating.
+	 */
+	AABB getConservativeBounds() const;
+
     /// Return the stage definition associated with this renderable
 	const IStageDef& getDef() const;
 
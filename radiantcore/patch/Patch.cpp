@@ -77,7 +77,7 @@ Patch::Patch(const Patch& other, PatchNode& node) :
     _renderableLattice(GL_LINES, _latticeIndices, _ctrl_vertices),
     _transformChanged(false),
     _tesselationChanged(true),
-    _shader(other._shader.getMaterialName())
+    _shader(other._shader.getInternedMaterialName())
 {
     // Initalise the default values
     construct();
@@ -87,7 +87,7 @@ Patch::Patch(const Patch& other, PatchNode& node) :
     _subDivisions = other._subDivisions;
     setDims(other._width, other._height);
     copy_ctrl(_ctrl.begin(), other._ctrl.begin(), other._ctrl.begin()+(_width*_height));
-    _shader.setMaterialName(other._shader.getMaterialName());
+    _shader.setMaterialName(other._shader.getInternedMaterialName());
     controlPointsChanged();
 }
 
@@ -318,7 +318,17 @@ void Patch::freezeTransform()
     // Don't call controlPointsChanged() here since that one will re-apply the
     // current transformation matrix, possible the second time.
     transformChanged();
-    updateTesselation();
+
+    // The mesh is tesselated on demand, only the bounds need to be up to date
+    // right away. This allows bulk transformations to generate the meshes in parallel.
+    if (isValid())
+    {
+        updateAABB();
+    }
+    else
+    {
+        updateTesselation();
+    }
 
     for (Observers::iterator i = _observers.begin(); i != _observers.end();)
     {
@@ -435,7 +445,11 @@ void Patch::undoSave()
 // Save the current patch state into a new UndoMemento instance (allocated on heap) and return it to the undo observer
 IUndoMementoPtr Patch::exportState() const
 {
-    return IUndoMementoPtr(new SavedState(_width, _height, _ctrl, _patchDef3, _subDivisions.x(), _subDivisions.y(), _shader.getMaterialName()));
+    auto state = std::make_shared<patch::SavedState>(_width, _height, _ctrl, _patchDef3, _subDivisions.x(), _subDivisions.y(),
+        _shader.getInternedMaterialName(), _lastSavedState.lock());
+    _lastSavedState = state;
+
+    return state;
 }
 
 // Revert the state of this patch to the one that has been saved in the UndoMemento
@@ -443,7 +457,7 @@ void Patch::importState(const IUndoMementoPtr& state)
 {
     undoSave();
 
-    const SavedState& other = *(std::static_pointer_cast<SavedState>(state));
+    const patch::SavedState& other = *(std::static_pointer_cast<patch::SavedState>(state));
 
     // begin duplicate of SavedState copy constructor, needs refactoring
 
@@ -451,7 +465,7 @@ void Patch::importState(const IUndoMementoPtr& state)
     {
         _width = other.m_width;
         _height = other.m_height;
-        _ctrl = other.m_ctrl;
+        other.exportControls(_ctrl);
         onAllocate(_ctrl.size());
         _patchDef3 = other.m_patchDef3;
         _subDivisions = Subdivisions(other.m_subdivisions_x, other.m_subdivisions_y);
@@ -2653,6 +2667,9 @@ bool Patch::subdivisionsFixed() const
 
 bool Patch::getIntersection(const Ray& ray, Vector3& intersection)
 {
+    // Ensure the tesselation is up to date
+    updateTesselation();
+
     std::vector<RenderIndex>::const_iterator stripStartIndex = _mesh.indices.begin();
 
     // Go over each quad strip and intersect the ray with its triangles
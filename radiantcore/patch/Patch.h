@@ -22,6 +22,8 @@
 class PatchNode;
 class Ray;
 
+namespace patch { class SavedState; }
+
 /* greebo: The patch class itself, represented by control vertices. The basic rendering of the patch
  * is handled here (unselected control points, tesselation lines, shader).
  *
@@ -48,6 +50,9 @@ class Patch :
 
 	IUndoStateSaver* _undoStateSaver;
 
+	// The most recently exported undo state, used as reference for the next one
+	mutable std::weak_ptr<patch::SavedState> _lastSavedState;
+
 	// dynamically allocated array of control points, size is _width*_height
 	PatchControlArray _ctrl;			// the true control array
 	PatchControlArray _ctrlTransformed;	// a temporary control array used during transformations, so that the
@@ -54,7 +54,7 @@ std::string PatchNode::getFingerprint()
         return std::string(); // empty patches produce an empty fingerprint
     }
 
-    math::Hash hash;
+    math::FastHash hash;
 
     // Width & Height
     hash.addSizet(m_patch.getHeight());
@@ -1,24 +1,46 @@
 #pragma once
 
+#include <memory>
 #include "PatchControl.h"
+#include "BasicUndoMemento.h"
+#include "string/interned.h"
+
+namespace patch
+{
 
 /* greebo: This is a structure that is allocated on the heap and contains all the state
  * information of a patch. This information is used by the UndoSystem to save the current
  * patch state and to revert it on request.
+ *
+ * To keep the undo stack small, the control points are stored as delta against a
+ * full control point array which can be shared by several states of the same patch:
+ * an optional translation applied to all base vertices, followed by the list of
+ * control points which still differ from the translated base. A new full snapshot
+ * is only taken if the dimensions changed or too many control points are different.
  */
-class SavedState : 
+class SavedState :
 	public IUndoMemento
 {
 public:
 	// The members to store the state information
 	std::size_t m_width, m_height;
-	PatchControlArray m_ctrl;
 	bool m_patchDef3;
 	std::size_t m_subdivisions_x;
 	std::size_t m_subdivisions_y;
-    std::string _materialName;
+    string::InternedString _materialName;
+
+private:
+    // The full control point array this state is based on
+    std::shared_ptr<const PatchControlArray> _baseCtrl;
 
-	// Constructor
+    // Offset to apply to all vertices of the base array
+    Vector3 _baseTranslation;
+
+    // The control points differing from the (translated) base, with their index
+    std::vector<std::pair<std::size_t, PatchControl>> _changedCtrl;
+
+public:
+	// Constructor, the previous state of the same patch is used as reference (can be empty)
 	SavedState(
 		std::size_t width,
 		std::size_t height,
@@ -26,14 +48,119 @@ public:
 		bool patchDef3,
 		std::size_t subdivisions_x,
 		std::size_t subdivisions_y,
-        const std::string& materialName
+        const string::InternedString& materialName,
+        const std::shared_ptr<SavedState>& previous
 	) :
 		m_width(width),
 		m_height(height),
-		m_ctrl(ctrl),
 		m_patchDef3(patchDef3),
 		m_subdivisions_x(subdivisions_x),
 		m_subdivisions_y(subdivisions_y),
-        _materialName(materialName)
-    {}
+        _materialName(materialName),
+        _baseTranslation(0, 0, 0)
+    {
+        if (!previous || previous->m_width != width || previous->m_height != height || ctrl.empty() ||
+            !tryStoreAsDelta(previous->_baseCtrl, ctrl))
+        {
+            _baseCtrl = std::make_shared<PatchControlArray>(ctrl);
+        }
+    }
+
+    // Reconstructs the full control point array of this state
+    void exportControls(PatchControlArray& ctrl) const
+    {
+        ctrl = *_baseCtrl;
+
+        if (_baseTranslation != Vector3(0, 0, 0))
+        {
+            for (auto& control : ctrl)
+            {
+                control.vertex = control.vertex + _baseTranslation;
+            }
+        }
+
+        for (const auto& [index, control] : _changedCtrl)
+        {
+            ctrl[index] = control;
+        }
+    }
+
+    std::size_t getApproximateSize() const override
+    {
+        return sizeof(*this) + undo::getHeapSize(_changedCtrl) +
+            undo::getSharedSize(_baseCtrl, sizeof(PatchControlArray) + undo::getHeapSize(*_baseCtrl));
+    }
+
+private:
+    // Returns true if the given base control point (moved by the translation) reproduces the other one exactly
+    static bool controlMatches(const PatchControl& base, const PatchControl& control, const Vector3& translation)
+    {
+        if (base.texcoord != control.texcoord)
+        {
+            return false;
+        }
+
+        // Use the same arithmetic as exportControls() to get identical results
+        return translation == Vector3(0, 0, 0) ? base.vertex == control.vertex : 
+            base.vertex + translation == control.vertex;
+    }
+
+    static std::size_t countChangedControls(const PatchControlArray& base, const PatchControlArray& ctrl,
+        const Vector3& translation)
+    {
+        std::size_t count = 0;
+
+        for (std::size_t i = 0; i < ctrl.size(); ++i)
+        {
+            if (!controlMatches(base[i], ctrl[i], translation))
+            {
+                ++count;
+            }
+        }
+
+        return count;
+    }
+
+    bool tryStoreAsDelta(const std::shared_ptr<const PatchControlArray>& baseCtrl, const PatchControlArray& ctrl)
+    {
+        const auto& base = *baseCtrl;
+
+        // Compare against the untranslated base, and against the base moved by the
+        // offset of the first vertex (a translation of the whole patch)
+        auto translation = ctrl.front().vertex - base.front().vertex;
+        auto numChanged = countChangedControls(base, ctrl, Vector3(0, 0, 0));
+
+        if (numChanged > 0 && translation != Vector3(0, 0, 0))
+        {
+            auto numChangedTranslated = countChangedControls(base, ctrl, translation);
+
+            if (numChangedTranslated < numChanged)
+            {
+                numChanged = numChangedTranslated;
+                _baseTranslation = translation;
+            }
+        }
+
+        // A full copy is cheaper if more than a quarter of the points is different
+        if (numChanged > ctrl.size() / 4)
+        {
+            _baseTranslation = Vector3(0, 0, 0);
+            return false;
+        }
+
+        _baseCtrl = baseCtrl;
+        _changedCtrl.reserve(numChanged);
+
+        for (std::size_t i = 0; i < ctrl.size(); ++i)
+        {
+            if (!controlMatches(base[i], ctrl[i], _baseTranslation))
+            {
+                _changedCtrl.emplace_back(i, ctrl[i]);
+            }
+        }
+
+        return true;
+    }
 };
+
+}
@@ -197,85 +197,123 @@ void PatchTesselation::generateNormals()
 	}
 }
 
-void PatchTesselation::sampleSinglePatchPoint(const ArbitraryMeshVertex ctrl[3][3], float u, float v, ArbitraryMeshVertex& out) const
+namespace
 {
-	double vCtrl[3][8];
 
-	// find the control points for the v coordinate
-	for (std::size_t vPoint = 0; vPoint < 3; vPoint++)
-	{
-		for (std::size_t axis = 0; axis < 8; axis++)
-		{
-			double a, b, c;
+// The number of scalar attributes interpolated per vertex: 3 position, 3 normal, 2 texcoord
+constexpr std::size_t NumPatchAttributes = 8;
 
-			if (axis < 3)
-			{
-				a = ctrl[0][vPoint].vertex[axis];
-				b = ctrl[1][vPoint].vertex[axis];
-				c = ctrl[2][vPoint].vertex[axis];
-			}
-			else if (axis < 6)
-			{
-				a = ctrl[0][vPoint].normal[axis - 3];
-				b = ctrl[1][vPoint].normal[axis - 3];
-				c = ctrl[2][vPoint].normal[axis - 3];
-			}
-			else
-			{
-				a = ctrl[0][vPoint].texcoord[axis - 6];
-				b = ctrl[1][vPoint].texcoord[axis - 6];
-				c = ctrl[2][vPoint].texcoord[axis - 6];
-			}
+// A single vertex' interpolated attributes, packed contiguously such that the
+// weighted sums below operate on plain arrays (and can be vectorised by the compiler)
+struct PackedPatchVertex
+{
+	double attr[NumPatchAttributes];
+};
 
-			double qA = a - 2.0 * b + c;
-			double qB = 2.0 * b - 2.0 * a;
-			double qC = a;
+inline void packVertex(const ArbitraryMeshVertex& in, PackedPatchVertex& out)
+{
+	out.attr[0] = in.vertex[0];
+	out.attr[1] = in.vertex[1];
+	out.attr[2] = in.vertex[2];
+	out.attr[3] = in.normal[0];
+	out.attr[4] = in.normal[1];
+	out.attr[5] = in.normal[2];
+	out.attr[6] = in.texcoord[0];
+	out.attr[7] = in.texcoord[1];
+}
 
-			vCtrl[vPoint][axis] = qA * u * u + qB * u + qC;
-		}
-	}
+inline void unpackVertex(const PackedPatchVertex& in, ArbitraryMeshVertex& out)
+{
+	out.vertex.set(in.attr[0], in.attr[1], in.attr[2]);
+	out.normal.set(in.attr[3], in.attr[4], in.attr[5]);
+	out.texcoord[0] = in.attr[6];
+	out.texcoord[1] = in.attr[7];
+}
+
+// The three quadratic bezier basis weights for the given parameter value
+struct BasisWeights
+{
+	double w[3];
+};
+
+inline BasisWeights getBasisWeights(std::size_t step, std::size_t numSteps)
+{
+	// Parameter values are calculated in single precision like idTech4 does
+	double t = static_cast<float>(step) / numSteps;
+	double oneMinusT = 1.0 - t;
+
+	return BasisWeights{ { oneMinusT * oneMinusT, 2.0 * t * oneMinusT, t * t } };
+}
 
-	// interpolate the v value
-	for (std::size_t axis = 0; axis < 8; axis++)
+inline void blendPackedVertices(const BasisWeights& weights, const PackedPatchVertex* points, 
+	std::size_t stride, PackedPatchVertex& out)
+{
+	const auto& a = points[0].attr;
+	const auto& b = points[stride].attr;
+	const auto& c = points[2 * stride].attr;
+
+	for (std::size_t axis = 0; axis < NumPatchAttributes; ++axis)
 	{
-		double a = vCtrl[0][axis];
-		double b = vCtrl[1][axis];
-		double c = vCtrl[2][axis];
-		double qA = a - 2.0 * b + c;
-		double qB = 2.0 * b - 2.0 * a;
-		double qC = a;
+		out.attr[axis] = weights.w[0] * a[axis] + weights.w[1] * b[axis] + weights.w[2] * c[axis];
+	}
+}
 
-		if (axis < 3)
-		{
-			out.vertex[axis] = qA * v * v + qB * v + qC;
-		}
-		else if (axis < 6)
-		{
-			out.normal[axis - 3] = qA * v * v + qB * v + qC;
-		}
-		else
-		{
-			out.texcoord[axis - 6] = qA * v * v + qB * v + qC;
-		}
+inline void midPackedVertices(const PackedPatchVertex& a, const PackedPatchVertex& b, PackedPatchVertex& out)
+{
+	for (std::size_t axis = 0; axis < NumPatchAttributes; ++axis)
+	{
+		out.attr[axis] = (a.attr[axis] + b.attr[axis]) * 0.5;
 	}
 }
 
+}
+
 void PatchTesselation::sampleSinglePatch(const ArbitraryMeshVertex ctrl[3][3],
 	std::size_t baseCol, std::size_t baseRow,
 	std::size_t w, std::size_t horzSub, std::size_t vertSub,
 	std::vector<ArbitraryMeshVertex>& outVerts) const
 {
-	horzSub++;
-	vertSub++;
+	// Pack the control points, column-major: ctrl[col][row]
+	PackedPatchVertex packedCtrl[3][3];
 
-	for (std::size_t i = 0; i < horzSub; i++)
+	for (std::size_t col = 0; col < 3; col++)
 	{
-		for (std::size_t j = 0; j < vertSub; j++)
+		for (std::size_t row = 0; row < 3; row++)
 		{
-			float u = static_cast<float>(i) / (horzSub - 1);
-			float v = static_cast<float>(j) / (vertSub - 1);
+			packVertex(ctrl[col][row], packedCtrl[col][row]);
+		}
+	}
+
+	// The basis weights only depend on the subdivision step, calculate them once per row and column
+	std::vector<BasisWeights> uWeights(horzSub + 1);
+	std::vector<BasisWeights> vWeights(vertSub + 1);
 
-			sampleSinglePatchPoint(ctrl, u, v, outVerts[((baseRow + j) * w) + i + baseCol]);
+	for (std::size_t i = 0; i <= horzSub; i++)
+	{
+		uWeights[i] = getBasisWeights(i, horzSub);
+	}
+
+	for (std::size_t j = 0; j <= vertSub; j++)
+	{
+		vWeights[j] = getBasisWeights(j, vertSub);
+	}
+
+	PackedPatchVertex vCtrl[3];
+	PackedPatchVertex sample;
+
+	for (std::size_t i = 0; i <= horzSub; i++)
+	{
+		// Reduce the control grid along u, leaving three control points for the v coordinate,
+		// these are shared by all samples of this column
+		for (std::size_t vPoint = 0; vPoint < 3; vPoint++)
+		{
+			blendPackedVertices(uWeights[i], &packedCtrl[0][vPoint], 3, vCtrl[vPoint]);
+		}
+
+		for (std::size_t j = 0; j <= vertSub; j++)
+		{
+			blendPackedVertices(vWeights[j], vCtrl, 1, sample);
+			unpackVertex(sample, outVerts[((baseRow + j) * w) + i + baseCol]);
 		}
 	}
 }
@@ -377,9 +415,13 @@ void PatchTesselation::resizeExpandedMesh(std::size_t newHeight, std::size_t new
 
 void PatchTesselation::lerpVert(const ArbitraryMeshVertex& a, const ArbitraryMeshVertex& b, ArbitraryMeshVertex&out)
 {
-	out.vertex = math::midPoint(a.vertex, b.vertex);
-	out.normal = math::midPoint(a.normal, b.normal);
-	out.texcoord = a.texcoord.mid(b.texcoord);
+	PackedPatchVertex packedA, packedB, mid;
+
+	packVertex(a, packedA);
+	packVertex(b, packedB);
+
+	midPackedVertices(packedA, packedB, mid);
+	unpackVertex(mid, out);
 }
 
 void PatchTesselation::putOnCurve()
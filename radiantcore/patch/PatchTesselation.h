@@ -66,7 +66,6 @@ private:
 	void sampleSinglePatch(const ArbitraryMeshVertex ctrl[3][3], std::size_t baseCol, std::size_t baseRow, 
 		std::size_t width, std::size_t horzSub, std::size_t vertSub, 
 		std::vector<ArbitraryMeshVertex>& outVerts) const;
-	void sampleSinglePatchPoint(const ArbitraryMeshVertex ctrl[3][3], float u, float v, ArbitraryMeshVertex& out) const;
 	void deriveTangents();
 	void deriveFaceTangents(std::vector<FaceTangents>& faceTangents);
 };
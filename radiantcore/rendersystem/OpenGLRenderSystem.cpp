@@ -202,6 +202,8 @@ void OpenGLRenderSystem::render(RenderStateFlags globalstate,
     glHint(GL_FOG_HINT, GL_NICEST);
     glDisable(GL_FOG);
 
+    _statistics = Statistics();
+
     // Iterate over the sorted mapping between OpenGLStates and their
     // OpenGLShaderPasses (containing the renderable geometry), and render the
     // contents of each bucket. Each pass is passed a reference to the "current"
@@ -213,7 +215,7 @@ void OpenGLRenderSystem::render(RenderStateFlags globalstate,
         // Render the OpenGLShaderPass
         if (!i->second->empty())
         {
-            i->second->render(current, globalstate, viewer, _time);
+            i->second->render(current, globalstate, viewer, _time, _statistics);
         }
     }
 
@@ -357,6 +359,11 @@ void OpenGLRenderSystem::setShaderProgramsAvailable(bool available)
     _shaderProgramsAvailable = available;
 }
 
+const RenderSystem::Statistics& OpenGLRenderSystem::getStatistics() const
+{
+    return _statistics;
+}
+
 void OpenGLRenderSystem::insertSortedState(const OpenGLStates::value_type& val) {
     _state_sorted.insert(val);
 }
@@ -43,6 +43,9 @@ class OpenGLRenderSystem
 	// Render time
 	std::size_t _time;
 
+	// Counters of the last render() call
+	Statistics _statistics;
+
 	sigc::signal<void> _sigExtensionsInitialised;
 
 	sigc::connection _materialDefsLoaded;
@@ -83,6 +86,8 @@ public:
 	bool shaderProgramsAvailable() const override;
 	void setShaderProgramsAvailable(bool available) override;
 
+	const Statistics& getStatistics() const override;
+
 	typedef std::set<const Renderable*> Renderables;
 	Renderables m_renderables;
 	mutable bool m_traverseRenderablesMutex;
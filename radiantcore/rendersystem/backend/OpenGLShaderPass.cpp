@@ -67,6 +67,30 @@ inline void setState(unsigned int state,
     }
 }
 
+// True if the given stage looks the same regardless of the entity it is rendered for
+inline bool stageIsEntityIndependent(const IShaderLayer::Ptr& stage)
+{
+    if (!stage)
+    {
+        return true;
+    }
+
+    if (stage->getNumVertexParms() > 0)
+    {
+        return false;
+    }
+
+    for (int slot = 0; slot < IShaderLayer::Expression::NumExpressionSlots; ++slot)
+    {
+        if (stage->getExpression(static_cast<IShaderLayer::Expression::Slot>(slot)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 inline void evaluateStage(const IShaderLayer::Ptr& stage, std::size_t time, const IRenderEntity* entity)
 {
     if (stage)
@@ -565,7 +589,8 @@ void OpenGLShaderPass::addRenderable(const OpenGLRenderable& renderable,
 void OpenGLShaderPass::render(OpenGLState& current,
                               unsigned int flagsMask,
                               const Vector3& viewer,
-                              std::size_t time)
+                              std::size_t time,
+                              RenderSystem::Statistics& statistics)
 {
     // Reset the texture matrix
     glMatrixMode(GL_TEXTURE);
@@ -576,9 +601,18 @@ void OpenGLShaderPass::render(OpenGLState& current,
     // Apply our state to the current state object
     applyState(current, flagsMask, viewer, time, NULL);
 
+    if (canMergeInstances(current))
+    {
+        prepareInstanceBatches();
+    }
+    else
+    {
+        _instanceBatches.clear();
+    }
+
     if (!_renderablesWithoutEntity.empty())
     {
-        renderAllContained(_renderablesWithoutEntity, current, viewer, time);
+        renderAllContained(_renderablesWithoutEntity, current, viewer, time, statistics);
     }
 
     for (RenderablesByEntity::const_iterator i = _renderables.begin();
@@ -593,13 +627,119 @@ void OpenGLShaderPass::render(OpenGLState& current,
             continue;
         }
 
-        renderAllContained(i->second, current, viewer, time);
+        renderAllContained(i->second, current, viewer, time, statistics);
+    }
+
+    if (!_instanceBatches.empty())
+    {
+        // The state is entity-independent, re-applying it is a no-op unless
+        // the last entity bucket has been skipped
+        applyState(current, flagsMask, viewer, time, NULL);
+        renderInstanceBatches(current, viewer, statistics);
     }
 
     _renderablesWithoutEntity.clear();
     _renderables.clear();
 }
 
+bool OpenGLShaderPass::canMergeInstances(const OpenGLState& current)
+{
+    // Blending depends on the draw order, which is changed by merging
+    if (current.glProgram || current.testRenderFlag(RENDER_TEXTURE_CUBEMAP) ||
+        current.testRenderFlag(RENDER_BLEND))
+    {
+        return false;
+    }
+
+    return stageIsEntityIndependent(_glState.stage0) &&
+           stageIsEntityIndependent(_glState.stage1) &&
+           stageIsEntityIndependent(_glState.stage2) &&
+           stageIsEntityIndependent(_glState.stage3) &&
+           stageIsEntityIndependent(_glState.stage4) &&
+           stateIsActive();
+}
+
+void OpenGLShaderPass::prepareInstanceBatches()
+{
+    auto collectInstances = [&](const Renderables& renderables)
+    {
+        for (const auto& r : renderables)
+        {
+            if (r.light) continue; // lit renderables are set up one by one
+
+            _instanceBatches.addInstance(*r.renderable, r.transform);
+        }
+    };
+
+    collectInstances(_renderablesWithoutEntity);
+
+    for (const auto& pair : _renderables)
+    {
+        collectInstances(pair.second);
+    }
+
+    _instanceBatches.update();
+}
+
+void OpenGLShaderPass::renderInstanceBatches(OpenGLState& current,
+                                             const Vector3& viewer,
+                                             RenderSystem::Statistics& statistics)
+{
+    // The batches are in world space, no need to touch the modelview matrix
+    RenderInfo info(current.getRenderFlags(), viewer, current.cubeMapMode);
+
+    std::vector<GLsizei> counts;
+    std::vector<const GLvoid*> offsets;
+
+    _instanceBatches.foreachBatch([&](bool rightHanded, const InstanceBatch& batch)
+    {
+        if (batch.getRanges().empty()) return;
+
+        if (current.testRenderFlag(RENDER_CULLFACE) && rightHanded)
+        {
+            glFrontFace(GL_CW);
+        }
+        else
+        {
+            glFrontFace(GL_CCW);
+        }
+
+        const auto& vertices = batch.getVertices();
+
+        // Same client array handling as the other array-based renderables
+        glVertexPointer(3, GL_FLOAT, sizeof(InstanceBatch::Vertex), vertices.front().vertex);
+
+        if (info.checkFlag(RENDER_LIGHTING))
+        {
+            glNormalPointer(GL_FLOAT, sizeof(InstanceBatch::Vertex), vertices.front().normal);
+        }
+
+        if (info.checkFlag(RENDER_TEXTURE_2D))
+        {
+            glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+            glTexCoordPointer(2, GL_FLOAT, sizeof(InstanceBatch::Vertex), vertices.front().texcoord);
+        }
+
+        // The ranges of all instances are submitted with a single call
+        counts.clear();
+        offsets.clear();
+
+        for (const auto& range : batch.getRanges())
+        {
+            counts.push_back(static_cast<GLsizei>(range.numIndices));
+            offsets.push_back(batch.getIndices().data() + range.firstIndex);
+        }
+
+        glMultiDrawElements(GL_TRIANGLES, counts.data(), GL_UNSIGNED_INT, offsets.data(),
+            static_cast<GLsizei>(counts.size()));
+
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+        ++statistics.drawCalls;
+        statistics.batchedInstances += batch.getNumInstances();
+    });
+}
+
 bool OpenGLShaderPass::stateIsActive()
 {
     return ((_glState.stage0 == NULL || _glState.stage0->isVisible()) &&
@@ -668,7 +808,8 @@ void OpenGLShaderPass::setUpLightingCalculation(OpenGLState& current,
 void OpenGLShaderPass::renderAllContained(const Renderables& renderables,
                                           OpenGLState& current,
                                           const Vector3& viewer,
-                                          std::size_t time)
+                                          std::size_t time,
+                                          RenderSystem::Statistics& statistics)
 {
     // Keep a pointer to the last transform matrix used
     const Matrix4* transform = nullptr;
@@ -678,6 +819,12 @@ void OpenGLShaderPass::renderAllContained(const Renderables& renderables,
     // Iterate over each transformed renderable in the vector
     for (const TransformedRenderable& r : renderables)
     {
+        // Unlit instances of merged renderables are drawn by their batch
+        if (!r.light && _instanceBatches.isBatched(*r.renderable, r.transform))
+        {
+            continue;
+        }
+
         // If the current iteration's transform matrix was different from the
         // last, apply it and store for the next iteration
         if (!transform || !transform->isAffineEqual(r.transform))
@@ -710,6 +857,7 @@ void OpenGLShaderPass::renderAllContained(const Renderables& renderables,
         // Render the renderable
         RenderInfo info(current.getRenderFlags(), viewer, current.cubeMapMode);
         r.renderable->render(info);
+        ++statistics.drawCalls;
     }
 
     // Cleanup
@@ -3,6 +3,8 @@
 #include "math/Vector3.h"
 #include "math/Matrix4.h"
 #include "iglrender.h"
+#include "irender.h"
+#include "render/InstanceBatch.h"
 
 #include <vector>
 #include <map>
@@ -70,6 +72,9 @@ protected:
 	typedef std::map<const IRenderEntity*, Renderables> RenderablesByEntity;
 	RenderablesByEntity _renderables;
 
+	// Merged instance batches, kept across frames and dropped once unused
+	InstanceBatchSet _instanceBatches;
+
 protected:
 
     void setTextureState(GLint& current,
@@ -95,11 +100,25 @@ protected:
 
 	void setupTextureMatrix(GLenum textureUnit, const IShaderLayer::Ptr& stage);
 
-	// Render all of the given TransformedRenderables
+	// Render all of the given TransformedRenderables, except for the merged ones
 	void renderAllContained(const Renderables& renderables,
 							OpenGLState& current,
 						    const Vector3& viewer,
-							std::size_t time);
+							std::size_t time,
+							RenderSystem::Statistics& statistics);
+
+	// Returns true if the state applied last is the same for every entity
+	// and doesn't involve any lighting program or blending, such that
+	// instances of the same renderable can be drawn in one go
+	bool canMergeInstances(const OpenGLState& current);
+
+	// Updates the instance batches from the submitted renderables
+	void prepareInstanceBatches();
+
+	// Draws the batches prepared for this frame
+	void renderInstanceBatches(OpenGLState& current,
+							   const Vector3& viewer,
+							   RenderSystem::Statistics& statistics);
 
     /* Helper functions to enable/disable particular GL states */
 
@@ -185,11 +204,15 @@ public:
      * \param viewer
      * Viewer location in world space.
      *
+     * \param statistics
+     * The counters of the render system, incremented by the draw calls
+     * issued by this pass.
      */
 	void render(OpenGLState& current,
 				unsigned int flagsMask,
 				const Vector3& viewer,
-				std::size_t time);
+				std::size_t time,
+				RenderSystem::Statistics& statistics);
 
 	/**
 	 * Returns true if this shaderpass doesn't have anything to render.
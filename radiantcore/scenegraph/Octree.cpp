@@ -32,17 +32,42 @@ void Octree::link(const scene::INodePtr& sceneNode)
 	assert(_nodeMapping.find(sceneNode) == _nodeMapping.end());
 
 	// Make sure the root node is large enough
-	ensureRootSize(sceneNode);
+	ensureRootSize(sceneNode->worldAABB());
 
 	// Root node size is adjusted, let's link the node into the smallest encompassing octant
 	_root->linkRecursively(sceneNode);
 }
 
-void Octree::ensureRootSize(const scene::INodePtr& sceneNode)
+void Octree::link(const std::vector<scene::INodePtr>& sceneNodes)
 {
-	// Check if sceneNode exceeds the root node's bounds
-	const AABB& aabb = sceneNode->worldAABB();
+	// Evaluate all bounds before linking anything, this way no node is
+	// re-linked due to its bounds being calculated during the process
+	AABB totalBounds;
 
+	for (const auto& sceneNode : sceneNodes)
+	{
+		assert(_nodeMapping.find(sceneNode) == _nodeMapping.end());
+
+		const AABB& aabb = sceneNode->worldAABB();
+
+		if (aabb.isValid())
+		{
+			totalBounds.includeAABB(aabb);
+		}
+	}
+
+	// Grow the root node once, such that it is encompassing all nodes
+	ensureRootSize(totalBounds);
+
+	for (const auto& sceneNode : sceneNodes)
+	{
+		_root->linkRecursively(sceneNode);
+	}
+}
+
+void Octree::ensureRootSize(const AABB& aabb)
+{
+	// Check if the given bounds exceed the root node's bounds
 	if (!aabb.isValid()) return; // skip this for invalid bounds
 
 	while (!_root->getBounds().contains(aabb))
@@ -57,6 +57,9 @@ public:
 	// Links this node into the SP tree.
 	void link(const scene::INodePtr& sceneNode);
 
+	// Links all the given nodes, the root node is enlarged only once
+	void link(const std::vector<scene::INodePtr>& sceneNodes);
+
 	// Unlink this node from the SP tree, returns true if found
 	bool unlink(const scene::INodePtr& sceneNode);
 
@@ -79,7 +82,7 @@ private:
 	 * and ensures that the topmost octree node (the root node) is
 	 * large enough to encompass the scenenode's bounds.
 	 */
-	void ensureRootSize(const scene::INodePtr& sceneNode);
+	void ensureRootSize(const AABB& aabb);
 };
 
 } // namespace scene
@@ -1,5 +1,7 @@
 #include "SceneGraph.h"
 
+#include <algorithm>
+
 #include "ivolumetest.h"
 #include "itextstream.h"
 
@@ -19,7 +21,8 @@ SceneGraph::SceneGraph() :
 	_spacePartition(new Octree),
 	_visitedSPNodes(0),
 	_skippedSPNodes(0),
-    _traversalOngoing(false)
+    _traversalOngoing(false),
+    _transactionDepth(0)
 {}
 
 SceneGraph::~SceneGraph()
@@ -147,6 +150,19 @@ void SceneGraph::insert(const INodePtr& node)
         return;
     }
 
+    if (_transactionDepth > 0)
+    {
+        // Link the node and notify the observers when the transaction is committed
+        addPendingLink(node, PendingLink::Link);
+
+        assert(_root);
+        node->onInsertIntoScene(*_root);
+
+        _pendingInsertions[node] = _pendingChanges.size();
+        _pendingChanges.emplace_back(ChangeType::Insert, node);
+        return;
+    }
+
     // Notify the graph tree model about the change
 	sceneChanged();
 
@@ -171,6 +187,31 @@ void SceneGraph::erase(const INodePtr& node)
         return;
     }
 
+    if (_transactionDepth > 0)
+    {
+        // Removed nodes must not be found in the space partition anymore
+        _pendingLinks.erase(node);
+        _spacePartition->unlink(node);
+
+        assert(_root);
+        node->onRemoveFromScene(*_root);
+
+        auto insertion = _pendingInsertions.find(node);
+
+        if (insertion != _pendingInsertions.end())
+        {
+            // This node has been inserted during this transaction, the observers don't need to know
+            _pendingChanges[insertion->second].second.reset();
+            _pendingInsertions.erase(insertion);
+        }
+        else
+        {
+            _pendingChanges.emplace_back(ChangeType::Erase, node);
+        }
+
+        return;
+    }
+
 	_spacePartition->unlink(node);
 
 	// Fire the onRemove event on the Node
@@ -194,6 +235,13 @@ void SceneGraph::nodeBoundsChanged(const INodePtr& node)
         return;
     }
 
+    if (_transactionDepth > 0)
+    {
+        // Re-link the node only once when the transaction is committed
+        addPendingLink(node, PendingLink::Relink);
+        return;
+    }
+
 	if (_spacePartition->unlink(node))
 	{
 		// unlink returned true, so the given node was linked before => re-link it
@@ -201,6 +249,88 @@ void SceneGraph::nodeBoundsChanged(const INodePtr& node)
 	}
 }
 
+void SceneGraph::beginTransaction()
+{
+    ++_transactionDepth;
+}
+
+void SceneGraph::commitTransaction()
+{
+    assert(_transactionDepth > 0);
+
+    if (--_transactionDepth > 0)
+    {
+        return; // the outermost transaction is still active
+    }
+
+    linkPendingNodes();
+    notifyPendingChanges();
+}
+
+void SceneGraph::addPendingLink(const INodePtr& node, PendingLink type)
+{
+    auto result = _pendingLinks.emplace(node, type);
+
+    if (result.second)
+    {
+        _pendingLinkOrder.push_back(node);
+    }
+    else if (type == PendingLink::Link)
+    {
+        result.first->second = PendingLink::Link;
+    }
+}
+
+void SceneGraph::linkPendingNodes()
+{
+    std::vector<INodePtr> nodesToLink;
+    nodesToLink.reserve(_pendingLinks.size());
+
+    for (const auto& node : _pendingLinkOrder)
+    {
+        auto pending = _pendingLinks.find(node);
+
+        // Skip nodes removed in the meantime, or the ones we've seen already
+        if (pending == _pendingLinks.end()) continue;
+
+        // Nodes which changed their bounds are only linked again if they had been linked before
+        if (_spacePartition->unlink(node) || pending->second == PendingLink::Link)
+        {
+            nodesToLink.push_back(node);
+        }
+
+        _pendingLinks.erase(pending);
+    }
+
+    _pendingLinkOrder.clear();
+
+    if (!nodesToLink.empty())
+    {
+        _spacePartition->link(nodesToLink);
+    }
+}
+
+void SceneGraph::notifyPendingChanges()
+{
+    ChangeSet changes;
+    changes.swap(_pendingChanges);
+    _pendingInsertions.clear();
+
+    // Drop the insertions which have been reverted during the transaction
+    changes.erase(std::remove_if(changes.begin(), changes.end(),
+        [](const ChangeSet::value_type& change) { return !change.second; }), changes.end());
+
+    if (changes.empty()) return;
+
+    // Notify the graph tree model about the change
+    sceneChanged();
+
+    for (auto observer : _sceneObservers)
+    {
+        observer->onSceneNodesChanged(changes);
+    }
+}
+
 void SceneGraph::foreachNode(const INode::VisitorFunc& functor)
 {
 	if (!_root) return;
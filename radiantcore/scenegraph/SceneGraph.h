@@ -2,6 +2,8 @@
 
 #include <map>
 #include <list>
+#include <unordered_map>
+#include <vector>
 #include <sigc++/signal.h>
 #include <sigc++/connection.h>
 
@@ -53,6 +55,25 @@ private:
 
     bool _traversalOngoing;
 
+    // Nesting level of the currently active transactions
+    std::size_t _transactionDepth;
+
+    // The nodes to link into the space partition at the end of a transaction,
+    // nodes which just changed their bounds are only linked if they've been linked before.
+    enum class PendingLink
+    {
+        Link,
+        Relink,
+    };
+    std::unordered_map<INodePtr, PendingLink> _pendingLinks;
+    std::vector<INodePtr> _pendingLinkOrder;
+
+    // Insertions and removals to send to the observers at the end of a transaction
+    ChangeSet _pendingChanges;
+
+    // Index into _pendingChanges of the nodes inserted during the current transaction
+    std::unordered_map<INodePtr, std::size_t> _pendingInsertions;
+
     sigc::connection _undoEventHandler;
 
 public:
@@ -85,6 +106,9 @@ public:
 
     void nodeBoundsChanged(const scene::INodePtr& node) override;
 
+    void beginTransaction() override;
+    void commitTransaction() override;
+
 	// Walker variants
     void foreachNodeInVolume(const VolumeTest& volume, Walker& walker) override;
     void foreachVisibleNodeInVolume(const VolumeTest& volume, Walker& walker) override;
@@ -105,6 +129,10 @@ private:
 
     void flushActionBuffer();
 
+    void addPendingLink(const INodePtr& node, PendingLink type);
+    void linkPendingNodes();
+    void notifyPendingChanges();
+
     void onUndoEvent(IUndoSystem::EventType type, const std::string& operationName);
 };
 typedef std::shared_ptr<SceneGraph> SceneGraphPtr;
@@ -0,0 +1,92 @@
+#include "BatchTransform.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "ibrush.h"
+#include "ipatch.h"
+#include "iscenegraph.h"
+#include "iselectiontest.h"
+#include "itransformable.h"
+#include "scenelib.h"
+#include "util/Parallel.h"
+
+namespace selection
+{
+
+namespace
+{
+    // Below this number of primitives it's not worth to spawn any worker tasks
+    constexpr std::size_t MinPrimitivesForParallelEvaluation = 64;
+
+    // Re-builds the brush windings or the patch mesh of the given node, if they
+    // have been invalidated. This is only touching data owned by the node itself:
+    // the bounds of frozen patches are already up to date, and brushes
+    // don't notify anyone when building their windings.
+    void evaluateGeometry(const scene::INodePtr& node)
+    {
+        if (auto brush = Node_getIBrush(node); brush != nullptr)
+        {
+            brush->evaluateBRep();
+        }
+        else if (auto patch = Node_getIPatch(node); patch != nullptr)
+        {
+            patch->updateTesselation();
+        }
+    }
+
+    void evaluateGeometryInParallel(const std::vector<scene::INodePtr>& nodes)
+    {
+        util::forEachChunkInParallel(nodes.size(), MinPrimitivesForParallelEvaluation,
+            [&](std::size_t start, std::size_t end)
+        {
+            std::for_each(nodes.begin() + start, nodes.begin() + end, evaluateGeometry);
+        });
+    }
+
+    inline bool hasSelectedComponents(const scene::INodePtr& node)
+    {
+        auto componentSelectionTestable = Node_getComponentSelectionTestable(node);
+        return componentSelectionTestable && componentSelectionTestable->isSelectedComponents();
+    }
+}
+
+void freezeTransforms()
+{
+    // Coalesce the bounds changes caused by freezing and evaluating the nodes
+    scene::GraphTransaction transaction(GlobalSceneGraph());
+
+    std::vector<scene::INodePtr> primitives;
+
+    // Commit the transformed geometry and record the undo states
+    GlobalSceneGraph().foreachNode([&](const scene::INodePtr& node)
+    {
+        auto transformable = scene::node_cast<ITransformable>(node);
+
+        if (transformable)
+        {
+            transformable->freezeTransform();
+        }
+
+        // Re-building the windings of a brush is dropping its vertex and edge
+        // selectables, which might notify the selection system. Leave these
+        // to be evaluated on this thread.
+        if (Node_isPrimitive(node) && !hasSelectedComponents(node))
+        {
+            primitives.push_back(node);
+        }
+
+        return true;
+    });
+
+    evaluateGeometryInParallel(primitives);
+
+    // Evaluate the bounds on this thread, the changed nodes
+    // are re-linked when the transaction is committed
+    for (const auto& node : primitives)
+    {
+        node->worldAABB();
+    }
+}
+
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+namespace selection
+{
+
+/**
+ * Freezes the current transformation of all transformable nodes in the scene,
+ * this is the bulk version of calling freezeTransform() on every node.
+ *
+ * The new geometry and the undo states are committed on the calling thread,
+ * in scene graph order. The brush windings and patch meshes invalidated by
+ * the transformation are then re-built in parallel worker tasks, before the
+ * bounds of all primitives are evaluated in one go, which re-links the changed
+ * nodes in the scene's space partition.
+ *
+ * The resulting geometry is the same as the one produced by freezing
+ * and evaluating the nodes one after the other.
+ */
+void freezeTransforms();
+
+}
@@ -14,6 +14,7 @@
 #include "selection/algorithm/Primitives.h"
 #include "selection/algorithm/Transformation.h"
 #include "SceneWalkers.h"
+#include "BatchTransform.h"
 #include "SelectionTestWalkers.h"
 #include "command/ExecutionFailure.h"
 #include "string/case_conv.h"
@@ -776,7 +777,7 @@ void RadiantSelectionSystem::onManipulationChanged()
 
 void RadiantSelectionSystem::onManipulationEnd()
 {
-    GlobalSceneGraph().foreachNode(scene::freezeTransformableNode);
+    freezeTransforms();
 
     _pivot.endOperation();
 
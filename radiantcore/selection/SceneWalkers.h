@@ -76,23 +76,6 @@ public:
 	}
 };
 
-namespace scene
-{
-
-inline bool freezeTransformableNode(const scene::INodePtr& node)
-{
-	ITransformablePtr transform = scene::node_cast<ITransformable>(node);
-
-	if (transform)
-	{
-		transform->freezeTransform();
-	}
-
-	return true;
-}
-
-} // namespace
-
 /**
  * greebo: Traverses the selection and invokes the functor on
  * each encountered primitive.
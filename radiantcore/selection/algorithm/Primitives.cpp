@@ -155,11 +155,16 @@ void createCMFromSelection(const cmd::ArgumentList& args)
 		// Create a new collisionmodel on the heap using a shared_ptr
 		cmutil::CollisionModelPtr cm(new cmutil::CollisionModel());
 
-		// Add all the brushes to the collision model
+		std::vector<Brush*> brushList;
+		brushList.reserve(brushes.size());
+
 		for (std::size_t i = 0; i < brushes.size(); i++) {
-			cm->addBrush(brushes[i]->getBrush());
+			brushList.push_back(&brushes[i]->getBrush());
 		}
 
+		// Add all the brushes to the collision model
+		cm->addBrushes(brushList);
+
 		std::string basePath = GlobalGameManager().getModPath();
 
 		std::string modelPath = basePath + model;
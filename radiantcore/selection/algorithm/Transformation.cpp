@@ -23,6 +23,7 @@
 #include "debugging/debugging.h"
 #include "selection/TransformationVisitors.h"
 #include "selection/SceneWalkers.h"
+#include "selection/BatchTransform.h"
 #include "command/ExecutionFailure.h"
 
 #include "string/case_conv.h"
@@ -56,7 +57,7 @@ void rotateSelected(const Quaternion& rotation)
 	// Update the views
 	SceneChangeNotify();
 
-	GlobalSceneGraph().foreachNode(scene::freezeTransformableNode);
+	selection::freezeTransforms();
 }
 
 // greebo: see header for documentation
@@ -106,7 +107,7 @@ void scaleSelected(const Vector3& scaleXYZ)
 		// Update the scene views
 		SceneChangeNotify();
 
-		GlobalSceneGraph().foreachNode(scene::freezeTransformableNode);
+		selection::freezeTransforms();
 	}
 	else
 	{
@@ -372,7 +373,7 @@ void translateSelected(const Vector3& translation)
 	// Update the scene so that the changes are made visible
 	SceneChangeNotify();
 
-	GlobalSceneGraph().foreachNode(scene::freezeTransformableNode);
+	selection::freezeTransforms();
 }
 
 // Specialised overload, called by the general nudgeSelected() routine
@@ -6,6 +6,7 @@
 #include "string/convert.h"
 #include "string/replace.h"
 #include "parser/DefTokeniser.h"
+#include "stream/utils.h"
 
 #include "scenelib.h"
 #include "debugging/ScenegraphUtils.h"
@@ -38,6 +39,11 @@ void SelectionGroupInfoFileModule::clear()
 	_selectionGroupBuffer.str(std::string());
 	_selectionGroupBuffer.clear();
 	_nodeInfoCount = 0;
+
+	_nodeEntityNums.clear();
+	_nodePrimitiveNums.clear();
+	_nodeGroupIdCounts.clear();
+	_nodeGroupIds.clear();
 }
 
 void SelectionGroupInfoFileModule::onInfoFileSaveStart()
@@ -66,6 +72,10 @@ void SelectionGroupInfoFileModule::onBeginSaveMap(const scene::IMapRootNodePtr&
 			<< " { \"" << string::replace_all_copy(group.getName(), "\"", "&quot;") << "\" }"
 			<< std::endl;
 
+		_groupInfo.push_back(SelectionGroupImportInfo());
+		_groupInfo.back().id = group.getId();
+		_groupInfo.back().name = group.getName();
+
 		selectionGroupCount++;
 	});
 
@@ -125,8 +135,13 @@ void SelectionGroupInfoFileModule::saveNode(const scene::INodePtr& node, std::si
 	for (const IGroupSelectable::GroupIds::value_type& i : ids)
 	{
 		_output << i << " ";
+		_nodeGroupIds.push_back(i);
 	}
 
+	_nodeEntityNums.push_back(entityNum);
+	_nodePrimitiveNums.push_back(primitiveNum);
+	_nodeGroupIdCounts.push_back(static_cast<std::uint32_t>(ids.size()));
+
 	_output << ") ";
 
 	// Close the Node block
@@ -158,6 +173,27 @@ void SelectionGroupInfoFileModule::writeBlocks(std::ostream& stream)
 	rMessage() << _nodeInfoCount << " selection group member mappings written." << std::endl;
 }
 
+bool SelectionGroupInfoFileModule::writeBinaryBlock(std::ostream& stream)
+{
+	stream::writeLittleEndian<std::uint32_t>(stream, static_cast<std::uint32_t>(_groupInfo.size()));
+
+	for (const SelectionGroupImportInfo& info : _groupInfo)
+	{
+		stream::writeLittleEndian<std::uint64_t>(stream, info.id);
+		stream::writeLengthPrefixedString(stream, info.name);
+	}
+
+	stream::writeLittleEndian<std::uint64_t>(stream, _nodeEntityNums.size());
+	stream::writeLittleEndianArray(stream, _nodeEntityNums);
+	stream::writeLittleEndianArray(stream, _nodePrimitiveNums);
+	stream::writeLittleEndianArray(stream, _nodeGroupIdCounts);
+
+	stream::writeLittleEndian<std::uint64_t>(stream, _nodeGroupIds.size());
+	stream::writeLittleEndianArray(stream, _nodeGroupIds);
+
+	return true;
+}
+
 void SelectionGroupInfoFileModule::onInfoFileSaveFinished()
 {
 	clear();
@@ -187,6 +223,70 @@ void SelectionGroupInfoFileModule::parseBlock(const std::string& blockName, pars
 	}
 }
 
+bool SelectionGroupInfoFileModule::readBinaryBlock(std::istream& stream)
+{
+	std::uint32_t groupCount = 0;
+
+	if (!stream::readLittleEndian(stream, groupCount))
+	{
+		return false;
+	}
+
+	for (std::uint32_t i = 0; i < groupCount; ++i)
+	{
+		std::uint64_t id = 0;
+		std::string name;
+
+		if (!stream::readLittleEndian(stream, id) || !stream::readLengthPrefixedString(stream, name))
+		{
+			return false;
+		}
+
+		_groupInfo.push_back(SelectionGroupImportInfo());
+		_groupInfo.back().id = static_cast<std::size_t>(id);
+		_groupInfo.back().name = name;
+	}
+
+	std::uint64_t nodeCount = 0;
+	std::uint64_t idCount = 0;
+	std::vector<std::uint64_t> entityNums;
+	std::vector<std::uint64_t> primitiveNums;
+	std::vector<std::uint32_t> groupIdCounts;
+	std::vector<std::uint64_t> groupIds;
+
+	if (!stream::readLittleEndian(stream, nodeCount) ||
+		!stream::readLittleEndianArray(stream, entityNums, static_cast<std::size_t>(nodeCount)) ||
+		!stream::readLittleEndianArray(stream, primitiveNums, static_cast<std::size_t>(nodeCount)) ||
+		!stream::readLittleEndianArray(stream, groupIdCounts, static_cast<std::size_t>(nodeCount)) ||
+		!stream::readLittleEndian(stream, idCount) ||
+		!stream::readLittleEndianArray(stream, groupIds, static_cast<std::size_t>(idCount)))
+	{
+		return false;
+	}
+
+	auto groupId = groupIds.begin();
+
+	for (std::size_t i = 0; i < entityNums.size(); ++i)
+	{
+		if (static_cast<std::size_t>(groupIds.end() - groupId) < groupIdCounts[i])
+		{
+			return false;
+		}
+
+		// The nodes have been written in order, so they can be appended
+		_nodeMapping.emplace_hint(_nodeMapping.end(),
+			map::NodeIndexPair(static_cast<std::size_t>(entityNums[i]), static_cast<std::size_t>(primitiveNums[i])),
+			IGroupSelectable::GroupIds(groupId, groupId + groupIdCounts[i]));
+
+		groupId += groupIdCounts[i];
+	}
+
+	rMessage() << "[InfoFile]: Loaded " << _groupInfo.size() << " selection groups and "
+		<< _nodeMapping.size() << " node mappings" << std::endl;
+
+	return true;
+}
+
 void SelectionGroupInfoFileModule::parseSelectionGroups(parser::DefTokeniser& tok)
 {
 	// The opening brace
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <sstream>
+#include <vector>
 #include "iselectiongroup.h"
 #include "imapinfofile.h"
 
@@ -34,6 +36,13 @@ private:
 	std::stringstream _output;
 	std::stringstream _selectionGroupBuffer;
 
+	// The node mapping collected for the binary block, the group IDs
+	// of all nodes are stored in one flat list
+	std::vector<std::uint64_t> _nodeEntityNums;
+	std::vector<std::uint64_t> _nodePrimitiveNums;
+	std::vector<std::uint32_t> _nodeGroupIdCounts;
+	std::vector<std::uint64_t> _nodeGroupIds;
+
 	std::size_t _nodeInfoCount;
 
 public:
@@ -45,11 +54,13 @@ public:
 	void onSavePrimitive(const scene::INodePtr& node, std::size_t entityNum, std::size_t primitiveNum) override;
 	void onSaveEntity(const scene::INodePtr& node, std::size_t entityNum) override;
 	void writeBlocks(std::ostream& stream) override;
+	bool writeBinaryBlock(std::ostream& stream) override;
 	void onInfoFileSaveFinished() override;
 
 	void onInfoFileLoadStart() override;
 	bool canParseBlock(const std::string& blockName) override;
 	void parseBlock(const std::string& blockName, parser::DefTokeniser& tok) override;
+	bool readBinaryBlock(std::istream& stream) override;
 	void applyInfoToScene(const scene::IMapRootNodePtr& root, const map::NodeIndexMap& nodeMap) override;
 	void onInfoFileLoadFinished() override;
 
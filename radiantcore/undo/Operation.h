@@ -44,6 +44,11 @@ private:
         {
             _undoable.onOperationRestored();
         }
+
+        std::size_t getApproximateSize() const
+        {
+            return sizeof(*this) + _data->getApproximateSize();
+        }
 	};
 
 	// The Snapshot (the list of structs containing Undoable+Data)
@@ -52,11 +57,15 @@ private:
 	// The name of the UndoOperaton
 	std::string _command;
 
+	// The approximate size as calculated by the last updateSize() call
+	std::size_t _size;
+
 public:
     using Ptr = std::shared_ptr<Operation>;
 
 	Operation(const std::string& command) :
-		_command(command)
+		_command(command),
+		_size(0)
 	{}
 
 	const std::string& getName() const
@@ -74,6 +83,26 @@ public:
         return _snapshot.empty();
     }
 
+    // Returns the approximate number of bytes occupied by this operation
+    std::size_t getSize() const
+    {
+        return _size;
+    }
+
+    // Calculates the size of this operation, this is done once it is committed.
+    // The share of the data held together with other operations changes when
+    // these are added or discarded, so this can be repeated on request.
+    void updateSize()
+    {
+        // Every element of the snapshot list carries two pointers next to the state itself
+        _size = sizeof(*this) + _command.capacity() + _snapshot.size() * 2 * sizeof(void*);
+
+        for (const auto& state : _snapshot)
+        {
+            _size += state.getApproximateSize();
+        }
+    }
+
 	void save(IUndoable& undoable)
 	{
 		// Record the state of the given undable and push it to the snapshot
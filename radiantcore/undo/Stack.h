@@ -2,6 +2,7 @@
 
 #include "debugging/debugging.h"
 #include <list>
+#include <functional>
 #include "Operation.h"
 
 namespace undo
@@ -28,7 +29,13 @@ private:
 	// The pending undo operation (will be committed on finish, if not empty)
     Operation::Ptr _pending;
 
+	// The sum of the operation sizes, updated on push and pop
+	std::size_t _memoryUsage;
+
 public:
+	UndoStack() :
+		_memoryUsage(0)
+	{}
 
 	bool empty() const
 	{
@@ -52,17 +59,47 @@ public:
 
 	void pop_front()
 	{
+		_memoryUsage -= _stack.front()->getSize();
 		_stack.pop_front();
 	}
 
 	void pop_back()
 	{
+		_memoryUsage -= _stack.back()->getSize();
 		_stack.pop_back();
 	}
 
 	void clear()
 	{
 		_stack.clear();
+		_memoryUsage = 0;
+	}
+
+	// Returns the approximate number of bytes occupied by the operations in this stack
+	std::size_t getMemoryUsage() const
+	{
+		return _memoryUsage;
+	}
+
+	// Re-calculates the size of all operations, to update the shares of the data they have in common
+	void updateMemoryUsage()
+	{
+		_memoryUsage = 0;
+
+		for (const auto& operation : _stack)
+		{
+			operation->updateSize();
+			_memoryUsage += operation->getSize();
+		}
+	}
+
+	// Visits all operations, oldest first
+	void foreachOperation(const std::function<void(const Operation&)>& functor) const
+	{
+		for (const auto& operation : _stack)
+		{
+			functor(*operation);
+		}
 	}
 
 	// Allocate a new Operation to work with
@@ -97,6 +134,9 @@ public:
 		// Rename the last undo operation (it may be "unnamed" till now)
         _pending->setName(command);
 
+        _pending->updateSize();
+        _memoryUsage += _pending->getSize();
+
         // Move the pending operation into its place
         _stack.emplace_back(std::move(_pending));
 		return true;
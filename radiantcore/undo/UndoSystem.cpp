@@ -12,7 +12,8 @@ namespace undo
 
 UndoSystem::UndoSystem() :
 	_activeUndoStack(nullptr),
-	_undoLevels(RKEY_UNDO_QUEUE_SIZE)
+	_undoLevels(RKEY_UNDO_QUEUE_SIZE),
+	_memoryLimitMB(RKEY_UNDO_MEMORY_LIMIT)
 {}
 
 UndoSystem::~UndoSystem()
@@ -67,6 +68,7 @@ void UndoSystem::finish(const std::string& command)
 	if (finishUndo(command))
     {
 		rMessage() << command << std::endl;
+		trimHistoryToMemoryLimit();
         _eventSignal.emit(EventType::OperationRecorded, command);
 	}
 }
@@ -132,6 +134,47 @@ void UndoSystem::clear()
 	// there are some "persistent" observers like EntityInspector and ShaderClipboard
 }
 
+std::size_t UndoSystem::getMemoryUsage() const
+{
+	return _undoStack.getMemoryUsage() + _redoStack.getMemoryUsage();
+}
+
+void UndoSystem::updateMemoryUsage()
+{
+	_undoStack.updateMemoryUsage();
+	_redoStack.updateMemoryUsage();
+}
+
+void UndoSystem::foreachOperation(const std::function<void(const std::string&, std::size_t)>& functor) const
+{
+	_undoStack.foreachOperation([&](const Operation& operation)
+	{
+		functor(operation.getName(), operation.getSize());
+	});
+}
+
+void UndoSystem::trimHistoryToMemoryLimit()
+{
+	auto limit = _memoryLimitMB.get() * 1024 * 1024;
+
+	if (limit == 0) return;
+
+	std::size_t numDiscarded = 0;
+
+	// Always keep the most recent operation, even if it exceeds the limit on its own
+	while (_undoStack.size() > 1 && getMemoryUsage() > limit)
+	{
+		_undoStack.pop_front();
+		++numDiscarded;
+	}
+
+	if (numDiscarded > 0)
+	{
+		rMessage() << "Undo memory limit reached, discarded the " << numDiscarded << 
+			" oldest operation(s)" << std::endl;
+	}
+}
+
 sigc::signal<void(IUndoSystem::EventType, const std::string&)>& UndoSystem::signal_undoEvent()
 {
     return _eventSignal;
@@ -15,6 +15,7 @@ namespace undo
 {
 
 constexpr const char* const RKEY_UNDO_QUEUE_SIZE = "user/ui/undo/queueSize";
+constexpr const char* const RKEY_UNDO_MEMORY_LIMIT = "user/ui/undo/memoryLimit"; // in MB, 0 = unlimited
 
 /**
 * greebo: The UndoSystem (interface: iundo.h) is maintaining two internal
@@ -47,6 +48,7 @@ private:
 	std::map<IUndoable*, UndoStackFiller> _undoables;
 
     registry::CachedKey<std::size_t> _undoLevels;
+    registry::CachedKey<std::size_t> _memoryLimitMB;
 
     sigc::signal<void(EventType, const std::string&)> _eventSignal;
 
@@ -68,6 +70,10 @@ public:
 
 	void clear() override;
 
+	std::size_t getMemoryUsage() const override;
+	void updateMemoryUsage() override;
+	void foreachOperation(const std::function<void(const std::string&, std::size_t)>& functor) const override;
+
     sigc::signal<void(EventType, const std::string&)>& signal_undoEvent() override;
 
 private:
@@ -79,6 +85,9 @@ private:
 
 	// Assigns the given stack to all of the Undoables listed in the map
 	void setActiveUndoStack(UndoStack* stack);
+
+	// Discards the oldest undo operations until the history fits into the memory limit
+	void trimHistoryToMemoryLimit();
 };
 
 }
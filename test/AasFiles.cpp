@@ -0,0 +1,396 @@
+#include "RadiantTest.h"
+
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <fmt/format.h>
+#include "iaasfile.h"
+#include "render/View.h"
+#include "time/StopWatch.h"
+#include "algorithm/View.h"
+#include "os/fs.h"
+
+namespace test
+{
+
+class AasFileTest :
+    public RadiantTest
+{
+protected:
+    std::string getAasCachePath()
+    {
+        return _context.getCacheDataPath() + "aas/";
+    }
+
+    std::size_t getNumCacheEntries()
+    {
+        std::size_t count = 0;
+
+        for (const auto& entry : fs::directory_iterator(getAasCachePath()))
+        {
+            if (entry.path().extension() == ".drac") ++count;
+        }
+
+        return count;
+    }
+
+    void postShutdown() override
+    {
+        // Every test stores new entries, don't let them pile up
+        fs::remove_all(getAasCachePath());
+    }
+};
+
+namespace
+{
+
+constexpr double AreaSize = 64;
+
+/**
+ * Generates the text of an AAS file holding a grid of box-shaped areas,
+ * each one bounded by a floor and a ceiling face. Area 1 is located at the
+ * origin, the areas are numbered along the x axis first. The given checksum
+ * ends up in the file header, use different ones to get distinct files.
+ */
+std::string generateAasFile(std::size_t columns, std::size_t rows, long checksum)
+{
+    std::size_t numAreas = columns * rows;
+
+    std::ostringstream stream;
+
+    stream << "DewmAAS 1.07\n\n" << checksum << "\n\n";
+    stream << "settings\n{\n\tbboxes\n\t{\n\t\t(-16 -16 0)-(16 16 72)\n\t}\n\tusePatches = 0\n"
+        << "\tfileExtension = \"aas32\"\n\tgravity = (0 0 -1050)\n}\n";
+
+    // A single floor plane is enough, the areas don't reference planes in the editor
+    stream << "planes 1 {\n\t0 ( 0 0 1 0 )\n}\n";
+
+    // Eight vertices per area, four on the floor and four at the ceiling
+    stream << "vertices " << numAreas * 8 << " {\n";
+
+    for (std::size_t area = 0; area < numAreas; ++area)
+    {
+        double x = (area % columns) * AreaSize;
+        double y = (area / columns) * AreaSize;
+
+        for (std::size_t corner = 0; corner < 8; ++corner)
+        {
+            double cornerX = (corner & 1) != (corner & 2) >> 1 ? x + AreaSize : x;
+            double cornerY = (corner & 2) ? y + AreaSize : y;
+            double cornerZ = corner < 4 ? 0 : AreaSize;
+
+            stream << "\t" << area * 8 + corner << " ( " << cornerX << " " << cornerY << " " << cornerZ << " )\n";
+        }
+    }
+
+    stream << "}\n";
+
+    // Edge 0 is a placeholder, each area has four edges at the floor and four at the ceiling
+    stream << "edges " << numAreas * 8 + 1 << " {\n\t0 ( 0 0 )\n";
+
+    for (std::size_t area = 0; area < numAreas; ++area)
+    {
+        for (std::size_t edge = 0; edge < 8; ++edge)
+        {
+            std::size_t first = area * 8 + edge;
+            std::size_t second = area * 8 + (edge & 4) + ((edge + 1) & 3);
+
+            stream << "\t" << area * 8 + edge + 1 << " ( " << first << " " << second << " )\n";
+        }
+    }
+
+    stream << "}\n";
+
+    stream << "edgeIndex " << numAreas * 8 << " {\n";
+
+    for (std::size_t i = 0; i < numAreas * 8; ++i)
+    {
+        stream << "\t" << i << " ( " << i + 1 << " )\n";
+    }
+
+    stream << "}\n";
+
+    // Face 0 is a placeholder, the floor faces are flagged as such
+    stream << "faces " << numAreas * 2 + 1 << " {\n\t0 ( 0 0 0 0 0 0 )\n";
+
+    for (std::size_t area = 0; area < numAreas; ++area)
+    {
+        stream << "\t" << area * 2 + 1 << " ( 0 4 " << area + 1 << " 0 " << area * 8 << " 4 )\n";
+        stream << "\t" << area * 2 + 2 << " ( 0 1 " << area + 1 << " 0 " << area * 8 + 4 << " 4 )\n";
+    }
+
+    stream << "}\n";
+
+    stream << "faceIndex " << numAreas * 2 << " {\n";
+
+    for (std::size_t i = 0; i < numAreas * 2; ++i)
+    {
+        stream << "\t" << i << " ( " << i + 1 << " )\n";
+    }
+
+    stream << "}\n";
+
+    // Area 0 is a placeholder without faces, the others are reachable floor areas
+    stream << "areas " << numAreas + 1 << " {\n\t0 ( 0 0 0 0 0 0 ) 0 {\n\t}\n";
+
+    for (std::size_t area = 0; area < numAreas; ++area)
+    {
+        stream << "\t" << area + 1 << " ( 65 1 " << area * 2 << " 2 1 " << area + 1 << " ) 1 {\n"
+            << "\t\t1 0 ( 0 0 0 ) ( 0 0 0 ) 0 1\n\t}\n";
+    }
+
+    stream << "}\n";
+
+    // Blocks ignored by the loader
+    stream << "// The node tree is not used\nnodes 1 {\n\t0 ( 0 0 0 )\n}\n";
+
+    return stream.str();
+}
+
+map::IAasFilePtr loadAasFile(const std::string& contents)
+{
+    std::istringstream stream(contents);
+
+    auto loader = GlobalAasFileManager().getLoaderForStream(stream);
+
+    if (!loader) return map::IAasFilePtr();
+
+    return loader->loadFromStream(stream);
+}
+
+// Checksum unique to this test run, such that the first load is never served by the cache
+long getUniqueChecksum()
+{
+    return static_cast<long>(std::chrono::steady_clock::now().time_since_epoch().count() % 1000000000);
+}
+
+std::set<int> getAreasInVolumeBruteForce(const map::IAasFile& aasFile, const VolumeTest& volume)
+{
+    std::set<int> result;
+
+    for (std::size_t areaNum = 0; areaNum < aasFile.getNumAreas(); ++areaNum)
+    {
+        const auto& bounds = aasFile.getArea(static_cast<int>(areaNum)).bounds;
+
+        if (bounds.isValid() && volume.TestAABB(bounds) != VOLUME_OUTSIDE)
+        {
+            result.insert(static_cast<int>(areaNum));
+        }
+    }
+
+    return result;
+}
+
+std::set<int> getAreasInVolume(const map::IAasFile& aasFile, const VolumeTest& volume)
+{
+    std::set<int> result;
+
+    aasFile.forEachAreaInVolume(volume, [&](int areaNum)
+    {
+        EXPECT_TRUE(result.insert(areaNum).second) << "Area " << areaNum << " reported twice";
+    });
+
+    return result;
+}
+
+}
+
+TEST_F(AasFileTest, ParseAreasFromText)
+{
+    auto aasFile = loadAasFile(generateAasFile(4, 3, getUniqueChecksum()));
+    ASSERT_TRUE(aasFile);
+
+    EXPECT_EQ(aasFile->getNumAreas(), 13);
+    EXPECT_EQ(aasFile->getNumVertices(), 96);
+    EXPECT_EQ(aasFile->getNumEdges(), 97);
+    EXPECT_EQ(aasFile->getNumFaces(), 25);
+
+    // Area 6 is the second one in the second row
+    const auto& area = aasFile->getArea(6);
+
+    EXPECT_EQ(area.numFaces, 2);
+    EXPECT_TRUE(math::isNear(area.bounds.getOrigin(), Vector3(96, 96, 32), 0.001)) << area.bounds.getOrigin();
+    EXPECT_TRUE(math::isNear(area.bounds.getExtents(), Vector3(32, 32, 32), 0.001)) << area.bounds.getExtents();
+
+    // Reachable areas are centered on their floor faces
+    EXPECT_TRUE(math::isNear(area.center, Vector3(96, 96, 0), 0.001)) << area.center;
+
+    // The placeholder area has no bounds
+    EXPECT_FALSE(aasFile->getArea(0).bounds.isValid());
+}
+
+TEST_F(AasFileTest, CachedFileMatchesParsedFile)
+{
+    auto contents = generateAasFile(5, 5, getUniqueChecksum());
+
+    // The first load parses the text and stores the result, the second one reads it back
+    auto parsedFile = loadAasFile(contents);
+    auto cachedFile = loadAasFile(contents);
+
+    ASSERT_TRUE(parsedFile);
+    ASSERT_TRUE(cachedFile);
+    EXPECT_NE(parsedFile, cachedFile);
+
+    ASSERT_EQ(cachedFile->getNumPlanes(), parsedFile->getNumPlanes());
+    ASSERT_EQ(cachedFile->getNumVertices(), parsedFile->getNumVertices());
+    ASSERT_EQ(cachedFile->getNumEdges(), parsedFile->getNumEdges());
+    ASSERT_EQ(cachedFile->getNumEdgeIndexes(), parsedFile->getNumEdgeIndexes());
+    ASSERT_EQ(cachedFile->getNumFaces(), parsedFile->getNumFaces());
+    ASSERT_EQ(cachedFile->getNumFaceIndexes(), parsedFile->getNumFaceIndexes());
+    ASSERT_EQ(cachedFile->getNumAreas(), parsedFile->getNumAreas());
+
+    for (std::size_t i = 0; i < parsedFile->getNumPlanes(); ++i)
+    {
+        EXPECT_EQ(cachedFile->getPlane(i), parsedFile->getPlane(i));
+    }
+
+    for (std::size_t i = 0; i < parsedFile->getNumVertices(); ++i)
+    {
+        EXPECT_EQ(cachedFile->getVertex(i), parsedFile->getVertex(i));
+    }
+
+    for (std::size_t i = 0; i < parsedFile->getNumEdges(); ++i)
+    {
+        EXPECT_EQ(cachedFile->getEdge(i).vertexNumber[0], parsedFile->getEdge(i).vertexNumber[0]);
+        EXPECT_EQ(cachedFile->getEdge(i).vertexNumber[1], parsedFile->getEdge(i).vertexNumber[1]);
+    }
+
+    for (int i = 0; i < static_cast<int>(parsedFile->getNumEdgeIndexes()); ++i)
+    {
+        EXPECT_EQ(cachedFile->getEdgeByIndex(i), parsedFile->getEdgeByIndex(i));
+    }
+
+    for (int i = 0; i < static_cast<int>(parsedFile->getNumFaces()); ++i)
+    {
+        const auto& cached = cachedFile->getFace(i);
+        const auto& parsed = parsedFile->getFace(i);
+
+        EXPECT_EQ(cached.planeNum, parsed.planeNum);
+        EXPECT_EQ(cached.flags, parsed.flags);
+        EXPECT_EQ(cached.numEdges, parsed.numEdges);
+        EXPECT_EQ(cached.firstEdge, parsed.firstEdge);
+        EXPECT_EQ(cached.areas[0], parsed.areas[0]);
+        EXPECT_EQ(cached.areas[1], parsed.areas[1]);
+    }
+
+    for (int i = 0; i < static_cast<int>(parsedFile->getNumFaceIndexes()); ++i)
+    {
+        EXPECT_EQ(cachedFile->getFaceByIndex(i), parsedFile->getFaceByIndex(i));
+    }
+
+    for (int i = 0; i < static_cast<int>(parsedFile->getNumAreas()); ++i)
+    {
+        const auto& cached = cachedFile->getArea(i);
+        const auto& parsed = parsedFile->getArea(i);
+
+        EXPECT_EQ(cached.numFaces, parsed.numFaces);
+        EXPECT_EQ(cached.firstFace, parsed.firstFace);
+        EXPECT_EQ(cached.bounds, parsed.bounds);
+        EXPECT_EQ(cached.center, parsed.center);
+        EXPECT_EQ(cached.flags, parsed.flags);
+        EXPECT_EQ(cached.contents, parsed.contents);
+        EXPECT_EQ(cached.cluster, parsed.cluster);
+        EXPECT_EQ(cached.clusterAreaNum, parsed.clusterAreaNum);
+    }
+}
+
+TEST_F(AasFileTest, AreasInVolumeMatchBruteForce)
+{
+    auto aasFile = loadAasFile(generateAasFile(40, 30, getUniqueChecksum()));
+    ASSERT_TRUE(aasFile);
+
+    // Orthoviews looking at different parts of the grid, including one outside of it
+    for (const auto& origin : { Vector3(0, 0, 0), Vector3(1280, 960, 0), Vector3(2000, 300, 0), Vector3(-5000, 0, 0) })
+    {
+        render::View view;
+        algorithm::constructCenteredOrthoview(view, origin);
+
+        auto expected = getAreasInVolumeBruteForce(*aasFile, view);
+
+        EXPECT_EQ(getAreasInVolume(*aasFile, view), expected) << "View at " << origin;
+    }
+}
+
+TEST_F(AasFileTest, FindAreaAlongRay)
+{
+    auto aasFile = loadAasFile(generateAasFile(10, 10, getUniqueChecksum()));
+    ASSERT_TRUE(aasFile);
+
+    // Looking down on the center of the area in the third column of the fourth row
+    EXPECT_EQ(aasFile->findAreaAlongRay(Ray(Vector3(2.5 * AreaSize, 3.5 * AreaSize, 1000), Vector3(0, 0, -1))), 33);
+
+    // Looking along the x axis from the left, the first area of the row is hit first
+    EXPECT_EQ(aasFile->findAreaAlongRay(Ray(Vector3(-1000, 5.5 * AreaSize, 10), Vector3(1, 0, 0))), 51);
+
+    // Missing the grid entirely
+    EXPECT_EQ(aasFile->findAreaAlongRay(Ray(Vector3(-1000, -1000, 10), Vector3(0, -1, 0))), -1);
+}
+
+TEST_F(AasFileTest, CacheKeepsTheMostRecentEntries)
+{
+    // The cache keeps 64 entries, storing more removes the oldest ones
+    auto checksum = getUniqueChecksum();
+
+    for (long i = 0; i < 70; ++i)
+    {
+        ASSERT_TRUE(loadAasFile(generateAasFile(1, 1, checksum + i)));
+    }
+
+    EXPECT_EQ(getNumCacheEntries(), 64);
+}
+
+// Benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(AasFileTest, DISABLED_AasLoadAndCullBenchmark)
+{
+    auto contents = generateAasFile(100, 100, getUniqueChecksum());
+
+    util::StopWatch parseTimer;
+    auto parsedFile = loadAasFile(contents);
+    auto parseMsecs = parseTimer.getMilliSecondsPassed();
+
+    util::StopWatch cacheTimer;
+    auto cachedFile = loadAasFile(contents);
+    auto cacheMsecs = cacheTimer.getMilliSecondsPassed();
+
+    ASSERT_TRUE(parsedFile);
+    ASSERT_TRUE(cachedFile);
+
+    std::cout << "Loaded " << parsedFile->getNumAreas() << " areas (" << contents.size() / 1024 << " kB) in "
+        << parseMsecs << " ms from text, " << cacheMsecs << " ms from the cache" << std::endl;
+
+    // Pan an orthoview across the grid
+    constexpr std::size_t NumFrames = 200;
+    std::size_t visibleAreas = 0;
+
+    render::View view;
+
+    util::StopWatch cullTimer;
+
+    for (std::size_t frame = 0; frame < NumFrames; ++frame)
+    {
+        algorithm::constructCenteredOrthoview(view, Vector3(frame * 32.0, frame * 32.0, 0));
+        cachedFile->forEachAreaInVolume(view, [&](int) { ++visibleAreas; });
+    }
+
+    auto cullMsecs = cullTimer.getMilliSecondsPassed();
+
+    util::StopWatch bruteForceTimer;
+    std::size_t bruteForceAreas = 0;
+
+    for (std::size_t frame = 0; frame < NumFrames; ++frame)
+    {
+        algorithm::constructCenteredOrthoview(view, Vector3(frame * 32.0, frame * 32.0, 0));
+        bruteForceAreas += getAreasInVolumeBruteForce(*cachedFile, view).size();
+    }
+
+    auto bruteForceMsecs = bruteForceTimer.getMilliSecondsPassed();
+
+    EXPECT_EQ(visibleAreas, bruteForceAreas);
+
+    std::cout << "Submitted " << visibleAreas / NumFrames << " of " << cachedFile->getNumAreas()
+        << " areas per frame, " << NumFrames << " frames culled in " << cullMsecs << " ms (tree) vs. "
+        << bruteForceMsecs << " ms (all areas)" << std::endl;
+}
+
+}
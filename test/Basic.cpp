@@ -6,6 +6,7 @@
 #include "gtest/gtest.h"
 
 #include "string/string.h"
+#include "string/interned.h"
 #include "os/path.h"
 
 namespace test
@@ -33,6 +34,48 @@ TEST(BasicTest, StringILessFunctor)
     EXPECT_TRUE(!less("BLEH", "blah"));
 }
 
+TEST(BasicTest, StringIHashFunctor)
+{
+    string::IHash hash;
+    string::IEquals equals;
+
+    EXPECT_EQ(hash("blah"), hash("BLAH"));
+    EXPECT_EQ(hash("MiXeD_01"), hash("mIxED_01"));
+    EXPECT_NE(hash("blah"), hash("bleh"));
+
+    EXPECT_TRUE(equals("blah", "BLAH"));
+    EXPECT_FALSE(equals("blah", "BLEH"));
+    EXPECT_FALSE(equals("blah", "blahs"));
+}
+
+TEST(BasicTest, InternedStrings)
+{
+    string::InternedString empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty, std::string());
+
+    string::InternedString caulk("textures/common/caulk");
+    string::InternedString caulk2(std::string("textures/common/") + "caulk");
+    string::InternedString upperCaulk("TEXTURES/common/caulk");
+
+    // Equal strings share the same storage
+    EXPECT_EQ(caulk, caulk2);
+    EXPECT_EQ(&caulk.str(), &caulk2.str());
+    EXPECT_EQ(caulk, "textures/common/caulk");
+    EXPECT_EQ(std::string("textures/common/caulk"), caulk);
+
+    EXPECT_NE(caulk, upperCaulk);
+    EXPECT_TRUE(caulk.iequals(upperCaulk));
+    EXPECT_FALSE(caulk.iequals(string::InternedString("textures/common/clip")));
+
+    EXPECT_EQ(upperCaulk.toLowerCase(), caulk);
+    EXPECT_EQ(&upperCaulk.toLowerCase().str(), &caulk.str());
+    EXPECT_EQ(caulk.toLowerCase(), caulk);
+
+    const std::string& reference = caulk;
+    EXPECT_EQ(reference, "textures/common/caulk");
+}
+
 TEST(PathTests, GetFileExtension)
 {
     EXPECT_EQ(os::getExtension(""), "");
@@ -1,5 +1,8 @@
 #include "RadiantTest.h"
 
+#include <fstream>
+#include <iostream>
+#include <set>
 #include "ieclass.h"
 #include "ientity.h"
 #include "irendersystemfactory.h"
@@ -10,12 +13,16 @@
 #include "icolourscheme.h"
 #include "ieclasscolours.h"
 
+#include "render.h"
 #include "render/NopVolumeTest.h"
 #include "string/convert.h"
 #include "transformlib.h"
 #include "registry/registry.h"
 #include "eclass.h"
 #include "string/join.h"
+#include "os/fs.h"
+#include "string/predicate.h"
+#include "time/StopWatch.h"
 #include "scenelib.h"
 #include "algorithm/Entity.h"
 #include "algorithm/Scene.h"
@@ -221,6 +228,157 @@ TEST_F(EntityTest, ReloadDefsOnUnchangedFiles)
     checkBucketEntityDef(eclass);
 }
 
+TEST_F(EntityTest, EntityClassLookupIgnoresCase)
+{
+    auto cls = GlobalEntityClassManager().findClass("LIGHT_Extinguishable");
+    ASSERT_TRUE(cls);
+    EXPECT_EQ(cls, GlobalEntityClassManager().findClass("light_extinguishable"));
+    EXPECT_EQ(cls, GlobalEntityClassManager().findOrInsert("Light_Extinguishable", false));
+
+    for (int i = 0; i < 2; ++i)
+    {
+        // Inherited and own attributes
+        EXPECT_EQ(cls->getAttribute("EDITOR_COLOR").getValue(), "0 1 0");
+        EXPECT_EQ(cls->getAttribute("aiuse").getValue(), "AIUSE_LIGHTSOURCE");
+        EXPECT_EQ(cls->getAttribute("Editor_DisplayFolder", false).getValue(), "Lights/Base Entities, DoNotUse");
+        EXPECT_EQ(cls->getAttribute("EDITOR_COLOR", false).getValue(), "");
+
+        auto eclass = GlobalEntityClassManager().findClass("attribute_type_test");
+        EXPECT_EQ(eclass->getAttributeType("A_VECTOR"), "vector");
+        EXPECT_EQ(eclass->getAttributeDescription("Bool_Not_Defined_In_Base"), "Some bool description 12");
+
+        // Same results after reloading
+        GlobalEntityClassManager().reloadDefs();
+    }
+}
+
+namespace
+{
+
+void writeReloadTestDefs(const fs::path& path, const std::string& baseKeys, const std::string& childKeys)
+{
+    std::ofstream stream(path.string());
+
+    stream << "entityDef reload_test_base\n{\n" << baseKeys << "}\n\n";
+    stream << "entityDef reload_test_child\n{\n\t\"inherit\" \"reload_test_base\"\n" << childKeys << "}\n\n";
+    stream << "entityDef reload_test_grandchild\n{\n\t\"inherit\" \"reload_test_child\"\n}\n";
+}
+
+}
+
+// Changes to a parent class need to reach the flattened attributes of its descendants
+TEST_F(EntityTest, ReloadDefsUpdatesInheritedAttributes)
+{
+    fs::path defFile = _context.getTestProjectPath() + "def/reload_test.def";
+
+    writeReloadTestDefs(defFile,
+        "\t\"editor_color\" \"1 0 0\"\n\t\"editor_int reload_key\" \"First description\"\n"
+        "\t\"reload_key\" \"1\"\n\t\"removed_key\" \"removed\"\n",
+        "\t\"child_key\" \"child\"\n");
+
+    GlobalEntityClassManager().reloadDefs();
+
+    auto child = GlobalEntityClassManager().findClass("reload_test_child");
+    auto grandchild = GlobalEntityClassManager().findClass("reload_test_grandchild");
+    ASSERT_TRUE(child);
+    ASSERT_TRUE(grandchild);
+
+    for (const auto& eclass : { child, grandchild })
+    {
+        EXPECT_EQ(eclass->getAttribute("reload_key").getValue(), "1");
+        EXPECT_EQ(eclass->getAttributeType("reload_key"), "int");
+        EXPECT_EQ(eclass->getAttributeDescription("reload_key"), "First description");
+        EXPECT_EQ(eclass->getAttribute("removed_key").getValue(), "removed");
+        EXPECT_EQ(eclass->getAttribute("child_key").getValue(), "child");
+    }
+
+    // Change the base class only, the other two are parsed the same as before
+    writeReloadTestDefs(defFile,
+        "\t\"editor_color\" \"0 0 1\"\n\t\"editor_float reload_key\" \"Second description\"\n"
+        "\t\"reload_key\" \"2.5\"\n\t\"added_key\" \"added\"\n",
+        "\t\"child_key\" \"child\"\n");
+
+    GlobalEntityClassManager().reloadDefs();
+
+    for (const auto& eclass : { child, grandchild })
+    {
+        EXPECT_EQ(eclass->getAttribute("reload_key").getValue(), "2.5");
+        EXPECT_EQ(eclass->getAttributeType("reload_key"), "float");
+        EXPECT_EQ(eclass->getAttributeDescription("reload_key"), "Second description");
+        EXPECT_EQ(eclass->getAttribute("removed_key").getValue(), "");
+        EXPECT_EQ(eclass->getAttribute("added_key").getValue(), "added");
+        EXPECT_EQ(eclass->getAttribute("child_key").getValue(), "child");
+        EXPECT_EQ(eclass->getAttribute("editor_color").getValue(), "0 0 1");
+    }
+
+    // Change the middle class only, the grandchild needs to see it
+    writeReloadTestDefs(defFile,
+        "\t\"editor_color\" \"0 0 1\"\n\t\"editor_float reload_key\" \"Second description\"\n"
+        "\t\"reload_key\" \"2.5\"\n\t\"added_key\" \"added\"\n",
+        "\t\"child_key\" \"changed\"\n\t\"reload_key\" \"3.5\"\n");
+
+    GlobalEntityClassManager().reloadDefs();
+
+    EXPECT_EQ(grandchild->getAttribute("child_key").getValue(), "changed");
+    EXPECT_EQ(grandchild->getAttribute("reload_key").getValue(), "3.5");
+    EXPECT_EQ(grandchild->getAttributeDescription("reload_key"), "Second description");
+    EXPECT_EQ(grandchild->getAttribute("added_key").getValue(), "added");
+
+    fs::remove(defFile);
+    GlobalEntityClassManager().reloadDefs();
+}
+
+// Benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(EntityTest, DISABLED_EntityClassBenchmark)
+{
+    util::StopWatch timer;
+    GlobalEntityClassManager().reloadDefs();
+    auto reloadMsecs = timer.getMilliSecondsPassed();
+
+    struct ClassCollector :
+        public EntityClassVisitor
+    {
+        std::vector<IEntityClassPtr> classes;
+
+        void visit(const IEntityClassPtr& eclass) override
+        {
+            classes.push_back(eclass);
+        }
+    } collector;
+
+    GlobalEntityClassManager().forEachEntityClass(collector);
+    const auto& classes = collector.classes;
+
+    const std::vector<std::string> keys = { "editor_color", "spawnclass", "model", "inherit",
+        "editor_displayFolder", "AIUse", "editor_usage", "not_existing" };
+
+    constexpr std::size_t NumRounds = 100;
+
+    timer.restart();
+
+    std::size_t lookups = 0;
+    std::size_t nonEmpty = 0;
+
+    for (std::size_t round = 0; round < NumRounds; ++round)
+    {
+        for (const auto& eclass : classes)
+        {
+            for (const auto& key : keys)
+            {
+                nonEmpty += eclass->getAttribute(key).getValue().empty() ? 0 : 1;
+                ++lookups;
+            }
+        }
+    }
+
+    auto lookupMsecs = timer.getMilliSecondsPassed();
+
+    EXPECT_GT(nonEmpty, 0);
+
+    std::cout << "Reloaded " << classes.size() << " entity classes in " << reloadMsecs << " ms, "
+        << lookups << " attribute lookups took " << lookupMsecs << " ms" << std::endl;
+}
+
 TEST_F(EntityTest, CannotCreateEntityWithoutClass)
 {
     // Creating with a null entity class should throw an exception
@@ -416,6 +574,123 @@ TEST_F(EntityTest, UndoRedoSpawnargValueChange)
     EXPECT_EQ(entity.args().getKeyValue("name"), "another_bucket");
 }
 
+TEST_F(EntityTest, LookupOnEntityWithManySpawnargs)
+{
+    auto entity = TestEntity::create("bucket_metal");
+
+    constexpr int NumKeys = 100;
+
+    for (int i = 0; i < NumKeys; ++i)
+    {
+        entity.args().setKeyValue("Key_" + std::to_string(i), std::to_string(i));
+    }
+
+    // Lookups are case-insensitive
+    EXPECT_EQ(entity.args().getKeyValue("key_42"), "42");
+    EXPECT_EQ(entity.args().getKeyValue("KEY_99"), "99");
+    EXPECT_EQ(entity.args().getKeyValue("key_100"), "");
+    EXPECT_FALSE(entity.args().isInherited("kEy_0"));
+
+    // Assigning to a key with different case doesn't add a new key
+    entity.args().setKeyValue("KEY_7", "seven");
+    EXPECT_EQ(entity.args().getKeyValue("key_7"), "seven");
+
+    {
+        UndoableCommand cmd("removeKeyValue");
+        entity.args().setKeyValue("key_10", "");
+    }
+
+    EXPECT_EQ(entity.args().getKeyValue("key_10"), "");
+    EXPECT_EQ(entity.args().getKeyValue("key_11"), "11");
+    EXPECT_EQ(entity.args().getKeyValue("key_99"), "99");
+
+    GlobalUndoSystem().undo();
+    EXPECT_EQ(entity.args().getKeyValue("key_10"), "10");
+    EXPECT_EQ(entity.args().getKeyValue("key_99"), "99");
+
+    // The spawnargs are still visited in insertion order
+    std::vector<std::string> keys;
+    entity.args().forEachKeyValue([&](const std::string& key, const std::string&)
+    {
+        if (string::starts_with(key, "Key_")) keys.push_back(key);
+    }, false);
+
+    ASSERT_EQ(keys.size(), NumKeys);
+
+    for (int i = 0; i < NumKeys; ++i)
+    {
+        EXPECT_EQ(keys[i], "Key_" + std::to_string(i));
+    }
+}
+
+TEST_F(EntityTest, LookupAfterErasingSpawnargs)
+{
+    auto entity = TestEntity::create("bucket_metal");
+
+    constexpr int NumKeys = 40;
+
+    for (int i = 0; i < NumKeys; ++i)
+    {
+        entity.args().setKeyValue("key_" + std::to_string(i), std::to_string(i));
+    }
+
+    // Remove keys from the front, the middle and the back, down to a few keys
+    std::set<int> erased;
+
+    for (int i : { 0, 20, 39, 1, 21, 38, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 22, 23, 24, 25, 26, 27, 28, 29 })
+    {
+        entity.args().setKeyValue("key_" + std::to_string(i), "");
+        erased.insert(i);
+
+        for (int k = 0; k < NumKeys; ++k)
+        {
+            auto expected = erased.count(k) > 0 ? std::string() : std::to_string(k);
+            ASSERT_EQ(entity.args().getKeyValue("KEY_" + std::to_string(k)), expected) << "After erasing key_" << i;
+        }
+    }
+
+    // Keys added after the removals are found too
+    entity.args().setKeyValue("key_20", "twenty");
+    EXPECT_EQ(entity.args().getKeyValue("key_20"), "twenty");
+    EXPECT_EQ(entity.args().getKeyValue("key_37"), "37");
+}
+
+// Benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(EntityTest, DISABLED_SpawnargLookupBenchmark)
+{
+    auto entity = TestEntity::create("bucket_metal");
+
+    constexpr int NumKeys = 250;
+    constexpr int NumRounds = 200;
+
+    util::StopWatch timer;
+
+    for (int i = 0; i < NumKeys; ++i)
+    {
+        entity.args().setKeyValue("key_" + std::to_string(i), std::to_string(i));
+    }
+
+    auto insertMsecs = timer.getMilliSecondsPassed();
+    timer.restart();
+
+    std::size_t found = 0;
+
+    for (int round = 0; round < NumRounds; ++round)
+    {
+        for (int i = 0; i < NumKeys; ++i)
+        {
+            found += entity.args().getKeyValue("KEY_" + std::to_string(i)).empty() ? 0 : 1;
+        }
+    }
+
+    auto lookupMsecs = timer.getMilliSecondsPassed();
+
+    EXPECT_EQ(found, NumKeys * NumRounds);
+
+    std::cout << "Inserted " << NumKeys << " spawnargs in " << insertMsecs << " ms, looked them up "
+        << NumRounds << " times in " << lookupMsecs << " ms" << std::endl;
+}
+
 TEST_F(EntityTest, SelectEntity)
 {
     auto light = createByClassName("light");
@@ -1899,4 +2174,141 @@ TEST_F(EntityTest, GetVariousAttributeTypes)
     EXPECT_EQ(eclass->getAttributeType("a_hurk"), "hurk");
 }
 
-}
\ No newline at end of file
+namespace
+{
+
+// Returns the end points of the target lines starting at the given position
+std::vector<Vector3> getTargetLineEnds(const TestRenderableCollector& collector, const Vector3& start)
+{
+    std::vector<Vector3> ends;
+
+    for (const auto& pair : collector.renderablePtrs)
+    {
+        auto points = dynamic_cast<const RenderablePointVector*>(pair.second);
+
+        // Each target line consists of the line itself and two arrow indicators
+        if (!points || points->size() % 6 != 0) continue;
+
+        for (std::size_t i = 0; i < points->size(); i += 6)
+        {
+            Vector3 end = (*points)[i + 1].vertex;
+
+            if ((*points)[i].vertex == start && (*points)[i + 2].vertex == (start + end) * 0.5)
+            {
+                ends.push_back(end);
+            }
+        }
+    }
+
+    return ends;
+}
+
+std::vector<Vector3> renderTargetLineEnds(const IEntityNodePtr& node, const Vector3& start)
+{
+    RenderFixture rf;
+    rf.renderSubGraph(node);
+
+    return getTargetLineEnds(rf.collector, start);
+}
+
+}
+
+TEST_F(EntityTest, TargetLinesFollowTargetedEntity)
+{
+    auto source = TestEntity::create("light");
+    auto target = TestEntity::create("light");
+
+    source.args().setKeyValue("origin", "0 0 0");
+    target.args().setKeyValue("origin", "128 0 0");
+    target.args().setKeyValue("name", "target_light");
+    source.args().setKeyValue("target", "target_light");
+
+    // The map's target manager resolves the name to the targeted node
+    auto& targetManager = GlobalMapModule().getRoot()->getTargetManager();
+    EXPECT_EQ(targetManager.getTarget("target_light")->getNode(), scene::INodePtr(target.node).get());
+
+    EXPECT_EQ(renderTargetLineEnds(source.node, Vector3(0, 0, 0)), std::vector<Vector3>{ Vector3(128, 0, 0) });
+
+    // Moving the targeted entity updates the line
+    target.args().setKeyValue("origin", "256 64 0");
+    EXPECT_EQ(renderTargetLineEnds(source.node, Vector3(0, 0, 0)), std::vector<Vector3>{ Vector3(256, 64, 0) });
+
+    // Moving the targeting entity too
+    source.args().setKeyValue("origin", "0 0 32");
+    EXPECT_EQ(renderTargetLineEnds(source.node, Vector3(0, 0, 32)), std::vector<Vector3>{ Vector3(256, 64, 0) });
+
+    // Renaming the targeted entity removes the line
+    target.args().setKeyValue("name", "other_light");
+    EXPECT_TRUE(targetManager.getTarget("target_light")->isEmpty());
+    EXPECT_TRUE(renderTargetLineEnds(source.node, Vector3(0, 0, 32)).empty());
+
+    // Adding a second target key pointing to the new name brings it back
+    source.args().setKeyValue("target1", "other_light");
+    EXPECT_EQ(renderTargetLineEnds(source.node, Vector3(0, 0, 32)), std::vector<Vector3>{ Vector3(256, 64, 0) });
+
+    source.args().setKeyValue("target1", "");
+    EXPECT_TRUE(renderTargetLineEnds(source.node, Vector3(0, 0, 32)).empty());
+}
+
+// Benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(EntityTest, DISABLED_TargetLineRenderBenchmark)
+{
+    constexpr int NumEntities = 2000;
+    constexpr int NumFrames = 50;
+
+    // A long chain of lights, each targeting the next one
+    std::vector<IEntityNodePtr> entities;
+
+    for (int i = 0; i < NumEntities; ++i)
+    {
+        auto entity = TestEntity::create("light");
+        entity.args().setKeyValue("origin", string::to_string(Vector3((i % 50) * 64, (i / 50) * 64, 0)));
+        entity.args().setKeyValue("name", "path_" + std::to_string(i));
+
+        if (!entities.empty())
+        {
+            entities.back()->getEntity().setKeyValue("target", "path_" + std::to_string(i));
+        }
+
+        entities.push_back(entity.node);
+    }
+
+    auto root = GlobalMapModule().getRoot();
+
+    RenderFixture rf;
+    rf.renderSubGraph(root);
+
+    auto renderFrame = [&]()
+    {
+        rf.collector.renderables = 0;
+        rf.collector.renderablePtrs.clear();
+        root->traverse(rf);
+    };
+
+    util::StopWatch timer;
+
+    for (int frame = 0; frame < NumFrames; ++frame)
+    {
+        renderFrame();
+    }
+
+    auto unchangedMsecs = timer.getMilliSecondsPassed();
+    timer.restart();
+
+    // Move a different entity before each frame
+    for (int frame = 0; frame < NumFrames; ++frame)
+    {
+        entities[frame]->getEntity().setKeyValue("origin", string::to_string(Vector3(frame * 64, -64, 0)));
+        renderFrame();
+    }
+
+    auto movingMsecs = timer.getMilliSecondsPassed();
+
+    // The line of the first entity follows the moved second one
+    EXPECT_EQ(getTargetLineEnds(rf.collector, Vector3(0, -64, 0)), std::vector<Vector3>{ Vector3(64, -64, 0) });
+
+    std::cout << "Rendered " << NumFrames << " frames with " << (NumEntities - 1) << " target lines in "
+        << unchangedMsecs << " ms, with one entity moving per frame in " << movingMsecs << " ms" << std::endl;
+}
+
+}
@@ -0,0 +1,152 @@
+#include "RadiantTest.h"
+
+#include <iostream>
+#include <regex>
+#include "ifilter.h"
+#include "imap.h"
+#include "ientity.h"
+#include "ieclass.h"
+#include "scenelib.h"
+#include "time/StopWatch.h"
+
+namespace test
+{
+
+using FiltersTest = RadiantTest;
+
+namespace
+{
+
+scene::INodePtr createEntity(const std::string& className, const std::string& name)
+{
+    auto eclass = GlobalEntityClassManager().findOrInsert(className, true);
+    auto entity = GlobalEntityModule().createEntity(eclass);
+
+    Node_getEntity(entity)->setKeyValue("name", name);
+    scene::addNodeToContainer(entity, GlobalMapModule().getRoot());
+
+    return entity;
+}
+
+// Returns true if the given string is hidden by a single hide rule using the given expression
+bool isHiddenByExpression(const std::string& expression, const std::string& name)
+{
+    GlobalFilterSystem().setFilterRules("TestFilter", FilterRules
+    {
+        FilterRule::Create(FilterRule::TYPE_TEXTURE, expression, false)
+    });
+
+    return !GlobalFilterSystem().isVisible(FilterRule::TYPE_TEXTURE, name);
+}
+
+}
+
+TEST_F(FiltersTest, RuleExpressionsMatchLikeRegularExpressions)
+{
+    EXPECT_TRUE(GlobalFilterSystem().addFilter("TestFilter", FilterRules()));
+    GlobalFilterSystem().setFilterState("TestFilter", true);
+
+    std::vector<std::string> expressions =
+    {
+        "textures/common/caulk", "textures/common/.*", ".*caulk", ".*common.*", "^textures/common/clip$",
+        "textures/(.*)/clip", "textures/common/c.*k.*", "textures/common/clip.*", "textures/common/[a-c]+.*",
+        "textures/(common|darkmod)/.*", "textures/common/cau?lk", "textures\\.common", "",
+    };
+
+    std::vector<std::string> names =
+    {
+        "textures/common/caulk", "textures/common/clip", "textures/common/clipper", "textures/darkmod/caulk",
+        "textures.common", "textures/common/", "caulk", "textures/common/clk", "",
+    };
+
+    for (const auto& expression : expressions)
+    {
+        std::regex regex(expression);
+
+        for (const auto& name : names)
+        {
+            EXPECT_EQ(isHiddenByExpression(expression, name), std::regex_match(name, regex))
+                << "Expression " << expression << " doesn't match " << name << " like std::regex";
+        }
+    }
+
+    // Invalid expressions don't match anything
+    EXPECT_FALSE(isHiddenByExpression("textures/(common", "textures/(common"));
+}
+
+TEST_F(FiltersTest, EntityVisibility)
+{
+    auto light = createEntity("light", "light_1");
+    auto speaker = createEntity("speaker", "speaker_1");
+
+    EXPECT_TRUE(GlobalFilterSystem().addFilter("TestFilter", FilterRules
+    {
+        FilterRule::Create(FilterRule::TYPE_ENTITYCLASS, "light.*", false),
+        FilterRule::CreateEntityKeyValueRule("hidden", "1", false),
+    }));
+
+    EXPECT_TRUE(GlobalFilterSystem().isEntityVisible(FilterRule::TYPE_ENTITYCLASS, *Node_getEntity(light)));
+
+    GlobalFilterSystem().setFilterState("TestFilter", true);
+
+    EXPECT_FALSE(GlobalFilterSystem().isEntityVisible(FilterRule::TYPE_ENTITYCLASS, *Node_getEntity(light)));
+    EXPECT_TRUE(GlobalFilterSystem().isEntityVisible(FilterRule::TYPE_ENTITYCLASS, *Node_getEntity(speaker)));
+    EXPECT_TRUE(light->isFiltered());
+    EXPECT_FALSE(speaker->isFiltered());
+
+    // Changing the spawnarg is reflected by the keyvalue rule
+    Node_getEntity(speaker)->setKeyValue("hidden", "1");
+    EXPECT_FALSE(GlobalFilterSystem().isEntityVisible(FilterRule::TYPE_ENTITYKEYVALUE, *Node_getEntity(speaker)));
+
+    Node_getEntity(speaker)->setKeyValue("hidden", "0");
+    EXPECT_TRUE(GlobalFilterSystem().isEntityVisible(FilterRule::TYPE_ENTITYKEYVALUE, *Node_getEntity(speaker)));
+
+    // Changing the rules is taking effect immediately
+    GlobalFilterSystem().setFilterRules("TestFilter", FilterRules
+    {
+        FilterRule::Create(FilterRule::TYPE_ENTITYCLASS, "speaker", false),
+    });
+
+    EXPECT_TRUE(GlobalFilterSystem().isEntityVisible(FilterRule::TYPE_ENTITYCLASS, *Node_getEntity(light)));
+    EXPECT_FALSE(GlobalFilterSystem().isEntityVisible(FilterRule::TYPE_ENTITYCLASS, *Node_getEntity(speaker)));
+    EXPECT_FALSE(light->isFiltered());
+    EXPECT_TRUE(speaker->isFiltered());
+
+    GlobalFilterSystem().setFilterState("TestFilter", false);
+
+    EXPECT_FALSE(light->isFiltered());
+    EXPECT_FALSE(speaker->isFiltered());
+}
+
+// Benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(FiltersTest, DISABLED_FilterToggleBenchmark)
+{
+    constexpr std::size_t NumEntities = 20000;
+
+    for (std::size_t i = 0; i < NumEntities; ++i)
+    {
+        auto entity = createEntity(i % 2 == 0 ? "light" : "func_static", "entity_" + std::to_string(i));
+        Node_getEntity(entity)->setKeyValue("hidden", i % 10 == 0 ? "1" : "0");
+    }
+
+    EXPECT_TRUE(GlobalFilterSystem().addFilter("TestFilter", FilterRules
+    {
+        FilterRule::Create(FilterRule::TYPE_ENTITYCLASS, "light.*", false),
+        FilterRule::CreateEntityKeyValueRule("hidden", "1", false),
+        FilterRule::Create(FilterRule::TYPE_TEXTURE, "textures/common/.*", false),
+    }));
+
+    util::StopWatch timer;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        GlobalFilterSystem().setFilterState("TestFilter", true);
+        GlobalFilterSystem().setFilterState("TestFilter", false);
+    }
+
+    auto msecs = timer.getMilliSecondsPassed();
+
+    std::cout << "Toggled a filter 10 times on " << NumEntities << " entities in " << msecs << " ms" << std::endl;
+}
+
+}
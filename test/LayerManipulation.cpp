@@ -1,9 +1,15 @@
 #include "RadiantTest.h"
 
+#include <iostream>
 #include "imap.h"
 #include "ilayer.h"
+#include "ibrush.h"
+#include "ientity.h"
+#include "ieclass.h"
 #include "algorithm/Scene.h"
+#include "algorithm/Primitives.h"
 #include "scenelib.h"
+#include "time/StopWatch.h"
 
 namespace test
 {
@@ -110,4 +116,198 @@ TEST_F(LayerTest, RemovingFromLayerMarksMapAsModified)
     performMoveOrAddToLayerTest(LayerAction::RemoveFromLayer);
 }
 
+TEST_F(LayerTest, HidingLayerHidesItsMembers)
+{
+    auto& layerManager = GlobalMapModule().getRoot()->getLayerManager();
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto layerId = layerManager.createLayer("TestLayer");
+    auto brush = algorithm::createCubicBrush(worldspawn);
+    auto otherBrush = algorithm::createCubicBrush(worldspawn, Vector3(128, 0, 0));
+
+    brush->moveToLayer(layerId);
+    EXPECT_EQ(brush->getLayerMask(), scene::getLayerMaskBit(layerId));
+
+    layerManager.setLayerVisibility(layerId, false);
+
+    EXPECT_TRUE(brush->checkStateFlag(scene::Node::eLayered));
+    EXPECT_FALSE(otherBrush->checkStateFlag(scene::Node::eLayered));
+    EXPECT_FALSE(worldspawn->checkStateFlag(scene::Node::eLayered));
+
+    layerManager.setLayerVisibility(layerId, true);
+
+    EXPECT_FALSE(brush->checkStateFlag(scene::Node::eLayered));
+
+    // Nodes changing their layers are updated on the next membership change
+    layerManager.setLayerVisibility(layerId, false);
+    otherBrush->addToLayer(layerId);
+    otherBrush->removeFromLayer(0);
+
+    Node_setSelected(otherBrush, true);
+    GlobalCommandSystem().executeCommand("AddSelectionToLayer", cmd::Argument(layerId));
+
+    EXPECT_TRUE(otherBrush->checkStateFlag(scene::Node::eLayered));
+    EXPECT_FALSE(Node_isSelected(otherBrush));
+
+    // Hidden nodes are visible again after their layer has been deleted
+    layerManager.deleteLayer("TestLayer");
+
+    EXPECT_EQ(brush->getLayers(), scene::LayerList{ 0 });
+    EXPECT_FALSE(brush->checkStateFlag(scene::Node::eLayered));
+    EXPECT_FALSE(otherBrush->checkStateFlag(scene::Node::eLayered));
+}
+
+TEST_F(LayerTest, ParentIsVisibleWithVisibleChildren)
+{
+    auto& layerManager = GlobalMapModule().getRoot()->getLayerManager();
+
+    auto entity = GlobalEntityModule().createEntity(GlobalEntityClassManager().findOrInsert("func_static", true));
+    scene::addNodeToContainer(entity, GlobalMapModule().getRoot());
+
+    auto brush = algorithm::createCubicBrush(entity);
+
+    auto entityLayer = layerManager.createLayer("EntityLayer");
+    auto brushLayer = layerManager.createLayer("BrushLayer");
+
+    entity->moveToLayer(entityLayer);
+    brush->moveToLayer(brushLayer);
+
+    // The entity stays visible as long as its child is visible
+    layerManager.setLayerVisibility(entityLayer, false);
+
+    EXPECT_FALSE(entity->checkStateFlag(scene::Node::eLayered));
+    EXPECT_FALSE(brush->checkStateFlag(scene::Node::eLayered));
+
+    layerManager.setLayerVisibility(brushLayer, false);
+
+    EXPECT_TRUE(entity->checkStateFlag(scene::Node::eLayered));
+    EXPECT_TRUE(brush->checkStateFlag(scene::Node::eLayered));
+
+    layerManager.setLayerVisibility(brushLayer, true);
+
+    EXPECT_FALSE(entity->checkStateFlag(scene::Node::eLayered));
+    EXPECT_FALSE(brush->checkStateFlag(scene::Node::eLayered));
+}
+
+TEST_F(LayerTest, LayerIdsBeyondLayerMask)
+{
+    auto& layerManager = GlobalMapModule().getRoot()->getLayerManager();
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto firstLayer = layerManager.createLayer("Layer100", 100);
+    auto secondLayer = layerManager.createLayer("Layer200", 200);
+    EXPECT_EQ(scene::getLayerMaskBit(firstLayer), scene::getLayerMaskBit(secondLayer));
+
+    auto brush = algorithm::createCubicBrush(worldspawn);
+    brush->assignToLayers(scene::LayerList{ firstLayer, secondLayer });
+
+    layerManager.setLayerVisibility(firstLayer, false);
+    EXPECT_FALSE(brush->checkStateFlag(scene::Node::eLayered));
+
+    layerManager.setLayerVisibility(secondLayer, false);
+    EXPECT_TRUE(brush->checkStateFlag(scene::Node::eLayered));
+
+    layerManager.setLayerVisibility(firstLayer, true);
+    EXPECT_FALSE(brush->checkStateFlag(scene::Node::eLayered));
+}
+
+TEST_F(LayerTest, LayerToggleUpdatesReassignedNodes)
+{
+    auto& layerManager = GlobalMapModule().getRoot()->getLayerManager();
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto hiddenLayer = layerManager.createLayer("HiddenLayer");
+    auto otherLayer = layerManager.createLayer("OtherLayer");
+    layerManager.setLayerVisibility(hiddenLayer, false);
+
+    // Reassigned without a membership change being processed afterwards
+    auto brush = algorithm::createCubicBrush(worldspawn);
+    brush->moveToLayer(hiddenLayer);
+    EXPECT_FALSE(brush->checkStateFlag(scene::Node::eLayered));
+
+    // Toggling an unrelated layer brings the reassigned node up to date
+    layerManager.setLayerVisibility(otherLayer, false);
+
+    EXPECT_TRUE(brush->checkStateFlag(scene::Node::eLayered));
+}
+
+TEST_F(LayerTest, BulkLayerAssignmentUpdatesAllNodes)
+{
+    auto& layerManager = GlobalMapModule().getRoot()->getLayerManager();
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto hiddenLayer = layerManager.createLayer("HiddenLayer");
+    layerManager.setLayerVisibility(hiddenLayer, false);
+
+    // More nodes than the layer manager tracks one by one
+    std::vector<scene::INodePtr> brushes;
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        brushes.push_back(algorithm::createCubicBrush(worldspawn, Vector3((i % 100) * 128, (i / 100) * 128, 0)));
+    }
+
+    for (const auto& brush : brushes)
+    {
+        brush->moveToLayer(hiddenLayer);
+    }
+
+    auto visibleBrush = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 512));
+    Node_setSelected(visibleBrush, true);
+    GlobalCommandSystem().executeCommand("AddSelectionToLayer", cmd::Argument(0));
+
+    for (const auto& brush : brushes)
+    {
+        EXPECT_TRUE(brush->checkStateFlag(scene::Node::eLayered));
+    }
+
+    EXPECT_FALSE(visibleBrush->checkStateFlag(scene::Node::eLayered));
+    EXPECT_FALSE(worldspawn->checkStateFlag(scene::Node::eLayered));
+
+    // Showing the layer again goes through the member index as before
+    layerManager.setLayerVisibility(hiddenLayer, true);
+
+    for (const auto& brush : brushes)
+    {
+        EXPECT_FALSE(brush->checkStateFlag(scene::Node::eLayered));
+    }
+}
+
+// Benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(LayerTest, DISABLED_LayerToggleBenchmark)
+{
+    constexpr int NumLayers = 60;
+    constexpr std::size_t NumBrushes = 30000;
+
+    auto& layerManager = GlobalMapModule().getRoot()->getLayerManager();
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    std::vector<int> layerIds;
+
+    for (int i = 0; i < NumLayers; ++i)
+    {
+        layerIds.push_back(layerManager.createLayer("Layer " + std::to_string(i)));
+    }
+
+    for (std::size_t i = 0; i < NumBrushes; ++i)
+    {
+        auto brush = GlobalBrushCreator().createBrush();
+        scene::addNodeToContainer(brush, worldspawn);
+        brush->moveToLayer(layerIds[i % NumLayers]);
+    }
+
+    util::StopWatch timer;
+
+    for (int layerId : layerIds)
+    {
+        layerManager.setLayerVisibility(layerId, false);
+        layerManager.setLayerVisibility(layerId, true);
+    }
+
+    auto msecs = timer.getMilliSecondsPassed();
+
+    std::cout << "Toggled " << NumLayers << " layers of a map with " << NumBrushes << " brushes in "
+        << msecs << " ms" << std::endl;
+}
+
 }
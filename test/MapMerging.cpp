@@ -16,6 +16,11 @@
 #include "scene/merge/ThreeWaySelectionGroupMerger.h"
 #include "scene/merge/ThreeWayLayerMerger.h"
 #include "scene/merge/LayerMerger.h"
+#include "scene/merge/NodeUtils.h"
+#include "time/StopWatch.h"
+#include "util/Parallel.h"
+#include <iostream>
+#include <thread>
 
 namespace test
 {
@@ -291,6 +296,99 @@ inline ComparisonResult::EntityDifference getEntityDifference(const ComparisonRe
     return ComparisonResult::EntityDifference();
 }
 
+// Adds a cubic brush without going through the undo system
+inline scene::INodePtr addCubicBrush(const scene::INodePtr& parent, const Vector3& origin)
+{
+    auto brushNode = GlobalBrushCreator().createBrush();
+    parent->addChildNode(brushNode);
+
+    auto& brush = *Node_getIBrush(brushNode);
+
+    auto translation = Matrix4::getTranslation(origin);
+    brush.addFace(Plane3(+1, 0, 0, 16).transform(translation));
+    brush.addFace(Plane3(-1, 0, 0, 16).transform(translation));
+    brush.addFace(Plane3(0, +1, 0, 16).transform(translation));
+    brush.addFace(Plane3(0, -1, 0, 16).transform(translation));
+    brush.addFace(Plane3(0, 0, +1, 16).transform(translation));
+    brush.addFace(Plane3(0, 0, -1, 16).transform(translation));
+
+    brush.setShader("textures/numbers/1");
+    brush.evaluateBRep();
+
+    return brushNode;
+}
+
+// Parallel sections started from a worker thread (like the child fingerprints
+// of entities) must not spawn another set of threads
+TEST_F(MapMergeTest, NestedParallelSectionsRunSequentially)
+{
+    constexpr std::size_t Count = 256;
+
+    std::vector<std::thread::id> outerThreads(Count);
+    std::vector<std::vector<std::thread::id>> innerThreads(Count, std::vector<std::thread::id>(Count));
+
+    util::forEachIndexInParallel(Count, 1, [&](std::size_t outer)
+    {
+        outerThreads[outer] = std::this_thread::get_id();
+
+        util::forEachIndexInParallel(Count, 1, [&](std::size_t inner)
+        {
+            innerThreads[outer][inner] = std::this_thread::get_id();
+        });
+    });
+
+    for (std::size_t outer = 0; outer < Count; ++outer)
+    {
+        for (std::size_t inner = 0; inner < Count; ++inner)
+        {
+            ASSERT_EQ(innerThreads[outer][inner], outerThreads[outer]) << "Nested section used another thread";
+        }
+    }
+
+    // The outer section has been distributed to worker threads
+    for (const auto& threadId : outerThreads)
+    {
+        EXPECT_NE(threadId, std::this_thread::get_id());
+    }
+}
+
+// Benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(MapMergeTest, DISABLED_GraphComparisonBenchmark)
+{
+    constexpr std::size_t NumBrushes = 20000;
+
+    GlobalCommandSystem().executeCommand("OpenMap", cmd::Argument("maps/fingerprinting.mapx"));
+
+    auto sourceMap = _context.getTestProjectPath() + "maps/fingerprinting.mapx";
+    auto resource = GlobalMapResourceManager().createFromPath(sourceMap);
+    EXPECT_TRUE(resource->load()) << "Test map not found in path " << sourceMap;
+
+    auto sourceWorldspawn = algorithm::findWorldspawn(resource->getRootNode());
+    auto baseWorldspawn = algorithm::findWorldspawn(GlobalMapModule().getRoot());
+
+    for (std::size_t i = 0; i < NumBrushes; ++i)
+    {
+        Vector3 origin(static_cast<double>(i % 100) * 32, static_cast<double>(i / 100) * 32, 4096);
+
+        addCubicBrush(sourceWorldspawn, origin);
+        addCubicBrush(baseWorldspawn, origin);
+    }
+
+    // One brush is present in the source only
+    addCubicBrush(sourceWorldspawn, Vector3(-4096, 0, 0));
+
+    util::StopWatch timer;
+    auto result = GraphComparer::Compare(resource->getRootNode(), GlobalMapModule().getRoot());
+    auto msecs = timer.getMilliSecondsPassed();
+
+    auto diff = getEntityDifference(result, "worldspawn");
+    EXPECT_EQ(diff.type, ComparisonResult::EntityDifference::Type::EntityPresentButDifferent);
+    EXPECT_EQ(countPrimitiveDifference(diff, ComparisonResult::PrimitiveDifference::Type::PrimitiveAdded), 1);
+    EXPECT_EQ(countPrimitiveDifference(diff, ComparisonResult::PrimitiveDifference::Type::PrimitiveRemoved), 0);
+
+    std::cout << "Compared two maps with " << NumBrushes << " brushes in " << msecs << " ms" << std::endl;
+}
+
 TEST_F(MapMergeTest, DetectMissingEntities)
 {
     auto result = performComparison("maps/fingerprinting.mapx", _context.getTestProjectPath() + "maps/fingerprinting_2.mapx");
@@ -2002,6 +2100,48 @@ TEST_F(ThreeWayMergeTest, MergeEntityNameCollisions)
     EXPECT_EQ(Node_getEntity(node_3)->getKeyValue("target0"), newNode4Name);
 }
 
+// Benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(ThreeWayMergeTest, DISABLED_ThreeWayComparisonBenchmark)
+{
+    constexpr std::size_t NumBrushes = 20000;
+
+    auto baseResource = GlobalMapResourceManager().createFromPath("maps/threeway_merge_base.mapx");
+    EXPECT_TRUE(baseResource->load()) << "Base map not found.";
+
+    auto sourceResource = GlobalMapResourceManager().createFromPath("maps/threeway_merge_base.mapx");
+    EXPECT_TRUE(sourceResource->load()) << "Source map not found";
+
+    auto targetResource = GlobalMapResourceManager().createFromPath("maps/threeway_merge_base.mapx");
+    EXPECT_TRUE(targetResource->load()) << "Target map not found";
+
+    auto baseWorldspawn = algorithm::findWorldspawn(baseResource->getRootNode());
+    auto sourceWorldspawn = algorithm::findWorldspawn(sourceResource->getRootNode());
+    auto targetWorldspawn = algorithm::findWorldspawn(targetResource->getRootNode());
+
+    for (std::size_t i = 0; i < NumBrushes; ++i)
+    {
+        Vector3 origin(static_cast<double>(i % 100) * 32, static_cast<double>(i / 100) * 32, 4096);
+
+        addCubicBrush(baseWorldspawn, origin);
+        addCubicBrush(sourceWorldspawn, origin);
+        addCubicBrush(targetWorldspawn, origin);
+    }
+
+    // Source and target both add a different brush
+    addCubicBrush(sourceWorldspawn, Vector3(-4096, 0, 0));
+    addCubicBrush(targetWorldspawn, Vector3(-4096, 256, 0));
+
+    util::StopWatch timer;
+    auto operation = ThreeWayMergeOperation::Create(baseResource->getRootNode(), sourceResource->getRootNode(), targetResource->getRootNode());
+    auto msecs = timer.getMilliSecondsPassed();
+
+    // The brush added in the source is merged into the target
+    auto addActionCount = countActions<AddChildAction>(operation, [](const std::shared_ptr<AddChildAction>& action) { return true; });
+    EXPECT_EQ(addActionCount, 1);
+
+    std::cout << "Compared three maps with " << NumBrushes << " brushes in " << msecs << " ms" << std::endl;
+}
+
 // The source map tries to remove an entity that has been modified in target (func_static_8)
 TEST_F(ThreeWayMergeTest, RemovalOfModifiedEntity)
 {
@@ -9,6 +9,7 @@
 #include "ifilesystem.h"
 #include "iradiant.h"
 #include "iselectiongroup.h"
+#include "ilayer.h"
 #include "ilightnode.h"
 #include "icommandsystem.h"
 #include "messages/ApplicationShutdownRequest.h"
@@ -20,6 +21,7 @@
 #include "algorithm/XmlUtils.h"
 #include "algorithm/Primitives.h"
 #include "os/file.h"
+#include "scenelib.h"
 #include <sigc++/connection.h>
 #include "testutil/FileSelectionHelper.h"
 
@@ -147,13 +149,16 @@ private:
         mapPath /= mapToCopy;
 
         fs::path targetInfoFilePath = fs::path(targetPath).replace_extension("darkradiant");
+        fs::path targetBinaryInfoFilePath = targetInfoFilePath.string() + ".bin";
 
         _pathsToCleanupAfterTest.push_back(targetPath);
         _pathsToCleanupAfterTest.push_back(targetInfoFilePath);
+        _pathsToCleanupAfterTest.push_back(targetBinaryInfoFilePath);
 
-        // Copy both .map and .darkradiant file
+        // Copy both .map and .darkradiant file, the binary info file is written on save
         fs::remove(targetPath);
         fs::remove(targetInfoFilePath);
+        fs::remove(targetBinaryInfoFilePath);
 
         fs::copy(mapPath, targetPath);
         fs::copy(fs::path(mapPath).replace_extension("darkradiant"), targetInfoFilePath);
@@ -509,6 +514,149 @@ TEST_F(MapSavingTest, saveMapWithoutModification)
     conn.disconnect();
 }
 
+namespace
+{
+
+// Returns the layers and selection groups of all entities and primitives, in scene order
+std::vector<std::pair<scene::LayerList, IGroupSelectable::GroupIds>> getLayersAndGroups(const scene::IMapRootNodePtr& root)
+{
+    std::vector<std::pair<scene::LayerList, IGroupSelectable::GroupIds>> result;
+
+    root->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (!Node_isEntity(node) && !Node_isPrimitive(node)) return true;
+
+        auto selectable = std::dynamic_pointer_cast<IGroupSelectable>(node);
+        result.emplace_back(node->getLayers(), selectable ? selectable->getGroupIds() : IGroupSelectable::GroupIds());
+
+        return true;
+    });
+
+    return result;
+}
+
+std::vector<std::pair<scene::LayerList, IGroupSelectable::GroupIds>> loadLayersAndGroups(const fs::path& mapPath)
+{
+    auto resource = GlobalMapResourceManager().createFromPath(mapPath.string());
+    EXPECT_TRUE(resource->load()) << "Could not load map " << mapPath;
+
+    checkAltarScene(resource->getRootNode());
+
+    return getLayersAndGroups(resource->getRootNode());
+}
+
+// Replaces a string of the same length in the given file
+void replaceInFile(const fs::path& path, const std::string& search, const std::string& replacement)
+{
+    std::string contents;
+    {
+        std::ifstream stream(path.string(), std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    auto pos = contents.find(search);
+    ASSERT_NE(pos, std::string::npos) << search << " not found in " << path;
+
+    contents.replace(pos, search.length(), replacement);
+
+    std::ofstream(path.string(), std::ios::binary | std::ios::trunc) << contents;
+}
+
+bool hasLayerAndGroup(const scene::IMapRootNodePtr& root, const std::string& layerName, const std::string& groupName)
+{
+    bool groupFound = false;
+
+    root->getSelectionGroupManager().foreachSelectionGroup([&](selection::ISelectionGroup& group)
+    {
+        groupFound |= group.getName() == groupName;
+    });
+
+    return groupFound && root->getLayerManager().getLayerID(layerName) != -1;
+}
+
+}
+
+TEST_F(MapSavingTest, saveMapWritesBinaryInfoFile)
+{
+    auto tempPath = createMapCopyInTempDataPath("altar.map", "altar_saveMapWritesBinaryInfoFile.map");
+    auto infoFilePath = fs::path(tempPath).replace_extension("darkradiant");
+    auto binaryInfoFilePath = fs::path(infoFilePath.string() + ".bin");
+
+    GlobalCommandSystem().executeCommand("OpenMap", tempPath.string());
+    checkAltarScene();
+
+    auto root = GlobalMapModule().getRoot();
+
+    // Spread the nodes across several layers and nested selection groups
+    auto firstLayer = root->getLayerManager().createLayer("BinaryLayerA");
+    auto secondLayer = root->getLayerManager().createLayer("BinaryLayerB");
+
+    auto outerGroup = root->getSelectionGroupManager().createSelectionGroup();
+    auto innerGroup = root->getSelectionGroupManager().createSelectionGroup();
+    outerGroup->setName("BinaryGroupA");
+    innerGroup->setName("BinaryGroupB");
+
+    std::size_t index = 0;
+
+    root->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (!Node_isEntity(node) && !Node_isPrimitive(node)) return true;
+
+        if (index % 2 == 0) node->addToLayer(firstLayer);
+        if (index % 3 == 0) node->addToLayer(secondLayer);
+
+        if (index % 2 == 1) outerGroup->addNode(node);
+        if (index % 4 == 1) innerGroup->addNode(node);
+
+        ++index;
+        return true;
+    });
+
+    auto expected = getLayersAndGroups(root);
+
+    EXPECT_FALSE(os::fileOrDirExists(binaryInfoFilePath));
+    GlobalCommandSystem().executeCommand("SaveMap");
+    EXPECT_TRUE(os::fileOrDirExists(binaryInfoFilePath));
+
+    // Loading the binary blocks
+    EXPECT_EQ(loadLayersAndGroups(tempPath), expected);
+
+    // Rename a layer and a group in the binary file only, the text file still matches its header.
+    // The names can only show up in the loaded map if the binary blocks have been used.
+    replaceInFile(binaryInfoFilePath, "BinaryLayerB", "BinaryLayerX");
+    replaceInFile(binaryInfoFilePath, "BinaryGroupB", "BinaryGroupX");
+
+    {
+        auto resource = GlobalMapResourceManager().createFromPath(tempPath.string());
+        EXPECT_TRUE(resource->load());
+        EXPECT_EQ(getLayersAndGroups(resource->getRootNode()), expected);
+        EXPECT_TRUE(hasLayerAndGroup(resource->getRootNode(), "BinaryLayerX", "BinaryGroupX"));
+        EXPECT_FALSE(hasLayerAndGroup(resource->getRootNode(), "BinaryLayerB", "BinaryGroupB"));
+    }
+
+    // A truncated binary file is ignored
+    fs::resize_file(binaryInfoFilePath, fs::file_size(binaryInfoFilePath) - 5);
+    EXPECT_EQ(loadLayersAndGroups(tempPath), expected);
+
+    // Save again, then change the text file, the binary file is out of date now
+    GlobalCommandSystem().executeCommand("SaveMap");
+    replaceInFile(binaryInfoFilePath, "BinaryLayerB", "BinaryLayerX");
+    replaceInFile(binaryInfoFilePath, "BinaryGroupB", "BinaryGroupX");
+
+    std::ofstream(infoFilePath.string(), std::ios::app) << "// Edited" << std::endl;
+
+    {
+        auto resource = GlobalMapResourceManager().createFromPath(tempPath.string());
+        EXPECT_TRUE(resource->load());
+        EXPECT_EQ(getLayersAndGroups(resource->getRootNode()), expected);
+        EXPECT_TRUE(hasLayerAndGroup(resource->getRootNode(), "BinaryLayerB", "BinaryGroupB"));
+    }
+
+    // Without a binary file
+    fs::remove(binaryInfoFilePath);
+    EXPECT_EQ(loadLayersAndGroups(tempPath), expected);
+}
+
 TEST_F(MapSavingTest, saveMapClearsModifiedFlag)
 {
     auto tempPath = createMapCopyInTempDataPath("altar.map", "altar_modified_flag_test.map");
@@ -566,6 +714,7 @@ TEST_F(MapSavingTest, saveMapDoesntChangeMap)
     fs::remove(fs::path(copiedMap).replace_extension("bak"));
     fs::remove(fs::path(copiedMap).replace_extension("darkradiant"));
     fs::remove(fs::path(copiedMap).replace_extension("darkradiant").string() + ".bak");
+    fs::remove(fs::path(copiedMap).replace_extension("darkradiant").string() + ".bin");
 }
 
 TEST_F(MapSavingTest, saveMapCreatesInfoFile)
@@ -10,6 +10,13 @@
 #include "scenelib.h"
 #include "os/path.h"
 #include "string/case_conv.h"
+#include "string/replace.h"
+#include "gamelib.h"
+#include "time/StopWatch.h"
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
 
 namespace test
 {
@@ -531,4 +538,638 @@ TEST_F(ModelExportTest, ExportedModelInheritsLayers)
     fs::remove(fullModelPath);
 }
 
+namespace
+{
+
+// Straight port of the original collision model writer, using linear lookups for
+// vertices, edges and polygons. The exporter needs to produce the same output.
+class ReferenceCollisionModel
+{
+    struct Edge
+    {
+        std::size_t from = 0;
+        std::size_t to = 0;
+        std::size_t numVertices = 2;
+    };
+
+    struct Polygon
+    {
+        std::vector<int> edges;
+        Plane3 plane;
+        Vector3 min;
+        Vector3 max;
+    };
+
+    struct BrushStruc
+    {
+        std::vector<Plane3> planes;
+        Vector3 min;
+        Vector3 max;
+    };
+
+    std::vector<Vector3> _vertices;
+    std::vector<Edge> _edges;
+    std::vector<Polygon> _polygons;
+    std::vector<BrushStruc> _brushes;
+
+    static constexpr float MaxPrecision = 0.0001f;
+
+public:
+    ReferenceCollisionModel()
+    {
+        Edge nullEdge;
+        nullEdge.numVertices = 0;
+        _edges.push_back(nullEdge);
+    }
+
+    void addBrush(const scene::INodePtr& node)
+    {
+        const auto& brush = *Node_getIBrush(node);
+        BrushStruc b;
+
+        AABB brushAABB = node->localAABB();
+        b.min = brushAABB.origin - brushAABB.extents;
+        b.max = brushAABB.origin + brushAABB.extents;
+
+        for (std::size_t f = 0; f < brush.getNumFaces(); ++f)
+        {
+            const auto& face = brush.getFace(f);
+            b.planes.push_back(face.getPlane3());
+
+            std::vector<std::size_t> vertexList;
+
+            for (const auto& vertex : face.getWinding())
+            {
+                vertexList.push_back(addVertex(vertex.vertex));
+            }
+
+            vertexList.push_back(addVertex(face.getWinding().front().vertex));
+
+            for (std::size_t i = 0; i < vertexList.size() - 1; ++i)
+            {
+                if (findEdge(vertexList[i], vertexList[i + 1]) == 0)
+                {
+                    Edge edge;
+                    edge.from = vertexList[i];
+                    edge.to = vertexList[i + 1];
+                    _edges.push_back(edge);
+                }
+            }
+
+            Polygon poly;
+
+            for (std::size_t i = 0; i < vertexList.size() - 1; ++i)
+            {
+                poly.edges.push_back(findEdge(vertexList[i], vertexList[i + 1]));
+            }
+
+            if (!removeMatchingPolygon(poly.edges))
+            {
+                AABB faceAABB;
+
+                for (const auto& vertex : face.getWinding())
+                {
+                    faceAABB.includePoint(vertex.vertex);
+                }
+
+                poly.plane = face.getPlane3();
+                poly.min = faceAABB.origin - faceAABB.extents;
+                poly.max = faceAABB.origin + faceAABB.extents;
+                _polygons.push_back(poly);
+            }
+        }
+
+        _brushes.push_back(b);
+    }
+
+    std::string write(const std::string& model) const
+    {
+        std::ostringstream st;
+        auto shader = game::current::getValue<std::string>("/defaults/collisionTexture");
+
+        st << "CM \"1.00\"\n\n0\n\n";
+        st << "collisionModel \"" << model << "\" {\n";
+
+        st << "\tvertices { /* numVertices = */ " << _vertices.size() << "\n";
+        for (std::size_t i = 0; i < _vertices.size(); ++i)
+        {
+            st << "\t/* " << i << " */ ";
+            writeVector(st, _vertices[i]);
+            st << "\n";
+        }
+        st << "\t}\n";
+
+        st << "\tedges { /* numEdges = */ " << _edges.size() << "\n";
+        for (std::size_t i = 0; i < _edges.size(); ++i)
+        {
+            st << "\t/* " << i << " */ ( " << _edges[i].from << " " << _edges[i].to << " ) 0 " << _edges[i].numVertices << "\n";
+        }
+        st << "\t}\n";
+
+        st << "\tnodes {\n\t( -1 0 )\n\t}\n";
+
+        st << "\tpolygons {\n";
+        for (const auto& poly : _polygons)
+        {
+            st << "\t" << poly.edges.size() << " (";
+            for (int edge : poly.edges) st << " " << edge;
+            st << " ) ";
+            writeVector(st, poly.plane.normal());
+            st << " " << poly.plane.dist() << " ";
+            writeVector(st, poly.min);
+            st << " ";
+            writeVector(st, poly.max);
+            st << " \"" << shader << "\"\n";
+        }
+        st << "\t}\n";
+
+        std::size_t faceCount = 0;
+        for (const auto& b : _brushes) faceCount += b.planes.size();
+
+        st << "\tbrushes /* brushMemory = */ " << faceCount * 16 + _brushes.size() * 44 << " {\n";
+        for (const auto& b : _brushes)
+        {
+            st << "\t" << b.planes.size() << " {\n";
+            for (const auto& plane : b.planes)
+            {
+                st << "\t\t";
+                writeVector(st, plane.normal());
+                st << " " << plane.dist() << "\n";
+            }
+            st << "\t} ";
+            writeVector(st, b.min);
+            st << " ";
+            writeVector(st, b.max);
+            st << " \"solid\"\n";
+        }
+        st << "\t}\n";
+
+        st << "}\n";
+
+        return st.str();
+    }
+
+private:
+    static void writeVector(std::ostream& st, const Vector3& vector)
+    {
+        Vector3 snapped = vector.getSnapped(MaxPrecision);
+        st << "( " << snapped[0] << " " << snapped[1] << " " << snapped[2] << " )";
+    }
+
+    std::size_t addVertex(const Vector3& vertex)
+    {
+        Vector3 snapped = vertex.getSnapped(MaxPrecision);
+
+        for (std::size_t i = 0; i < _vertices.size(); ++i)
+        {
+            if (_vertices[i] == snapped) return i;
+        }
+
+        _vertices.push_back(snapped);
+        return _vertices.size() - 1;
+    }
+
+    int findEdge(std::size_t from, std::size_t to) const
+    {
+        for (std::size_t i = 0; i < _edges.size(); ++i)
+        {
+            if (_edges[i].from == from && _edges[i].to == to) return static_cast<int>(i);
+            if (_edges[i].from == to && _edges[i].to == from) return -static_cast<int>(i);
+        }
+
+        return 0;
+    }
+
+    bool removeMatchingPolygon(const std::vector<int>& edges)
+    {
+        for (std::size_t p = 0; p < _polygons.size(); ++p)
+        {
+            if (_polygons[p].edges.size() != edges.size()) continue;
+
+            std::size_t matches = 0;
+
+            for (int existing : _polygons[p].edges)
+            {
+                for (int edge : edges)
+                {
+                    if (std::abs(existing) == std::abs(edge)) ++matches;
+                }
+            }
+
+            if (matches == edges.size())
+            {
+                _polygons.erase(_polygons.begin() + p);
+                return true;
+            }
+        }
+
+        return false;
+    }
+};
+
+scene::INodePtr createCollisionModelEntity()
+{
+    auto eclass = GlobalEntityClassManager().findClass("func_static");
+    auto entity = GlobalEntityModule().createEntity(eclass);
+
+    scene::addNodeToContainer(entity, GlobalMapModule().getRoot());
+
+    return entity;
+}
+
+// Exports the given entity's brushes and returns the contents of the written file
+std::string exportCollisionModel(const scene::INodePtr& entity, const std::string& modelPath)
+{
+    GlobalSelectionSystem().setSelectedAll(false);
+    Node_setSelected(entity, true);
+
+    GlobalCommandSystem().executeCommand("ExportSelectedAsCollisionModel", cmd::Argument(modelPath));
+
+    auto cmPath = os::replaceExtension(GlobalGameManager().getModPath() + modelPath,
+        "." + game::current::getValue<std::string>("/defaults/collisionModelExt"));
+
+    std::ifstream stream(cmPath);
+    std::stringstream contents;
+    contents << stream.rdbuf();
+    stream.close();
+
+    fs::remove(cmPath);
+
+    return contents.str();
+}
+
+std::string getReferenceCollisionModel(const scene::INodePtr& entity, const std::string& modelPath)
+{
+    ReferenceCollisionModel reference;
+
+    entity->foreachNode([&](const scene::INodePtr& child)
+    {
+        if (Node_isBrush(child))
+        {
+            reference.addBrush(child);
+        }
+        return true;
+    });
+
+    return reference.write(modelPath);
+}
+
+}
+
+TEST_F(ModelExportTest, CollisionModelMatchesReference)
+{
+    auto entity = createCollisionModelEntity();
+
+    // A block of touching cubes, the faces between them cancel out
+    for (int x = 0; x < 3; ++x)
+    {
+        for (int y = 0; y < 2; ++y)
+        {
+            algorithm::createCubicBrush(entity, Vector3(x * 128, y * 128, 0));
+        }
+    }
+
+    // A brush with slanted faces and a stacked cube sharing a face with it
+    auto wedge = GlobalBrushCreator().createBrush();
+    scene::addNodeToContainer(wedge, entity);
+
+    auto& brush = *Node_getIBrush(wedge);
+    brush.addFace(Plane3(Vector3(1, 1, 0).getNormalised(), 300));
+    brush.addFace(Plane3(-1, 0, 0, 64));
+    brush.addFace(Plane3(0, -1, 0, 64));
+    brush.addFace(Plane3(0, 0, 1, 300));
+    brush.addFace(Plane3(0, 0, -1, -64));
+    brush.addFace(Plane3(Vector3(0.3, 0.1, 1).getNormalised(), 290.3333));
+    brush.setShader("_default");
+    brush.evaluateBRep();
+
+    algorithm::createCubicBrush(entity, Vector3(0, 0, -128));
+
+    auto exported = exportCollisionModel(entity, "models/collision_export_test.ase");
+
+    EXPECT_FALSE(exported.empty()) << "No collision model has been written";
+    EXPECT_EQ(exported, getReferenceCollisionModel(entity, "models/collision_export_test.ase"));
+}
+
+TEST_F(ModelExportTest, LargeCollisionModelMatchesReference)
+{
+    auto entity = createCollisionModelEntity();
+
+    // Enough brushes to have their geometry collected in parallel (64 or more)
+    for (int i = 0; i < 100; ++i)
+    {
+        algorithm::createCubicBrush(entity, Vector3((i % 5) * 128, (i / 5 % 5) * 128, (i / 25) * 128));
+    }
+
+    // Some overlapping slanted brushes resting on top of the block
+    for (int i = 0; i < 4; ++i)
+    {
+        auto wedge = GlobalBrushCreator().createBrush();
+        scene::addNodeToContainer(wedge, entity);
+
+        auto& brush = *Node_getIBrush(wedge);
+        brush.addFace(Plane3(Vector3(1, 1, 0).getNormalised(), 64 + i * 128));
+        brush.addFace(Plane3(-1, 0, 0, 64 - i * 128));
+        brush.addFace(Plane3(0, -1, 0, 64));
+        brush.addFace(Plane3(0, 0, 1, 512));
+        brush.addFace(Plane3(0, 0, -1, -448));
+        brush.setShader("_default");
+        brush.evaluateBRep();
+    }
+
+    auto exported = exportCollisionModel(entity, "models/collision_export_large_test.ase");
+
+    EXPECT_FALSE(exported.empty()) << "No collision model has been written";
+    EXPECT_EQ(exported, getReferenceCollisionModel(entity, "models/collision_export_large_test.ase"));
+}
+
+// Benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(ModelExportTest, DISABLED_CollisionModelExportBenchmark)
+{
+    auto entity = createCollisionModelEntity();
+
+    // 5000 touching cubes, such that most vertices, edges and faces are shared
+    constexpr int NumBrushes = 5000;
+
+    for (int i = 0; i < NumBrushes; ++i)
+    {
+        algorithm::createCubicBrush(entity, Vector3((i % 25) * 128, (i / 25 % 20) * 128, (i / 500) * 128));
+    }
+
+    util::StopWatch timer;
+    auto exported = exportCollisionModel(entity, "models/collision_export_benchmark.ase");
+    auto msecs = timer.getMilliSecondsPassed();
+
+    EXPECT_FALSE(exported.empty()) << "No collision model has been written";
+
+    std::cout << "Exported a collision model of " << NumBrushes << " brushes (" << exported.size() / 1024
+        << " kB) in " << msecs << " ms" << std::endl;
+}
+
+namespace
+{
+
+std::string readFileContents(const fs::path& path)
+{
+    std::ifstream stream(path.string(), std::ios::binary);
+    std::stringstream contents;
+    contents << stream.rdbuf();
+
+    return contents.str();
+}
+
+// Deterministic polygons with awkward numbers and vertex colours, the golden
+// files in resources/export/ have been written from these by the exporters
+// before they were changed to buffer their output
+std::vector<model::ModelPolygon> createGoldenExportPolygons(std::size_t surface)
+{
+    std::vector<model::ModelPolygon> polys;
+
+    auto createVertex = [&](std::size_t index)
+    {
+        auto a = static_cast<double>((index * 37 + surface * 11) % 101);
+        auto b = static_cast<double>((index * 53 + surface * 7) % 89);
+
+        return ArbitraryMeshVertex(
+            Vertex3f(a * 1.25 - 60.5, b / 3 - 14.0, (a - b) * 0.1 + 1e-4 * index),
+            Normal3f(index % 3 == 0 ? 1 : 0, index % 3 == 1 ? -1 : 0, index % 3 == 2 ? 1 : 0),
+            TexCoord2f(a / 7, -b / 11),
+            Vector3((index % 5) * 0.25, 1.0 / (1 + index % 3), surface * 0.5));
+    };
+
+    for (std::size_t i = 0; i < 20; ++i)
+    {
+        polys.emplace_back(model::ModelPolygon{ createVertex(i * 3), createVertex(i * 3 + 1), createVertex(i * 3 + 2) });
+    }
+
+    return polys;
+}
+
+ArbitraryMeshVertex convertWindingVertex(const WindingVertex& in)
+{
+    ArbitraryMeshVertex out;
+
+    out.vertex = in.vertex;
+    out.normal = in.normal;
+    out.texcoord = in.texcoord;
+    out.bitangent = in.bitangent;
+    out.tangent = in.tangent;
+    out.colour.set(1.0, 1.0, 1.0);
+
+    return out;
+}
+
+// Feeds the brush faces to the given exporter, the same way the ModelExporter does
+void addBrushToExporter(const scene::INodePtr& node, const model::IModelExporterPtr& exporter)
+{
+    auto brush = Node_getIBrush(node);
+    auto exportTransform = node->localToWorld().getPremultipliedBy(Matrix4::getIdentity());
+
+    for (std::size_t f = 0; f < brush->getNumFaces(); ++f)
+    {
+        const auto& face = brush->getFace(f);
+        const auto& winding = face.getWinding();
+
+        std::vector<model::ModelPolygon> polys;
+
+        for (std::size_t i = 1; i < winding.size() - 1; ++i)
+        {
+            model::ModelPolygon poly;
+
+            poly.a = convertWindingVertex(winding[i + 1]);
+            poly.b = convertWindingVertex(winding[i]);
+            poly.c = convertWindingVertex(winding[0]);
+
+            polys.push_back(poly);
+        }
+
+        exporter->addPolygons(face.getShader(), polys, exportTransform);
+    }
+}
+
+}
+
+// The text exporters need to format the numbers exactly like std::ostream
+TEST_F(ModelExportTest, ObjNumberFormatting)
+{
+    auto exporter = GlobalModelFormatManager().getExporter("obj");
+
+    std::vector<model::ModelPolygon> polys;
+
+    polys.emplace_back(model::ModelPolygon
+    {
+        ArbitraryMeshVertex(Vertex3f(0.1, -2.5, 1e7), Normal3f(1,0,0), TexCoord2f(0.333333333, -0.0)),
+        ArbitraryMeshVertex(Vertex3f(123.456789, 0, -0.000012345), Normal3f(1,0,0), TexCoord2f(1e-5, 12345.65)),
+        ArbitraryMeshVertex(Vertex3f(-999999.5, 1.0 / 3, 65536), Normal3f(1,0,0), TexCoord2f(-7.25, 2.0 / 3))
+    });
+
+    exporter->addPolygons(CustomMaterialName, polys, Matrix4::getIdentity());
+
+    fs::path outputPath = _context.getTemporaryDataPath();
+    exporter->exportToPath(outputPath.string(), "number_format.obj");
+
+    // Reference output, written through std::ostream
+    std::ostringstream expected;
+    expected << "# Generated by DarkRadiant's OBJ file exporter" << std::endl;
+    expected << "mtllib number_format.mtl" << std::endl << std::endl;
+    expected << "g " << CustomMaterialName << std::endl;
+    expected << "usemtl " << CustomMaterialName << std::endl << std::endl;
+
+    for (const auto& vertex : { polys[0].a, polys[0].b, polys[0].c })
+    {
+        expected << "v " << vertex.vertex.x() << " " << vertex.vertex.y() << " " << vertex.vertex.z() << "\n";
+    }
+    expected << std::endl;
+
+    for (const auto& vertex : { polys[0].a, polys[0].b, polys[0].c })
+    {
+        expected << "vt " << vertex.texcoord.x() << " " << -vertex.texcoord.y() << "\n";
+    }
+    expected << std::endl;
+
+    expected << "f 1/1 2/2 3/3\n" << std::endl;
+
+    EXPECT_EQ(readFileContents(outputPath / "number_format.obj"), expected.str());
+
+    fs::remove(outputPath / "number_format.obj");
+    fs::remove(outputPath / "number_format.mtl");
+}
+
+// Large selections are collected in parallel, the result needs to be the same
+// as the one of adding all the nodes sequentially in the order of the scene
+TEST_F(ModelExportTest, ParallelExportMatchesSequentialExport)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    // Brushes with a few different materials, enough to have them processed in parallel
+    const std::vector<std::string> materials = { "textures/numbers/1", "textures/numbers/2", "_default" };
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto brush = algorithm::createCubicBrush(worldspawn,
+            Vector3((i % 10) * 128.5, (i / 10 % 10) * 130, (i / 100) * 129), materials[i % materials.size()]);
+        Node_setSelected(brush, true);
+    }
+
+    fs::path outputPath = _context.getTemporaryDataPath();
+
+    for (const std::string format : { "obj", "ase", "lwo" })
+    {
+        auto filename = "parallel_export." + format;
+
+        cmd::ArgumentList argList;
+
+        argList.push_back((outputPath / "exported" / filename).string());
+        argList.push_back(format);
+        argList.push_back(false); // centerObjects
+        argList.push_back(false); // skipCaulk
+        argList.push_back(false); // replaceSelectionWithModel
+        argList.push_back(false); // useEntityOrigin
+        argList.push_back(false); // exportLightsAsObjects
+
+        GlobalCommandSystem().executeCommand("ExportSelectedAsModel", argList);
+
+        auto reference = GlobalModelFormatManager().getExporter(format);
+
+        worldspawn->foreachNode([&](const scene::INodePtr& node)
+        {
+            addBrushToExporter(node, reference);
+            return true;
+        });
+
+        reference->exportToPath((outputPath / "reference").string(), filename);
+
+        auto exported = readFileContents(outputPath / "exported" / filename);
+
+        EXPECT_FALSE(exported.empty()) << "Nothing exported to " << filename;
+        EXPECT_TRUE(exported == readFileContents(outputPath / "reference" / filename)) << filename << " differs from the reference";
+    }
+
+    fs::remove_all(outputPath / "exported");
+    fs::remove_all(outputPath / "reference");
+}
+
+TEST_F(ModelExportTest, ExportMatchesGoldenFiles)
+{
+    const std::vector<std::string> materials = { "textures/numbers/1", "textures/numbers/2", "models/golden/export_test" };
+
+    auto transform = Matrix4::getTranslation(Vector3(16, -32, 8.5)).getMultipliedBy(Matrix4::getScale(Vector3(2, 2, 0.5)));
+    fs::path outputPath = _context.getTemporaryDataPath();
+    fs::path goldenPath = _context.getTestResourcePath();
+    goldenPath /= "export";
+
+    for (const std::string format : { "ase", "lwo" })
+    {
+        auto filename = "golden_export." + format;
+        auto exporter = GlobalModelFormatManager().getExporter(format);
+
+        for (std::size_t s = 0; s < materials.size(); ++s)
+        {
+            exporter->addPolygons(materials[s], createGoldenExportPolygons(s), transform);
+        }
+
+        exporter->exportToPath(outputPath.string(), filename);
+
+        auto exported = readFileContents(outputPath / filename);
+        auto golden = readFileContents(goldenPath / filename);
+
+        // The text formats are written with the platform's line endings
+        if (format == "ase")
+        {
+            string::replace_all(exported, "\r", "");
+            string::replace_all(golden, "\r", "");
+        }
+
+        EXPECT_FALSE(golden.empty()) << "Golden file " << filename << " not found";
+        EXPECT_TRUE(exported == golden) << filename << " differs from the golden file";
+
+        fs::remove(outputPath / filename);
+    }
+}
+
+// Benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(ModelExportTest, DISABLED_ModelExportBenchmark)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    constexpr int NumBrushes = 5000;
+
+    for (int i = 0; i < NumBrushes; ++i)
+    {
+        auto brush = algorithm::createCubicBrush(worldspawn,
+            Vector3((i % 25) * 128, (i / 25 % 20) * 128, (i / 500) * 128), "textures/numbers/1");
+        Node_setSelected(brush, true);
+    }
+
+    fs::path outputPath = _context.getTemporaryDataPath();
+
+    for (const std::string format : { "obj", "ase", "lwo" })
+    {
+        auto outputFile = outputPath / ("export_benchmark." + format);
+
+        cmd::ArgumentList argList;
+
+        argList.push_back(outputFile.string());
+        argList.push_back(format);
+        argList.push_back(true); // centerObjects
+        argList.push_back(false); // skipCaulk
+        argList.push_back(false); // replaceSelectionWithModel
+        argList.push_back(false); // useEntityOrigin
+        argList.push_back(false); // exportLightsAsObjects
+
+        util::StopWatch timer;
+        GlobalCommandSystem().executeCommand("ExportSelectedAsModel", argList);
+        auto msecs = timer.getMilliSecondsPassed();
+
+        EXPECT_TRUE(fs::exists(outputFile));
+
+        std::cout << "Exported " << NumBrushes << " brushes to " << format << " ("
+            << fs::file_size(outputFile) / 1024 << " kB) in " << msecs << " ms" << std::endl;
+
+        fs::remove(outputFile);
+    }
+
+    fs::remove(outputPath / "export_benchmark.mtl");
+}
+
 }
@@ -1,10 +1,16 @@
 #include "RadiantTest.h"
 
+#include <iostream>
 #include <unordered_set>
+#include "ifilesystem.h"
 #include "imodelsurface.h"
 #include "imodelcache.h"
+#include "imd5anim.h"
+#include "imd5model.h"
 
+#include "os/dir.h"
 #include "render/VertexHashing.h"
+#include "time/StopWatch.h"
 
 namespace test
 {
@@ -453,4 +459,369 @@ TEST_F(ModelTest, LoadFbxModel)
     EXPECT_EQ(model->getPolyCount(), 12);
 }
 
+TEST_F(ModelTest, PrefetchedModelsAreCached)
+{
+    auto statisticsBefore = GlobalModelCache().getStatistics();
+
+    GlobalModelCache().prefetchModels({
+        "models/darkmod/test/unit_cube.ase",
+        "models/darkmod/test/unit_cube.lwo",
+        "func_static_1", // brush-based entity, no model file
+    });
+
+    auto statistics = GlobalModelCache().getStatistics();
+    EXPECT_EQ(statistics.modelsPrefetched - statisticsBefore.modelsPrefetched, 2);
+
+    auto aseModel = GlobalModelCache().getModel("models/darkmod/test/unit_cube.ase");
+    auto lwoModel = GlobalModelCache().getModel("models/darkmod/test/unit_cube.lwo");
+
+    ASSERT_TRUE(aseModel);
+    ASSERT_TRUE(lwoModel);
+    EXPECT_EQ(aseModel->getPolyCount(), 12);
+    EXPECT_EQ(lwoModel->getPolyCount(), 12);
+
+    // The prefetched models ended up in the cache
+    EXPECT_EQ(GlobalModelCache().getModel("models/darkmod/test/unit_cube.ase"), aseModel);
+    EXPECT_EQ(GlobalModelCache().getModel("models/darkmod/test/unit_cube.lwo"), lwoModel);
+
+    // Prefetching cached models doesn't do anything
+    GlobalModelCache().prefetchModels({ "models/darkmod/test/unit_cube.ase" });
+    EXPECT_EQ(GlobalModelCache().getStatistics().modelsPrefetched, statistics.modelsPrefetched);
+}
+
+// The material fallback is resolved on the main thread, the result must match a regular load
+TEST_F(AseImportTest, PrefetchedModelsKeepBitmapMaterial)
+{
+    GlobalModelCache().prefetchModels({ "models/missing_texture.ase" });
+
+    auto model = GlobalModelCache().getModel("models/missing_texture.ase");
+    ASSERT_TRUE(model);
+
+    EXPECT_EQ(model->getSurfaceCount(), 1);
+    EXPECT_EQ(model->getSurface(0).getDefaultMaterial(), "textures/doesnt_exist");
+}
+
+TEST_F(ModelTest, ClearDiscardsPrefetchedModels)
+{
+    GlobalModelCache().prefetchModels({ "models/darkmod/test/unit_cube.ase" });
+    GlobalModelCache().clear();
+
+    // The model is loaded again after clearing the cache
+    auto loadedBefore = GlobalModelCache().getStatistics().modelsLoaded;
+    auto model = GlobalModelCache().getModel("models/darkmod/test/unit_cube.ase");
+
+    EXPECT_TRUE(model);
+    EXPECT_EQ(GlobalModelCache().getStatistics().modelsLoaded, loadedBefore + 1);
+}
+
+TEST_F(ModelTest, RemoveModelDiscardsPrefetchedModel)
+{
+    GlobalModelCache().prefetchModels({ "models/darkmod/test/unit_cube.ase", "models/darkmod/test/unit_cube.lwo" });
+
+    // The worker is either skipping the model or done with it when this returns
+    GlobalModelCache().removeModel("models/darkmod/test/unit_cube.ase");
+
+    auto loadedBefore = GlobalModelCache().getStatistics().modelsLoaded;
+    auto model = GlobalModelCache().getModel("models/darkmod/test/unit_cube.ase");
+
+    ASSERT_TRUE(model);
+    EXPECT_EQ(model->getPolyCount(), 12);
+    EXPECT_EQ(GlobalModelCache().getStatistics().modelsLoaded, loadedBefore + 1);
+
+    // The other prefetched model is still there
+    auto lwoModel = GlobalModelCache().getModel("models/darkmod/test/unit_cube.lwo");
+    ASSERT_TRUE(lwoModel);
+    EXPECT_EQ(GlobalModelCache().getStatistics().modelsLoaded, loadedBefore + 1);
+}
+
+namespace
+{
+
+inline void expectIdenticalVertex(const ArbitraryMeshVertex& a, const ArbitraryMeshVertex& b)
+{
+    EXPECT_EQ(a.vertex, b.vertex);
+    EXPECT_EQ(a.normal, b.normal);
+    EXPECT_EQ(a.texcoord, b.texcoord);
+    EXPECT_EQ(a.tangent, b.tangent);
+    EXPECT_EQ(a.bitangent, b.bitangent);
+    EXPECT_EQ(a.colour, b.colour);
+}
+
+void expectIdenticalModels(const model::IModelPtr& model, const model::IModelPtr& other)
+{
+    ASSERT_EQ(model->getSurfaceCount(), other->getSurfaceCount());
+    EXPECT_EQ(model->getFilename(), other->getFilename());
+    EXPECT_EQ(model->getModelPath(), other->getModelPath());
+
+    for (int i = 0; i < model->getSurfaceCount(); ++i)
+    {
+        auto& surface = dynamic_cast<const model::IIndexedModelSurface&>(model->getSurface(i));
+        auto& otherSurface = dynamic_cast<const model::IIndexedModelSurface&>(other->getSurface(i));
+
+        EXPECT_EQ(surface.getDefaultMaterial(), otherSurface.getDefaultMaterial());
+        EXPECT_EQ(surface.getIndexArray(), otherSurface.getIndexArray());
+        ASSERT_EQ(surface.getVertexArray().size(), otherSurface.getVertexArray().size());
+
+        for (std::size_t v = 0; v < surface.getVertexArray().size(); ++v)
+        {
+            expectIdenticalVertex(surface.getVertexArray()[v], otherSurface.getVertexArray()[v]);
+        }
+    }
+}
+
+// Returns the paths of all static models in the test resources
+std::vector<std::string> getStaticModelPaths()
+{
+    std::vector<std::string> paths;
+
+    for (auto extension : { "ase", "lwo", "obj" })
+    {
+        GlobalFileSystem().forEachFile("models/", extension, [&](const vfs::FileInfo& fileInfo)
+        {
+            paths.push_back(fileInfo.fullPath());
+        }, 99);
+    }
+
+    return paths;
+}
+
+}
+
+TEST_F(ModelTest, BinaryCacheRestoresIdenticalModels)
+{
+    // The test context starts with an empty cache folder
+    std::vector<model::IModelPtr> importedModels;
+    auto statistics = GlobalModelCache().getStatistics();
+
+    for (const auto& path : getStaticModelPaths())
+    {
+        auto model = GlobalModelCache().getModel(path);
+
+        ASSERT_TRUE(model) << "Failed to load " << path;
+        importedModels.push_back(model);
+    }
+
+    // Nothing is cached on disk yet
+    EXPECT_EQ(GlobalModelCache().getStatistics().modelsReadFromBinaryCache, statistics.modelsReadFromBinaryCache);
+
+    // After clearing the in-memory cache, the models are read back from disk
+    GlobalModelCache().clear();
+
+    for (const auto& importedModel : importedModels)
+    {
+        auto cachedModel = GlobalModelCache().getModel(importedModel->getModelPath());
+
+        ASSERT_TRUE(cachedModel);
+        EXPECT_NE(cachedModel, importedModel);
+        expectIdenticalModels(importedModel, cachedModel);
+    }
+
+    EXPECT_EQ(GlobalModelCache().getStatistics().modelsReadFromBinaryCache - statistics.modelsReadFromBinaryCache,
+        importedModels.size());
+}
+
+// Benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(ModelTest, DISABLED_BinaryCacheColdVersusWarmLoad)
+{
+    auto paths = getStaticModelPaths();
+
+    constexpr std::size_t NumIterations = 20;
+
+    std::size_t coldMsecs = 0;
+    std::size_t warmMsecs = 0;
+
+    for (std::size_t i = 0; i < NumIterations; ++i)
+    {
+        // Cold: remove the files from disk, every model is imported
+        os::removeDirectory(_context.getCacheDataPath() + "models/");
+        GlobalModelCache().clear();
+
+        util::StopWatch timer;
+
+        for (const auto& path : paths)
+        {
+            GlobalModelCache().getModel(path);
+        }
+
+        coldMsecs += timer.getMilliSecondsPassed();
+
+        // Warm: the models are read from the files written during the cold pass
+        GlobalModelCache().clear();
+        timer.restart();
+
+        for (const auto& path : paths)
+        {
+            GlobalModelCache().getModel(path);
+        }
+
+        warmMsecs += timer.getMilliSecondsPassed();
+    }
+
+    EXPECT_GE(GlobalModelCache().getStatistics().modelsReadFromBinaryCache, paths.size() * NumIterations);
+
+    std::cout << "Loaded " << paths.size() * NumIterations << " models: " << coldMsecs << " ms cold, "
+        << warmMsecs << " ms from the binary cache" << std::endl;
+}
+
+namespace
+{
+
+const char* const TubeMeshPath = "models/md5/test/tube.md5mesh";
+const char* const TubeAnimPath = "models/md5/test/tube_bend.md5anim";
+const char* const TubeAnimCopyPath = "models/md5/test/tube_bend_copy.md5anim";
+const char* const TubeAnimTruncatedPath = "models/md5/test/tube_bend_truncated.md5anim";
+
+std::vector<Vector3> getVertexPositions(const model::IModel& model)
+{
+    std::vector<Vector3> positions;
+
+    for (int s = 0; s < model.getSurfaceCount(); ++s)
+    {
+        const auto& surface = model.getSurface(s);
+
+        for (int v = 0; v < surface.getNumVertices(); ++v)
+        {
+            positions.push_back(surface.getVertex(v).vertex);
+        }
+    }
+
+    return positions;
+}
+
+}
+
+TEST_F(ModelTest, MD5AnimationSkinning)
+{
+    auto model = GlobalModelCache().getModel(TubeMeshPath);
+    ASSERT_TRUE(model);
+
+    auto md5Model = std::dynamic_pointer_cast<md5::IMD5Model>(model);
+    ASSERT_TRUE(md5Model);
+
+    auto anim = GlobalAnimationCache().getAnim(TubeAnimPath);
+    ASSERT_TRUE(anim);
+
+    auto bindPose = getVertexPositions(*model);
+    ASSERT_FALSE(bindPose.empty());
+
+    // The first frame of the test anim matches the bind pose of the mesh
+    md5Model->setAnim(anim);
+    md5Model->updateAnim(0);
+
+    auto firstFrame = getVertexPositions(*model);
+    ASSERT_EQ(firstFrame.size(), bindPose.size());
+
+    for (std::size_t i = 0; i < bindPose.size(); ++i)
+    {
+        EXPECT_TRUE(math::isNear(firstFrame[i], bindPose[i], 0.01)) << "Vertex " << i << " differs";
+    }
+
+    // In frame 6 the root joint has moved 8 units along the y axis, the
+    // vertices of the first ring are only attached to the root joint
+    md5Model->updateAnim(250);
+
+    auto sixthFrame = getVertexPositions(*model);
+    constexpr std::size_t VerticesPerRing = 16;
+
+    for (std::size_t i = 0; i < VerticesPerRing; ++i)
+    {
+        EXPECT_TRUE(math::isNear(sixthFrame[i], bindPose[i] + Vector3(0, 8, 0), 0.01)) << "Vertex " << i << " differs";
+    }
+
+    // The joints further up the tube are bent
+    EXPECT_FALSE(math::isNear(sixthFrame.back(), bindPose.back() + Vector3(0, 8, 0), 1.0));
+
+    // Going back to the first frame restores the same vertices
+    md5Model->updateAnim(0);
+    EXPECT_EQ(getVertexPositions(*model), firstFrame);
+
+    md5Model->setAnim(md5::IMD5AnimPtr());
+}
+
+TEST_F(ModelTest, MD5IdenticalAnimsAreShared)
+{
+    auto anim = GlobalAnimationCache().getAnim(TubeAnimPath);
+    auto copy = GlobalAnimationCache().getAnim(TubeAnimCopyPath);
+
+    ASSERT_TRUE(anim);
+    EXPECT_EQ(anim, copy) << "Files with the same contents should share the anim";
+
+    // All frames can be decoded, the poses stay valid while held
+    auto firstPose = anim->getFramePose(0);
+    auto lastPose = anim->getFramePose(anim->getNumFrames() - 1);
+
+    EXPECT_EQ(firstPose->size(), anim->getNumJoints());
+    EXPECT_EQ(lastPose->size(), anim->getNumJoints());
+    EXPECT_EQ(anim->getFramePose(0), firstPose);
+}
+
+// The truncated file ends after frame 8, the remaining frames use the base frame
+TEST_F(ModelTest, MD5MissingFramesUseTheBaseFrame)
+{
+    auto anim = GlobalAnimationCache().getAnim(TubeAnimPath);
+    auto truncated = GlobalAnimationCache().getAnim(TubeAnimTruncatedPath);
+
+    ASSERT_TRUE(anim);
+    ASSERT_TRUE(truncated);
+    ASSERT_EQ(truncated->getNumFrames(), anim->getNumFrames());
+
+    constexpr std::size_t NumFramesInFile = 9;
+
+    for (std::size_t frame = 0; frame < truncated->getNumFrames(); ++frame)
+    {
+        auto pose = truncated->getFramePose(frame);
+        auto fullPose = anim->getFramePose(frame);
+
+        for (std::size_t joint = 0; joint < truncated->getNumJoints(); ++joint)
+        {
+            const auto& expected = frame < NumFramesInFile ? (*fullPose)[joint] : truncated->getBaseFrameKey(joint);
+
+            EXPECT_TRUE(math::isNear((*pose)[joint].origin, expected.origin, 0.01)) << "Frame " << frame << ", joint " << joint;
+            EXPECT_NEAR((*pose)[joint].orientation.x(), expected.orientation.x(), 0.001);
+            EXPECT_NEAR((*pose)[joint].orientation.y(), expected.orientation.y(), 0.001);
+            EXPECT_NEAR((*pose)[joint].orientation.z(), expected.orientation.z(), 0.001);
+            EXPECT_NEAR((*pose)[joint].orientation.w(), expected.orientation.w(), 0.001);
+        }
+    }
+}
+
+// Benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(ModelTest, DISABLED_MD5SkinningBenchmark)
+{
+    auto model = GlobalModelCache().getModel(TubeMeshPath);
+    auto md5Model = std::dynamic_pointer_cast<md5::IMD5Model>(model);
+    ASSERT_TRUE(md5Model);
+
+    md5Model->setAnim(GlobalAnimationCache().getAnim(TubeAnimPath));
+
+    // Every millisecond of the one second anim is a different pose
+    constexpr std::size_t NumPoses = 1000;
+    const auto numVertices = static_cast<std::size_t>(model->getVertexCount());
+
+    util::StopWatch timer;
+
+    for (std::size_t time = 0; time < NumPoses; ++time)
+    {
+        md5Model->updateAnim(time);
+    }
+
+    auto skinningMsecs = std::max<std::size_t>(timer.getMilliSecondsPassed(), 1);
+
+    // Updating a model which is not moving doesn't re-skin anything
+    timer.restart();
+
+    for (std::size_t i = 0; i < NumPoses; ++i)
+    {
+        md5Model->updateAnim(500);
+    }
+
+    auto staticMsecs = timer.getMilliSecondsPassed();
+
+    std::cout << "Skinned " << NumPoses << " poses of " << numVertices << " vertices in " << skinningMsecs
+        << " ms, " << (NumPoses * numVertices * 1000 / skinningMsecs) << " vertices per second, "
+        << NumPoses << " updates of a static pose took " << staticMsecs << " ms" << std::endl;
+
+    md5Model->setAnim(md5::IMD5AnimPtr());
+}
+
 }
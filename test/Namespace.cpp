@@ -0,0 +1,148 @@
+#include "RadiantTest.h"
+
+#include <iostream>
+#include <set>
+#include "inamespace.h"
+#include "imap.h"
+#include "imapresource.h"
+#include "ieclass.h"
+#include "ientity.h"
+#include "scenelib.h"
+#include "time/StopWatch.h"
+
+namespace test
+{
+
+using NamespaceTest = RadiantTest;
+
+namespace
+{
+
+void addNamedEntity(const scene::INodePtr& root, const std::string& name)
+{
+    auto entity = GlobalEntityModule().createEntity(GlobalEntityClassManager().findOrInsert("func_static", true));
+    Node_getEntity(entity)->setKeyValue("name", name);
+    scene::addNodeToContainer(entity, root);
+}
+
+std::set<std::string> collectEntityNames(const scene::INodePtr& root, const std::string& prefix)
+{
+    std::set<std::string> names;
+
+    root->foreachNode([&](const scene::INodePtr& node)
+    {
+        auto entity = Node_getEntity(node);
+
+        if (entity && entity->getKeyValue("name").rfind(prefix, 0) == 0)
+        {
+            names.insert(entity->getKeyValue("name"));
+        }
+
+        return true;
+    });
+
+    return names;
+}
+
+// Adds entities named func_static_1..N to both the current map and a loaded
+// map, returning the resource of the latter
+IMapResourcePtr loadMapWithConflictingEntities(int numEntities)
+{
+    auto resource = GlobalMapResourceManager().createFromPath("maps/simple_brushes.map");
+    EXPECT_TRUE(resource->load()) << "Test map not found";
+
+    auto foreignRoot = resource->getRootNode();
+
+    for (int i = 1; i <= numEntities; ++i)
+    {
+        addNamedEntity(GlobalMapModule().getRoot(), "func_static_" + std::to_string(i));
+        addNamedEntity(foreignRoot, "func_static_" + std::to_string(i));
+    }
+
+    return resource;
+}
+
+}
+
+TEST_F(NamespaceTest, UniqueNamesFollowPostfixRules)
+{
+    auto nspace = GlobalNamespaceFactory().createNamespace();
+
+    EXPECT_TRUE(nspace->insert("func_static_1"));
+    EXPECT_TRUE(nspace->insert("func_static_2"));
+    EXPECT_TRUE(nspace->insert("func_static_04"));
+    EXPECT_TRUE(nspace->insert("func_static_"));
+    EXPECT_FALSE(nspace->insert("func_static_1"));
+
+    EXPECT_TRUE(nspace->nameExists("func_static_04"));
+    EXPECT_FALSE(nspace->nameExists("func_static_4"));
+
+    // Conflicting names get the lowest unused number, "04" is not the same as "4"
+    EXPECT_EQ(nspace->addUniqueName("func_static_1"), "func_static_3");
+    EXPECT_EQ(nspace->addUniqueName("func_static_"), "func_static_4");
+    EXPECT_EQ(nspace->addUniqueName("func_static_04"), "func_static_5");
+
+    // Names not in use are kept as they are
+    EXPECT_EQ(nspace->addUniqueName("func_static_0"), "func_static_0");
+    EXPECT_EQ(nspace->addUniqueName("func_static_100"), "func_static_100");
+    EXPECT_EQ(nspace->addUniqueName("light"), "light");
+    EXPECT_EQ(nspace->addUniqueName("light"), "light1");
+
+    // Numbers which are freed up are used again
+    EXPECT_TRUE(nspace->erase("func_static_2"));
+    EXPECT_FALSE(nspace->erase("func_static_2"));
+    EXPECT_EQ(nspace->addUniqueName("func_static_1"), "func_static_2");
+    EXPECT_EQ(nspace->addUniqueName("func_static_1"), "func_static_6");
+
+    EXPECT_TRUE(nspace->erase("func_static_4"));
+    EXPECT_TRUE(nspace->erase("func_static_3"));
+    EXPECT_EQ(nspace->addUniqueName("func_static_1"), "func_static_3");
+    EXPECT_EQ(nspace->addUniqueName("func_static_1"), "func_static_4");
+    EXPECT_EQ(nspace->addUniqueName("func_static_1"), "func_static_7");
+
+    // Numbers in use are skipped when advancing to the next free one
+    nspace->insert("func_static_8");
+    nspace->insert("func_static_9");
+
+    for (int i = 10; i < 100; ++i)
+    {
+        EXPECT_EQ(nspace->addUniqueName("func_static_1"), "func_static_" + std::to_string(i));
+    }
+
+    EXPECT_EQ(nspace->addUniqueName("func_static_1"), "func_static_101");
+}
+
+TEST_F(NamespaceTest, ImportManyConflictingEntities)
+{
+    constexpr int NumEntities = 2000;
+
+    auto resource = loadMapWithConflictingEntities(NumEntities);
+    auto foreignRoot = resource->getRootNode();
+    GlobalMapModule().getRoot()->getNamespace()->ensureNoConflicts(foreignRoot);
+
+    // All imported entities got the lowest numbers not used in any of the two maps
+    auto foreignNames = collectEntityNames(foreignRoot, "func_static_");
+    EXPECT_EQ(foreignNames.size(), NumEntities);
+
+    for (int i = NumEntities + 1; i <= 2 * NumEntities; ++i)
+    {
+        EXPECT_EQ(foreignNames.count("func_static_" + std::to_string(i)), 1);
+    }
+}
+
+// Benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(NamespaceTest, DISABLED_ImportManyConflictingEntitiesBenchmark)
+{
+    constexpr int NumEntities = 20000;
+
+    auto resource = loadMapWithConflictingEntities(NumEntities);
+    auto foreignRoot = resource->getRootNode();
+
+    util::StopWatch timer;
+    GlobalMapModule().getRoot()->getNamespace()->ensureNoConflicts(foreignRoot);
+    auto msecs = timer.getMilliSecondsPassed();
+
+    std::cout << "Resolved the name conflicts of " << NumEntities << " entities in " << msecs << " ms" << std::endl;
+}
+
+}
@@ -0,0 +1,415 @@
+#include "RadiantTest.h"
+
+#include <iostream>
+#include "ieclass.h"
+#include "ientity.h"
+#include "imap.h"
+#include "iparticlenode.h"
+#include "iparticles.h"
+#include "iparticlestage.h"
+#include "irender.h"
+#include "irenderable.h"
+#include "irendersystemfactory.h"
+#include "scenelib.h"
+#include "math/AABB.h"
+#include "math/Matrix4.h"
+#include "math/pi.h"
+#include "render/NopVolumeTest.h"
+#include "string/convert.h"
+#include "time/StopWatch.h"
+
+namespace test
+{
+
+using ParticlesTest = RadiantTest;
+
+namespace
+{
+
+// Evaluates the particle at the given time (in msecs) and returns its bounds
+AABB getBoundsAtTime(const particles::IRenderableParticlePtr& particle, RenderSystem& renderSystem,
+    std::size_t time, const Matrix4& viewRotation = Matrix4::getIdentity())
+{
+    renderSystem.setTime(time);
+    particle->update(viewRotation);
+
+    return particle->getBounds();
+}
+
+void expectBounds(const AABB& bounds, const Vector3& origin, const Vector3& extents)
+{
+    EXPECT_TRUE(math::isNear(bounds.getOrigin(), origin, 0.01)) << "Origin is " << bounds.getOrigin();
+    EXPECT_TRUE(math::isNear(bounds.getExtents(), extents, 0.01)) << "Extents are " << bounds.getExtents();
+}
+
+float integrate(const particles::IParticleParameter& param, float duration, float time)
+{
+    return (param.getTo() - param.getFrom()) / duration * time * time * 0.5f + param.getFrom() * time;
+}
+
+Matrix4 getStageRotation(const particles::IStageDef& stage, const Matrix4& viewRotation)
+{
+    switch (stage.getOrientationType())
+    {
+    case particles::IStageDef::ORIENTATION_VIEW:
+        return viewRotation;
+    case particles::IStageDef::ORIENTATION_X:
+        return Matrix4::getRotation(Vector3(0, 0, 1), Vector3(1, 0, 0)).getMultipliedBy(
+            Matrix4::getRotationAboutZ(math::Degrees(-90)));
+    case particles::IStageDef::ORIENTATION_Y:
+        return Matrix4::getRotation(Vector3(0, 0, 1), Vector3(0, 1, 0));
+    default:
+        return Matrix4::getIdentity();
+    }
+}
+
+// The spawn position of particles without random distribution
+Vector3 getFixedDistributionOffset(const particles::IStageDef& stage)
+{
+    Vector3 offset(stage.getDistributionParm(0), stage.getDistributionParm(1), stage.getDistributionParm(2));
+
+    if (stage.getDistributionType() == particles::IStageDef::DISTRIBUTION_CYLINDER && stage.getDistributionParm(3) > 1.0f)
+    {
+        offset.x() *= stage.getDistributionParm(3);
+        offset.y() *= stage.getDistributionParm(3);
+    }
+
+    return offset;
+}
+
+// Bounds of the quads the per-particle evaluation (which preceded the particle kernel)
+// produces for the given stage of the first cycle. Only supports stages without random
+// input: no random distribution, a zero cone angle and a fixed initial angle.
+AABB getReferenceBounds(const particles::IStageDef& stage, std::size_t time, const Matrix4& viewRotation, const Vector3& direction)
+{
+    AABB bounds;
+
+    // The particle compensates the camera rotation by its inverse
+    auto stageRotation = getStageRotation(stage, viewRotation.getInverse());
+    auto durationMsec = static_cast<std::size_t>(stage.getDuration() * 1000);
+    auto spawnSpacingMsec = static_cast<std::size_t>(stage.getBunching() * static_cast<float>(durationMsec) / stage.getCount());
+
+    auto mainDirection = direction.getNormalised();
+    auto zDir = Vector3(0, 0, 1);
+    auto directionRotation = mainDirection.angle(zDir) != 0 ? Matrix4::getRotation(zDir, mainDirection) : Matrix4::getIdentity();
+
+    for (std::size_t i = 0; i < static_cast<std::size_t>(stage.getCount()); ++i)
+    {
+        auto startTimeMsec = i * spawnSpacingMsec;
+
+        if (time < startTimeMsec || time - startTimeMsec > durationMsec) continue;
+
+        auto particleTime = time - startTimeMsec;
+        auto timeFraction = static_cast<float>(particleTime) / durationMsec;
+        auto timeSecs = particleTime / 1000.0f;
+
+        // Origin along the standard path
+        auto distributionOffset = getFixedDistributionOffset(stage);
+        auto origin = directionRotation.transformPoint(stage.getOffset()) + distributionOffset;
+
+        auto particleDirection = directionRotation.transformPoint(Vector3(0, 0, 1)).getNormalised();
+
+        if (stage.getDirectionType() == particles::IStageDef::DIRECTION_OUTWARD)
+        {
+            particleDirection = distributionOffset.getNormalised();
+            particleDirection.z() += stage.getDirectionParm(0);
+        }
+
+        origin += particleDirection * integrate(stage.getSpeed(), stage.getDuration(), timeSecs);
+
+        auto gravity = stage.getWorldGravityFlag() ? Vector3(0, 0, -1) : -mainDirection;
+        origin += gravity * stage.getGravity() * timeSecs * timeSecs * 0.5f;
+
+        // Half the particles rotate backwards
+        float rotFactor = i % 2 == 0 ? -1.0f : 1.0f;
+        float angle = stage.getInitialAngle() + rotFactor * integrate(stage.getRotationSpeed(), stage.getDuration(), timeSecs);
+
+        float size = stage.getSize().evaluate(timeFraction);
+        float aspect = stage.getAspect().evaluate(timeFraction);
+
+        double cosPhi = cos(degrees_to_radians(angle));
+        double sinPhi = sin(degrees_to_radians(angle));
+        auto quadRotation = Matrix4::byColumns(
+            cosPhi, -sinPhi, 0, 0,
+            sinPhi, cosPhi, 0, 0,
+            0, 0, 1, 0,
+            0, 0, 0, 1);
+
+        for (const auto& corner : { Vector3(-size, size * aspect, 0), Vector3(size, size * aspect, 0),
+                                    Vector3(size, -size * aspect, 0), Vector3(-size, -size * aspect, 0) })
+        {
+            bounds.includePoint(stageRotation.transformPoint(quadRotation.transformPoint(corner)) + origin);
+        }
+    }
+
+    return bounds;
+}
+
+void expectReferenceBounds(const std::string& particleName, const Matrix4& viewRotation,
+    const Vector3& direction = Vector3(0, 0, 1))
+{
+    auto backend = GlobalRenderSystemFactory().createRenderSystem();
+    auto particle = GlobalParticlesManager().getRenderableParticle(particleName);
+    ASSERT_TRUE(particle);
+
+    particle->setRenderSystem(backend);
+    particle->setMainDirection(direction);
+
+    const auto& stage = particle->getParticleDef()->getStage(0);
+
+    for (std::size_t time : { 0, 250, 900, 1333, 1700, 1999 })
+    {
+        auto bounds = getBoundsAtTime(particle, *backend, time, viewRotation);
+        auto expected = getReferenceBounds(stage, time, viewRotation, direction);
+
+        ASSERT_TRUE(expected.isValid());
+        EXPECT_TRUE(math::isNear(bounds.getOrigin(), expected.getOrigin(), 0.01))
+            << particleName << " at " << time << " ms: origin is " << bounds.getOrigin() << ", expected " << expected.getOrigin();
+        EXPECT_TRUE(math::isNear(bounds.getExtents(), expected.getExtents(), 0.01))
+            << particleName << " at " << time << " ms: extents are " << bounds.getExtents() << ", expected " << expected.getExtents();
+    }
+}
+
+}
+
+// The expected values of these tests follow from the particle definitions, see kernel_test.prt
+TEST_F(ParticlesTest, QuadsFollowStageDefinition)
+{
+    auto backend = GlobalRenderSystemFactory().createRenderSystem();
+    auto particle = GlobalParticlesManager().getRenderableParticle("kernel_test_rising");
+    ASSERT_TRUE(particle);
+
+    particle->setRenderSystem(backend);
+
+    // After one second, the first three particles are 10, 5 and 0 units up in the air,
+    // their quads are rotated by 45 degrees
+    constexpr double HalfDiagonal = 2.828427;
+    expectBounds(getBoundsAtTime(particle, *backend, 1000), Vector3(4, 2, 5), Vector3(HalfDiagonal, HalfDiagonal, 5));
+
+    // Half a second later the fourth one has been spawned
+    expectBounds(getBoundsAtTime(particle, *backend, 1500), Vector3(4, 2, 7.5), Vector3(HalfDiagonal, HalfDiagonal, 7.5));
+}
+
+TEST_F(ParticlesTest, ViewOrientedQuadsFaceTheViewer)
+{
+    auto backend = GlobalRenderSystemFactory().createRenderSystem();
+    auto particle = GlobalParticlesManager().getRenderableParticle("kernel_test_facing");
+    ASSERT_TRUE(particle);
+
+    particle->setRenderSystem(backend);
+
+    // A view rotated by 90 degrees about the x axis turns the quads into the xz plane
+    constexpr double HalfDiagonal = 2.828427;
+    auto viewRotation = Matrix4::getRotation(Vector3(1, 0, 0), math::PI / 2);
+
+    expectBounds(getBoundsAtTime(particle, *backend, 1000, viewRotation), Vector3(4, 2, 10), Vector3(HalfDiagonal, 0, HalfDiagonal));
+}
+
+TEST_F(ParticlesTest, AnimatedQuadsWithGravityAndSizeRamp)
+{
+    auto backend = GlobalRenderSystemFactory().createRenderSystem();
+    auto particle = GlobalParticlesManager().getRenderableParticle("kernel_test_accelerating");
+    ASSERT_TRUE(particle);
+
+    particle->setRenderSystem(backend);
+
+    // Halfway through its life the particle travelled 5 units up, gravity pulled it 2 down.
+    // The size is 2 with aspect 2, rotated by 90 degrees the quad is 8 units wide.
+    expectBounds(getBoundsAtTime(particle, *backend, 1000), Vector3(4, 2, 3), Vector3(4, 2, 0));
+}
+
+// Compares the kernel's quads with those of the per-particle evaluation for
+// different orientations, paths, ramps and emitter directions
+TEST_F(ParticlesTest, KernelMatchesPerParticleEvaluation)
+{
+    auto viewRotation = Matrix4::getRotation(Vector3(1, 0, 0), math::PI / 3)
+        .getMultipliedBy(Matrix4::getRotationAboutZ(math::Degrees(30)));
+
+    expectReferenceBounds("kernel_reference_x", Matrix4::getIdentity());
+    expectReferenceBounds("kernel_reference_x", Matrix4::getIdentity(), Vector3(1, 0, 1));
+    expectReferenceBounds("kernel_reference_view", viewRotation);
+    expectReferenceBounds("kernel_reference_view", viewRotation, Vector3(0, -1, 0));
+    expectReferenceBounds("kernel_reference_outward", viewRotation);
+}
+
+namespace
+{
+
+// Counts the renderables submitted by the particle nodes
+class CountingCollector :
+    public RenderableCollector
+{
+public:
+    std::size_t count = 0;
+
+    void addRenderable(Shader& shader, const OpenGLRenderable& renderable,
+                       const Matrix4& localToWorld,
+                       const LitObject* litObject = nullptr,
+                       const IRenderEntity* entity = nullptr) override
+    {
+        ++count;
+    }
+
+    void addLight(const RendererLight& light) override
+    {}
+
+    bool supportsFullMaterials() const override { return true; }
+
+    void setHighlightFlag(Highlight::Flags flags, bool enabled) override
+    {}
+};
+
+// The viewer is located at the origin, only boxes touching the given region are visible
+class RegionVolumeTest :
+    public render::NopVolumeTest
+{
+private:
+    AABB _region;
+
+public:
+    RegionVolumeTest(const AABB& region) :
+        _region(region)
+    {}
+
+    VolumeIntersectionValue TestAABB(const AABB& aabb, const Matrix4& localToWorld) const override
+    {
+        return _region.intersects(AABB::createFromOrientedAABBSafe(aabb, localToWorld)) ?
+            VOLUME_PARTIAL : VOLUME_OUTSIDE;
+    }
+};
+
+// Creates a particle node below a new entity at the given origin
+scene::INodePtr createEmitter(const std::string& particleName, const Vector3& origin,
+    const RenderSystemPtr& renderSystem)
+{
+    auto entity = GlobalEntityModule().createEntity(GlobalEntityClassManager().findClass("func_static"));
+    entity->getEntity().setKeyValue("origin", string::to_string(origin));
+    scene::addNodeToContainer(entity, GlobalMapModule().getRoot());
+
+    auto particleNode = GlobalParticlesManager().createParticleNode(particleName);
+    scene::addNodeToContainer(particleNode, entity);
+    particleNode->setRenderSystem(renderSystem);
+
+    return particleNode;
+}
+
+// Renders the given emitters at the given time, returns the statistics of this frame
+particles::IParticlesManager::EmitterStatistics renderEmitters(RenderSystem& renderSystem, std::size_t time,
+    const std::vector<scene::INodePtr>& emitters, const VolumeTest& volume)
+{
+    renderSystem.setTime(time);
+    GlobalParticlesManager().resetEmitterStatistics();
+
+    CountingCollector collector;
+
+    for (const auto& emitter : emitters)
+    {
+        emitter->renderSolid(collector, volume);
+    }
+
+    return GlobalParticlesManager().getEmitterStatistics();
+}
+
+}
+
+TEST_F(ParticlesTest, EmittersOutsideTheViewAreNotSimulated)
+{
+    auto backend = GlobalRenderSystemFactory().createRenderSystem();
+    auto visible = createEmitter("kernel_test_rising", Vector3(0, 0, 0), backend);
+    auto culled = createEmitter("kernel_test_rising", Vector3(10000, 0, 0), backend);
+
+    RegionVolumeTest volume(AABB(Vector3(0, 0, 0), Vector3(512, 512, 512)));
+
+    backend->setTime(500);
+    GlobalParticlesManager().resetEmitterStatistics();
+
+    CountingCollector visibleCollector;
+    CountingCollector culledCollector;
+    visible->renderSolid(visibleCollector, volume);
+    culled->renderSolid(culledCollector, volume);
+
+    auto statistics = GlobalParticlesManager().getEmitterStatistics();
+    EXPECT_EQ(statistics.active, 1);
+    EXPECT_EQ(statistics.skipped, 1);
+
+    EXPECT_GT(visibleCollector.count, 0);
+    EXPECT_EQ(culledCollector.count, 0) << "Culled emitters should not submit anything";
+}
+
+// Emitters farther than 2048 units are updated every 100 msecs (the defaults in user.xml)
+TEST_F(ParticlesTest, DistantEmittersAreUpdatedAtAReducedRate)
+{
+    auto backend = GlobalRenderSystemFactory().createRenderSystem();
+    auto nearby = createEmitter("kernel_test_rising", Vector3(0, 0, 0), backend);
+    auto distant = createEmitter("kernel_test_rising", Vector3(4096, 0, 0), backend);
+
+    render::NopVolumeTest volume;
+
+    auto statistics = renderEmitters(*backend, 500, { nearby, distant }, volume);
+    EXPECT_EQ(statistics.active, 2);
+    EXPECT_EQ(statistics.skipped, 0);
+
+    auto distantBounds = distant->localAABB();
+
+    // 50 msecs later, the distant emitter keeps its geometry
+    statistics = renderEmitters(*backend, 550, { nearby, distant }, volume);
+    EXPECT_EQ(statistics.active, 1);
+    EXPECT_EQ(statistics.skipped, 1);
+    EXPECT_EQ(distant->localAABB().getOrigin(), distantBounds.getOrigin());
+    EXPECT_EQ(distant->localAABB().getExtents(), distantBounds.getExtents());
+
+    // Once the interval has passed, it is simulated again
+    statistics = renderEmitters(*backend, 650, { nearby, distant }, volume);
+    EXPECT_EQ(statistics.active, 2);
+    EXPECT_EQ(statistics.skipped, 0);
+    EXPECT_NE(distant->localAABB().getOrigin(), distantBounds.getOrigin());
+}
+
+TEST_F(ParticlesTest, EmittersOfTheSameDefShareTheirSimulation)
+{
+    auto backend = GlobalRenderSystemFactory().createRenderSystem();
+
+    auto first = createEmitter("kernel_test_benchmark", Vector3(0, 0, 0), backend);
+    auto sameDef = createEmitter("kernel_test_benchmark", Vector3(64, 0, 0), backend);
+    auto otherDef = createEmitter("kernel_test_rising", Vector3(-64, 0, 0), backend);
+
+    render::NopVolumeTest volume;
+
+    auto statistics = renderEmitters(*backend, 500, { first, sameDef, otherDef }, volume);
+    EXPECT_EQ(statistics.active, 2);
+    EXPECT_EQ(statistics.skipped, 1);
+
+    // The emitter of the same def renders the first one's particles
+    EXPECT_EQ(sameDef->localAABB().getOrigin(), first->localAABB().getOrigin());
+    EXPECT_EQ(sameDef->localAABB().getExtents(), first->localAABB().getExtents());
+}
+
+// Benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(ParticlesTest, DISABLED_ParticleUpdateBenchmark)
+{
+    auto backend = GlobalRenderSystemFactory().createRenderSystem();
+    auto particle = GlobalParticlesManager().getRenderableParticle("kernel_test_benchmark");
+    ASSERT_TRUE(particle);
+
+    particle->setRenderSystem(backend);
+
+    // All particles are spawned at once and live for the whole two second cycle
+    constexpr std::size_t NumUpdates = 500;
+    auto numParticles = static_cast<std::size_t>(particle->getParticleDef()->getStage(0).getCount());
+
+    util::StopWatch timer;
+
+    for (std::size_t i = 0; i < NumUpdates; ++i)
+    {
+        getBoundsAtTime(particle, *backend, i * 4, Matrix4::getRotationAboutZ(math::Degrees(30)));
+    }
+
+    auto msecs = std::max<std::size_t>(timer.getMilliSecondsPassed(), 1);
+
+    EXPECT_TRUE(particle->getBounds().isValid());
+
+    std::cout << "Updated " << NumUpdates << " times " << numParticles << " particles in " << msecs << " ms, "
+        << (NumUpdates * numParticles * 1000 / msecs) << " particles per second" << std::endl;
+}
+
+}
@@ -0,0 +1,224 @@
+#include "RadiantTest.h"
+
+#include <iostream>
+#include "imap.h"
+#include "ipatch.h"
+#include "math/Vector3.h"
+#include "time/StopWatch.h"
+
+namespace test
+{
+
+using PatchTesselationTest = RadiantTest;
+
+namespace
+{
+
+// Creates a curved patchDef3 with the given dimensions and fixed subdivisions
+inline IPatchNodePtr createCurvedPatch(std::size_t width, std::size_t height, const Subdivisions& subdivisions)
+{
+    auto world = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto sceneNode = GlobalPatchModule().createPatch(patch::PatchDefType::Def3);
+    auto patchNode = std::dynamic_pointer_cast<IPatchNode>(sceneNode);
+
+    world->addChildNode(sceneNode);
+
+    auto& patch = patchNode->getPatch();
+
+    patch.setDims(width, height);
+    patch.setFixedSubdivisions(true, subdivisions);
+
+    for (std::size_t row = 0; row < height; ++row)
+    {
+        for (std::size_t col = 0; col < width; ++col)
+        {
+            // Bulge every second row/column out of the XY plane
+            auto z = ((row + col) % 2) * 48.0 + row * 3.0;
+
+            patch.ctrlAt(row, col).vertex.set(col * 64.0 + row * 7.0, row * 64.0, z);
+            patch.ctrlAt(row, col).texcoord[0] = col * 1.0 / (width - 1.0);
+            patch.ctrlAt(row, col).texcoord[1] = row * 0.5 / (height - 1.0) + col * 0.125;
+        }
+    }
+
+    patch.controlPointsChanged();
+
+    return patchNode;
+}
+
+// Straight-forward evaluation of the quadratic bezier in the way the tesselator used to do it
+template<typename ValueType>
+ValueType evaluateBezier(const ValueType& a, const ValueType& b, const ValueType& c, double t)
+{
+    auto qA = a - b * 2.0 + c;
+    auto qB = b * 2.0 - a * 2.0;
+
+    return qA * t * t + qB * t + a;
+}
+
+// Calculates the normals of the control points, averaging the faces formed with the neighbouring
+// points like the tesselator does. The test patches are neither planar nor wrapped, and don't
+// have any degenerate edges, so the direct neighbours are always good.
+std::vector<Vector3> getControlPointNormals(const IPatch& patch)
+{
+    static const int neighbours[8][2] = { { 0,1 },{ 1,1 },{ 1,0 },{ 1,-1 },{ 0,-1 },{ -1,-1 },{ -1,0 },{ -1,1 } };
+
+    auto width = static_cast<int>(patch.getWidth());
+    auto height = static_cast<int>(patch.getHeight());
+
+    std::vector<Vector3> normals(patch.getWidth() * patch.getHeight());
+
+    for (int row = 0; row < height; ++row)
+    {
+        for (int col = 0; col < width; ++col)
+        {
+            const auto& base = patch.ctrlAt(row, col).vertex;
+
+            Vector3 around[8];
+            bool good[8];
+
+            for (int k = 0; k < 8; ++k)
+            {
+                auto x = col + neighbours[k][0];
+                auto y = row + neighbours[k][1];
+
+                good[k] = x >= 0 && x < width && y >= 0 && y < height;
+
+                if (good[k])
+                {
+                    around[k] = (patch.ctrlAt(y, x).vertex - base).getNormalised();
+                }
+            }
+
+            Vector3 sum(0, 0, 0);
+
+            for (int k = 0; k < 8; ++k)
+            {
+                if (good[k] && good[(k + 1) & 7])
+                {
+                    sum += around[(k + 1) & 7].cross(around[k]).getNormalised();
+                }
+            }
+
+            normals[row * width + col] = sum.getNormalised();
+        }
+    }
+
+    return normals;
+}
+
+// Calculates the expected vertex of the given subpatch, at the sample point (i,j)
+VertexNT getExpectedVertex(const IPatch& patch, const std::vector<Vector3>& controlNormals,
+    std::size_t subpatchCol, std::size_t subpatchRow, std::size_t i, std::size_t j)
+{
+    auto u = static_cast<double>(static_cast<float>(i) / patch.getSubdivisions().x());
+    auto v = static_cast<double>(static_cast<float>(j) / patch.getSubdivisions().y());
+
+    Vector3 vCtrlVertex[3];
+    Vector3 vCtrlNormal[3];
+    Vector2 vCtrlTexcoord[3];
+
+    for (std::size_t row = 0; row < 3; ++row)
+    {
+        auto ctrlRow = subpatchRow * 2 + row;
+        auto ctrlCol = subpatchCol * 2;
+
+        const auto& a = patch.ctrlAt(ctrlRow, ctrlCol + 0);
+        const auto& b = patch.ctrlAt(ctrlRow, ctrlCol + 1);
+        const auto& c = patch.ctrlAt(ctrlRow, ctrlCol + 2);
+
+        const auto* normals = &controlNormals[ctrlRow * patch.getWidth() + ctrlCol];
+
+        vCtrlVertex[row] = evaluateBezier(a.vertex, b.vertex, c.vertex, u);
+        vCtrlNormal[row] = evaluateBezier(normals[0], normals[1], normals[2], u);
+        vCtrlTexcoord[row] = evaluateBezier(a.texcoord, b.texcoord, c.texcoord, u);
+    }
+
+    VertexNT result;
+    result.vertex = evaluateBezier(vCtrlVertex[0], vCtrlVertex[1], vCtrlVertex[2], v);
+    result.normal = evaluateBezier(vCtrlNormal[0], vCtrlNormal[1], vCtrlNormal[2], v).getNormalised();
+    result.texcoord = evaluateBezier(vCtrlTexcoord[0], vCtrlTexcoord[1], vCtrlTexcoord[2], v);
+
+    return result;
+}
+
+void checkFixedTesselation(const IPatch& patch)
+{
+    auto mesh = patch.getTesselatedPatchMesh();
+
+    auto subdivX = patch.getSubdivisions().x();
+    auto subdivY = patch.getSubdivisions().y();
+
+    EXPECT_EQ(mesh.width, (patch.getWidth() - 1) / 2 * subdivX + 1);
+    EXPECT_EQ(mesh.height, (patch.getHeight() - 1) / 2 * subdivY + 1);
+    EXPECT_EQ(mesh.vertices.size(), mesh.width * mesh.height);
+
+    auto controlNormals = getControlPointNormals(patch);
+
+    for (std::size_t subpatchCol = 0; subpatchCol < (patch.getWidth() - 1) / 2; ++subpatchCol)
+    {
+        for (std::size_t subpatchRow = 0; subpatchRow < (patch.getHeight() - 1) / 2; ++subpatchRow)
+        {
+            for (std::size_t i = 0; i <= subdivX; ++i)
+            {
+                for (std::size_t j = 0; j <= subdivY; ++j)
+                {
+                    auto expected = getExpectedVertex(patch, controlNormals, subpatchCol, subpatchRow, i, j);
+                    const auto& actual = mesh.vertices[(subpatchRow * subdivY + j) * mesh.width + subpatchCol * subdivX + i];
+
+                    EXPECT_TRUE(math::isNear(actual.vertex, expected.vertex, 1e-6))
+                        << "Vertex mismatch: " << actual.vertex << " vs. " << expected.vertex;
+                    EXPECT_TRUE(math::isNear(actual.normal, expected.normal, 1e-6))
+                        << "Normal mismatch: " << actual.normal << " vs. " << expected.normal;
+                    EXPECT_NEAR(actual.texcoord.x(), expected.texcoord.x(), 1e-8);
+                    EXPECT_NEAR(actual.texcoord.y(), expected.texcoord.y(), 1e-8);
+                }
+            }
+        }
+    }
+}
+
+}
+
+TEST_F(PatchTesselationTest, FixedSubdivisionSinglePatch)
+{
+    auto patchNode = createCurvedPatch(3, 3, Subdivisions(4, 4));
+    checkFixedTesselation(patchNode->getPatch());
+}
+
+TEST_F(PatchTesselationTest, FixedSubdivisionMultiplePatches)
+{
+    auto patchNode = createCurvedPatch(7, 5, Subdivisions(5, 3));
+    checkFixedTesselation(patchNode->getPatch());
+}
+
+TEST_F(PatchTesselationTest, FixedSubdivisionHighResolution)
+{
+    auto patchNode = createCurvedPatch(9, 9, Subdivisions(32, 24));
+    checkFixedTesselation(patchNode->getPatch());
+}
+
+// Benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(PatchTesselationTest, DISABLED_TesselationPerformance)
+{
+    auto patchNode = createCurvedPatch(15, 15, Subdivisions(64, 64));
+    auto& patch = patchNode->getPatch();
+
+    constexpr std::size_t NumIterations = 200;
+
+    util::StopWatch timer;
+
+    for (std::size_t i = 0; i < NumIterations; ++i)
+    {
+        patch.updateTesselation(true);
+    }
+
+    auto numVertices = patch.getTesselatedPatchMesh().vertices.size() * NumIterations;
+    auto msecs = std::max<std::size_t>(timer.getMilliSecondsPassed(), 1);
+
+    std::cout << "Tesselated " << numVertices << " vertices in " << msecs << " ms ("
+        << (numVertices * 1000 / msecs) << " vertices per second)" << std::endl;
+}
+
+}
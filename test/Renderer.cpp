@@ -1,9 +1,19 @@
 #include "RadiantTest.h"
 
+#include <iostream>
 #include "ieclass.h"
 #include "ientity.h"
+#include "igl.h"
 #include "ilightnode.h"
+#include "imap.h"
+#include "irenderable.h"
+#include "iscenegraph.h"
+#include "scenelib.h"
 #include "math/Matrix4.h"
+#include "render/InstanceBatch.h"
+#include "render/NopVolumeTest.h"
+#include "render/SceneRenderWalker.h"
+#include "time/StopWatch.h"
 
 namespace test
 {
@@ -257,4 +267,385 @@ TEST_F(RendererTest, RotatedProjectedLight)
     EXPECT_EQ(mat * V4(16, 0, 0, 1), V4(0.5, 0.5, 1, 1));
 }
 
-}
\ No newline at end of file
+namespace
+{
+
+// Submits every renderable to its shader without any lights
+class UnlitRenderableCollector :
+    public RenderableCollector
+{
+public:
+    void addRenderable(Shader& shader, const OpenGLRenderable& renderable,
+                       const Matrix4& localToWorld,
+                       const LitObject* litObject = nullptr,
+                       const IRenderEntity* entity = nullptr) override
+    {
+        shader.addRenderable(renderable, localToWorld, nullptr, entity);
+    }
+
+    void addLight(const RendererLight& light) override
+    {}
+
+    bool supportsFullMaterials() const override { return true; }
+
+    void setHighlightFlag(Highlight::Flags flags, bool enabled) override
+    {}
+};
+
+}
+
+namespace
+{
+
+// Synthetic scene of props sharing the same model, laid out in a grid
+constexpr int PropGridSize = 100;
+constexpr double PropSpacing = 64;
+
+void createPropGrid()
+{
+    for (int x = 0; x < PropGridSize; ++x)
+    {
+        for (int y = 0; y < PropGridSize; ++y)
+        {
+            auto prop = createByClassName("func_static");
+            prop->getEntity().setKeyValue("model", "models/ase/testcube_uv_tiling.ase");
+            prop->getEntity().setKeyValue("origin", string::to_string(Vector3(x * PropSpacing, y * PropSpacing, 0)));
+            scene::addNodeToContainer(prop, GlobalMapModule().getRoot());
+        }
+    }
+}
+
+// Renders one frame looking down onto the grid with a plain orthographic projection
+void renderPropGrid()
+{
+    auto modelView = Matrix4::getTranslation(Vector3(-PropGridSize * PropSpacing / 2, -PropGridSize * PropSpacing / 2, -1024));
+    auto projection = Matrix4::byRows(2 / (PropGridSize * PropSpacing), 0, 0, 0,
+                                      0, 2 / (PropGridSize * PropSpacing), 0, 0,
+                                      0, 0, -1.0 / 4096, 0,
+                                      0, 0, 0, 1);
+    const unsigned int renderFlags = RENDER_DEPTHTEST | RENDER_DEPTHWRITE | RENDER_CULLFACE |
+        RENDER_FILL | RENDER_LIGHTING | RENDER_TEXTURE_2D | RENDER_SMOOTH | RENDER_SCALED;
+
+    render::NopVolumeTest volume;
+
+    UnlitRenderableCollector collector;
+    render::SceneRenderWalker walker(collector, volume);
+    GlobalSceneGraph().foreachVisibleNodeInVolume(volume, walker);
+
+    GlobalRenderSystem().render(renderFlags, modelView, projection, Vector3(0, 0, 1024));
+    glFinish();
+}
+
+}
+
+TEST_F(RendererTest, RepeatedModelsAreDrawnInBatches)
+{
+    if (!GlobalOpenGLContext().getSharedContext())
+    {
+        GTEST_SKIP() << "No OpenGL context available";
+    }
+
+    createPropGrid();
+    renderPropGrid();
+
+    const auto& statistics = GlobalRenderSystem().getStatistics();
+
+    // The props are merged into a few batches instead of issuing one call each
+    EXPECT_GE(statistics.batchedInstances, PropGridSize * PropGridSize);
+    EXPECT_LT(statistics.drawCalls, PropGridSize * PropGridSize);
+}
+
+// Benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(RendererTest, DISABLED_RepeatedModelsRenderBenchmark)
+{
+    if (!GlobalOpenGLContext().getSharedContext())
+    {
+        GTEST_SKIP() << "No OpenGL context available";
+    }
+
+    createPropGrid();
+
+    constexpr int NumFrames = 10;
+    std::size_t firstFrameTime = 0;
+    std::size_t totalTime = 0;
+
+    for (int frame = 0; frame < NumFrames; ++frame)
+    {
+        util::StopWatch timer;
+
+        renderPropGrid();
+
+        auto frameTime = timer.getMilliSecondsPassed();
+        totalTime += frameTime;
+
+        if (frame == 0)
+        {
+            firstFrameTime = frameTime;
+        }
+    }
+
+    const auto& statistics = GlobalRenderSystem().getStatistics();
+
+    std::cout << "Rendered " << PropGridSize * PropGridSize << " props with " << statistics.drawCalls
+        << " draw calls (" << statistics.batchedInstances << " batched instances), first frame "
+        << firstFrameTime << " ms, average frame " << totalTime / NumFrames << " ms" << std::endl;
+}
+
+namespace
+{
+
+// Submits every renderable at the given transforms, on top of its own
+class RepeatingRenderableCollector :
+    public UnlitRenderableCollector
+{
+private:
+    std::vector<Matrix4> _transforms;
+
+public:
+    RepeatingRenderableCollector(const std::vector<Matrix4>& transforms) :
+        _transforms(transforms)
+    {}
+
+    void addRenderable(Shader& shader, const OpenGLRenderable& renderable,
+                       const Matrix4& localToWorld,
+                       const LitObject* litObject = nullptr,
+                       const IRenderEntity* entity = nullptr) override
+    {
+        for (const auto& transform : _transforms)
+        {
+            shader.addRenderable(renderable, transform.getMultipliedBy(localToWorld), nullptr, entity);
+        }
+    }
+};
+
+RenderSystem::Statistics renderWithTransforms(const std::vector<Matrix4>& transforms)
+{
+    auto modelView = Matrix4::getTranslation(Vector3(0, 0, -1024));
+    auto projection = Matrix4::byRows(1.0 / 512, 0, 0, 0,
+                                      0, 1.0 / 512, 0, 0,
+                                      0, 0, -1.0 / 4096, 0,
+                                      0, 0, 0, 1);
+    const unsigned int renderFlags = RENDER_DEPTHTEST | RENDER_DEPTHWRITE | RENDER_CULLFACE |
+        RENDER_FILL | RENDER_LIGHTING | RENDER_TEXTURE_2D | RENDER_SMOOTH | RENDER_SCALED;
+
+    render::NopVolumeTest volume;
+    RepeatingRenderableCollector collector(transforms);
+    render::SceneRenderWalker walker(collector, volume);
+    GlobalSceneGraph().foreachVisibleNodeInVolume(volume, walker);
+
+    GlobalRenderSystem().render(renderFlags, modelView, projection, Vector3(0, 0, 1024));
+    glFinish();
+
+    return GlobalRenderSystem().getStatistics();
+}
+
+}
+
+TEST_F(RendererTest, MirroredInstancesAreDrawnBesideTheirBatch)
+{
+    if (!GlobalOpenGLContext().getSharedContext())
+    {
+        GTEST_SKIP() << "No OpenGL context available";
+    }
+
+    auto prop = createByClassName("func_static");
+    prop->getEntity().setKeyValue("model", "models/ase/testcube_uv_tiling.ase");
+    scene::addNodeToContainer(prop, GlobalMapModule().getRoot());
+
+    std::vector<Matrix4> transforms;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        transforms.push_back(Matrix4::getTranslation(Vector3(i * 64, 0, 0)));
+    }
+
+    auto mirrored = Matrix4::getTranslation(Vector3(0, 64, 0)).getMultipliedBy(Matrix4::getScale(Vector3(-1, 1, 1)));
+
+    auto batchOnly = renderWithTransforms(transforms);
+    auto mirroredOnly = renderWithTransforms({ mirrored });
+
+    transforms.push_back(mirrored);
+    auto batchAndMirrored = renderWithTransforms(transforms);
+
+    // The four regular instances are merged, the mirrored one has the other
+    // handedness and is below the batch size, it must be drawn on its own
+    EXPECT_GT(batchOnly.batchedInstances, 0);
+    EXPECT_EQ(mirroredOnly.batchedInstances, 0);
+    EXPECT_GT(mirroredOnly.drawCalls, 0);
+    EXPECT_EQ(batchAndMirrored.batchedInstances, batchOnly.batchedInstances);
+    EXPECT_EQ(batchAndMirrored.drawCalls, batchOnly.drawCalls + mirroredOnly.drawCalls);
+}
+
+namespace
+{
+
+// A single triangle, standing in for a static model surface
+class TestTriangle :
+    public InstanceableRenderable
+{
+private:
+    std::vector<ArbitraryMeshVertex> _vertices;
+    std::vector<unsigned int> _indices;
+    std::size_t _geometryId;
+
+public:
+    TestTriangle(std::size_t geometryId) :
+        _indices({ 0, 1, 2 }),
+        _geometryId(geometryId)
+    {
+        _vertices.emplace_back(Vertex3f(0, 0, 0), Normal3f(0, 0, 1), TexCoord2f(0, 0));
+        _vertices.emplace_back(Vertex3f(8, 0, 0), Normal3f(0, 0, 1), TexCoord2f(1, 0));
+        _vertices.emplace_back(Vertex3f(0, 8, 0), Normal3f(0, 0, 1), TexCoord2f(0, 1));
+    }
+
+    void render(const RenderInfo& info) const override
+    {}
+
+    const std::vector<ArbitraryMeshVertex>& getVertexArray() const override
+    {
+        return _vertices;
+    }
+
+    const std::vector<unsigned int>& getIndexArray() const override
+    {
+        return _indices;
+    }
+
+    std::size_t getGeometryId() const override
+    {
+        return _geometryId;
+    }
+
+    void setGeometryId(std::size_t geometryId)
+    {
+        _geometryId = geometryId;
+    }
+};
+
+// Something drawn by the backend which can't be batched
+class TestRenderable :
+    public OpenGLRenderable
+{
+public:
+    void render(const RenderInfo& info) const override
+    {}
+};
+
+std::vector<Matrix4> getTranslations(int first, int last)
+{
+    std::vector<Matrix4> transforms;
+
+    for (int i = first; i <= last; ++i)
+    {
+        transforms.push_back(Matrix4::getTranslation(Vector3(i * 64, 0, 0)));
+    }
+
+    return transforms;
+}
+
+// Returns the world-space position of the given vertex of each drawn instance
+std::vector<Vector3> getDrawnVertices(const render::InstanceBatch& batch, std::size_t vertexIndex)
+{
+    std::vector<Vector3> result;
+
+    for (const auto& range : batch.getRanges())
+    {
+        for (auto i = range.firstIndex; i < range.firstIndex + range.numIndices; i += 3)
+        {
+            const auto& vertex = batch.getVertices()[batch.getIndices()[i + vertexIndex]].vertex;
+            result.emplace_back(vertex[0], vertex[1], vertex[2]);
+        }
+    }
+
+    return result;
+}
+
+}
+
+TEST_F(RendererTest, InstanceBatchKeepsTransformedInstances)
+{
+    TestTriangle triangle(1);
+    render::InstanceBatch batch;
+
+    EXPECT_EQ(batch.update(triangle, getTranslations(0, 3)), 4);
+    EXPECT_EQ(batch.getNumInstances(), 4);
+    EXPECT_EQ(batch.getRanges().size(), 1) << "Adjacent instances should be drawn as one range";
+
+    // The vertices are baked into world space
+    auto secondVertices = getDrawnVertices(batch, 1);
+    ASSERT_EQ(secondVertices.size(), 4);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(secondVertices[i], Vector3(i * 64 + 8, 0, 0));
+    }
+
+    // The same instances don't need to be transformed again
+    EXPECT_EQ(batch.update(triangle, getTranslations(0, 3)), 0);
+
+    // When the visible set changes, only the new instances are transformed
+    EXPECT_EQ(batch.update(triangle, getTranslations(1, 5)), 2);
+    EXPECT_EQ(batch.getNumInstances(), 5);
+
+    auto firstVertices = getDrawnVertices(batch, 0);
+    ASSERT_EQ(firstVertices.size(), 5);
+
+    for (int i = 0; i < 5; ++i)
+    {
+        EXPECT_EQ(firstVertices[i], Vector3((i + 1) * 64, 0, 0));
+    }
+
+    // Instances out of sight are kept until they outnumber the visible ones
+    EXPECT_EQ(batch.update(triangle, getTranslations(0, 1)), 0);
+    EXPECT_EQ(batch.getNumSlots(), 2);
+
+    // Changing the geometry invalidates all instances
+    triangle.setGeometryId(2);
+    EXPECT_EQ(batch.update(triangle, getTranslations(0, 1)), 2);
+}
+
+TEST_F(RendererTest, InstanceBatchSetGroupsByRenderableAndHandedness)
+{
+    TestTriangle batched(1);
+    TestTriangle rare(2);
+    TestRenderable other;
+
+    render::InstanceBatchSet batches;
+
+    auto transforms = getTranslations(0, render::InstanceBatchSet::MinInstancesPerBatch - 1);
+    auto mirrored = Matrix4::getScale(Vector3(-1, 1, 1));
+
+    for (const auto& transform : transforms)
+    {
+        EXPECT_TRUE(batches.addInstance(batched, transform));
+    }
+
+    EXPECT_TRUE(batches.addInstance(batched, mirrored));
+    EXPECT_TRUE(batches.addInstance(rare, transforms.front()));
+    EXPECT_FALSE(batches.addInstance(other, transforms.front())) << "Only instanceable renderables can be batched";
+
+    batches.update();
+
+    EXPECT_TRUE(batches.isBatched(batched, transforms.back()));
+    EXPECT_FALSE(batches.isBatched(batched, mirrored)) << "Mirrored instances are below the batch size";
+    EXPECT_FALSE(batches.isBatched(rare, transforms.front())) << "Single instances are drawn on their own";
+
+    std::size_t numBatches = 0;
+
+    batches.foreachBatch([&](bool rightHanded, const render::InstanceBatch& batch)
+    {
+        EXPECT_EQ(batch.getNumInstances(), transforms.size());
+        ++numBatches;
+    });
+
+    EXPECT_EQ(numBatches, 1);
+
+    // Once the renderable is submitted less often, its batch is dropped
+    batches.addInstance(batched, transforms.front());
+    batches.update();
+
+    EXPECT_FALSE(batches.isBatched(batched, transforms.front()));
+    EXPECT_TRUE(batches.empty());
+}
+
+}
@@ -0,0 +1,218 @@
+#include "RadiantTest.h"
+
+#include <algorithm>
+
+#include "imap.h"
+#include "iscenegraph.h"
+#include "ispacepartition.h"
+#include "itransformable.h"
+#include "scenelib.h"
+#include "algorithm/Primitives.h"
+
+namespace test
+{
+
+using SceneGraphTest = RadiantTest;
+
+namespace
+{
+
+// Observer relying on the per-node notifications
+class NodeObserver :
+    public scene::Graph::Observer
+{
+public:
+    std::vector<scene::INodePtr> inserted;
+    std::vector<scene::INodePtr> erased;
+
+    void onSceneNodeInsert(const scene::INodePtr& node) override
+    {
+        inserted.push_back(node);
+    }
+
+    void onSceneNodeErase(const scene::INodePtr& node) override
+    {
+        erased.push_back(node);
+    }
+};
+
+// Observer processing the batched change sets
+class ChangeSetObserver :
+    public scene::Graph::Observer
+{
+public:
+    std::vector<scene::Graph::ChangeSet> changeSets;
+
+    void onSceneNodesChanged(const scene::Graph::ChangeSet& changes) override
+    {
+        changeSets.push_back(changes);
+    }
+};
+
+// Returns the space partition node the given scene node is linked to, or null
+scene::ISPNodePtr findLinkedNode(const scene::ISPNodePtr& spNode, const scene::INodePtr& node)
+{
+    const auto& members = spNode->getMembers();
+
+    if (std::find(members.begin(), members.end(), node) != members.end())
+    {
+        return spNode;
+    }
+
+    for (const auto& child : spNode->getChildNodes())
+    {
+        if (auto found = findLinkedNode(child, node); found)
+        {
+            return found;
+        }
+    }
+
+    return scene::ISPNodePtr();
+}
+
+scene::ISPNodePtr findLinkedNode(const scene::INodePtr& node)
+{
+    return findLinkedNode(GlobalSceneGraph().getSpacePartition()->getRoot(), node);
+}
+
+}
+
+TEST_F(SceneGraphTest, TransactionDefersObserverNotifications)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    NodeObserver nodeObserver;
+    ChangeSetObserver changeSetObserver;
+    GlobalSceneGraph().addSceneObserver(&nodeObserver);
+    GlobalSceneGraph().addSceneObserver(&changeSetObserver);
+
+    std::vector<scene::INodePtr> brushes;
+
+    {
+        scene::GraphTransaction transaction(GlobalSceneGraph());
+
+        for (auto i = 0; i < 100; ++i)
+        {
+            brushes.push_back(algorithm::createCubicBrush(worldspawn, Vector3(i * 128, 0, 0)));
+        }
+
+        // The nodes are part of the scene, but nobody has been notified yet
+        EXPECT_TRUE(brushes.front()->inScene());
+        EXPECT_TRUE(nodeObserver.inserted.empty());
+        EXPECT_TRUE(changeSetObserver.changeSets.empty());
+    }
+
+    // The per-node observer received every node in the order they were inserted
+    EXPECT_EQ(nodeObserver.inserted, brushes);
+
+    // The other observer received a single change set
+    ASSERT_EQ(changeSetObserver.changeSets.size(), 1);
+
+    const auto& changes = changeSetObserver.changeSets.front();
+    ASSERT_EQ(changes.size(), brushes.size());
+
+    for (std::size_t i = 0; i < changes.size(); ++i)
+    {
+        EXPECT_EQ(changes[i].first, scene::Graph::ChangeType::Insert);
+        EXPECT_EQ(changes[i].second, brushes[i]);
+    }
+
+    GlobalSceneGraph().removeSceneObserver(&nodeObserver);
+    GlobalSceneGraph().removeSceneObserver(&changeSetObserver);
+}
+
+TEST_F(SceneGraphTest, TransactionDropsRevertedInsertions)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto existingBrush = algorithm::createCubicBrush(worldspawn);
+
+    NodeObserver observer;
+    GlobalSceneGraph().addSceneObserver(&observer);
+
+    scene::INodePtr temporaryBrush;
+
+    {
+        scene::GraphTransaction transaction(GlobalSceneGraph());
+
+        temporaryBrush = algorithm::createCubicBrush(worldspawn, Vector3(256, 0, 0));
+        scene::removeNodeFromParent(temporaryBrush);
+        scene::removeNodeFromParent(existingBrush);
+
+        // Removed nodes are unlinked from the space partition right away
+        EXPECT_FALSE(findLinkedNode(existingBrush));
+    }
+
+    // The temporary brush has never been reported
+    EXPECT_TRUE(observer.inserted.empty());
+    EXPECT_EQ(observer.erased, std::vector<scene::INodePtr>{ existingBrush });
+    EXPECT_FALSE(findLinkedNode(temporaryBrush));
+
+    GlobalSceneGraph().removeSceneObserver(&observer);
+}
+
+TEST_F(SceneGraphTest, TransactionLinksNodesOnCommit)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto movedBrush = algorithm::createCubicBrush(worldspawn);
+
+    EXPECT_TRUE(findLinkedNode(movedBrush));
+
+    scene::INodePtr newBrush;
+
+    {
+        scene::GraphTransaction transaction(GlobalSceneGraph());
+
+        newBrush = algorithm::createCubicBrush(worldspawn, Vector3(512, 512, 0));
+
+        // Move the existing brush far away in several steps
+        auto transformable = scene::node_cast<ITransformable>(movedBrush);
+
+        for (auto i = 1; i <= 10; ++i)
+        {
+            transformable->setTranslation(Vector3(i * 2048, 0, 0));
+            movedBrush->worldAABB();
+        }
+
+        transformable->freezeTransform();
+        movedBrush->worldAABB();
+
+        // Nothing is linked until the transaction is committed
+        EXPECT_FALSE(findLinkedNode(newBrush));
+    }
+
+    auto newBrushOctant = findLinkedNode(newBrush);
+    ASSERT_TRUE(newBrushOctant);
+    EXPECT_TRUE(newBrushOctant->getBounds().contains(newBrush->worldAABB()));
+
+    // The moved brush has been re-linked to an octant containing its new bounds
+    auto movedBrushOctant = findLinkedNode(movedBrush);
+    ASSERT_TRUE(movedBrushOctant);
+    EXPECT_EQ(movedBrush->worldAABB().getOrigin(), Vector3(20480, 0, 0));
+    EXPECT_TRUE(movedBrushOctant->getBounds().contains(movedBrush->worldAABB()));
+}
+
+TEST_F(SceneGraphTest, NestedTransactions)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    NodeObserver observer;
+    GlobalSceneGraph().addSceneObserver(&observer);
+
+    {
+        scene::GraphTransaction outer(GlobalSceneGraph());
+
+        {
+            scene::GraphTransaction inner(GlobalSceneGraph());
+            algorithm::createCubicBrush(worldspawn);
+        }
+
+        // Committing the inner transaction doesn't notify anyone
+        EXPECT_TRUE(observer.inserted.empty());
+    }
+
+    EXPECT_EQ(observer.inserted.size(), 1);
+
+    GlobalSceneGraph().removeSceneObserver(&observer);
+}
+
+}
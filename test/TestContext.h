@@ -17,6 +17,7 @@ class TestContext :
 private:
 	std::string _settingsFolder;
 	std::string _tempDataPath;
+	std::string _cacheDataPath;
 
 public:
 	TestContext()
@@ -36,6 +37,14 @@ public:
         os::removeDirectory(_tempDataPath);
         os::makeDirectory(_tempDataPath);
 
+        // The cache folder is only purged here, the test log is kept after the run
+        auto cacheDataFolder = os::getTemporaryPath() / "dr_temp_cache";
+
+        _cacheDataPath = os::standardPathWithSlash(cacheDataFolder.string());
+
+        os::removeDirectory(_cacheDataPath);
+        os::makeDirectory(_cacheDataPath);
+
 		setErrorHandlingFunction([&](const std::string& title, const std::string& message)
 		{
 			std::cerr << "Fatal error " << title << "\n" << message << std::endl;
@@ -85,6 +94,12 @@ public:
 		return _settingsFolder;
 	}
 
+    // Binary caches written by the tests are not mixed with the user's ones
+    std::string getCacheDataPath() const override
+    {
+        return _cacheDataPath;
+    }
+
     // Path to a directory where any stuff can be written to
     // This folder will be purged once on context destruction
     std::string getTemporaryDataPath() const
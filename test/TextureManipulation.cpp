@@ -1,5 +1,6 @@
 #include "RadiantTest.h"
 
+#include <iostream>
 #include "itransformable.h"
 #include "ishaders.h"
 #include "ishaderclipboard.h"
@@ -10,6 +11,8 @@
 #include "math/Quaternion.h"
 #include "registry/registry.h"
 #include "render/CameraView.h"
+#include "shaderlib.h"
+#include "time/StopWatch.h"
 #include "algorithm/View.h"
 
 namespace test
@@ -799,4 +802,63 @@ TEST_F(TextureManipulationTest, FaceGetShiftScaleRotation)
     EXPECT_NEAR(ssr.rotate, 75, 0.01) << "Brush B: Rotation Value is off";
 }
 
+TEST_F(TextureManipulationTest, BrushHasShaderIgnoresCase)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brush = Node_getIBrush(algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0), "textures/a_1024x512"));
+
+    EXPECT_TRUE(brush->hasShader("textures/a_1024x512"));
+    EXPECT_TRUE(brush->hasShader("Textures/A_1024x512"));
+    EXPECT_FALSE(brush->hasShader("textures/b_1024x512"));
+
+    brush->setShader("TEXTURES/B_1024x512");
+
+    EXPECT_TRUE(brush->hasShader("textures/b_1024x512"));
+    EXPECT_FALSE(brush->hasShader("textures/a_1024x512"));
+}
+
+// Benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(TextureManipulationTest, DISABLED_FindAndReplaceShaderBenchmark)
+{
+    constexpr std::size_t NumBrushes = 20000;
+
+    auto materialA = "textures/a_1024x512";
+    auto materialB = "textures/b_1024x512";
+
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    for (std::size_t i = 0; i < NumBrushes; ++i)
+    {
+        Vector3 origin(static_cast<double>(i % 100) * 128, static_cast<double>(i / 100) * 128, 0);
+        algorithm::createCubicBrush(worldspawn, origin, i % 2 == 0 ? materialA : materialB);
+    }
+
+    util::StopWatch timer;
+    auto replaced = scene::findAndReplaceShader(materialA, materialB, false);
+    auto replaceMsecs = timer.getMilliSecondsPassed();
+
+    EXPECT_EQ(replaced, NumBrushes / 2 * 6);
+
+    timer.restart();
+
+    std::size_t brushesWithMaterial = 0;
+
+    worldspawn->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (Node_isBrush(node) && Node_getIBrush(node)->hasShader(materialB))
+        {
+            ++brushesWithMaterial;
+        }
+
+        return true;
+    });
+
+    auto searchMsecs = timer.getMilliSecondsPassed();
+
+    EXPECT_EQ(brushesWithMaterial, NumBrushes);
+
+    std::cout << "Replaced the material of " << replaced << " faces in " << replaceMsecs << " ms, found "
+        << brushesWithMaterial << " brushes by material in " << searchMsecs << " ms" << std::endl;
+}
+
 }
@@ -7,8 +7,11 @@
 #include "scenelib.h"
 #include "selection/SingleItemSelector.h"
 #include "selection/SelectedPlaneSet.h"
+#include "math/Quaternion.h"
 #include "render/View.h"
+#include "registry/registry.h"
 #include "algorithm/View.h"
+#include "algorithm/Primitives.h"
 
 namespace test
 {
@@ -151,4 +154,115 @@ TEST_F(TransformationTest, UniformLightDragResize)
     EXPECT_EQ(entityNode->worldAABB().getExtents(), Vector3(320, 320, 320));
 }
 
+namespace
+{
+
+// Creates a row of brushes and patches, each primitive is created twice at the same position
+void createPrimitivePairs(std::size_t count, std::vector<scene::INodePtr>& first, std::vector<scene::INodePtr>& second)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        Vector3 origin(i * 160.0, (i % 7) * 96.0, (i % 3) * 32.0);
+
+        for (auto* list : { &first, &second })
+        {
+            if (i % 4 == 0)
+            {
+                list->push_back(algorithm::createPatchFromBounds(worldspawn, AABB(origin, Vector3(48, 32, 16))));
+            }
+            else
+            {
+                list->push_back(algorithm::createCubicBrush(worldspawn, origin));
+            }
+        }
+    }
+}
+
+void expectIdenticalGeometry(const scene::INodePtr& node, const scene::INodePtr& expected)
+{
+    if (Node_isBrush(node))
+    {
+        auto& brush = *Node_getIBrush(node);
+        auto& expectedBrush = *Node_getIBrush(expected);
+
+        brush.evaluateBRep();
+        expectedBrush.evaluateBRep();
+
+        ASSERT_EQ(brush.getNumFaces(), expectedBrush.getNumFaces());
+
+        for (std::size_t i = 0; i < brush.getNumFaces(); ++i)
+        {
+            const auto& winding = brush.getFace(i).getWinding();
+            const auto& expectedWinding = expectedBrush.getFace(i).getWinding();
+
+            EXPECT_EQ(brush.getFace(i).getPlane3(), expectedBrush.getFace(i).getPlane3());
+            ASSERT_EQ(winding.size(), expectedWinding.size());
+
+            for (std::size_t v = 0; v < winding.size(); ++v)
+            {
+                EXPECT_EQ(winding[v].vertex, expectedWinding[v].vertex);
+                EXPECT_EQ(winding[v].texcoord, expectedWinding[v].texcoord);
+            }
+        }
+    }
+    else
+    {
+        auto mesh = Node_getIPatch(node)->getTesselatedPatchMesh();
+        auto expectedMesh = Node_getIPatch(expected)->getTesselatedPatchMesh();
+
+        ASSERT_EQ(mesh.vertices.size(), expectedMesh.vertices.size());
+
+        for (std::size_t v = 0; v < mesh.vertices.size(); ++v)
+        {
+            EXPECT_EQ(mesh.vertices[v].vertex, expectedMesh.vertices[v].vertex);
+            EXPECT_EQ(mesh.vertices[v].texcoord, expectedMesh.vertices[v].texcoord);
+        }
+    }
+
+    EXPECT_EQ(node->worldAABB(), expected->worldAABB());
+}
+
+}
+
+// Rotating a large selection must produce the same geometry as transforming the nodes one by one
+TEST_F(TransformationTest, BulkRotationMatchesSingleNodeTransformation)
+{
+    registry::setValue("user/ui/rotateObjectsIndependently", false);
+
+    std::vector<scene::INodePtr> bulkNodes;
+    std::vector<scene::INodePtr> singleNodes;
+    createPrimitivePairs(200, bulkNodes, singleNodes);
+
+    for (const auto& node : bulkNodes)
+    {
+        Node_setSelected(node, true);
+    }
+
+    auto pivot = GlobalSelectionSystem().getPivot2World().translation();
+    Vector3 eulerAngles(15, 30, 45);
+
+    GlobalCommandSystem().executeCommand("RotateSelectedEulerXYZ", cmd::Argument(eulerAngles));
+
+    // Apply the same rotation to the second set of nodes, freezing them one after the other
+    auto rotation = Quaternion::createForEulerXYZDegrees(eulerAngles);
+
+    for (const auto& node : singleNodes)
+    {
+        auto transformable = scene::node_cast<ITransformable>(node);
+
+        transformable->setType(TRANSFORM_PRIMITIVE);
+        transformable->setScale(Vector3(1, 1, 1));
+        transformable->setTranslation(Vector3(0, 0, 0));
+        transformable->setRotation(rotation, pivot, node->localToWorld());
+        transformable->freezeTransform();
+    }
+
+    for (std::size_t i = 0; i < bulkNodes.size(); ++i)
+    {
+        expectIdenticalGeometry(bulkNodes[i], singleNodes[i]);
+    }
+}
+
 }
@@ -3,15 +3,19 @@
 #include <sigc++/connection.h>
 #include "iundo.h"
 #include "ibrush.h"
+#include "ipatch.h"
+#include "itransformable.h"
 #include "ieclass.h"
 #include "ientity.h"
 #include "iscenegraphfactory.h"
 #include "imap.h"
 #include "icommandsystem.h"
 #include "math/Matrix4.h"
+#include "math/Quaternion.h"
 #include "algorithm/Scene.h"
 #include "algorithm/Primitives.h"
 #include "scenelib.h"
+#include "registry/registry.h"
 #include "scene/BasicRootNode.h"
 #include "testutil/FileSelectionHelper.h"
 
@@ -872,4 +876,269 @@ TEST_F(UndoTest, OperationTracking)
     EXPECT_EQ(tracker.receivedOperationName, "") << "Nothing should fire, already detached";
 }
 
+namespace
+{
+
+inline std::vector<PatchControl> getPatchControls(const IPatch& patch)
+{
+    std::vector<PatchControl> controls;
+
+    algorithm::foreachPatchVertex(patch, [&](const PatchControl& control)
+    {
+        controls.push_back(control);
+    });
+
+    return controls;
+}
+
+inline void expectPatchControlsEqual(const IPatch& patch, const std::vector<PatchControl>& expected)
+{
+    auto controls = getPatchControls(patch);
+    ASSERT_EQ(controls.size(), expected.size());
+
+    for (std::size_t i = 0; i < controls.size(); ++i)
+    {
+        // Undo/Redo needs to restore the exact values
+        EXPECT_EQ(controls[i].vertex, expected[i].vertex) << "Control vertex " << i << " mismatch";
+        EXPECT_EQ(controls[i].texcoord, expected[i].texcoord) << "Control texcoord " << i << " mismatch";
+    }
+}
+
+inline void transformNode(const scene::INodePtr& node, const Vector3& translation, const Quaternion& rotation)
+{
+    UndoableCommand cmd("transformNode");
+
+    auto transformable = scene::node_cast<ITransformable>(node);
+    transformable->setTranslation(translation);
+    transformable->setRotation(rotation);
+    transformable->freezeTransform();
+}
+
+struct FaceState
+{
+    Plane3 plane;
+    Matrix3 projection;
+    std::string material;
+};
+
+inline std::vector<FaceState> getFaceStates(IBrush& brush)
+{
+    std::vector<FaceState> states;
+
+    algorithm::foreachFace(brush, [&](IFace& face)
+    {
+        states.push_back(FaceState{ face.getPlane3(), face.getProjectionMatrix(), face.getShader() });
+    });
+
+    return states;
+}
+
+inline void expectFaceStatesEqual(IBrush& brush, const std::vector<FaceState>& expected)
+{
+    auto states = getFaceStates(brush);
+    ASSERT_EQ(states.size(), expected.size());
+
+    for (std::size_t i = 0; i < states.size(); ++i)
+    {
+        EXPECT_EQ(states[i].plane.normal(), expected[i].plane.normal()) << "Face " << i << " normal mismatch";
+        EXPECT_EQ(states[i].plane.dist(), expected[i].plane.dist()) << "Face " << i << " distance mismatch";
+        EXPECT_EQ(states[i].projection, expected[i].projection) << "Face " << i << " projection mismatch";
+        EXPECT_EQ(states[i].material, expected[i].material) << "Face " << i << " material mismatch";
+    }
+}
+
+}
+
+// Patch states are stored as deltas, check that translations, rotations and
+// single control point changes round-trip exactly
+TEST_F(UndoTest, PatchStatesRoundTrip)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto patchNode = algorithm::createPatchFromBounds(worldspawn, AABB(Vector3(4, 50, 17), Vector3(64, 128, 32)));
+    auto patch = Node_getIPatch(patchNode);
+
+    std::vector<std::vector<PatchControl>> states;
+    states.push_back(getPatchControls(*patch));
+
+    // Integer translation
+    transformNode(patchNode, Vector3(16, -32, 8), Quaternion::Identity());
+    states.push_back(getPatchControls(*patch));
+
+    // Fractional translation
+    transformNode(patchNode, Vector3(0.1, 0.35, -7.77), Quaternion::Identity());
+    states.push_back(getPatchControls(*patch));
+
+    // Move a single control point and change its texcoord
+    {
+        UndoableCommand cmd("moveControlPoint");
+        patch->undoSave();
+        patch->ctrlAt(1, 1).vertex += Vector3(3.3, 0, 12);
+        patch->ctrlAt(1, 1).texcoord += Vector2(0.25, 0.5);
+        patch->controlPointsChanged();
+    }
+    states.push_back(getPatchControls(*patch));
+
+    // Rotation
+    transformNode(patchNode, Vector3(0, 0, 0), Quaternion::createForZ(degrees_to_radians(33)));
+    states.push_back(getPatchControls(*patch));
+
+    // Another integer translation
+    transformNode(patchNode, Vector3(-64, 0, 128), Quaternion::Identity());
+    states.push_back(getPatchControls(*patch));
+
+    for (auto i = static_cast<int>(states.size()) - 2; i >= 0; --i)
+    {
+        GlobalUndoSystem().undo();
+        expectPatchControlsEqual(*patch, states[i]);
+    }
+
+    for (std::size_t i = 1; i < states.size(); ++i)
+    {
+        GlobalUndoSystem().redo();
+        expectPatchControlsEqual(*patch, states[i]);
+    }
+}
+
+// Face states share unchanged material and texture data, check that this round-trips
+TEST_F(UndoTest, BrushFaceStatesRoundTrip)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brushNode = algorithm::createCubicBrush(worldspawn, Vector3(32, 16, -8), "textures/numbers/1");
+    auto& brush = *Node_getIBrush(brushNode);
+
+    std::vector<std::vector<FaceState>> states;
+    states.push_back(getFaceStates(brush));
+
+    transformNode(brushNode, Vector3(16, -32, 8), Quaternion::Identity());
+    states.push_back(getFaceStates(brush));
+
+    {
+        UndoableCommand cmd("shiftTexture");
+        algorithm::foreachFace(brush, [](IFace& face) { face.shiftTexdef(0.125f, 0.5f); });
+    }
+    states.push_back(getFaceStates(brush));
+
+    {
+        UndoableCommand cmd("changeMaterial");
+        brush.getFace(0).setShader("textures/numbers/2");
+    }
+    states.push_back(getFaceStates(brush));
+
+    transformNode(brushNode, Vector3(0, 0, 0), Quaternion::createForZ(degrees_to_radians(45)));
+    states.push_back(getFaceStates(brush));
+
+    for (auto i = static_cast<int>(states.size()) - 2; i >= 0; --i)
+    {
+        GlobalUndoSystem().undo();
+        expectFaceStatesEqual(brush, states[i]);
+    }
+
+    for (std::size_t i = 1; i < states.size(); ++i)
+    {
+        GlobalUndoSystem().redo();
+        expectFaceStatesEqual(brush, states[i]);
+    }
+}
+
+TEST_F(UndoTest, MemoryUsageTracking)
+{
+    auto& undoSystem = GlobalUndoSystem();
+    auto entity = setupTestEntity();
+
+    {
+        UndoableCommand cmd("firstOperation");
+        Node_getEntity(entity)->setKeyValue("test", std::string(10000, 'a'));
+    }
+
+    {
+        UndoableCommand cmd("secondOperation");
+        Node_getEntity(entity)->setKeyValue("test", std::string(10000, 'b'));
+    }
+
+    // The second operation saved the 10k value of the first one
+    std::vector<std::pair<std::string, std::size_t>> operations;
+    undoSystem.foreachOperation([&](const std::string& name, std::size_t size)
+    {
+        operations.emplace_back(name, size);
+    });
+
+    ASSERT_EQ(operations.size(), 2) << "Expected the two recorded operations";
+    EXPECT_EQ(operations[0].first, "firstOperation");
+    EXPECT_EQ(operations[1].first, "secondOperation");
+    EXPECT_GT(operations[0].second, 0);
+    EXPECT_GT(operations[1].second, 10000);
+
+    auto usage = undoSystem.getMemoryUsage();
+    EXPECT_EQ(usage, operations[0].second + operations[1].second);
+
+    // Undoing moves the operation to the redo stack which is still accounted for
+    undoSystem.undo();
+    EXPECT_GT(undoSystem.getMemoryUsage(), 10000);
+
+    undoSystem.clear();
+    EXPECT_EQ(undoSystem.getMemoryUsage(), 0) << "Cleared history should not occupy any memory";
+}
+
+// Control points shared by several patch states are accounted for once, split among the owners
+TEST_F(UndoTest, MemoryUsageCountsSharedStatesOnce)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto patchNode = algorithm::createPatchFromBounds(worldspawn, AABB(Vector3(4, 50, 17), Vector3(64, 128, 32)));
+    auto patch = Node_getIPatch(patchNode);
+
+    {
+        UndoableCommand cmd("resizePatch");
+        patch->undoSave();
+        patch->setDims(31, 31);
+        patch->controlPointsChanged();
+    }
+
+    GlobalUndoSystem().clear();
+
+    // The first translation takes a full snapshot, the others refer to it
+    for (int i = 1; i <= 4; ++i)
+    {
+        transformNode(patchNode, Vector3(16 * i, 0, 0), Quaternion::Identity());
+    }
+
+    // The shares of the older operations have been estimated with fewer owners
+    GlobalUndoSystem().updateMemoryUsage();
+
+    auto controlPointSize = 31 * 31 * sizeof(PatchControl);
+    auto usage = GlobalUndoSystem().getMemoryUsage();
+
+    EXPECT_GT(usage, controlPointSize);
+    EXPECT_LT(usage, controlPointSize * 3 / 2) << "Shared control points have been counted more than once";
+}
+
+TEST_F(UndoTest, MemoryLimitDiscardsOldestOperations)
+{
+    registry::setValue("user/ui/undo/memoryLimit", 1); // 1 MB
+
+    auto& undoSystem = GlobalUndoSystem();
+    auto entity = setupTestEntity();
+
+    // Each operation saves the previous 300 kB value
+    for (char c = 'a'; c < 'h'; ++c)
+    {
+        UndoableCommand cmd(std::string("operation_") + c);
+        Node_getEntity(entity)->setKeyValue("test", std::string(300 * 1024, c));
+    }
+
+    std::vector<std::string> operations;
+    undoSystem.foreachOperation([&](const std::string& name, std::size_t size)
+    {
+        operations.push_back(name);
+    });
+
+    EXPECT_LE(undoSystem.getMemoryUsage(), 1024 * 1024) << "History exceeds the memory limit";
+    EXPECT_LT(operations.size(), 7) << "No operations have been discarded";
+    ASSERT_FALSE(operations.empty());
+    EXPECT_EQ(operations.back(), "operation_g") << "Most recent operation should have been kept";
+
+    // The remaining operations are still functional
+    undoSystem.undo();
+    EXPECT_EQ(Node_getEntity(entity)->getKeyValue("test"), std::string(300 * 1024, 'f'));
+}
+
 }
@@ -0,0 +1,69 @@
+#include "gtest/gtest.h"
+
+#include "math/Hash.h"
+
+namespace test
+{
+
+TEST(MathTest, Sha256Hash)
+{
+    math::Hash hash;
+    hash.addString("abc");
+
+    EXPECT_EQ(static_cast<std::string>(hash), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+}
+
+TEST(MathTest, FastHash)
+{
+    // MurmurHash3 (x64, 128 bit) reference values
+    EXPECT_EQ(static_cast<std::string>(math::FastHash()), "00000000000000000000000000000000");
+
+    math::FastHash hash;
+    hash.addString("hello");
+
+    EXPECT_EQ(static_cast<std::string>(hash), "cbd8a7b341bd9b025b1e906a48ae1d19");
+    EXPECT_EQ(hash.getDigest64(), 0xcbd8a7b341bd9b02ULL);
+}
+
+TEST(MathTest, FastHashIsIndependentOfDataPartitioning)
+{
+    std::string data = "The quick brown fox jumps over the lazy dog, 0123456789 times";
+
+    math::FastHash reference;
+    reference.addString(data);
+
+    for (std::size_t split = 0; split < data.length(); ++split)
+    {
+        math::FastHash hash;
+
+        hash.addString(data.substr(0, split));
+        hash.addString(data.substr(split, 7));
+
+        if (split + 7 < data.length())
+        {
+            hash.addString(data.substr(split + 7));
+        }
+
+        EXPECT_EQ(static_cast<std::string>(hash), static_cast<std::string>(reference)) << "Split at " << split;
+    }
+}
+
+TEST(MathTest, FastHashDistinguishesValues)
+{
+    math::FastHash first;
+    first.addVector3(Vector3(1, 2, 3), 6);
+    first.addDouble(0.5, 6);
+
+    math::FastHash second;
+    second.addVector3(Vector3(1, 2, 3), 6);
+    second.addDouble(0.25, 6);
+
+    math::FastHash third;
+    third.addVector3(Vector3(1, 2, 3), 6);
+    third.addDouble(0.5, 6);
+
+    EXPECT_NE(static_cast<std::string>(first), static_cast<std::string>(second));
+    EXPECT_EQ(static_cast<std::string>(first), static_cast<std::string>(third));
+}
+
+}